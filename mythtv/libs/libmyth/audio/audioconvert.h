@@ -65,8 +65,11 @@ public:
                            int data_size);
 
     // static utilities
-    static int  toFloat(AudioFormat format, void* out, const void* in, int bytes);
-    static int  fromFloat(AudioFormat format, void* out, const void* in, int bytes);
+    // optimised = false only runs the C code (see AudioKernels)
+    static int  toFloat(AudioFormat format, void* out, const void* in, int bytes,
+                        bool optimised = true);
+    static int  fromFloat(AudioFormat format, void* out, const void* in, int bytes,
+                          bool optimised = true);
     static void MonoToStereo(void* dst, const void* src, int samples);
     static void DeinterleaveSamples(AudioFormat format, int channels,
                                     uint8_t* output, const uint8_t* input,
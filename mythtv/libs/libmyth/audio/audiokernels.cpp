@@ -0,0 +1,925 @@
+/*
+ *  Class AudioKernels
+ *
+ *  SSE2 code moved from AudioConvert and AudioOutputUtil
+ *  Copyright (C) Bubblestuff Pty Ltd 2013
+ *  Copyright (C) foobum@gmail.com 2010
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <array>
+
+#include "mythconfig.h"
+#include "mythlogging.h"
+#include "audiokernels.h"
+
+extern "C" {
+#include "libavutil/cpu.h"
+}
+
+#if ARCH_X86 && HAVE_AVX2 && defined(__GNUC__)
+#define AUDIO_KERNELS_AVX2 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#if HAVE_INTRINSICS_NEON
+#if ARCH_AARCH64
+#include "libavutil/aarch64/cpu.h"
+#elif ARCH_ARM
+#include "libavutil/arm/cpu.h"
+#endif
+#include <arm_neon.h>
+#endif
+
+#define LOC QString("AudioKernels: ")
+
+/*
+ All kernels produce exactly what the C code in AudioConvert, AudioOutputUtil
+ and AudioOutputDownmix produces for the samples they process, bar the
+ rounding of exact halves on ARMv7 (which has no round to nearest
+ conversion).
+ */
+
+#if ARCH_X86
+
+/*
+ The SSE code processes 16 samples at a time and leaves any remainder for
+ the C
+ */
+
+static int SSE2_toFloat8(float* out, const uchar* in, int len)
+{
+    if (len < 16)
+        return 0;
+
+    float f = 1.0F / ((1<<7));
+
+    int loops = len >> 4;
+    int a = 0x80808080;
+
+    __asm__ volatile (
+                      "movd       %3, %%xmm0          \n\t"
+                      "movd       %4, %%xmm7          \n\t"
+                      "punpckldq  %%xmm0, %%xmm0      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "punpckldq  %%xmm0, %%xmm0      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "1:                             \n\t"
+                      "movdqu     (%1), %%xmm1        \n\t"
+                      "xorpd      %%xmm2, %%xmm2      \n\t"
+                      "xorpd      %%xmm3, %%xmm3      \n\t"
+                      "psubb      %%xmm0, %%xmm1      \n\t"
+                      "xorpd      %%xmm4, %%xmm4      \n\t"
+                      "punpcklbw  %%xmm1, %%xmm2      \n\t"
+                      "xorpd      %%xmm5, %%xmm5      \n\t"
+                      "punpckhbw  %%xmm1, %%xmm3      \n\t"
+                      "punpcklwd  %%xmm2, %%xmm4      \n\t"
+                      "xorpd      %%xmm6, %%xmm6      \n\t"
+                      "punpckhwd  %%xmm2, %%xmm5      \n\t"
+                      "psrad      $24,    %%xmm4      \n\t"
+                      "punpcklwd  %%xmm3, %%xmm6      \n\t"
+                      "psrad      $24,    %%xmm5      \n\t"
+                      "punpckhwd  %%xmm3, %%xmm1      \n\t"
+                      "psrad      $24,    %%xmm6      \n\t"
+                      "cvtdq2ps   %%xmm4, %%xmm4      \n\t"
+                      "psrad      $24,    %%xmm1      \n\t"
+                      "cvtdq2ps   %%xmm5, %%xmm5      \n\t"
+                      "mulps      %%xmm7, %%xmm4      \n\t"
+                      "cvtdq2ps   %%xmm6, %%xmm6      \n\t"
+                      "mulps      %%xmm7, %%xmm5      \n\t"
+                      "movups     %%xmm4, (%0)        \n\t"
+                      "cvtdq2ps   %%xmm1, %%xmm1      \n\t"
+                      "mulps      %%xmm7, %%xmm6      \n\t"
+                      "movups     %%xmm5, 16(%0)      \n\t"
+                      "mulps      %%xmm7, %%xmm1      \n\t"
+                      "movups     %%xmm6, 32(%0)      \n\t"
+                      "add        $16,    %1          \n\t"
+                      "movups     %%xmm1, 48(%0)      \n\t"
+                      "add        $64,    %0          \n\t"
+                      "sub        $1, %%ecx           \n\t"
+                      "jnz        1b                  \n\t"
+                      :"+r"(out),"+r"(in)
+                      :"c"(loops), "r"(a), "r"(f)
+                      );
+    return loops << 4;
+}
+
+static int SSE2_fromFloat8(uchar* out, const float* in, int len)
+{
+    if (len < 16)
+        return 0;
+
+    float f = (1<<7);
+
+    int loops = len >> 4;
+    int a = 0x80808080;
+
+    __asm__ volatile (
+                      "movd       %3, %%xmm0          \n\t"
+                      "movd       %4, %%xmm7          \n\t"
+                      "punpckldq  %%xmm0, %%xmm0      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "punpckldq  %%xmm0, %%xmm0      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "1:                             \n\t"
+                      "movups     (%1), %%xmm1        \n\t"
+                      "movups     16(%1), %%xmm2      \n\t"
+                      "mulps      %%xmm7, %%xmm1      \n\t"
+                      "movups     32(%1), %%xmm3      \n\t"
+                      "mulps      %%xmm7, %%xmm2      \n\t"
+                      "cvtps2dq   %%xmm1, %%xmm1      \n\t"
+                      "movups     48(%1), %%xmm4      \n\t"
+                      "mulps      %%xmm7, %%xmm3      \n\t"
+                      "cvtps2dq   %%xmm2, %%xmm2      \n\t"
+                      "mulps      %%xmm7, %%xmm4      \n\t"
+                      "cvtps2dq   %%xmm3, %%xmm3      \n\t"
+                      "packssdw   %%xmm2, %%xmm1      \n\t"
+                      "cvtps2dq   %%xmm4, %%xmm4      \n\t"
+                      "packssdw   %%xmm4, %%xmm3      \n\t"
+                      "add        $64,    %1          \n\t"
+                      "packsswb   %%xmm3, %%xmm1      \n\t"
+                      "paddb      %%xmm0, %%xmm1      \n\t"
+                      "movdqu     %%xmm1, (%0)        \n\t"
+                      "add        $16,    %0          \n\t"
+                      "sub        $1, %%ecx           \n\t"
+                      "jnz        1b                  \n\t"
+                      :"+r"(out),"+r"(in)
+                      :"c"(loops), "r"(a), "r"(f)
+                      );
+    return loops << 4;
+}
+
+static int SSE2_toFloat16(float* out, const short* in, int len)
+{
+    if (len < 16)
+        return 0;
+
+    float f = 1.0F / ((1<<15));
+
+    int loops = len >> 4;
+
+    __asm__ volatile (
+                      "movd       %3, %%xmm7          \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "1:                             \n\t"
+                      "xorpd      %%xmm2, %%xmm2      \n\t"
+                      "movdqu     (%1),   %%xmm1      \n\t"
+                      "xorpd      %%xmm3, %%xmm3      \n\t"
+                      "punpcklwd  %%xmm1, %%xmm2      \n\t"
+                      "movdqu     16(%1), %%xmm4      \n\t"
+                      "punpckhwd  %%xmm1, %%xmm3      \n\t"
+                      "psrad      $16,    %%xmm2      \n\t"
+                      "punpcklwd  %%xmm4, %%xmm5      \n\t"
+                      "psrad      $16,    %%xmm3      \n\t"
+                      "cvtdq2ps   %%xmm2, %%xmm2      \n\t"
+                      "punpckhwd  %%xmm4, %%xmm6      \n\t"
+                      "psrad      $16,    %%xmm5      \n\t"
+                      "mulps      %%xmm7, %%xmm2      \n\t"
+                      "cvtdq2ps   %%xmm3, %%xmm3      \n\t"
+                      "psrad      $16,    %%xmm6      \n\t"
+                      "mulps      %%xmm7, %%xmm3      \n\t"
+                      "cvtdq2ps   %%xmm5, %%xmm5      \n\t"
+                      "movups     %%xmm2, (%0)        \n\t"
+                      "cvtdq2ps   %%xmm6, %%xmm6      \n\t"
+                      "mulps      %%xmm7, %%xmm5      \n\t"
+                      "movups     %%xmm3, 16(%0)      \n\t"
+                      "mulps      %%xmm7, %%xmm6      \n\t"
+                      "movups     %%xmm5, 32(%0)      \n\t"
+                      "add        $32, %1             \n\t"
+                      "movups     %%xmm6, 48(%0)      \n\t"
+                      "add        $64, %0             \n\t"
+                      "sub        $1, %%ecx           \n\t"
+                      "jnz        1b                  \n\t"
+                      :"+r"(out),"+r"(in)
+                      :"c"(loops), "r"(f)
+                      );
+    return loops << 4;
+}
+
+static int SSE2_fromFloat16(short* out, const float* in, int len)
+{
+    if (len < 16)
+        return 0;
+
+    float f = (1<<15);
+
+    int loops = len >> 4;
+
+    __asm__ volatile (
+                      "movd       %3, %%xmm7          \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "1:                             \n\t"
+                      "movups     (%1), %%xmm1        \n\t"
+                      "movups     16(%1), %%xmm2      \n\t"
+                      "mulps      %%xmm7, %%xmm1      \n\t"
+                      "movups     32(%1), %%xmm3      \n\t"
+                      "mulps      %%xmm7, %%xmm2      \n\t"
+                      "cvtps2dq   %%xmm1, %%xmm1      \n\t"
+                      "movups     48(%1), %%xmm4      \n\t"
+                      "mulps      %%xmm7, %%xmm3      \n\t"
+                      "cvtps2dq   %%xmm2, %%xmm2      \n\t"
+                      "mulps      %%xmm7, %%xmm4      \n\t"
+                      "cvtps2dq   %%xmm3, %%xmm3      \n\t"
+                      "cvtps2dq   %%xmm4, %%xmm4      \n\t"
+                      "packssdw   %%xmm2, %%xmm1      \n\t"
+                      "packssdw   %%xmm4, %%xmm3      \n\t"
+                      "add        $64,    %1          \n\t"
+                      "movdqu     %%xmm1, (%0)        \n\t"
+                      "movdqu     %%xmm3, 16(%0)      \n\t"
+                      "add        $32,    %0          \n\t"
+                      "sub        $1, %%ecx           \n\t"
+                      "jnz        1b                  \n\t"
+                      :"+r"(out),"+r"(in)
+                      :"c"(loops), "r"(f)
+                      );
+    return loops << 4;
+}
+
+static int SSE2_toFloat32(float* out, const int* in, int len, float f, int shift)
+{
+    if (len < 16)
+        return 0;
+
+    int loops = len >> 4;
+
+    __asm__ volatile (
+                      "movd       %3, %%xmm7          \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "movd       %4, %%xmm6          \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "1:                             \n\t"
+                      "movdqu     (%1),   %%xmm1      \n\t"
+                      "movdqu     16(%1), %%xmm2      \n\t"
+                      "psrad      %%xmm6, %%xmm1      \n\t"
+                      "movdqu     32(%1), %%xmm3      \n\t"
+                      "cvtdq2ps   %%xmm1, %%xmm1      \n\t"
+                      "psrad      %%xmm6, %%xmm2      \n\t"
+                      "movdqu     48(%1), %%xmm4      \n\t"
+                      "cvtdq2ps   %%xmm2, %%xmm2      \n\t"
+                      "psrad      %%xmm6, %%xmm3      \n\t"
+                      "mulps      %%xmm7, %%xmm1      \n\t"
+                      "psrad      %%xmm6, %%xmm4      \n\t"
+                      "cvtdq2ps   %%xmm3, %%xmm3      \n\t"
+                      "movups     %%xmm1, (%0)        \n\t"
+                      "mulps      %%xmm7, %%xmm2      \n\t"
+                      "cvtdq2ps   %%xmm4, %%xmm4      \n\t"
+                      "movups     %%xmm2, 16(%0)      \n\t"
+                      "mulps      %%xmm7, %%xmm3      \n\t"
+                      "mulps      %%xmm7, %%xmm4      \n\t"
+                      "movups     %%xmm3, 32(%0)      \n\t"
+                      "add        $64,    %1          \n\t"
+                      "movups     %%xmm4, 48(%0)      \n\t"
+                      "add        $64,    %0          \n\t"
+                      "sub        $1, %%ecx           \n\t"
+                      "jnz        1b                  \n\t"
+                      :"+r"(out),"+r"(in)
+                      :"c"(loops), "r"(f), "r"(shift)
+                      );
+    return loops << 4;
+}
+
+static int SSE2_fromFloat32(int* out, const float* in, int len, float f, int shift)
+{
+    if (len < 16)
+        return 0;
+
+    // Largest value that scales to (range - 128), as the C code clips to
+    float o = (f - 128) / f;
+    float mo = -1;
+    int loops = len >> 4;
+
+    __asm__ volatile (
+                      "movd       %3, %%xmm7          \n\t"
+                      "movss      %4, %%xmm5          \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "movss      %5, %%xmm6          \n\t"
+                      "punpckldq  %%xmm5, %%xmm5      \n\t"
+                      "punpckldq  %%xmm6, %%xmm6      \n\t"
+                      "movd       %6, %%xmm0          \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "punpckldq  %%xmm5, %%xmm5      \n\t"
+                      "punpckldq  %%xmm6, %%xmm6      \n\t"
+                      "1:                             \n\t"
+                      "movups     (%1), %%xmm1        \n\t"
+                      "movups     16(%1), %%xmm2      \n\t"
+                      "minps      %%xmm5, %%xmm1      \n\t"
+                      "movups     32(%1), %%xmm3      \n\t"
+                      "maxps      %%xmm6, %%xmm1      \n\t"
+                      "movups     48(%1), %%xmm4      \n\t"
+                      "mulps      %%xmm7, %%xmm1      \n\t"
+                      "minps      %%xmm5, %%xmm2      \n\t"
+                      "cvtps2dq   %%xmm1, %%xmm1      \n\t"
+                      "maxps      %%xmm6, %%xmm2      \n\t"
+                      "pslld      %%xmm0, %%xmm1      \n\t"
+                      "minps      %%xmm5, %%xmm3      \n\t"
+                      "mulps      %%xmm7, %%xmm2      \n\t"
+                      "movdqu     %%xmm1, (%0)        \n\t"
+                      "cvtps2dq   %%xmm2, %%xmm2      \n\t"
+                      "maxps      %%xmm6, %%xmm3      \n\t"
+                      "minps      %%xmm5, %%xmm4      \n\t"
+                      "pslld      %%xmm0, %%xmm2      \n\t"
+                      "mulps      %%xmm7, %%xmm3      \n\t"
+                      "maxps      %%xmm6, %%xmm4      \n\t"
+                      "movdqu     %%xmm2, 16(%0)      \n\t"
+                      "cvtps2dq   %%xmm3, %%xmm3      \n\t"
+                      "mulps      %%xmm7, %%xmm4      \n\t"
+                      "pslld      %%xmm0, %%xmm3      \n\t"
+                      "cvtps2dq   %%xmm4, %%xmm4      \n\t"
+                      "movdqu     %%xmm3, 32(%0)      \n\t"
+                      "pslld      %%xmm0, %%xmm4      \n\t"
+                      "add        $64,    %1          \n\t"
+                      "movdqu     %%xmm4, 48(%0)      \n\t"
+                      "add        $64,    %0          \n\t"
+                      "sub        $1, %%ecx           \n\t"
+                      "jnz        1b                  \n\t"
+                      :"+r"(out), "+r"(in)
+                      :"c"(loops), "r"(f), "m"(o), "m"(mo), "r"(shift)
+                      );
+    return loops << 4;
+}
+
+static int SSE2_clipFloat(float* out, const float* in, int len)
+{
+    if (len < 16)
+        return 0;
+
+    int loops = len >> 4;
+    float o = 1;
+    float mo = -1;
+
+    __asm__ volatile (
+                      "movss      %3, %%xmm6          \n\t"
+                      "movss      %4, %%xmm7          \n\t"
+                      "punpckldq  %%xmm6, %%xmm6      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "punpckldq  %%xmm6, %%xmm6      \n\t"
+                      "punpckldq  %%xmm7, %%xmm7      \n\t"
+                      "1:                             \n\t"
+                      "movups     (%1), %%xmm1        \n\t"
+                      "movups     16(%1), %%xmm2      \n\t"
+                      "minps      %%xmm6, %%xmm1      \n\t"
+                      "movups     32(%1), %%xmm3      \n\t"
+                      "maxps      %%xmm7, %%xmm1      \n\t"
+                      "minps      %%xmm6, %%xmm2      \n\t"
+                      "movups     48(%1), %%xmm4      \n\t"
+                      "maxps      %%xmm7, %%xmm2      \n\t"
+                      "movups     %%xmm1, (%0)        \n\t"
+                      "minps      %%xmm6, %%xmm3      \n\t"
+                      "movups     %%xmm2, 16(%0)      \n\t"
+                      "maxps      %%xmm7, %%xmm3      \n\t"
+                      "minps      %%xmm6, %%xmm4      \n\t"
+                      "movups     %%xmm3, 32(%0)      \n\t"
+                      "maxps      %%xmm7, %%xmm4      \n\t"
+                      "add        $64,    %1          \n\t"
+                      "movups     %%xmm4, 48(%0)      \n\t"
+                      "add        $64,    %0          \n\t"
+                      "sub        $1, %%ecx           \n\t"
+                      "jnz        1b                  \n\t"
+                      :"+r"(out), "+r"(in)
+                      :"c"(loops), "m"(o), "m"(mo)
+                      );
+    return loops << 4;
+}
+
+static int SSE2_scaleFloat(float* buf, int len, float gain)
+{
+    if (len < 16)
+        return 0;
+
+    int loops = len >> 4;
+
+    __asm__ volatile (
+        "movss      %2, %%xmm0          \n\t"
+        "punpckldq  %%xmm0, %%xmm0      \n\t"
+        "punpckldq  %%xmm0, %%xmm0      \n\t"
+        "1:                             \n\t"
+        "movups     (%0), %%xmm1        \n\t"
+        "movups     16(%0), %%xmm2      \n\t"
+        "mulps      %%xmm0, %%xmm1      \n\t"
+        "movups     32(%0), %%xmm3      \n\t"
+        "mulps      %%xmm0, %%xmm2      \n\t"
+        "movups     48(%0), %%xmm4      \n\t"
+        "mulps      %%xmm0, %%xmm3      \n\t"
+        "movups     %%xmm1, (%0)        \n\t"
+        "mulps      %%xmm0, %%xmm4      \n\t"
+        "movups     %%xmm2, 16(%0)      \n\t"
+        "movups     %%xmm3, 32(%0)      \n\t"
+        "movups     %%xmm4, 48(%0)      \n\t"
+        "add        $64,    %0          \n\t"
+        "sub        $1, %%ecx           \n\t"
+        "jnz        1b                  \n\t"
+        :"+r"(buf)
+        :"c"(loops),"m"(gain)
+    );
+    return loops << 4;
+}
+#endif //ARCH_X86
+
+#ifdef AUDIO_KERNELS_AVX2
+AVX2_TARGET static int AVX2_toFloat8(float* out, const uchar* in, int len)
+{
+    const __m256  scale = _mm256_set1_ps(1.0F / ((1<<7)));
+    const __m256i bias  = _mm256_set1_epi32(0x80);
+    int i = 0;
+    for (; i < (len & ~15); i += 16)
+    {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m256i lo = _mm256_sub_epi32(_mm256_cvtepu8_epi32(bytes), bias);
+        __m256i hi = _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(bytes, 8)), bias);
+        _mm256_storeu_ps(out + i,     _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    return i;
+}
+
+AVX2_TARGET static int AVX2_fromFloat8(uchar* out, const float* in, int len)
+{
+    const __m256  scale = _mm256_set1_ps(1<<7);
+    const __m256i bias  = _mm256_set1_epi8(static_cast<char>(0x80));
+    // The packs work within 128 bit lanes, this puts the dwords back in order
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+    int i = 0;
+    for (; i < (len & ~31); i += 32)
+    {
+        __m256i a = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i),      scale));
+        __m256i b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8),  scale));
+        __m256i c = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i + 16), scale));
+        __m256i d = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i + 24), scale));
+        __m256i bytes = _mm256_packs_epi16(_mm256_packs_epi32(a, b), _mm256_packs_epi32(c, d));
+        bytes = _mm256_add_epi8(_mm256_permutevar8x32_epi32(bytes, order), bias);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), bytes);
+    }
+    return i;
+}
+
+AVX2_TARGET static int AVX2_toFloat16(float* out, const short* in, int len)
+{
+    const __m256 scale = _mm256_set1_ps(1.0F / ((1<<15)));
+    int i = 0;
+    for (; i < (len & ~15); i += 16)
+    {
+        __m256i lo = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)));
+        __m256i hi = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 8)));
+        _mm256_storeu_ps(out + i,     _mm256_mul_ps(_mm256_cvtepi32_ps(lo), scale));
+        _mm256_storeu_ps(out + i + 8, _mm256_mul_ps(_mm256_cvtepi32_ps(hi), scale));
+    }
+    return i;
+}
+
+AVX2_TARGET static int AVX2_fromFloat16(short* out, const float* in, int len)
+{
+    const __m256 scale = _mm256_set1_ps(1<<15);
+    int i = 0;
+    for (; i < (len & ~15); i += 16)
+    {
+        __m256i a = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i),     scale));
+        __m256i b = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale));
+        __m256i words = _mm256_permute4x64_epi64(_mm256_packs_epi32(a, b), 0xD8);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), words);
+    }
+    return i;
+}
+
+AVX2_TARGET static int AVX2_toFloat32(float* out, const int* in, int len, float f, int shift)
+{
+    const __m256  scale = _mm256_set1_ps(f);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    int i = 0;
+    for (; i < (len & ~7); i += 8)
+    {
+        __m256i v = _mm256_sra_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)), count);
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+    }
+    return i;
+}
+
+AVX2_TARGET static int AVX2_fromFloat32(int* out, const float* in, int len, float f, int shift)
+{
+    auto range = static_cast<uint>(f);
+    const __m256  scale = _mm256_set1_ps(f);
+    const __m256  one   = _mm256_set1_ps(1.0F);
+    const __m256  mone  = _mm256_set1_ps(-1.0F);
+    const __m256i maxv  = _mm256_set1_epi32(static_cast<int>((range - 128) << shift));
+    const __m256i minv  = _mm256_set1_epi32(static_cast<int>((-range) << shift));
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    int i = 0;
+    for (; i < (len & ~7); i += 8)
+    {
+        __m256  x = _mm256_loadu_ps(in + i);
+        __m256i v = _mm256_sll_epi32(_mm256_cvtps_epi32(_mm256_mul_ps(x, scale)), count);
+        v = _mm256_blendv_epi8(v, maxv, _mm256_castps_si256(_mm256_cmp_ps(x, one,  _CMP_GE_OQ)));
+        v = _mm256_blendv_epi8(v, minv, _mm256_castps_si256(_mm256_cmp_ps(x, mone, _CMP_LE_OQ)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), v);
+    }
+    return i;
+}
+
+AVX2_TARGET static int AVX2_clipFloat(float* out, const float* in, int len)
+{
+    const __m256 one  = _mm256_set1_ps(1.0F);
+    const __m256 mone = _mm256_set1_ps(-1.0F);
+    int i = 0;
+    for (; i < (len & ~7); i += 8)
+        _mm256_storeu_ps(out + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(in + i), mone), one));
+    return i;
+}
+
+AVX2_TARGET static int AVX2_scaleFloat(float* buf, int len, float gain)
+{
+    const __m256 g = _mm256_set1_ps(gain);
+    int i = 0;
+    for (; i < (len & ~7); i += 8)
+        _mm256_storeu_ps(buf + i, _mm256_mul_ps(_mm256_loadu_ps(buf + i), g));
+    return i;
+}
+
+AVX2_TARGET static int AVX2_muteStereo16(short* buf, int ch, int frames)
+{
+    int i = 0;
+    for (; i < (frames & ~7); i += 8)
+    {
+        auto *p = reinterpret_cast<__m256i*>(buf + (i << 1));
+        __m256i v = _mm256_loadu_si256(p);
+        if (ch == 0)
+            v = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0xF5), 0xF5); // R R
+        else
+            v = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(v, 0xA0), 0xA0); // L L
+        _mm256_storeu_si256(p, v);
+    }
+    return i;
+}
+
+AVX2_TARGET static int AVX2_muteStereo32(int* buf, int ch, int frames)
+{
+    int i = 0;
+    for (; i < (frames & ~3); i += 4)
+    {
+        auto *p = reinterpret_cast<float*>(buf + (i << 1));
+        __m256 v = _mm256_loadu_ps(p);
+        _mm256_storeu_ps(p, ch == 0 ? _mm256_movehdup_ps(v) : _mm256_moveldup_ps(v));
+    }
+    return i;
+}
+
+/*
+ Outputs are accumulated in the same order as the C code, one input channel
+ at a time, so the results are identical.
+ */
+AVX2_TARGET static int AVX2_downmix(float* dst, const float* src, int frames,
+                                    int channels_in, int channels_out,
+                                    const float* matrix)
+{
+    if (channels_in > 8 || channels_out > 8)
+        return 0;
+
+    __m256 coeffs[8]; // NOLINT(modernize-avoid-c-arrays)
+    int n = 0;
+
+    if (channels_out == 2)
+    {
+        // Four frames at a time, as L0 R0 L1 R1 L2 R2 L3 R3
+        for (int j = 0; j < channels_in; j++)
+        {
+            coeffs[j] = _mm256_setr_ps(matrix[j*2], matrix[j*2+1], matrix[j*2], matrix[j*2+1],
+                                       matrix[j*2], matrix[j*2+1], matrix[j*2], matrix[j*2+1]);
+        }
+        const __m256i index = _mm256_setr_epi32(0, 0,
+                                                channels_in,     channels_in,
+                                                channels_in * 2, channels_in * 2,
+                                                channels_in * 3, channels_in * 3);
+        for (; n < (frames & ~3); n += 4)
+        {
+            const float *s = src + n * channels_in;
+            __m256 acc = _mm256_setzero_ps();
+            for (int j = 0; j < channels_in; j++)
+                acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_i32gather_ps(s + j, index, 4), coeffs[j]));
+            _mm256_storeu_ps(dst + n * 2, acc);
+        }
+        return n;
+    }
+
+    // One frame at a time. The 8 float store runs into the next frame, which
+    // is then overwritten, so stop while there is room for it.
+    for (int j = 0; j < channels_in; j++)
+    {
+        alignas(32) std::array<float,8> row {};
+        for (int i = 0; i < channels_out; i++)
+            row[i] = matrix[j * channels_out + i];
+        coeffs[j] = _mm256_load_ps(row.data());
+    }
+    for (; (n * channels_out) + 8 <= frames * channels_out; n++)
+    {
+        const float *s = src + n * channels_in;
+        __m256 acc = _mm256_setzero_ps();
+        for (int j = 0; j < channels_in; j++)
+            acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_set1_ps(s[j]), coeffs[j]));
+        _mm256_storeu_ps(dst + n * channels_out, acc);
+    }
+    return n;
+}
+#endif // AUDIO_KERNELS_AVX2
+
+#if HAVE_INTRINSICS_NEON
+static inline int32x4_t NEON_round(float32x4_t x)
+{
+#if ARCH_AARCH64
+    return vcvtnq_s32_f32(x);
+#else
+    // ARMv7 can only truncate, so round halves away from zero
+    float32x4_t half = vbslq_f32(vdupq_n_u32(0x80000000), x, vdupq_n_f32(0.5F));
+    return vcvtq_s32_f32(vaddq_f32(x, half));
+#endif
+}
+
+static int NEON_toFloat8(float* out, const uchar* in, int len)
+{
+    const float32x4_t scale = vdupq_n_f32(1.0F / ((1<<7)));
+    const int32x4_t   bias  = vdupq_n_s32(0x80);
+    int i = 0;
+    for (; i < (len & ~15); i += 16)
+    {
+        uint8x16_t bytes = vld1q_u8(in + i);
+        uint16x8_t lo    = vmovl_u8(vget_low_u8(bytes));
+        uint16x8_t hi    = vmovl_u8(vget_high_u8(bytes));
+        int32x4_t  v0 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(lo))),  bias);
+        int32x4_t  v1 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(lo))), bias);
+        int32x4_t  v2 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(hi))),  bias);
+        int32x4_t  v3 = vsubq_s32(vreinterpretq_s32_u32(vmovl_u16(vget_high_u16(hi))), bias);
+        vst1q_f32(out + i,      vmulq_f32(vcvtq_f32_s32(v0), scale));
+        vst1q_f32(out + i + 4,  vmulq_f32(vcvtq_f32_s32(v1), scale));
+        vst1q_f32(out + i + 8,  vmulq_f32(vcvtq_f32_s32(v2), scale));
+        vst1q_f32(out + i + 12, vmulq_f32(vcvtq_f32_s32(v3), scale));
+    }
+    return i;
+}
+
+static int NEON_fromFloat8(uchar* out, const float* in, int len)
+{
+    const float32x4_t scale = vdupq_n_f32(1<<7);
+    const uint8x16_t  bias  = vdupq_n_u8(0x80);
+    int i = 0;
+    for (; i < (len & ~15); i += 16)
+    {
+        int32x4_t v0 = NEON_round(vmulq_f32(vld1q_f32(in + i),      scale));
+        int32x4_t v1 = NEON_round(vmulq_f32(vld1q_f32(in + i + 4),  scale));
+        int32x4_t v2 = NEON_round(vmulq_f32(vld1q_f32(in + i + 8),  scale));
+        int32x4_t v3 = NEON_round(vmulq_f32(vld1q_f32(in + i + 12), scale));
+        int16x8_t lo = vcombine_s16(vqmovn_s32(v0), vqmovn_s32(v1));
+        int16x8_t hi = vcombine_s16(vqmovn_s32(v2), vqmovn_s32(v3));
+        int8x16_t bytes = vcombine_s8(vqmovn_s16(lo), vqmovn_s16(hi));
+        vst1q_u8(out + i, veorq_u8(vreinterpretq_u8_s8(bytes), bias));
+    }
+    return i;
+}
+
+static int NEON_toFloat16(float* out, const short* in, int len)
+{
+    const float32x4_t scale = vdupq_n_f32(1.0F / ((1<<15)));
+    int i = 0;
+    for (; i < (len & ~7); i += 8)
+    {
+        int16x8_t v = vld1q_s16(in + i);
+        vst1q_f32(out + i,     vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))),  scale));
+        vst1q_f32(out + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+    }
+    return i;
+}
+
+static int NEON_fromFloat16(short* out, const float* in, int len)
+{
+    const float32x4_t scale = vdupq_n_f32(1<<15);
+    int i = 0;
+    for (; i < (len & ~7); i += 8)
+    {
+        int32x4_t lo = NEON_round(vmulq_f32(vld1q_f32(in + i),     scale));
+        int32x4_t hi = NEON_round(vmulq_f32(vld1q_f32(in + i + 4), scale));
+        vst1q_s16(out + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+    return i;
+}
+
+static int NEON_toFloat32(float* out, const int* in, int len, float f, int shift)
+{
+    const float32x4_t scale = vdupq_n_f32(f);
+    const int32x4_t   count = vdupq_n_s32(-shift); // Negative shifts right
+    int i = 0;
+    for (; i < (len & ~3); i += 4)
+    {
+        int32x4_t v = vshlq_s32(vld1q_s32(in + i), count);
+        vst1q_f32(out + i, vmulq_f32(vcvtq_f32_s32(v), scale));
+    }
+    return i;
+}
+
+static int NEON_fromFloat32(int* out, const float* in, int len, float f, int shift)
+{
+    auto range = static_cast<uint>(f);
+    const float32x4_t scale = vdupq_n_f32(f);
+    const float32x4_t one   = vdupq_n_f32(1.0F);
+    const float32x4_t mone  = vdupq_n_f32(-1.0F);
+    const int32x4_t   maxv  = vdupq_n_s32(static_cast<int>((range - 128) << shift));
+    const int32x4_t   minv  = vdupq_n_s32(static_cast<int>((-range) << shift));
+    const int32x4_t   count = vdupq_n_s32(shift);
+    int i = 0;
+    for (; i < (len & ~3); i += 4)
+    {
+        float32x4_t x = vld1q_f32(in + i);
+        int32x4_t   v = vshlq_s32(NEON_round(vmulq_f32(x, scale)), count);
+        v = vbslq_s32(vcgeq_f32(x, one),  maxv, v);
+        v = vbslq_s32(vcleq_f32(x, mone), minv, v);
+        vst1q_s32(out + i, v);
+    }
+    return i;
+}
+
+static int NEON_clipFloat(float* out, const float* in, int len)
+{
+    const float32x4_t one  = vdupq_n_f32(1.0F);
+    const float32x4_t mone = vdupq_n_f32(-1.0F);
+    int i = 0;
+    for (; i < (len & ~3); i += 4)
+        vst1q_f32(out + i, vminq_f32(vmaxq_f32(vld1q_f32(in + i), mone), one));
+    return i;
+}
+
+static int NEON_scaleFloat(float* buf, int len, float gain)
+{
+    int i = 0;
+    for (; i < (len & ~3); i += 4)
+        vst1q_f32(buf + i, vmulq_n_f32(vld1q_f32(buf + i), gain));
+    return i;
+}
+
+static int NEON_muteStereo16(short* buf, int ch, int frames)
+{
+    int i = 0;
+    for (; i < (frames & ~3); i += 4)
+    {
+        int16x8_t   v = vld1q_s16(buf + (i << 1));
+        int16x8x2_t t = vtrnq_s16(v, v); // L L ..., R R ...
+        vst1q_s16(buf + (i << 1), ch == 0 ? t.val[1] : t.val[0]);
+    }
+    return i;
+}
+
+static int NEON_muteStereo32(int* buf, int ch, int frames)
+{
+    int i = 0;
+    for (; i < (frames & ~1); i += 2)
+    {
+        int32x4_t   v = vld1q_s32(buf + (i << 1));
+        int32x4x2_t t = vtrnq_s32(v, v); // L L ..., R R ...
+        vst1q_s32(buf + (i << 1), ch == 0 ? t.val[1] : t.val[0]);
+    }
+    return i;
+}
+
+/*
+ Outputs are accumulated in the same order as the C code, one input channel
+ at a time. vmlaq isn't used so nothing is fused.
+ */
+static int NEON_downmix(float* dst, const float* src, int frames,
+                        int channels_in, int channels_out,
+                        const float* matrix)
+{
+    if (channels_in > 8 || channels_out > 8)
+        return 0;
+
+    int n = 0;
+
+    if (channels_out == 2)
+    {
+        // Two frames at a time, as L0 R0 L1 R1
+        float32x4_t coeffs[8]; // NOLINT(modernize-avoid-c-arrays)
+        for (int j = 0; j < channels_in; j++)
+        {
+            float32x2_t c = vld1_f32(matrix + j * 2);
+            coeffs[j] = vcombine_f32(c, c);
+        }
+        for (; n < (frames & ~1); n += 2)
+        {
+            const float *s = src + n * channels_in;
+            float32x4_t acc = vdupq_n_f32(0.0F);
+            for (int j = 0; j < channels_in; j++)
+            {
+                float32x4_t v = vcombine_f32(vdup_n_f32(s[j]), vdup_n_f32(s[channels_in + j]));
+                acc = vaddq_f32(acc, vmulq_f32(v, coeffs[j]));
+            }
+            vst1q_f32(dst + n * 2, acc);
+        }
+        return n;
+    }
+
+    // One frame at a time. The 8 float store runs into the next frame, which
+    // is then overwritten, so stop while there is room for it.
+    float32x4_t lo[8]; // NOLINT(modernize-avoid-c-arrays)
+    float32x4_t hi[8]; // NOLINT(modernize-avoid-c-arrays)
+    for (int j = 0; j < channels_in; j++)
+    {
+        std::array<float,8> row {};
+        for (int i = 0; i < channels_out; i++)
+            row[i] = matrix[j * channels_out + i];
+        lo[j] = vld1q_f32(row.data());
+        hi[j] = vld1q_f32(row.data() + 4);
+    }
+    for (; (n * channels_out) + 8 <= frames * channels_out; n++)
+    {
+        const float *s = src + n * channels_in;
+        float32x4_t acc0 = vdupq_n_f32(0.0F);
+        float32x4_t acc1 = vdupq_n_f32(0.0F);
+        for (int j = 0; j < channels_in; j++)
+        {
+            float32x4_t v = vdupq_n_f32(s[j]);
+            acc0 = vaddq_f32(acc0, vmulq_f32(v, lo[j]));
+            acc1 = vaddq_f32(acc1, vmulq_f32(v, hi[j]));
+        }
+        vst1q_f32(dst + n * channels_out,     acc0);
+        vst1q_f32(dst + n * channels_out + 4, acc1);
+    }
+    return n;
+}
+#endif // HAVE_INTRINSICS_NEON
+
+static AudioKernels select_kernels(void)
+{
+    AudioKernels result;
+    int flags = av_get_cpu_flags();
+#if ARCH_X86
+    if (flags & AV_CPU_FLAG_SSE2)
+    {
+        result.m_name        = "SSE2";
+        result.m_toFloat8    = SSE2_toFloat8;
+        result.m_fromFloat8  = SSE2_fromFloat8;
+        result.m_toFloat16   = SSE2_toFloat16;
+        result.m_fromFloat16 = SSE2_fromFloat16;
+        result.m_toFloat32   = SSE2_toFloat32;
+        result.m_fromFloat32 = SSE2_fromFloat32;
+        result.m_clipFloat   = SSE2_clipFloat;
+        result.m_scaleFloat  = SSE2_scaleFloat;
+    }
+#endif
+#ifdef AUDIO_KERNELS_AVX2
+    if (flags & AV_CPU_FLAG_AVX2)
+    {
+        result.m_name         = "AVX2";
+        result.m_toFloat8     = AVX2_toFloat8;
+        result.m_fromFloat8   = AVX2_fromFloat8;
+        result.m_toFloat16    = AVX2_toFloat16;
+        result.m_fromFloat16  = AVX2_fromFloat16;
+        result.m_toFloat32    = AVX2_toFloat32;
+        result.m_fromFloat32  = AVX2_fromFloat32;
+        result.m_clipFloat    = AVX2_clipFloat;
+        result.m_scaleFloat   = AVX2_scaleFloat;
+        result.m_muteStereo16 = AVX2_muteStereo16;
+        result.m_muteStereo32 = AVX2_muteStereo32;
+        result.m_downmix      = AVX2_downmix;
+    }
+#endif
+#if HAVE_INTRINSICS_NEON
+    if (have_neon(flags))
+    {
+        result.m_name         = "NEON";
+        result.m_toFloat8     = NEON_toFloat8;
+        result.m_fromFloat8   = NEON_fromFloat8;
+        result.m_toFloat16    = NEON_toFloat16;
+        result.m_fromFloat16  = NEON_fromFloat16;
+        result.m_toFloat32    = NEON_toFloat32;
+        result.m_fromFloat32  = NEON_fromFloat32;
+        result.m_clipFloat    = NEON_clipFloat;
+        result.m_scaleFloat   = NEON_scaleFloat;
+        result.m_muteStereo16 = NEON_muteStereo16;
+        result.m_muteStereo32 = NEON_muteStereo32;
+        result.m_downmix      = NEON_downmix;
+    }
+#endif
+    (void)flags;
+    LOG(VB_AUDIO, LOG_INFO, LOC + QString("Using %1 audio kernels").arg(result.m_name));
+    return result;
+}
+
+/**
+ * Returns the kernels in use, or a set with none at all (so that only the
+ * C code runs) if optimised is false.
+ */
+const AudioKernels& AudioKernels::Get(bool optimised)
+{
+    static const AudioKernels s_scalar {};
+    static const AudioKernels s_optimised = select_kernels();
+    return optimised ? s_optimised : s_scalar;
+}
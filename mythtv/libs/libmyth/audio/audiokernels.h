@@ -0,0 +1,64 @@
+/*
+ *  Class AudioKernels
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#ifndef AUDIOKERNELS_H
+#define AUDIOKERNELS_H
+
+#include <QtGlobal>
+
+#include "mythexp.h"
+
+/**
+ * SIMD versions of the inner loops of AudioConvert, AudioOutputUtil and
+ * AudioOutputDownmix.
+ *
+ * Each kernel processes as much of the buffer as its vector width allows,
+ * and returns the number of samples (frames for the mute and downmix
+ * kernels) it has done. The caller finishes the remainder with its C code.
+ * A kernel that isn't available for the CPU is null.
+ *
+ * The set in use is chosen once, from the CPU flags reported by FFmpeg:
+ * AVX2 or SSE2 on x86, NEON on ARM.
+ */
+class MPUBLIC AudioKernels
+{
+  public:
+    static const AudioKernels& Get(bool optimised = true);
+
+    const char* m_name { "C" };
+
+    int (*m_toFloat8)     (float* out, const uchar* in, int len)               { nullptr };
+    int (*m_fromFloat8)   (uchar* out, const float* in, int len)               { nullptr };
+    int (*m_toFloat16)    (float* out, const short* in, int len)               { nullptr };
+    int (*m_fromFloat16)  (short* out, const float* in, int len)               { nullptr };
+    int (*m_toFloat32)    (float* out, const int* in, int len,
+                           float scale, int shift)                              { nullptr };
+    int (*m_fromFloat32)  (int* out, const float* in, int len,
+                           float scale, int shift)                              { nullptr };
+    int (*m_clipFloat)    (float* out, const float* in, int len)               { nullptr };
+    int (*m_scaleFloat)   (float* buf, int len, float gain)                    { nullptr };
+    // Stereo only: copy the other channel over channel ch
+    int (*m_muteStereo16) (short* buf, int ch, int frames)                     { nullptr };
+    int (*m_muteStereo32) (int* buf, int ch, int frames)                       { nullptr };
+    // matrix holds channels_in rows of channels_out coefficients
+    int (*m_downmix)      (float* dst, const float* src, int frames,
+                           int channels_in, int channels_out,
+                           const float* matrix)                                 { nullptr };
+};
+
+#endif // AUDIOKERNELS_H
@@ -300,8 +300,7 @@ void AudioOutputBase::SetStretchFactorLocked(float lstretchfactor)
             m_pSoundStretch = nullptr;
             VBGENERAL(QString("Cancelling time stretch"));
             m_bytesPerFrame = m_previousBpf;
-            m_waud = m_raud = 0;
-            m_resetActive.Ref();
+            FlushBuffer(0);
         }
         else
         {
@@ -336,8 +335,7 @@ void AudioOutputBase::SetStretchFactorLocked(float lstretchfactor)
             m_bytesPerFrame = m_sourceChannels *
                               AudioOutputSettings::SampleSize(FORMAT_FLT);
             m_audbufTimecode = m_audioTime = m_framesBuffered = 0;
-            m_waud = m_raud = 0;
-            m_resetActive.Ref();
+            FlushBuffer(0);
             m_wasPaused = m_pauseAudio;
             m_pauseAudio = true;
             m_actuallyPaused = false;
@@ -597,8 +595,9 @@ void AudioOutputBase::Reconfigure(const AudioSettings &orig_settings)
     QMutexLocker lock(&m_audioBufLock);
     QMutexLocker lockav(&m_avsyncLock);
 
+    // The output thread has gone, so no flush can be pending
     m_waud = m_raud = 0;
-    m_resetActive.Clear();
+    m_flushSeen = m_flushSeq.load();
     m_actuallyPaused = m_processing = m_forcedProcessing = false;
 
     m_channels               = settings.m_channels;
@@ -925,14 +924,13 @@ void AudioOutputBase::Reset()
     m_audbufTimecode = m_audioTime = m_framesBuffered = 0;
     if (m_encoder)
     {
-        m_waud = m_raud = 0;    // empty ring buffer
+        FlushBuffer(0);         // empty ring buffer
         memset(m_audioBuffer, 0, kAudioRingBufferSize);
     }
     else
     {
-        m_waud = m_raud;        // empty ring buffer
+        FlushBuffer(m_waud);    // empty ring buffer
     }
-    m_resetActive.Ref();
     m_currentSeconds = -1;
     m_wasPaused = !m_pauseAudio;
     m_unpauseWhenReady = false;
@@ -977,9 +975,23 @@ void AudioOutputBase::SetEffDsp(int dsprate)
  */
 inline int AudioOutputBase::audiolen() const
 {
-    if (m_waud >= m_raud)
-        return m_waud - m_raud;
-    return kAudioRingBufferSize - (m_raud - m_waud);
+    uint flushes = 0;
+    uint waud    = 0;
+    uint raud    = 0;
+
+    // Look again if the buffer was flushed while we were looking. A flush
+    // the reader hasn't applied yet has already emptied the buffer.
+    do
+    {
+        flushes = m_flushSeq;
+        waud    = m_waud;
+        raud    = (flushes == m_flushSeen) ? m_raud : m_flushRaud;
+    }
+    while ((flushes & 1) != 0 || flushes != m_flushSeq);
+
+    if (waud >= raud)
+        return waud - raud;
+    return kAudioRingBufferSize - (raud - waud);
 }
 
 /**
@@ -1007,10 +1019,73 @@ int AudioOutputBase::audioready() const
     return audiolen() * m_outputBytesPerFrame / m_bytesPerFrame;
 }
 
+/**
+ * Empty the audiobuffer, the next samples added will be written at 'waud'
+ *
+ * Only the reader moves the read position, it catches up with the flush
+ * in ApplyBufferFlush and drops anything it read from before the flush.
+ *
+ * You must hold the audio_buflock to call this safely
+ */
+void AudioOutputBase::FlushBuffer(uint waud)
+{
+    m_flushSeq++;
+    m_flushRaud = waud;
+    m_waud      = waud;
+    m_flushSeq++;
+}
+
+/**
+ * Move the read position to where the last FlushBuffer left the buffer,
+ * if that hasn't been done yet
+ *
+ * Only the thread reading the audiobuffer may call this
+ */
+void AudioOutputBase::ApplyBufferFlush(void)
+{
+    uint flushes = m_flushSeq;
+
+    if ((flushes & 1) != 0 || flushes == m_flushSeen)
+        return;
+
+    m_raud      = m_flushRaud.load();
+    m_flushSeen = flushes;
+}
+
+/**
+ * Get the read position, with any flush applied, and the flush sequence
+ * it belongs to. If m_flushSeq has moved on by the time the data is used,
+ * a flush came in meanwhile and the data must be dropped.
+ *
+ * Only the thread reading the audiobuffer may call this
+ */
+uint AudioOutputBase::ReadPosition(uint &raud)
+{
+    while (true)
+    {
+        uint flushes = m_flushSeq;
+        ApplyBufferFlush();
+        raud = m_raud;
+        // Retry if a flush was under way, or arrived after reading flushes
+        if ((flushes & 1) == 0 && flushes == m_flushSeen)
+            return flushes;
+    }
+}
+
 /**
  * Calculate the timecode of the samples that are about to become audible
  */
 int64_t AudioOutputBase::GetAudiotime(void)
+{
+    QMutexLocker lockav(&m_avsyncLock);
+
+    return GetAudiotimeLocked();
+}
+
+/**
+ * You must hold the avsync_lock to call this safely
+ */
+int64_t AudioOutputBase::GetAudiotimeLocked(void)
 {
     if (m_audbufTimecode == 0 || !m_configureSucceeded)
         return 0;
@@ -1043,9 +1118,6 @@ int64_t AudioOutputBase::GetAudiotime(void)
        'totalbuffer' is the total # of bytes in our audio buffer, and the
        sound card's buffer. */
 
-
-    QMutexLocker lockav(&m_avsyncLock);
-
     int64_t soundcard_buffer = GetBufferedOnSoundcard(); // bytes
 
     /* audioready tells us how many bytes are in audiobuffer
@@ -1071,7 +1143,8 @@ int64_t AudioOutputBase::GetAudiotime(void)
 
     VBAUDIOTS(QString("GetAudiotime audt=%1 abtc=%2 mb=%3 sb=%4 tb=%5 "
                       "sr=%6 obpf=%7 bpf=%8 esf=%9 edsp=%10 sbr=%11")
-              .arg(m_audioTime).arg(m_audbufTimecode)  // 1, 2
+              .arg(m_audioTime.load())                 // 1
+              .arg(m_audbufTimecode.load())            // 2
               .arg(main_buffer)                        // 3
               .arg(soundcard_buffer)                   // 4
               .arg(main_buffer+soundcard_buffer)       // 5
@@ -1124,7 +1197,7 @@ void AudioOutputBase::SetAudiotime(int frames, int64_t timecode)
         m_audioTime = 0;
 
     VBAUDIOTS(QString("SetAudiotime atc=%1 tc=%2 f=%3 pfu=%4 pfs=%5")
-              .arg(m_audbufTimecode)
+              .arg(m_audbufTimecode.load())
               .arg(timecode)
               .arg(frames)
               .arg(processframes_unstretched)
@@ -1597,7 +1670,15 @@ bool AudioOutputBase::AddData(void *in_buffer, int in_len,
  */
 void AudioOutputBase::Status()
 {
-    long ct = GetAudiotime();
+    // Don't wait for another thread's GetAudiotime or a reset, the last
+    // audiotime is good enough for a once a second event
+    long ct = m_audioTime;
+
+    if (m_avsyncLock.tryLock())
+    {
+        ct = GetAudiotimeLocked();
+        m_avsyncLock.unlock();
+    }
 
     if (ct < 0)
         ct = 0;
@@ -1670,6 +1751,7 @@ void AudioOutputBase::OutputAudioLoop(void)
         }
 
         /* do audio output */
+        ApplyBufferFlush();
         int ready = audioready();
 
         // wait for the buffer to fill with enough to play
@@ -1693,14 +1775,15 @@ void AudioOutputBase::OutputAudioLoop(void)
 
         // delay setting raud until after phys buffer is filled
         // so GetAudiotime will be accurate without locking
-        m_resetActive.TestAndDeref();
-        volatile uint next_raud = m_raud;
+        // and drop the fragment if the buffer was flushed meanwhile
+        uint next_raud = 0;
+        uint flushes   = ReadPosition(next_raud);
         if (GetAudioData(fragment, m_fragmentSize, true, &next_raud))
         {
-            if (!m_resetActive.TestAndDeref())
+            if (m_flushSeq == flushes)
             {
                 WriteAudio(fragment, m_fragmentSize);
-                if (!m_resetActive.TestAndDeref())
+                if (m_flushSeq == flushes)
                     m_raud = next_raud;
             }
         }
@@ -1726,19 +1809,27 @@ void AudioOutputBase::OutputAudioLoop(void)
  * available. Returns the number of bytes copied.
  */
 int AudioOutputBase::GetAudioData(uchar *buffer, int size, bool full_buffer,
-                                  volatile uint *local_raud)
+                                  uint *local_raud)
 {
 
 #define LRPOS (m_audioBuffer + *local_raud)
+    // Without a local read position, move m_raud once the data is copied
+    uint raud    = 0;
+    uint flushes = 0;
+    bool commit  = (local_raud == nullptr);
+
+    if (commit)
+    {
+        flushes    = ReadPosition(raud);
+        local_raud = &raud;
+    }
+
     // re-check audioready() in case things changed.
     // for example, ClearAfterSeek() might have run
     int avail_size   = audioready();
     int frag_size    = size;
     int written_size = size;
 
-    if (local_raud == nullptr)
-        local_raud = &m_raud;
-
     if (!full_buffer && (size > avail_size))
     {
         // when full_buffer is false, return any available data
@@ -1749,7 +1840,7 @@ int AudioOutputBase::GetAudioData(uchar *buffer, int size, bool full_buffer,
     if (!avail_size || (frag_size > avail_size))
         return 0;
 
-    int bdiff = kAudioRingBufferSize - m_raud;
+    int bdiff = kAudioRingBufferSize - *local_raud;
 
     int obytes = AudioOutputSettings::SampleSize(m_outputFormat);
 
@@ -1795,6 +1886,10 @@ int AudioOutputBase::GetAudioData(uchar *buffer, int size, bool full_buffer,
 
     *local_raud += frag_size;
 
+    // Drop what was read if the buffer was flushed meanwhile
+    if (commit && m_flushSeq == flushes)
+        m_raud = raud;
+
     // Mute individual channels through mono->stereo duplication
     MuteState mute_state = GetMuteState();
     if (!m_enc && !m_passthru &&
@@ -1821,7 +1916,7 @@ void AudioOutputBase::Drain()
         // Audio is paused and can't be drained, clear ringbuffer
         QMutexLocker lock(&m_audioBufLock);
 
-        m_waud = m_raud = 0;
+        FlushBuffer(0);
     }
 }
 
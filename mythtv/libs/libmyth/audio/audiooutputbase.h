@@ -1,6 +1,9 @@
 #ifndef AUDIOOUTPUTBASE
 #define AUDIOOUTPUTBASE
 
+// C++ headers
+#include <atomic>
+
 // POSIX headers
 #include <sys/time.h> // for struct timeval
 
@@ -31,18 +34,6 @@ class FreeSurround;
 class AudioOutputDigitalEncoder;
 struct AVCodecContext;
 
-class AsyncLooseLock
-{
-public:
-    AsyncLooseLock() = default;
-    void Clear() { m_head = m_tail = 0; }
-    void Ref() { m_head++; }
-    bool TestAndDeref() { bool r = false; if ((r=(m_head != m_tail))) m_tail++; return r; }
-private:
-    int m_head {0};
-    int m_tail {0};
-};
-
 // Forward declaration of SPDIF encoder
 class SPDIFEncoder;
 
@@ -147,7 +138,7 @@ class AudioOutputBase : public AudioOutput, public MThread
     virtual void StopOutputThread(void);
 
     int GetAudioData(uchar *buffer, int buf_size, bool full_buffer,
-                     volatile uint *local_raud = nullptr);
+                     uint *local_raud = nullptr);
 
     void OutputAudioLoop(void);
 
@@ -161,6 +152,10 @@ class AudioOutputBase : public AudioOutput, public MThread
 
     void SetStretchFactorLocked(float factor);
 
+    void FlushBuffer(uint waud);
+    void ApplyBufferFlush(void);
+    uint ReadPosition(uint &raud);
+
     // For audiooutputca
     int GetBaseAudBufTimeCode() const { return m_audbufTimecode; }
 
@@ -219,6 +214,7 @@ class AudioOutputBase : public AudioOutput, public MThread
     AudioOutputSettings* OutputSettings(bool digital = true);
     int CopyWithUpmix(char *buffer, int frames, uint &org_waud);
     void SetAudiotime(int frames, int64_t timecode);
+    int64_t GetAudiotimeLocked(void);
     AudioOutputSettings       *m_outputSettingsRaw         {nullptr};
     AudioOutputSettings       *m_outputSettings            {nullptr};
     AudioOutputSettings       *m_outputSettingsDigitalRaw  {nullptr};
@@ -252,26 +248,37 @@ class AudioOutputBase : public AudioOutput, public MThread
     QMutex            m_audioBufLock;
 
     /**
-     *  must hold avsync_lock to read or write 'audiotime' and
-     *  'audiotime_updated'
+     *  must hold avsync_lock to update 'audiotime'. The output thread only
+     *  ever tries to take it, so it is never held up by GetAudiotime()
+     *  callers or a reset
      */
     QMutex            m_avsyncLock;
 
     /**
      * timecode of audio leaving the soundcard (same units as timecodes)
      */
-    int64_t           m_audioTime                         {0};
+    std::atomic<int64_t> m_audioTime                      {0};
 
     /**
-     * Audio circular buffer
+     * Audio circular buffer, with a single writer (AddData, holding
+     * audio_buflock) and a single reader (the output thread or the
+     * device's callback). Only the writer moves m_waud and only the reader
+     * moves m_raud, each after the samples it covers have been written or
+     * read, so neither side ever waits for the other.
+     *
+     * The writer empties the buffer with FlushBuffer(), which the reader
+     * applies the next time it reads (ApplyBufferFlush). m_flushSeq is odd
+     * while a flush is in progress.
      */
-    volatile uint     m_raud                              {0}; // read position
-    volatile uint     m_waud                              {0}; // write position
+    std::atomic<uint> m_raud                              {0}; // read position
+    std::atomic<uint> m_waud                              {0}; // write position
+    std::atomic<uint> m_flushRaud                         {0}; // read position after last flush
+    std::atomic<uint> m_flushSeq                          {0}; // flushes requested * 2
+    std::atomic<uint> m_flushSeen                         {0}; // flushes applied * 2
     /**
      * timecode of audio most recently placed into buffer
      */
-    int64_t           m_audbufTimecode                    {0};
-    AsyncLooseLock    m_resetActive;
+    std::atomic<int64_t> m_audbufTimecode                 {0};
 
     QMutex            m_killAudioLock                     {QMutex::NonRecursive};
 
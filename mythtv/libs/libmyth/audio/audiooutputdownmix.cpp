@@ -18,6 +18,7 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 
 #include "audiooutputbase.h"
 #include "audiooutputdownmix.h"
+#include "audiokernels.h"
 
 #include <cstring>
 
@@ -166,18 +167,33 @@ static const std::array<six_speaker_set,3> s51_matrix
     }}
 }};
 
+// The SIMD kernels take each set as one channels_in x channels_out matrix
+static_assert(sizeof(two_speaker_set) == 8 * 2 * sizeof(float));
+static_assert(sizeof(six_speaker_set) == 8 * 6 * sizeof(float));
+
 int AudioOutputDownmix::DownmixFrames(int channels_in, int  channels_out,
-                                      float *dst, const float *src, int frames)
+                                      float *dst, const float *src, int frames,
+                                      bool optimised)
 {
     if (channels_in < channels_out)
         return -1;
 
+    const AudioKernels& kernels = AudioKernels::Get(optimised);
+    int done = 0;
+
     //VBAUDIO(LOC + QString("Downmixing %1 frames (in:%2 out:%3)")
     //    .arg(frames).arg(channels_in).arg(channels_out));
     if (channels_out == 2)
     {
         int index = channels_in - 1;
-        for (int n=0; n < frames; n++)
+        if (kernels.m_downmix)
+        {
+            done = kernels.m_downmix(dst, src, frames, channels_in, channels_out,
+                                     stereo_matrix[index][0].data());
+            dst += done * channels_out;
+            src += done * channels_in;
+        }
+        for (int n=done; n < frames; n++)
         {
             for (int i=0; i < channels_out; i++)
             {
@@ -192,7 +208,14 @@ int AudioOutputDownmix::DownmixFrames(int channels_in, int  channels_out,
     else if (channels_out == 6)
     {
         int index = channels_in - 6;
-        for (int n=0; n < frames; n++)
+        if (kernels.m_downmix)
+        {
+            done = kernels.m_downmix(dst, src, frames, channels_in, channels_out,
+                                     s51_matrix[index][0].data());
+            dst += done * channels_out;
+            src += done * channels_in;
+        }
+        for (int n=done; n < frames; n++)
         {
             for (int i=0; i < channels_out; i++)
             {
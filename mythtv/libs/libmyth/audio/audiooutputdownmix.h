@@ -1,11 +1,15 @@
 #ifndef AUDIOOUTPUTDOWNMIX
 #define AUDIOOUTPUTDOWNMIX
 
-class AudioOutputDownmix
+#include "mythexp.h"
+
+class MPUBLIC AudioOutputDownmix
 {
 public:
+    // optimised = false only runs the C code (see AudioKernels)
     static int DownmixFrames(int channels_in, int  channels_out,
-                             float *dst, const float *src, int frames);
+                             float *dst, const float *src, int frames,
+                             bool optimised = true);
 };
 
 #endif
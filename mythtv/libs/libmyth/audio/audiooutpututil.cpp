@@ -6,6 +6,7 @@
 #include "mythlogging.h"
 #include "audiooutpututil.h"
 #include "audioconvert.h"
+#include "audiokernels.h"
 #include "bswap.h"
 #include "libmythtv/mythavutil.h"
 
@@ -18,48 +19,14 @@ extern "C" {
 
 #define ISALIGN(x) (((unsigned long)(x) & 0xf) == 0)
 
-#if ARCH_X86
-static int has_sse2 = -1;
-
-// Check cpuid for SSE2 support on x86 / x86_64
-static inline bool sse_check()
-{
-    if (has_sse2 != -1)
-        return (bool)has_sse2;
-    __asm__(
-        // -fPIC - we may not clobber ebx/rbx
-#if ARCH_X86_64
-        "push       %%rbx               \n\t"
-#else
-        "push       %%ebx               \n\t"
-#endif
-        "mov        $1, %%eax           \n\t"
-        "cpuid                          \n\t"
-        "and        $0x4000000, %%edx   \n\t"
-        "shr        $26, %%edx          \n\t"
-#if ARCH_X86_64
-        "pop        %%rbx               \n\t"
-#else
-        "pop        %%ebx               \n\t"
-#endif
-        :"=d"(has_sse2)
-        ::"%eax","%ecx"
-    );
-    return (bool)has_sse2;
-}
-#endif //ARCH_x86
-
 /**
  * Returns true if platform has an FPU.
- * for the time being, this test is limited to testing if SSE2 is supported
+ * for the time being, this test is limited to testing if there are SIMD
+ * kernels (SSE2, AVX2 or NEON) for it
  */
 bool AudioOutputUtil::has_hardware_fpu()
 {
-#if ARCH_X86
-    return sse_check();
-#else
-    return false;
-#endif
+    return AudioKernels::Get().m_scaleFloat != nullptr;
 }
 
 /**
@@ -99,12 +66,11 @@ void AudioOutputUtil::MonoToStereo(void *dst, const void *src, int samples)
  * PCM from mythmusic, PCM from video and upmixed AC-3
  */
 void AudioOutputUtil::AdjustVolume(void *buf, int len, int volume,
-                                   bool music, bool upmix)
+                                   bool music, bool upmix, bool optimised)
 {
     float g     = volume / 100.0F;
     auto *fptr  = (float *)buf;
     int samples = len >> 2;
-    int i       = 0;
 
     // Should be exponential - this'll do
     g *= g;
@@ -120,37 +86,10 @@ void AudioOutputUtil::AdjustVolume(void *buf, int len, int volume,
     if (g == 1.0F)
         return;
 
-#if ARCH_X86
-    if (sse_check() && samples >= 16)
-    {
-        int loops = samples >> 4;
-        i = loops << 4;
-
-        __asm__ volatile (
-            "movss      %2, %%xmm0          \n\t"
-            "punpckldq  %%xmm0, %%xmm0      \n\t"
-            "punpckldq  %%xmm0, %%xmm0      \n\t"
-            "1:                             \n\t"
-            "movups     (%0), %%xmm1        \n\t"
-            "movups     16(%0), %%xmm2      \n\t"
-            "mulps      %%xmm0, %%xmm1      \n\t"
-            "movups     32(%0), %%xmm3      \n\t"
-            "mulps      %%xmm0, %%xmm2      \n\t"
-            "movups     48(%0), %%xmm4      \n\t"
-            "mulps      %%xmm0, %%xmm3      \n\t"
-            "movups     %%xmm1, (%0)        \n\t"
-            "mulps      %%xmm0, %%xmm4      \n\t"
-            "movups     %%xmm2, 16(%0)      \n\t"
-            "movups     %%xmm3, 32(%0)      \n\t"
-            "movups     %%xmm4, 48(%0)      \n\t"
-            "add        $64,    %0          \n\t"
-            "sub        $1, %%ecx           \n\t"
-            "jnz        1b                  \n\t"
-            :"+r"(fptr)
-            :"c"(loops),"m"(g)
-        );
-    }
-#endif //ARCH_X86
+    const AudioKernels& kernels = AudioKernels::Get(optimised);
+    int i = kernels.m_scaleFloat ? kernels.m_scaleFloat(fptr, samples, g) : 0;
+
+    fptr += i;
     for (; i < samples; i++)
         *fptr++ *= g;
 }
@@ -176,16 +115,27 @@ void tMuteChannel(AudioDataType *buffer, int channels, int ch, int frames)
  * channel over.
  */
 void AudioOutputUtil::MuteChannel(int obits, int channels, int ch,
-                                  void *buffer, int bytes)
+                                  void *buffer, int bytes, bool optimised)
 {
     int frames = bytes / ((obits >> 3) * channels);
+    int done   = 0;
+
+    const AudioKernels& kernels = AudioKernels::Get(optimised);
 
     if (obits == 8)
         tMuteChannel((uchar *)buffer, channels, ch, frames);
     else if (obits == 16)
-        tMuteChannel((short *)buffer, channels, ch, frames);
+    {
+        if (channels == 2 && kernels.m_muteStereo16)
+            done = kernels.m_muteStereo16((short *)buffer, ch, frames);
+        tMuteChannel((short *)buffer + done * channels, channels, ch, frames - done);
+    }
     else
-        tMuteChannel((int *)buffer, channels, ch, frames);
+    {
+        if (channels == 2 && kernels.m_muteStereo32)
+            done = kernels.m_muteStereo32((int *)buffer, ch, frames);
+        tMuteChannel((int *)buffer + done * channels, channels, ch, frames - done);
+    }
 }
 
 #if HAVE_BIGENDIAN
@@ -13,10 +13,11 @@ class MPUBLIC AudioOutputUtil
 {
  public:
     static bool has_hardware_fpu();
+    // optimised = false only runs the C code (see AudioKernels)
     static void AdjustVolume(void *buffer, int len, int volume,
-                             bool music, bool upmix);
+                             bool music, bool upmix, bool optimised = true);
     static void MuteChannel(int obits, int channels, int ch,
-                            void *buffer, int bytes);
+                            void *buffer, int bytes, bool optimised = true);
     static char *GeneratePinkFrames(char *frames, int channels,
                                     int channel, int count, int bits = 16);
     static int DecodeAudio(AVCodecContext *ctx,
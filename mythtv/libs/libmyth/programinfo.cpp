@@ -5797,51 +5797,11 @@ bool LoadFromOldRecorded(ProgramList &destination, const QString &sql,
     return true;
 }
 
-/** \fn ProgramInfo::LoadFromRecorded(void)
- *  \brief Load a ProgramList from the recorded table.
- *  \param destination     ProgramList to fill
- *  \param possiblyInProgressRecordingsOnly  return only in-progress
- *                                           recordings or empty list
- *  \param inUseMap        in-use programs map
- *  \param isJobRunning    job map
- *  \param recMap          recording map
- *  \param sort            sort order, negative for descending, 0 for
- *                         unsorted, positive for ascending
- *  \param sortBy          comma separated list of fields to sort by
- *  \return true if it succeeds, false if it fails.
- *  \sa QueryInUseMap(void)
- *      QueryJobsRunning(int)
- *      Scheduler::GetRecording()
- */
-bool LoadFromRecorded(
-    ProgramList &destination,
-    bool possiblyInProgressRecordingsOnly,
-    const QMap<QString,uint32_t> &inUseMap,
-    const QMap<QString,bool> &isJobRunning,
-    const QMap<QString, ProgramInfo*> &recMap,
-    int sort,
-    const QString &sortBy)
+/// Build the ORDER BY clause for a query based on kFromRecordedQuery
+static QString RecordedOrderBy(int sort, const QString &sortBy)
 {
-    destination.clear();
-
-    QString     fs_db_name = "";
-    QDateTime   rectime    = MythDate::current().addSecs(
-        -gCoreContext->GetNumSetting("RecordOverTime"));
-
-    // ----------------------------------------------------------------------
-
-    QString thequery = ProgramInfo::kFromRecordedQuery;
-    if (possiblyInProgressRecordingsOnly)
-        thequery += "WHERE r.endtime >= NOW() AND r.starttime <= NOW() ";
-
-    if (sortBy.isEmpty())
-    {
-        if (sort)
-            thequery += "ORDER BY r.starttime ";
-        if (sort < 0)
-            thequery += "DESC ";
-    }
-    else
+    QString sSortBy;
+    if (!sortBy.isEmpty())
     {
         QStringList sortByFields;
         sortByFields << "starttime" <<  "title" <<  "subtitle" << "season" << "episode" << "category"
@@ -5849,7 +5809,6 @@ bool LoadFromRecorded(
                      <<  "channum" << "callsign" << "name";
 
         // sanity check the fields are one of the above fields
-        QString sSortBy;
         QStringList fields = sortBy.split(",");
         for (int x = 0; x < fields.size(); x++)
         {
@@ -5891,17 +5850,115 @@ bool LoadFromRecorded(
                 LOG(VB_GENERAL, LOG_WARNING, QString("ProgramInfo::LoadFromRecorded() got an unknown sort field '%1' - ignoring").arg(fields.at(x)));
             }
         }
+    }
 
-        thequery += "ORDER BY " + sSortBy;
+    if (sSortBy.isEmpty())
+    {
+        if (!sort)
+            return QString();
+        sSortBy = QString("r.starttime %1").arg(sort < 0 ? "DESC" : "ASC");
     }
 
+    // recordedid makes the order total, so that pages neither overlap nor
+    // miss rows when several recordings share a sort key
+    return QString("ORDER BY %1, r.recordedid %2 ")
+        .arg(sSortBy).arg(sort < 0 ? "DESC" : "ASC");
+}
+
+/** \fn ProgramInfo::LoadFromRecorded(void)
+ *  \brief Load a ProgramList from the recorded table.
+ *  \param destination     ProgramList to fill
+ *  \param possiblyInProgressRecordingsOnly  return only in-progress
+ *                                           recordings or empty list
+ *  \param inUseMap        in-use programs map
+ *  \param isJobRunning    job map
+ *  \param recMap          recording map
+ *  \param sort            sort order, negative for descending, 0 for
+ *                         unsorted, positive for ascending
+ *  \param sortBy          comma separated list of fields to sort by
+ *  \return true if it succeeds, false if it fails.
+ *  \sa QueryInUseMap(void)
+ *      QueryJobsRunning(int)
+ *      Scheduler::GetRecording()
+ */
+bool LoadFromRecorded(
+    ProgramList &destination,
+    bool possiblyInProgressRecordingsOnly,
+    const QMap<QString,uint32_t> &inUseMap,
+    const QMap<QString,bool> &isJobRunning,
+    const QMap<QString, ProgramInfo*> &recMap,
+    int sort,
+    const QString &sortBy)
+{
+    QString where;
+    if (possiblyInProgressRecordingsOnly)
+        where = "r.endtime >= NOW() AND r.starttime <= NOW()";
+
+    return LoadFromRecorded(destination, where, MSqlBindings(), inUseMap,
+                            isJobRunning, recMap, sort, sortBy, 0, 0);
+}
+
+/** \brief Load a page of a ProgramList from the recorded table.
+ *
+ *  Filtering, sorting and paging are all done by the database, so the cost
+ *  is proportional to the size of the page rather than of the table.
+ *
+ *  \param destination     ProgramList to fill
+ *  \param where           SQL condition on the kFromRecordedQuery tables,
+ *                         without the WHERE keyword, or empty for all rows
+ *  \param bindings        bindings for the placeholders in where
+ *  \param inUseMap        in-use programs map
+ *  \param isJobRunning    job map
+ *  \param recMap          recording map
+ *  \param sort            sort order, negative for descending, 0 for
+ *                         unsorted, positive for ascending
+ *  \param sortBy          comma separated list of fields to sort by
+ *  \param start           number of matching rows to skip
+ *  \param limit           maximum number of rows to load, 0 for all
+ *  \return true if it succeeds, false if it fails.
+ */
+bool LoadFromRecorded(
+    ProgramList &destination,
+    const QString &where,
+    const MSqlBindings &bindings,
+    const QMap<QString,uint32_t> &inUseMap,
+    const QMap<QString,bool> &isJobRunning,
+    const QMap<QString, ProgramInfo*> &recMap,
+    int sort,
+    const QString &sortBy,
+    uint start,
+    uint limit)
+{
+    destination.clear();
+
+    QString     fs_db_name = "";
+    QDateTime   rectime    = MythDate::current().addSecs(
+        -gCoreContext->GetNumSetting("RecordOverTime"));
+
+    // ----------------------------------------------------------------------
+
+    QString thequery = ProgramInfo::kFromRecordedQuery;
+    if (!where.isEmpty())
+        thequery += QString("WHERE %1 ").arg(where);
+
+    thequery += RecordedOrderBy(sort, sortBy);
+
+    // MySQL only accepts an OFFSET after a LIMIT
+    if (limit > 0)
+        thequery += QString("LIMIT %1 ").arg(limit);
+    else if (start > 0)
+        thequery += "LIMIT 18446744073709551615 ";
+    if (start > 0)
+        thequery += QString("OFFSET %1 ").arg(start);
+
     MSqlQuery query(MSqlQuery::InitCon());
     query.prepare(thequery);
+    query.bindValues(bindings);
 
     if (!query.exec())
     {
         MythDB::DBError("ProgramList::FromRecorded", query);
-        return true;
+        return false;
     }
 
     while (query.next())
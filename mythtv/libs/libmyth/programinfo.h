@@ -875,6 +875,18 @@ MPUBLIC bool LoadFromRecorded(
     int                 sort = 0,
     const QString      &sortBy = "");
 
+MPUBLIC bool LoadFromRecorded(
+    ProgramList        &destination,
+    const QString      &where,
+    const MSqlBindings &bindings,
+    const QMap<QString,uint32_t> &inUseMap,
+    const QMap<QString,bool> &isJobRunning,
+    const QMap<QString, ProgramInfo*> &recMap,
+    int                 sort,
+    const QString      &sortBy,
+    uint                start,
+    uint                limit);
+
 
 template<typename TYPE>
 bool LoadFromScheduler(
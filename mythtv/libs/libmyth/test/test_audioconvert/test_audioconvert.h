@@ -18,10 +18,13 @@
  *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
  */
 
+#include <array>
+
 #include <QtTest/QtTest>
 
 #include "mythcorecontext.h"
 #include "audioconvert.h"
+#include "audiokernels.h"
 
 #define ISIZEOF(type) ((int)sizeof(type))
 
@@ -587,4 +590,106 @@ class TestAudioConvert: public QObject
         av_free(arrays2);
         av_free(arrayf1);
     }
+
+    static void SIMDvsC_data(void)
+    {
+        QTest::addColumn<int>("FORMAT");
+        QTest::newRow("U8") << (int)FORMAT_U8;
+        QTest::newRow("S16") << (int)FORMAT_S16;
+        QTest::newRow("S24") << (int)FORMAT_S24;
+        QTest::newRow("S24LSB") << (int)FORMAT_S24LSB;
+        QTest::newRow("S32") << (int)FORMAT_S32;
+        QTest::newRow("FLT") << (int)FORMAT_FLT;
+    }
+
+    // test float -> format -> float gives the same samples with the SIMD
+    // kernels as with the C code. The odd length leaves a tail for the C code
+    static void SIMDvsC(void)
+    {
+        QFETCH(int, FORMAT);
+        auto format     = (AudioFormat)FORMAT;
+        int SAMPLES     = 1003;
+        int ssize       = AudioOutputSettings::SampleSize(format);
+
+        auto *arrayf    = (float*)av_malloc(SAMPLES * ISIZEOF(float));
+        auto *arrayf1   = (float*)av_malloc(SAMPLES * ISIZEOF(float));
+        auto *arrayf2   = (float*)av_malloc(SAMPLES * ISIZEOF(float));
+        auto *arrays1   = (uint8_t*)av_malloc(SAMPLES * ssize);
+        auto *arrays2   = (uint8_t*)av_malloc(SAMPLES * ssize);
+
+        // -1.25 to 1.25 so clipping is tested too; no sample is half way
+        // between two integers in any format, so rounding is exact
+        for (int i = 0; i < SAMPLES; i++)
+        {
+            int k = ((i * 37) % 10240) - 5120;
+            arrayf[i] = (float)((4 * k) + 1) / 16384.0F;
+        }
+
+        int val1 = AudioConvert::fromFloat(format, arrays1, arrayf, SAMPLES * ISIZEOF(float), false);
+        int val2 = AudioConvert::fromFloat(format, arrays2, arrayf, SAMPLES * ISIZEOF(float), true);
+        QCOMPARE(val1, SAMPLES * ssize);
+        QCOMPARE(val2, SAMPLES * ssize);
+        QCOMPARE(memcmp(arrays1, arrays2, SAMPLES * ssize), 0);
+
+        val1 = AudioConvert::toFloat(format, arrayf1, arrays1, SAMPLES * ssize, false);
+        val2 = AudioConvert::toFloat(format, arrayf2, arrays1, SAMPLES * ssize, true);
+        QCOMPARE(val1, SAMPLES * ISIZEOF(float));
+        QCOMPARE(val2, SAMPLES * ISIZEOF(float));
+        for (int i = 0; i < SAMPLES; i++)
+        {
+            QCOMPARE(arrayf1[i], arrayf2[i]);
+            QVERIFY(arrayf1[i] >= -1.0F);
+            QVERIFY(arrayf1[i] <= 1.0F);
+        }
+
+        av_free(arrayf);
+        av_free(arrayf1);
+        av_free(arrayf2);
+        av_free(arrays1);
+        av_free(arrays2);
+    }
+
+    static void SIMDvsCSpeed_data(void)
+    {
+        QTest::addColumn<int>("FORMAT");
+        QTest::addColumn<bool>("OPTIMISED");
+
+        QString name = AudioKernels::Get().m_name;
+        const std::array<AudioFormat,5> formats
+            { FORMAT_U8, FORMAT_S16, FORMAT_S24, FORMAT_S32, FORMAT_FLT };
+        for (AudioFormat format : formats)
+        {
+            QString fmt = AudioOutputSettings::FormatToString(format);
+            QTest::newRow(qPrintable(fmt + " " + name)) << (int)format << true;
+            QTest::newRow(qPrintable(fmt + " C")) << (int)format << false;
+        }
+    }
+
+    // float -> format -> float throughput of the SIMD kernels and the C code
+    static void SIMDvsCSpeed(void)
+    {
+        QFETCH(int, FORMAT);
+        QFETCH(bool, OPTIMISED);
+        auto format     = (AudioFormat)FORMAT;
+        int SAMPLES     = 48000 * 2;
+        int ssize       = AudioOutputSettings::SampleSize(format);
+
+        auto *arrayf    = (float*)av_malloc(SAMPLES * ISIZEOF(float));
+        auto *arrays    = (uint8_t*)av_malloc(SAMPLES * ssize);
+
+        for (int i = 0; i < SAMPLES; i++)
+            arrayf[i] = (float)((i % 2001) - 1000) / 1000.0F;
+
+        QBENCHMARK
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                AudioConvert::fromFloat(format, arrays, arrayf, SAMPLES * ISIZEOF(float), OPTIMISED);
+                AudioConvert::toFloat(format, arrayf, arrays, SAMPLES * ssize, OPTIMISED);
+            }
+        }
+
+        av_free(arrayf);
+        av_free(arrays);
+    }
 };
@@ -24,6 +24,8 @@
 
 #include "mythcorecontext.h"
 #include "audiooutpututil.h"
+#include "audiooutputdownmix.h"
+#include "audiokernels.h"
 #include "pink.h"
 
 #define SSEALIGN 16     // for 16 bytes memory alignment
@@ -976,4 +978,137 @@ class TestAudioUtils: public QObject
         QCOMPARE(output[1022], expected_end[14]);
         QCOMPARE(output[1023], expected_end[15]);
     }
+
+    // test the SIMD volume kernel against the C code
+    static void AdjustVolumeCvsSIMD(void)
+    {
+        int SAMPLES   = 1003;
+
+        auto *arrayf1 = (float*)av_malloc(SAMPLES * ISIZEOF(float));
+        auto *arrayf2 = (float*)av_malloc(SAMPLES * ISIZEOF(float));
+
+        for (int i = 0; i < SAMPLES; i++)
+            arrayf1[i] = arrayf2[i] = (float)((i % 2001) - 1000) / 1000.0F;
+
+        AudioOutputUtil::AdjustVolume(arrayf1, SAMPLES * ISIZEOF(float), 73, true, true, false);
+        AudioOutputUtil::AdjustVolume(arrayf2, SAMPLES * ISIZEOF(float), 73, true, true, true);
+        for (int i = 0; i < SAMPLES; i++)
+        {
+            QCOMPARE(arrayf1[i], arrayf2[i]);
+        }
+
+        av_free(arrayf1);
+        av_free(arrayf2);
+    }
+
+    static void MuteChannelCvsSIMD_data(void)
+    {
+        QTest::addColumn<int>("BITS");
+        QTest::addColumn<int>("CHANNEL");
+        QTest::newRow("16 bits left") << 16 << 0;
+        QTest::newRow("16 bits right") << 16 << 1;
+        QTest::newRow("32 bits left") << 32 << 0;
+        QTest::newRow("32 bits right") << 32 << 1;
+    }
+
+    // test the SIMD stereo mute kernels against the C code
+    static void MuteChannelCvsSIMD(void)
+    {
+        QFETCH(int, BITS);
+        QFETCH(int, CHANNEL);
+        int FRAMES    = 1001;
+        int bytes     = FRAMES * 2 * (BITS >> 3);
+
+        auto *arrays1 = (uint8_t*)av_malloc(bytes);
+        auto *arrays2 = (uint8_t*)av_malloc(bytes);
+
+        for (int i = 0; i < bytes; i++)
+            arrays1[i] = arrays2[i] = (uint8_t)((i * 37) + (i >> 8));
+
+        AudioOutputUtil::MuteChannel(BITS, 2, CHANNEL, arrays1, bytes, false);
+        AudioOutputUtil::MuteChannel(BITS, 2, CHANNEL, arrays2, bytes, true);
+        QCOMPARE(memcmp(arrays1, arrays2, bytes), 0);
+
+        // both channels now hold the unmuted one
+        int ssize = BITS >> 3;
+        for (int i = 0; i < FRAMES; i++)
+        {
+            QCOMPARE(memcmp(arrays1 + (i * 2 * ssize), arrays1 + (((i * 2) + 1) * ssize), ssize), 0);
+        }
+
+        av_free(arrays1);
+        av_free(arrays2);
+    }
+
+    static void DownmixCvsSIMD_data(void)
+    {
+        QTest::addColumn<int>("CHANNELS_IN");
+        QTest::addColumn<int>("CHANNELS_OUT");
+        QTest::newRow("8 to 2") << 8 << 2;
+        QTest::newRow("6 to 2") << 6 << 2;
+        QTest::newRow("3 to 2") << 3 << 2;
+        QTest::newRow("8 to 6") << 8 << 6;
+        QTest::newRow("7 to 6") << 7 << 6;
+    }
+
+    // test the SIMD downmix kernels against the C code
+    static void DownmixCvsSIMD(void)
+    {
+        QFETCH(int, CHANNELS_IN);
+        QFETCH(int, CHANNELS_OUT);
+        int FRAMES    = 1001;
+
+        auto *arrayin = (float*)av_malloc(FRAMES * CHANNELS_IN * ISIZEOF(float));
+        auto *arrayf1 = (float*)av_malloc(FRAMES * CHANNELS_OUT * ISIZEOF(float));
+        auto *arrayf2 = (float*)av_malloc(FRAMES * CHANNELS_OUT * ISIZEOF(float));
+
+        for (int i = 0; i < FRAMES * CHANNELS_IN; i++)
+            arrayin[i] = (float)(((i * 37) % 2001) - 1000) / 1000.0F;
+
+        int val1 = AudioOutputDownmix::DownmixFrames(CHANNELS_IN, CHANNELS_OUT, arrayf1, arrayin, FRAMES, false);
+        int val2 = AudioOutputDownmix::DownmixFrames(CHANNELS_IN, CHANNELS_OUT, arrayf2, arrayin, FRAMES, true);
+        QCOMPARE(val1, FRAMES);
+        QCOMPARE(val2, FRAMES);
+        // the compiler may fuse the C code's multiply and add
+        for (int i = 0; i < FRAMES * CHANNELS_OUT; i++)
+        {
+            QVERIFY(qAbs(arrayf1[i] - arrayf2[i]) <= 1e-6F);
+        }
+
+        av_free(arrayin);
+        av_free(arrayf1);
+        av_free(arrayf2);
+    }
+
+    static void DownmixCvsSIMDSpeed_data(void)
+    {
+        QTest::addColumn<bool>("OPTIMISED");
+        QTest::newRow(AudioKernels::Get().m_name) << true;
+        QTest::newRow("C") << false;
+    }
+
+    // 7.1 to stereo throughput of the SIMD kernels and the C code
+    static void DownmixCvsSIMDSpeed(void)
+    {
+        QFETCH(bool, OPTIMISED);
+        int FRAMES    = 48000;
+
+        auto *arrayin = (float*)av_malloc(FRAMES * 8 * ISIZEOF(float));
+        auto *arrayf  = (float*)av_malloc(FRAMES * 2 * ISIZEOF(float));
+
+        for (int i = 0; i < FRAMES * 8; i++)
+            arrayin[i] = (float)((i % 2001) - 1000) / 1000.0F;
+
+        QBENCHMARK
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                AudioOutputDownmix::DownmixFrames(8, 2, arrayf, arrayin, FRAMES, OPTIMISED);
+                AudioOutputUtil::AdjustVolume(arrayf, FRAMES * 2 * ISIZEOF(float), 80, false, false, OPTIMISED);
+            }
+        }
+
+        av_free(arrayin);
+        av_free(arrayf);
+    }
 };
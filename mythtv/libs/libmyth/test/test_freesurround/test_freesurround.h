@@ -0,0 +1,209 @@
+/*
+ *  Class TestFreeSurround
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <QtTest/QtTest>
+
+#include "freesurround.h"
+#include "pink.h"
+
+/*
+ Upmixes a stereo WAV file (16 bit PCM or 32 bit float) named by the
+ FREESURROUND_TEST_WAV environment variable, or one minute of generated
+ pink noise and tones, and reports how many times faster than real time
+ FreeSurround is:
+
+   FREESURROUND_TEST_WAV=music.wav ./test_freesurround RealTimeFactor
+ */
+class TestFreeSurround: public QObject
+{
+    Q_OBJECT
+
+  private:
+    static inline std::vector<float> s_input;       // interleaved stereo
+    static inline int                s_rate {48000};
+
+    // Read the samples of a stereo WAV file, returns false if it can't
+    static bool LoadWav(const QString &path, std::vector<float> &samples, int &rate)
+    {
+        QFile file(path);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+        QByteArray wav = file.readAll();
+        if (wav.size() < 12 || !wav.startsWith("RIFF") || wav.mid(8, 4) != "WAVE")
+            return false;
+
+        int format = 0;
+        int channels = 0;
+        int bits = 0;
+        for (int pos = 12; pos + 8 <= wav.size(); )
+        {
+            QByteArray id = wav.mid(pos, 4);
+            int size = qFromLittleEndian<qint32>(wav.constData() + pos + 4);
+            const char *data = wav.constData() + pos + 8;
+            if (size < 0 || pos + 8 + static_cast<qint64>(size) > wav.size())
+                size = wav.size() - pos - 8;
+
+            if (id == "fmt " && size >= 16)
+            {
+                format   = qFromLittleEndian<quint16>(data);
+                channels = qFromLittleEndian<quint16>(data + 2);
+                rate     = qFromLittleEndian<qint32>(data + 4);
+                bits     = qFromLittleEndian<quint16>(data + 14);
+                // WAVE_FORMAT_EXTENSIBLE has the real format in its sub format
+                if (format == 0xFFFE && size >= 26)
+                    format = qFromLittleEndian<quint16>(data + 24);
+            }
+            else if (id == "data" && channels == 2)
+            {
+                if (format == 1 && bits == 16)
+                {
+                    for (int i = 0; i + 2 <= size; i += 2)
+                        samples.push_back(qFromLittleEndian<qint16>(data + i) / 32768.0F);
+                }
+                else if (format == 3 && bits == 32)
+                {
+                    for (int i = 0; i + 4 <= size; i += 4)
+                    {
+                        quint32 bits32 = qFromLittleEndian<quint32>(data + i);
+                        float sample = 0.0F;
+                        memcpy(&sample, &bits32, sizeof(sample));
+                        samples.push_back(sample);
+                    }
+                }
+                return !samples.empty();
+            }
+            pos += 8 + size + (size & 1);
+        }
+        return false;
+    }
+
+    // Upmix input to 5.1, returns the interleaved output
+    static std::vector<float> Upmix(const std::vector<float> &input, int rate,
+                                    FreeSurround::SurroundMode mode, bool parallel)
+    {
+        FreeSurround surround(rate, false, mode);
+        surround.SetParallel(parallel);
+
+        std::vector<float> output(input.size() * 3);
+        uint frames = input.size() / 2;
+        uint in = 0;
+        uint out = 0;
+        while (in < frames)
+        {
+            in += surround.putFrames(const_cast<float*>(&input[in * 2]), frames - in, 2);
+            out += surround.receiveFrames(&output[out * 6], frames - out);
+        }
+        output.resize(out * 6);
+        return output;
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    static void initTestCase(void)
+    {
+        s_rate = 48000;
+        QString path = QString::fromLocal8Bit(qgetenv("FREESURROUND_TEST_WAV"));
+        if (!path.isEmpty())
+        {
+            QVERIFY2(LoadWav(path, s_input, s_rate),
+                     qPrintable(path + " isn't a 16 bit or float stereo WAV file"));
+            return;
+        }
+
+        pink_noise_t pink;
+        initialize_pink_noise(&pink, 16);
+        s_input.resize(60 * s_rate * 2);
+        for (size_t i = 0; i < s_input.size(); i += 2)
+        {
+            double t    = static_cast<double>(i / 2) / s_rate;
+            float noise = generate_pink_noise_sample(&pink) * 0.25F;
+            auto  tone  = static_cast<float>(0.25 * std::sin(2 * M_PI * 440 * t));
+            auto  rear  = static_cast<float>(0.25 * std::sin(2 * M_PI * 97 * t));
+            // tone in the centre, noise panned by time, rear out of phase
+            auto  pan   = static_cast<float>(0.5 + 0.5 * std::sin(2 * M_PI * 0.1 * t));
+            s_input[i]     = tone + noise * (1 - pan) + rear;
+            s_input[i + 1] = tone + noise * pan - rear;
+        }
+    }
+
+    static void ParallelMatchesSerial_data(void)
+    {
+        QTest::addColumn<int>("MODE");
+        QTest::newRow("Simple") << (int)FreeSurround::SurroundModeActiveSimple;
+        QTest::newRow("Linear") << (int)FreeSurround::SurroundModeActiveLinear;
+    }
+
+    // running half of each block on a second thread mustn't change the output
+    static void ParallelMatchesSerial(void)
+    {
+        QFETCH(int, MODE);
+        auto mode = static_cast<FreeSurround::SurroundMode>(MODE);
+
+        // 10 seconds is plenty
+        std::vector<float> input(s_input.begin(),
+                                 s_input.begin() + std::min<size_t>(s_input.size(), 10 * s_rate * 2));
+        std::vector<float> serial   = Upmix(input, s_rate, mode, false);
+        std::vector<float> parallel = Upmix(input, s_rate, mode, true);
+
+        QCOMPARE(serial.size(), parallel.size());
+        QVERIFY(!serial.empty());
+        for (size_t i = 0; i < serial.size(); i++)
+        {
+            QVERIFY(std::isfinite(serial[i]));
+            QCOMPARE(serial[i], parallel[i]);
+        }
+    }
+
+    static void RealTimeFactor_data(void)
+    {
+        QTest::addColumn<int>("MODE");
+        QTest::addColumn<bool>("PARALLEL");
+        QTest::newRow("Simple") << (int)FreeSurround::SurroundModeActiveSimple << false;
+        QTest::newRow("Simple, 2 threads") << (int)FreeSurround::SurroundModeActiveSimple << true;
+        QTest::newRow("Linear") << (int)FreeSurround::SurroundModeActiveLinear << false;
+        QTest::newRow("Linear, 2 threads") << (int)FreeSurround::SurroundModeActiveLinear << true;
+    }
+
+    // time the upmixing of the whole input
+    static void RealTimeFactor(void)
+    {
+        QFETCH(int, MODE);
+        QFETCH(bool, PARALLEL);
+        auto mode = static_cast<FreeSurround::SurroundMode>(MODE);
+
+        QElapsedTimer timer;
+        qint64 elapsed = 0;
+        QBENCHMARK
+        {
+            timer.start();
+            Upmix(s_input, s_rate, mode, PARALLEL);
+            elapsed = timer.nsecsElapsed();
+        }
+
+        double seconds = static_cast<double>(s_input.size() / 2) / s_rate;
+        qInfo("%.1f s of audio upmixed in %.3f s, %.1fx real time", seconds,
+              elapsed / 1e9, seconds * 1e9 / std::max<qint64>(elapsed, 1));
+    }
+};
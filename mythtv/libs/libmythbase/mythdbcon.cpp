@@ -243,7 +243,8 @@ bool MSqlDatabase::KickDatabase(void)
 {
     m_lastDBKick = MythDate::current().addSecs(-60);
 
-    if (!m_db.isOpen())
+    // A reopened connection would have lost the open transaction
+    if (!m_db.isOpen() && !m_transaction)
         m_db.open();
 
     return m_db.isOpen();
@@ -521,6 +522,13 @@ MSqlQuery::MSqlQuery(const MSqlQueryInfo &qi)
 
 MSqlQuery::~MSqlQuery()
 {
+    if (m_transaction)
+    {
+        LOG(VB_GENERAL, LOG_WARNING,
+            "MSqlQuery destroyed with an open transaction, rolling back");
+        rollback();
+    }
+
     if (m_returnConnection)
     {
         MDBManager *dbmanager = GetMythDB()->GetDBManager();
@@ -678,6 +686,9 @@ bool MSqlQuery::exec()
         }
     }
 
+    if (!result && m_db->m_transaction)
+        m_db->m_transactionFailed = true;
+
     if (VERBOSE_LEVEL_CHECK(VB_DATABASE, LOG_INFO))
     {
         QString str = lastQuery();
@@ -735,6 +746,9 @@ bool MSqlQuery::exec(const QString &query)
         && Reconnect())
         result = QSqlQuery::exec(query);
 
+    if (!result && m_db->m_transaction)
+        m_db->m_transactionFailed = true;
+
     LOG(VB_DATABASE, LOG_INFO,
             QString("MSqlQuery::exec(%1) %2%3")
                     .arg(m_db->MSqlDatabase::GetConnectionName()).arg(query)
@@ -892,6 +906,13 @@ QVariant MSqlQuery::lastInsertId()
 
 bool MSqlQuery::Reconnect(void)
 {
+    if (m_db->m_transaction)
+    {
+        // The rest of the transaction would run outside it
+        LOG(VB_GENERAL, LOG_ERR, "MySQL server disconnected during a transaction");
+        m_db->m_transactionFailed = true;
+        return false;
+    }
     if (!m_db->Reconnect())
         return false;
     if (!m_lastPreparedQuery.isEmpty())
@@ -904,6 +925,69 @@ bool MSqlQuery::Reconnect(void)
     return true;
 }
 
+bool MSqlQuery::transaction(void)
+{
+    if (!m_db || m_db->m_transaction)
+        return false;
+
+    if (!m_db->isOpen() && !Reconnect())
+    {
+        LOG(VB_GENERAL, LOG_INFO, "MySQL server disconnected");
+        return false;
+    }
+
+    if (!m_db->m_db.transaction())
+    {
+        LOG(VB_GENERAL, LOG_ERR, "Failed to start a transaction: " +
+            MythDB::DBErrorMessage(m_db->m_db.lastError()));
+        return false;
+    }
+
+    m_db->m_transaction       = true;
+    m_db->m_transactionFailed = false;
+    m_transaction             = true;
+    return true;
+}
+
+bool MSqlQuery::commit(void)
+{
+    if (!m_transaction)
+        return false;
+
+    if (m_db->m_transactionFailed)
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "A query in the transaction failed, rolling it back");
+        rollback();
+        return false;
+    }
+
+    bool ok = m_db->m_db.commit();
+    if (!ok)
+    {
+        LOG(VB_GENERAL, LOG_ERR, "Failed to commit a transaction: " +
+            MythDB::DBErrorMessage(m_db->m_db.lastError()));
+        m_db->m_db.rollback();
+    }
+
+    m_db->m_transaction       = false;
+    m_db->m_transactionFailed = false;
+    m_transaction             = false;
+    return ok;
+}
+
+bool MSqlQuery::rollback(void)
+{
+    if (!m_transaction)
+        return false;
+
+    bool ok = m_db->m_db.rollback();
+    m_db->m_transaction       = false;
+    m_db->m_transactionFailed = false;
+    m_transaction             = false;
+    return ok;
+}
+
 void MSqlAddMoreBindings(MSqlBindings &output, MSqlBindings &addfrom)
 {
     MSqlBindings::Iterator it;
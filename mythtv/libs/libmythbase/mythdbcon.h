@@ -47,6 +47,8 @@ class MSqlDatabase
     QSqlDatabase m_db;
     QDateTime m_lastDBKick;
     DatabaseParams m_dbparms;
+    bool m_transaction       {false}; // don't reconnect while this is set
+    bool m_transactionFailed {false}; // a query in the transaction failed
 };
 
 /// \brief DB connection pool, used by MSqlQuery. Do not use directly.
@@ -194,6 +196,21 @@ class MBASE_PUBLIC MSqlQuery : private QSqlQuery
     /// query.
     bool Reconnect(void);
 
+    /** \brief Start a transaction on this query's connection
+     *
+     * Other queries made by this thread with InitCon() share the connection
+     * and so run inside the transaction. Until it ends, a lost connection is
+     * not reconnected and any failed query causes commit() to roll back.
+     * The transaction is rolled back if this query is destroyed first.
+     */
+    bool transaction(void);
+
+    /// \brief Commit the transaction, or roll it back if any query failed
+    bool commit(void);
+
+    /// \brief Discard everything done since transaction()
+    bool rollback(void);
+
     // Thunks that allow us to make QSqlQuery private
     QVariant value(int i) const { return QSqlQuery::value(i); }
     QString executedQuery(void) const { return QSqlQuery::executedQuery(); }
@@ -239,6 +256,7 @@ class MBASE_PUBLIC MSqlQuery : private QSqlQuery
     bool          m_isConnected      {false};
     bool          m_returnConnection {false};
     QString       m_lastPreparedQuery; // holds a copy of the last prepared query
+    bool          m_transaction      {false}; // this query started m_db's transaction
 };
 
 #endif
@@ -47,6 +47,7 @@ using namespace std;
 #include <QDataStream>
 #include <QRegularExpression>
 #include <QRegularExpressionMatchIterator>
+#include <QtEndian>
 
 // Myth headers
 #include "mythcorecontext.h"
@@ -609,21 +610,18 @@ QString FileHash(const QString& filename)
         return QString("NULL");
     }
 
-    file.seek(0);
-    QDataStream stream(&file);
-    stream.setByteOrder(QDataStream::LittleEndian);
-    for (quint64 tmp = 0, i = 0; i < 65536/sizeof(tmp); i++)
+    // Add up the first and last 64kB as little endian 64 bit words, reading
+    // each block in one go. A file of less than 64kB only has its first
+    // block, with any part word at the end left out.
+    auto sum = [&hash](const QByteArray &block)
     {
-        stream >> tmp;
-        hash += tmp;
-    }
+        for (int i = 0; i + 8 <= block.size(); i += 8)
+            hash += qFromLittleEndian<quint64>(block.constData() + i);
+    };
 
-    file.seek(initialsize - 65536);
-    for (quint64 tmp = 0, i = 0; i < 65536/sizeof(tmp); i++)
-    {
-        stream >> tmp;
-        hash += tmp;
-    }
+    sum(file.read(65536));
+    if (initialsize >= 65536 && file.seek(initialsize - 65536))
+        sum(file.read(65536));
 
     file.close();
 
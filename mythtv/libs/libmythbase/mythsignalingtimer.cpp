@@ -39,10 +39,17 @@ void MythSignalingTimer::start(int msec)
     if (msec <= 0)
         return;
 
+    bool changed = m_millisec != static_cast<uint64_t>(msec);
     m_millisec = msec;
 
     QMutexLocker locker(&m_startStopLock);
-    if (!m_running)
+    if (m_running)
+    {
+        // Restart the current wait so that a new interval applies immediately
+        if (changed)
+            m_timerWait.wakeAll();
+    }
+    else
     {
         m_dorun = true;
         MThread::start();
@@ -95,5 +95,65 @@ void TestMiscUtil::test_parse_cmdline(void)
     QCOMPARE(output, expectedOutput);
 }
 
+// The hash the video scanner stored before FileHash read whole blocks
+static QString OldFileHash(const QString& filename)
+{
+    QFile file(filename);
+    qint64 initialsize = QFileInfo(file).size();
+    if (initialsize == 0 || !file.open(QIODevice::ReadOnly))
+        return QString("NULL");
+    quint64 hash = initialsize;
+
+    QDataStream stream(&file);
+    stream.setByteOrder(QDataStream::LittleEndian);
+    for (quint64 tmp = 0, i = 0; i < 65536/sizeof(tmp); i++)
+    {
+        stream >> tmp;
+        hash += tmp;
+    }
+
+    file.seek(initialsize - 65536);
+    for (quint64 tmp = 0, i = 0; i < 65536/sizeof(tmp); i++)
+    {
+        stream >> tmp;
+        hash += tmp;
+    }
+
+    return QString("%1").arg(hash, 0, 16);
+}
+
+void TestMiscUtil::test_file_hash_data(void)
+{
+    QTest::addColumn<int>("size");
+
+    QTest::newRow("empty")       << 0;
+    QTest::newRow("part word")   << 13;
+    QTest::newRow("small")       << 1000;
+    QTest::newRow("one block")   << 65536;
+    QTest::newRow("overlapping") << 100003;
+    QTest::newRow("two blocks")  << 131072;
+    QTest::newRow("large")       << 1000005;
+}
+
+// FileHash must still match the hashes already in the database
+void TestMiscUtil::test_file_hash(void)
+{
+    QFETCH(int, size);
+
+    QByteArray data(size, 0);
+    quint32 seed = 12345;
+    for (char & byte : data)
+    {
+        seed = (seed * 1103515245) + 12345;
+        byte = static_cast<char>(seed >> 16);
+    }
+
+    QTemporaryFile file;
+    QVERIFY(file.open());
+    QCOMPARE(file.write(data), static_cast<qint64>(size));
+    file.close();
+
+    QCOMPARE(FileHash(file.fileName()), OldFileHash(file.fileName()));
+}
 
 QTEST_APPLESS_MAIN(TestMiscUtil)
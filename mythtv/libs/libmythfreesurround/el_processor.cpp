@@ -21,7 +21,15 @@ Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
 #include <complex>
 #include <cstdlib>
 #include <cstring>
+#include <functional>
 #include <vector>
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "mythconfig.h"
+#include "mthread.h"
+
 #ifdef USE_FFTW3
 #include "fftw3.h"
 #else
@@ -32,6 +40,25 @@ extern "C" {
 using FFTComplexArray = FFTSample[2];
 #endif
 
+extern "C" {
+#include "libavutil/cpu.h"
+}
+
+#if (HAVE_SSE2 && ARCH_X86_64)
+#include <emmintrin.h>
+static const bool s_haveSIMD = (av_get_cpu_flags() & AV_CPU_FLAG_SSE2) != 0;
+#elif HAVE_INTRINSICS_NEON
+#if ARCH_AARCH64
+#include "libavutil/aarch64/cpu.h"
+#elif ARCH_ARM
+#include "libavutil/arm/cpu.h"
+#endif
+#include <arm_neon.h>
+static const bool s_haveSIMD = have_neon(av_get_cpu_flags());
+#else
+static const bool s_haveSIMD = false;
+#endif
+
 
 #if defined(_WIN32) && defined(USE_FFTW3)
 #pragma comment (lib,"libfftw3f-3.lib")
@@ -43,6 +70,246 @@ static const float PI = 3.141592654;
 static const float epsilon = 0.000001;
 static const float center_level = 0.5*sqrt(0.5);
 
+/*
+ The loops over every bin (or sample) of a block are written once, as
+ templates over the vector type. They are run with 4 floats at a time where
+ the CPU has SIMD, and the remainder is done with fs_float, one float at a
+ time, using the very same arithmetic.
+ */
+
+// a single float
+struct fs_float {
+    static constexpr unsigned kWidth = 1;
+    float m_v;
+    static fs_float load(const float *p)      { return {*p}; }
+    static fs_float load_even(const float *p) { return {*p}; }   // every other float
+    static fs_float set(float x)              { return {x}; }
+    void store(float *p) const                { *p = m_v; }
+    static void store2(float *p, fs_float a, fs_float b) { p[0] = a.m_v; p[1] = b.m_v; } // interleaved
+    friend fs_float operator+(fs_float a, fs_float b) { return {a.m_v + b.m_v}; }
+    friend fs_float operator-(fs_float a, fs_float b) { return {a.m_v - b.m_v}; }
+    friend fs_float operator*(fs_float a, fs_float b) { return {a.m_v * b.m_v}; }
+    friend fs_float vmin(fs_float a, fs_float b)      { return {a.m_v < b.m_v ? a.m_v : b.m_v}; }
+    friend fs_float vmax(fs_float a, fs_float b)      { return {a.m_v > b.m_v ? a.m_v : b.m_v}; }
+    friend fs_float vabs(fs_float a)                  { return {std::fabs(a.m_v)}; }
+};
+
+#if (HAVE_SSE2 && ARCH_X86_64)
+// 4 floats in an SSE register
+struct fs_simd {
+    static constexpr unsigned kWidth = 4;
+    __m128 m_v;
+    static fs_simd load(const float *p)      { return {_mm_loadu_ps(p)}; }
+    static fs_simd load_even(const float *p) {
+        return {_mm_shuffle_ps(_mm_loadu_ps(p), _mm_loadu_ps(p+4), _MM_SHUFFLE(2,0,2,0))};
+    }
+    static fs_simd set(float x)              { return {_mm_set1_ps(x)}; }
+    void store(float *p) const               { _mm_storeu_ps(p, m_v); }
+    static void store2(float *p, fs_simd a, fs_simd b) {
+        _mm_storeu_ps(p,   _mm_unpacklo_ps(a.m_v, b.m_v));
+        _mm_storeu_ps(p+4, _mm_unpackhi_ps(a.m_v, b.m_v));
+    }
+    friend fs_simd operator+(fs_simd a, fs_simd b) { return {_mm_add_ps(a.m_v, b.m_v)}; }
+    friend fs_simd operator-(fs_simd a, fs_simd b) { return {_mm_sub_ps(a.m_v, b.m_v)}; }
+    friend fs_simd operator*(fs_simd a, fs_simd b) { return {_mm_mul_ps(a.m_v, b.m_v)}; }
+    friend fs_simd vmin(fs_simd a, fs_simd b)      { return {_mm_min_ps(a.m_v, b.m_v)}; }
+    friend fs_simd vmax(fs_simd a, fs_simd b)      { return {_mm_max_ps(a.m_v, b.m_v)}; }
+    friend fs_simd vabs(fs_simd a)                 { return {_mm_andnot_ps(_mm_set1_ps(-0.0F), a.m_v)}; }
+};
+#elif HAVE_INTRINSICS_NEON
+// 4 floats in a NEON register
+struct fs_simd {
+    static constexpr unsigned kWidth = 4;
+    float32x4_t m_v;
+    static fs_simd load(const float *p)      { return {vld1q_f32(p)}; }
+    static fs_simd load_even(const float *p) { return {vld2q_f32(p).val[0]}; }
+    static fs_simd set(float x)              { return {vdupq_n_f32(x)}; }
+    void store(float *p) const               { vst1q_f32(p, m_v); }
+    static void store2(float *p, fs_simd a, fs_simd b) {
+        float32x4x2_t v = {{a.m_v, b.m_v}};
+        vst2q_f32(p, v);
+    }
+    friend fs_simd operator+(fs_simd a, fs_simd b) { return {vaddq_f32(a.m_v, b.m_v)}; }
+    friend fs_simd operator-(fs_simd a, fs_simd b) { return {vsubq_f32(a.m_v, b.m_v)}; }
+    friend fs_simd operator*(fs_simd a, fs_simd b) { return {vmulq_f32(a.m_v, b.m_v)}; }
+    friend fs_simd vmin(fs_simd a, fs_simd b)      { return {vminq_f32(a.m_v, b.m_v)}; }
+    friend fs_simd vmax(fs_simd a, fs_simd b)      { return {vmaxq_f32(a.m_v, b.m_v)}; }
+    friend fs_simd vabs(fs_simd a)                 { return {vabsq_f32(a.m_v)}; }
+};
+#else
+using fs_simd = fs_float;
+#endif
+
+// run a vector loop over [0..n) with SIMD where the CPU has it, and finish it one float at a time
+#define FS_LOOP(func, n, ...) \
+    func<fs_float>(s_haveSIMD ? func<fs_simd>(0, (n), __VA_ARGS__) : 0, (n), __VA_ARGS__)
+
+// out = in * wnd
+template <class V>
+static unsigned fs_window(unsigned k, unsigned n, const float *in, const float *wnd, float *out)
+{
+    for (; k + V::kWidth <= n; k += V::kWidth)
+        (V::load(in+k) * V::load(wnd+k)).store(out+k);
+    return k;
+}
+
+// the parameters of the steering pass
+struct fs_steering {
+    bool  linear;                        // linear steering, rather than the simple one
+    float center_width;
+    float dimension;
+    float adaption_rate;
+    float front_separation;
+    float rear_separation;
+    float surround_level;
+    float surround_balance;
+};
+
+// move the sound field positions xfs/yfs by the dimension and separation controls,
+// and adapt the filters of the 5 main channels towards them
+template <class V>
+static unsigned fs_steer(unsigned f, unsigned n, float *xfs, float *yfs, float *const filter[5], const fs_steering &s)
+{
+    const V zero = V::set(0), one = V::set(1), mone = V::set(-1), half = V::set(0.5F);
+    const V cw = V::set(s.center_width), ncw = V::set(1-s.center_width);
+    const V dim = V::set(s.dimension);
+    const V fsep = V::set(s.front_separation), rsep = V::set(s.rear_separation);
+    const V clevel = V::set(center_level), slevel = V::set(s.surround_level);
+    const V sbal = V::set(s.surround_balance), isbal = V::set(1/s.surround_balance);
+    const V ifront = V::set(1/(1-s.surround_balance));
+    const V rate = V::set(s.adaption_rate), keep = V::set(1-s.adaption_rate);
+
+    for (; f + V::kWidth <= n; f += V::kWidth) {
+        V x = V::load(xfs+f);
+        V y = V::load(yfs+f);
+
+        if (!s.linear) {
+            // blend linearly between the surrounds and the fronts if the balance exceeds the surround encoding balance
+            // this is necessary because the sound field is trapezoidal and will be stretched behind the listener
+            V frontness = vmax(zero, (vabs(x) - sbal) * ifront);
+            y = (one-frontness) * y + frontness;
+        }
+
+        // add dimension control
+        y = vmax(mone, vmin(one, y - dim));
+
+        // add crossfeed control
+        x = vmax(mone, vmin(one, x * (fsep*(one+y)*half + rsep*(one-y)*half)));
+
+        x.store(xfs+f);
+        y.store(yfs+f);
+
+        // generate frequency filters for each output channel, according to the signal position
+        // the sum of all channel volumes must be 1.0
+        V left = (one-x)*half;
+        V right = (one+x)*half;
+        V front = (one+y)*half;
+        V back = (one-y)*half;
+        V volume[5] = {
+            front * (left * cw + vmax(zero, zero-x) * ncw),     // left
+            front * clevel*((one-vabs(x)) * ncw),               // center
+            front * (right * cw + vmax(zero, x) * ncw),         // right
+            s.linear ? back * slevel * left                     // left surround
+                     : back * slevel*vmax(zero, vmin(one, (one-x*isbal)*half)),
+            s.linear ? back * slevel * right                    // right surround
+                     : back * slevel*vmax(zero, vmin(one, (one+x*isbal)*half))
+        };
+
+        // adapt the prior filter
+        for (unsigned c=0;c<5;c++)
+            (keep*V::load(filter[c]+f) + rate*volume[c]).store(filter[c]+f);
+    }
+    return f;
+}
+
+// dst = (a + b) * rot * flt, as interleaved complex; a and b are split into real and imaginary parts, b is optional
+template <class V>
+static unsigned fs_filter(unsigned f, unsigned n, const float *const a[2], const float *const b[2], cfloat rot, const float *flt, float *dst)
+{
+    const V rc = V::set(rot.real()), rs = V::set(rot.imag());
+    for (; f + V::kWidth <= n; f += V::kWidth) {
+        V re = V::load(a[0]+f);
+        V im = V::load(a[1]+f);
+        if (b) {
+            re = re + V::load(b[0]+f);
+            im = im + V::load(b[1]+f);
+        }
+        V gain = V::load(flt+f);
+        V::store2(dst+2*f, (re*rc - im*rs) * gain, (re*rs + im*rc) * gain);
+    }
+    return f;
+}
+
+// add the windowed 1st half of the block src to t1, and set t2 to the windowed 2nd half
+//  src is read with a stride of 1 or 2 floats (i.e. the real parts of complex data)
+template <class V>
+static unsigned fs_overlap(unsigned k, unsigned n, const float *src, unsigned stride, const float *wnd, float *t1, float *t2)
+{
+    const float *src2 = src + n*stride;
+    for (; k + V::kWidth <= n; k += V::kWidth) {
+        V s1 = stride == 1 ? V::load(src+k)  : V::load_even(src+2*k);
+        V s2 = stride == 1 ? V::load(src2+k) : V::load_even(src2+2*k);
+        // 1st part is overlap add
+        (V::load(t1+k) + V::load(wnd+k) * s1).store(t1+k);
+        // 2nd part is set as has no history
+        (V::load(wnd+n+k) * s2).store(t2+k);
+    }
+    return k;
+}
+
+// a second thread for the halves of a block that are independent of each other
+class decoder_thread : public MThread {
+public:
+    decoder_thread() : MThread("FreeSurround") { start(); }
+
+    ~decoder_thread() override {
+        m_lock.lock();
+        m_quit = true;
+        m_wake.wakeAll();
+        m_lock.unlock();
+        wait();
+    }
+
+    // start running job, which has to stay valid until finish() returns
+    void begin(const std::function<void()> *job) {
+        QMutexLocker locker(&m_lock);
+        m_job = job;
+        m_wake.wakeAll();
+    }
+
+    // wait for the job to be done
+    void finish() {
+        QMutexLocker locker(&m_lock);
+        while (m_job)
+            m_wake.wait(&m_lock);
+    }
+
+protected:
+    void run() override {
+        RunProlog();
+        m_lock.lock();
+        while (!m_quit) {
+            if (!m_job) {
+                m_wake.wait(&m_lock);
+                continue;
+            }
+            m_lock.unlock();
+            (*m_job)();
+            m_lock.lock();
+            m_job = nullptr;
+            m_wake.wakeAll();
+        }
+        m_lock.unlock();
+        RunEpilog();
+    }
+
+private:
+    QMutex         m_lock;
+    QWaitCondition m_wake;
+    const std::function<void()> *m_job {nullptr};
+    bool           m_quit {false};
+};
+
 // private implementation of the surround decoder
 class decoder_impl {
 public:
@@ -53,34 +320,39 @@ public:
         // create FFTW buffers
         m_lt = (float*)fftwf_malloc(sizeof(float)*m_n);
         m_rt = (float*)fftwf_malloc(sizeof(float)*m_n);
-        m_dst = (float*)fftwf_malloc(sizeof(float)*m_n);
         m_dftL = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*m_n);
         m_dftR = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*m_n);
-        m_src = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*m_n);
+        for (unsigned s=0;s<2;s++) {
+            m_dst[s] = (float*)fftwf_malloc(sizeof(float)*m_n);
+            m_src[s] = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*m_n);
+        }
         m_loadL = fftwf_plan_dft_r2c_1d(m_n, m_lt, m_dftL,FFTW_MEASURE);
         m_loadR = fftwf_plan_dft_r2c_1d(m_n, m_rt, m_dftR,FFTW_MEASURE);
-        m_store = fftwf_plan_dft_c2r_1d(m_n, m_src, m_dst,FFTW_MEASURE);
+        m_store = fftwf_plan_dft_c2r_1d(m_n, m_src[0], m_dst[0],FFTW_MEASURE);
 #else
         // create lavc fft buffers
         m_lt = (float*)av_malloc(sizeof(FFTSample)*m_n);
         m_rt = (float*)av_malloc(sizeof(FFTSample)*m_n);
         m_dftL = (FFTComplexArray*)av_malloc(sizeof(FFTComplex)*m_n*2);
         m_dftR = (FFTComplexArray*)av_malloc(sizeof(FFTComplex)*m_n*2);
-        m_src = (FFTComplexArray*)av_malloc(sizeof(FFTComplex)*m_n*2);
-        m_fftContextForward = (FFTContext*)av_malloc(sizeof(FFTContext));
-        memset(m_fftContextForward, 0, sizeof(FFTContext));
-        m_fftContextReverse = (FFTContext*)av_malloc(sizeof(FFTContext));
-        memset(m_fftContextReverse, 0, sizeof(FFTContext));
-        ff_fft_init(m_fftContextForward, 13, 0);
-        ff_fft_init(m_fftContextReverse, 13, 1);
+        // a context for each thread, as av_fft_permute uses a scratch buffer in the context
+        for (unsigned s=0;s<2;s++) {
+            m_src[s] = (FFTComplexArray*)av_malloc(sizeof(FFTComplex)*m_n*2);
+            m_fftContextForward[s] = (FFTContext*)av_malloc(sizeof(FFTContext));
+            memset(m_fftContextForward[s], 0, sizeof(FFTContext));
+            m_fftContextReverse[s] = (FFTContext*)av_malloc(sizeof(FFTContext));
+            memset(m_fftContextReverse[s], 0, sizeof(FFTContext));
+            ff_fft_init(m_fftContextForward[s], 13, 0);
+            ff_fft_init(m_fftContextReverse[s], 13, 1);
+        }
 #endif
         // resize our own buffers
-        m_frontR.resize(m_n);
-        m_frontL.resize(m_n);
-        m_avg.resize(m_n);
-        m_surR.resize(m_n);
-        m_surL.resize(m_n);
-        m_trueavg.resize(m_n);
+        for (unsigned s=0;s<2;s++) {
+            m_inRe[s].resize(m_halfN+1);
+            m_inIm[s].resize(m_halfN+1);
+            m_frontRe[s].resize(m_halfN+1);
+            m_frontIm[s].resize(m_halfN+1);
+        }
         m_xFs.resize(m_n);
         m_yFs.resize(m_n);
         m_inbuf[0].resize(m_n);
@@ -106,27 +378,32 @@ public:
 
     // destructor
     ~decoder_impl() {
+        delete m_thread;
 #ifdef USE_FFTW3
         // clean up the FFTW stuff
         fftwf_destroy_plan(m_store);
         fftwf_destroy_plan(m_loadR);
         fftwf_destroy_plan(m_loadL);
-        fftwf_free(m_src);
+        for (unsigned s=0;s<2;s++) {
+            fftwf_free(m_src[s]);
+            fftwf_free(m_dst[s]);
+        }
         fftwf_free(m_dftR);
         fftwf_free(m_dftL);
-        fftwf_free(m_dst);
         fftwf_free(m_rt);
         fftwf_free(m_lt);
 #else
-        ff_fft_end(m_fftContextForward);
-        ff_fft_end(m_fftContextReverse);
-        av_free(m_src);
+        for (unsigned s=0;s<2;s++) {
+            ff_fft_end(m_fftContextForward[s]);
+            ff_fft_end(m_fftContextReverse[s]);
+            av_free(m_fftContextForward[s]);
+            av_free(m_fftContextReverse[s]);
+            av_free(m_src[s]);
+        }
         av_free(m_dftR);
         av_free(m_dftL);
         av_free(m_rt);
         av_free(m_lt);
-        av_free(m_fftContextForward);
-        av_free(m_fftContextReverse);
 #endif
     }
 
@@ -162,7 +439,7 @@ public:
         add_output(in_first,in_second,center_width,dimension,adaption_rate,true);
         // shift last half of input buffer to the beginning
     }
-    
+
     // flush the internal buffers
     void flush() {
         for (unsigned k=0;k<m_n;k++) {
@@ -205,8 +482,8 @@ public:
     // set the phase shifting mode
     void phase_mode(unsigned mode) {
         const float modes[4][2] = {{0,0},{0,PI},{PI,0},{-PI/2,PI/2}};
-        m_phaseOffsetL = modes[mode][0];
-        m_phaseOffsetR = modes[mode][1];
+        m_phaseShiftL = std::polar(1.0F, modes[mode][0]);
+        m_phaseShiftR = std::polar(1.0F, modes[mode][1]);
     }
 
     // what steering mode should be chosen
@@ -218,11 +495,17 @@ public:
         m_rearSeparation = rear;
     }
 
+    // decode the halves of each block that are independent on a second thread
+    void parallel_mode(bool mode) {
+        if (mode && !m_thread)
+            m_thread = new decoder_thread();
+        else if (!mode) {
+            delete m_thread;
+            m_thread = nullptr;
+        }
+    }
+
 private:
-    // polar <-> cartesian coodinates conversion
-    static inline float amplitude(const float cf[2]) { return std::sqrt(cf[0]*cf[0] + cf[1]*cf[1]); }
-    static inline float phase(const float cf[2]) { return std::atan2(cf[1],cf[0]); }
-    static inline cfloat polar(float a, float p) { return {static_cast<float>(a*std::cos(p)),static_cast<float>(a*std::sin(p))}; }
     static inline float sqr(float x) { return x*x; }
     // the dreaded min/max
     static inline float min(float a, float b) { return a<b?a:b; }
@@ -236,58 +519,70 @@ private:
         block_decode(input1,input2,out,center_width,dimension,adaption_rate);
     }
 
+    // run job1 on the second thread (if there is one) while job2 runs on this one
+    void run_parallel(const std::function<void()> &job1, const std::function<void()> &job2) {
+        if (m_thread) {
+            m_thread->begin(&job1);
+            job2();
+            m_thread->finish();
+        } else {
+            job1();
+            job2();
+        }
+    }
+
     // CORE FUNCTION: decode a block of data
     void block_decode(float *input1[2], float *input2[2], float *output[6], float center_width, float dimension, float adaption_rate) {
-        // 1. scale the input by the window function; this serves a dual purpose:
-        // - first it improves the FFT resolution b/c boundary discontinuities (and their frequencies) get removed
-        // - second it allows for smooth blending of varying filters between the blocks
-        {
-            float* pWnd = &m_wnd[0];
-            float* pLt =  &m_lt[0];
-            float* pRt =  &m_rt[0];
-            float* pIn0 = input1[0];
-            float* pIn1 = input1[1];
-            for (unsigned k=0;k<m_halfN;k++) {
-                *pLt++ = *pIn0++ * *pWnd;
-                *pRt++ = *pIn1++ * *pWnd++;
-            }
-            pIn0 = input2[0];
-            pIn1 = input2[1];
-            for (unsigned k=0;k<m_halfN;k++) {
-                *pLt++ = *pIn0++ * *pWnd;
-                *pRt++ = *pIn1++ * *pWnd++;
-            }
-        }
+        // 1. scale the input by the window function and transform it into the frequency domain,
+        //    left and right at the same time
+        run_parallel([&]{ load(0,input1,input2); }, [&]{ load(1,input1,input2); });
 
+        // 2. compare amplitude and phase of each DFT bin and produce the X/Y coordinates in the sound field
+        analyse();
+
+        // 3. generate frequency filters for each output channel
+        fs_steering steering {
+            m_linearSteering, center_width, dimension, adaption_rate,
+            m_frontSeparation, m_rearSeparation, m_surroundLevel, m_surroundBalance
+        };
+        float *filter[5] = {&m_filter[0][0],&m_filter[1][0],&m_filter[2][0],&m_filter[3][0],&m_filter[4][0]};
+        FS_LOOP(fs_steer, m_halfN, &m_xFs[0], &m_yFs[0], filter, steering);
+
+        // 4. distribute the unfiltered reference signals over the channels,
+        //    the surrounds and lfe on the second thread
+        run_parallel([&]{ synthesize_rear(output); }, [&]{ synthesize_front(output); });
+    }
+
+    // scale one channel of the input by the window function; this serves a dual purpose:
+    // - first it improves the FFT resolution b/c boundary discontinuities (and their frequencies) get removed
+    // - second it allows for smooth blending of varying filters between the blocks
+    // ... and tranform it into the frequency domain
+    void load(unsigned ch, float *input1[2], float *input2[2]) {
+        float *in = ch ? m_rt : m_lt;
+        FS_LOOP(fs_window, m_halfN, input1[ch], &m_wnd[0], in);
+        FS_LOOP(fs_window, m_halfN, input2[ch], &m_wnd[m_halfN], in + m_halfN);
 #ifdef USE_FFTW3
-        // ... and tranform it into the frequency domain
-        fftwf_execute(m_loadL);
-        fftwf_execute(m_loadR);
+        fftwf_execute(ch ? m_loadR : m_loadL);
 #else
-        ff_fft_permuteRC(m_fftContextForward, m_lt, (FFTComplex*)&m_dftL[0]);
-        av_fft_calc(m_fftContextForward, (FFTComplex*)&m_dftL[0]);
-
-        ff_fft_permuteRC(m_fftContextForward, m_rt, (FFTComplex*)&m_dftR[0]);
-        av_fft_calc(m_fftContextForward, (FFTComplex*)&m_dftR[0]);
+        auto *dft = (FFTComplex*)&(ch ? m_dftR : m_dftL)[0];
+        ff_fft_permuteRC(m_fftContextForward[ch], in, dft);
+        av_fft_calc(m_fftContextForward[ch], dft);
 #endif
+    }
 
-        // 2. compare amplitude and phase of each DFT bin and produce the X/Y coordinates in the sound field
-        //    but dont do DC or N/2 component
+    // get the sound field position of each bin (but dont do DC or N/2 component), and the signals to be positioned
+    void analyse() {
         for (unsigned f=0;f<m_halfN;f++) {
-            // get left/right amplitudes/phases
-            float ampL = amplitude(m_dftL[f]);
-            float ampR = amplitude(m_dftR[f]);
-            float phaseL = phase(m_dftL[f]);
-            float phaseR = phase(m_dftR[f]);
-//          if (ampL+ampR < epsilon)
-//              continue;       
-
-            // calculate the amplitude/phase difference
+            float reL = m_dftL[f][0], imL = m_dftL[f][1];
+            float reR = m_dftR[f][0], imR = m_dftR[f][1];
+
+            // get left/right amplitudes, and the phase difference [0..pi] as the angle of L * conj(R)
+            float ampL = std::sqrt(reL*reL + imL*imL);
+            float ampR = std::sqrt(reR*reR + imR*imR);
+            float phaseDiff = std::fabs(std::atan2(imL*reR - reL*imR, reL*reR + imL*imR));
+
+            // calculate the amplitude difference
             float ampDiff = clamp((ampL+ampR < epsilon) ? 0 : (ampR-ampL) / (ampR+ampL));
-            float phaseDiff = phaseL - phaseR;
-            if (phaseDiff < -PI) phaseDiff += 2*PI;
-            if (phaseDiff > PI) phaseDiff -= 2*PI;
-            phaseDiff = abs(phaseDiff);
 
             if (m_linearSteering) {
                 // --- this is the fancy new linear mode ---
@@ -295,94 +590,50 @@ private:
                 // get sound field x/y position
                 m_yFs[f] = get_yfs(ampDiff,phaseDiff);
                 m_xFs[f] = get_xfs(ampDiff,m_yFs[f]);
-
-                // add dimension control
-                m_yFs[f] = clamp(m_yFs[f] - dimension);
-
-                // add crossfeed control
-                m_xFs[f] = clamp(m_xFs[f] * (m_frontSeparation*(1+m_yFs[f])/2 + m_rearSeparation*(1-m_yFs[f])/2));
-
-                // 3. generate frequency filters for each output channel
-                float left = (1-m_xFs[f])/2;
-                float right = (1+m_xFs[f])/2;
-                float front = (1+m_yFs[f])/2;
-                float back = (1-m_yFs[f])/2;
-                float volume[5] = {
-                    front * (left * center_width + max(0,-m_xFs[f]) * (1-center_width)),  // left
-                    front * center_level*((1-abs(m_xFs[f])) * (1-center_width)),          // center
-                    front * (right * center_width + max(0, m_xFs[f]) * (1-center_width)), // right
-                    back * m_surroundLevel * left,                                        // left surround
-                    back * m_surroundLevel * right                                        // right surround
-                };
-
-                // adapt the prior filter
-                for (unsigned c=0;c<5;c++)
-                    m_filter[c][f] = (1-adaption_rate)*m_filter[c][f] + adaption_rate*volume[c];
-
             } else {
                 // --- this is the old & simple steering mode ---
 
-                // calculate the amplitude/phase difference
-                float ampDiff = clamp((ampL+ampR < epsilon) ? 0 : (ampR-ampL) / (ampR+ampL));
-                float phaseDiff = phaseL - phaseR;
-                if (phaseDiff < -PI) phaseDiff += 2*PI;
-                if (phaseDiff > PI) phaseDiff -= 2*PI;
-                phaseDiff = abs(phaseDiff);
-
                 // determine sound field x-position
                 m_xFs[f] = ampDiff;
 
                 // determine preliminary sound field y-position from phase difference
                 m_yFs[f] = 1 - (phaseDiff/PI)*2;
-
-                if (abs(m_xFs[f]) > m_surroundBalance) {
-                    // blend linearly between the surrounds and the fronts if the balance exceeds the surround encoding balance
-                    // this is necessary because the sound field is trapezoidal and will be stretched behind the listener
-                    float frontness = (abs(m_xFs[f]) - m_surroundBalance)/(1-m_surroundBalance);
-                    m_yFs[f]  = (1-frontness) * m_yFs[f] + frontness * 1;
-                }
-
-                // add dimension control
-                m_yFs[f] = clamp(m_yFs[f] - dimension);
-
-                // add crossfeed control
-                m_xFs[f] = clamp(m_xFs[f] * (m_frontSeparation*(1+m_yFs[f])/2 + m_rearSeparation*(1-m_yFs[f])/2));
-
-                // 3. generate frequency filters for each output channel, according to the signal position
-                // the sum of all channel volumes must be 1.0
-                float left = (1-m_xFs[f])/2;
-                float right = (1+m_xFs[f])/2;
-                float front = (1+m_yFs[f])/2;
-                float back = (1-m_yFs[f])/2;
-                float volume[5] = {
-                    front * (left * center_width + max(0,-m_xFs[f]) * (1-center_width)),      // left
-                    front * center_level*((1-abs(m_xFs[f])) * (1-center_width)),              // center
-                    front * (right * center_width + max(0, m_xFs[f]) * (1-center_width)),     // right
-                    back * m_surroundLevel*max(0,min(1,((1-(m_xFs[f]/m_surroundBalance))/2))),// left surround
-                    back * m_surroundLevel*max(0,min(1,((1+(m_xFs[f]/m_surroundBalance))/2))) // right surround
-                };
-
-                // adapt the prior filter
-                for (unsigned c=0;c<5;c++)
-                    m_filter[c][f] = (1-adaption_rate)*m_filter[c][f] + adaption_rate*volume[c];
             }
 
-            // ... and build the signal which we want to position
-            m_frontL[f] = polar(ampL+ampR,phaseL);
-            m_frontR[f] = polar(ampL+ampR,phaseR);
-            m_avg[f] = m_frontL[f] + m_frontR[f];
-            m_surL[f] = polar(ampL+ampR,phaseL+m_phaseOffsetL);
-            m_surR[f] = polar(ampL+ampR,phaseR+m_phaseOffsetR);
-            m_trueavg[f] = cfloat(m_dftL[f][0] + m_dftR[f][0], m_dftL[f][1] + m_dftR[f][1]);
+            // ... and build the signal which we want to position: each side with its own phase,
+            // and the amplitude of both (i.e. polar(ampL+ampR,phase), without the trigonometry)
+            float amp = ampL + ampR;
+            m_inRe[0][f] = reL; m_inIm[0][f] = imL;
+            m_inRe[1][f] = reR; m_inIm[1][f] = imR;
+            if (ampL > 0) {
+                m_frontRe[0][f] = reL * (amp/ampL); m_frontIm[0][f] = imL * (amp/ampL);
+            } else {
+                m_frontRe[0][f] = amp;              m_frontIm[0][f] = 0;
+            }
+            if (ampR > 0) {
+                m_frontRe[1][f] = reR * (amp/ampR); m_frontIm[1][f] = imR * (amp/ampR);
+            } else {
+                m_frontRe[1][f] = amp;              m_frontIm[1][f] = 0;
+            }
         }
+    }
 
-        // 4. distribute the unfiltered reference signals over the channels
-        apply_filter(&m_frontL[0], &m_filter[0][0],&output[0][0]);  // front left
-        apply_filter(&m_avg[0],    &m_filter[1][0],&output[1][0]);  // front center
-        apply_filter(&m_frontR[0], &m_filter[2][0],&output[2][0]);  // front right
-        apply_filter(&m_surL[0],   &m_filter[3][0],&output[3][0]);  // surround left
-        apply_filter(&m_surR[0],   &m_filter[4][0],&output[4][0]);  // surround right
-        apply_filter(&m_trueavg[0],&m_filter[5][0],&output[5][0]);  // lfe
+    void synthesize_front(float *output[6]) {
+        const float *frontL[2] = {&m_frontRe[0][0],&m_frontIm[0][0]};
+        const float *frontR[2] = {&m_frontRe[1][0],&m_frontIm[1][0]};
+        apply_filter(frontL, nullptr, 1, &m_filter[0][0], output[0], 0);   // front left
+        apply_filter(frontL, frontR,  1, &m_filter[1][0], output[1], 0);   // front center
+        apply_filter(frontR, nullptr, 1, &m_filter[2][0], output[2], 0);   // front right
+    }
+
+    void synthesize_rear(float *output[6]) {
+        const float *frontL[2] = {&m_frontRe[0][0],&m_frontIm[0][0]};
+        const float *frontR[2] = {&m_frontRe[1][0],&m_frontIm[1][0]};
+        const float *inL[2] = {&m_inRe[0][0],&m_inIm[0][0]};
+        const float *inR[2] = {&m_inRe[1][0],&m_inIm[1][0]};
+        apply_filter(frontL, nullptr, m_phaseShiftL, &m_filter[3][0], output[3], 1);   // surround left
+        apply_filter(frontR, nullptr, m_phaseShiftR, &m_filter[4][0], output[4], 1);   // surround right
+        apply_filter(inL,    inR,     1,             &m_filter[5][0], output[5], 1);   // lfe
     }
 
 #define FASTER_CALC
@@ -434,54 +685,36 @@ private:
 #endif
     }
 
-    // filter the complex source signal and add it to target
-    void apply_filter(cfloat *signal, const float *flt, float *target) {
-        // filter the signal
-        for (unsigned f=0;f<=m_halfN;f++) {
-            m_src[f][0] = signal[f].real() * flt[f];
-            m_src[f][1] = signal[f].imag() * flt[f];
-        }
+    // filter the complex source signal a (+ b), phase shifted by rot, and add it to target
+    //  slot selects the scratch buffers, one for each thread
+    void apply_filter(const float *a[2], const float *b[2], cfloat rot, const float *flt, float *target, unsigned slot) {
+        float* pT1   = &target[m_currentBuf*m_halfN];
+        float* pT2   = &target[(m_currentBuf^1)*m_halfN];
+#ifdef USE_FFTW3
+        auto *src = (float*)m_src[slot];
+#else
+        float *src = &m_src[slot][0][0];
+#endif
+        // filter the signal, the N/2 component is never decoded
+        FS_LOOP(fs_filter, m_halfN, a, b, rot, flt, src);
+        src[2*m_halfN] = src[2*m_halfN+1] = 0;
 #ifdef USE_FFTW3
         // transform into time domain
-        fftwf_execute(m_store);
+        fftwf_execute_dft_c2r(m_store, m_src[slot], m_dst[slot]);
 
-        float* pT1   = &target[m_currentBuf*m_halfN];
-        float* pWnd1 = &m_wnd[0];
-        float* pDst1 = &m_dst[0];
-        float* pT2   = &target[(m_currentBuf^1)*m_halfN];
-        float* pWnd2 = &m_wnd[m_halfN];
-        float* pDst2 = &m_dst[m_halfN];
         // add the result to target, windowed
-        for (unsigned int k=0;k<m_halfN;k++)
-        {
-            // 1st part is overlap add
-            *pT1++ += *pWnd1++ * *pDst1++;
-            // 2nd part is set as has no history
-            *pT2++  = *pWnd2++ * *pDst2++;
-        }
+        FS_LOOP(fs_overlap, m_halfN, m_dst[slot], 1, &m_wnd[0], pT1, pT2);
 #else
         // enforce odd symmetry
         for (unsigned f=1;f<m_halfN;f++) {
-            m_src[m_n-f][0] = m_src[f][0];
-            m_src[m_n-f][1] = -m_src[f][1];   // complex conjugate
+            m_src[slot][m_n-f][0] = m_src[slot][f][0];
+            m_src[slot][m_n-f][1] = -m_src[slot][f][1];   // complex conjugate
         }
-        av_fft_permute(m_fftContextReverse, (FFTComplex*)&m_src[0]);
-        av_fft_calc(m_fftContextReverse, (FFTComplex*)&m_src[0]);
+        av_fft_permute(m_fftContextReverse[slot], (FFTComplex*)&m_src[slot][0]);
+        av_fft_calc(m_fftContextReverse[slot], (FFTComplex*)&m_src[slot][0]);
 
-        float* pT1   = &target[m_currentBuf*m_halfN];
-        float* pWnd1 = &m_wnd[0];
-        float* pDst1 = &m_src[0][0];
-        float* pT2   = &target[(m_currentBuf^1)*m_halfN];
-        float* pWnd2 = &m_wnd[m_halfN];
-        float* pDst2 = &m_src[m_halfN][0];
         // add the result to target, windowed
-        for (unsigned int k=0;k<m_halfN;k++)
-        {
-            // 1st part is overlap add
-            *pT1++ += *pWnd1++ * *pDst1; pDst1 += 2;
-            // 2nd part is set as has no history
-            *pT2++  = *pWnd2++ * *pDst2; pDst2 += 2;
-        }
+        FS_LOOP(fs_overlap, m_halfN, src, 2, &m_wnd[0], pT1, pT2);
 #endif
     }
 
@@ -490,7 +723,7 @@ private:
      *  * Do the permutation needed BEFORE calling ff_fft_calc()
      *  special for freesurround that also copies
      *   */
-    void ff_fft_permuteRC(FFTContext *s, FFTSample *r, FFTComplex *z)
+    static void ff_fft_permuteRC(FFTContext *s, FFTSample *r, FFTComplex *z)
     {
         int j, k, np;
         const uint16_t *revtab = s->revtab;
@@ -509,7 +742,7 @@ private:
      *  special for freesurround that also copies and 
      *  discards im component as it should be 0
      *   */
-    void ff_fft_permuteCR(FFTContext *s, FFTComplex *z, FFTSample *r)
+    static void ff_fft_permuteCR(FFTContext *s, FFTComplex *z, FFTSample *r)
     {
         int j, k, np;
         const uint16_t *revtab = s->revtab;
@@ -530,17 +763,17 @@ private:
     unsigned int m_halfN;                // half block size precalculated
 #ifdef USE_FFTW3
     // FFTW data structures
-    float *m_lt,*m_rt,*m_dst;              // left total, right total (source arrays), destination array
-    fftwf_complex *m_dftL,*m_dftR,*m_src;  // intermediate arrays (FFTs of lt & rt, processing source)
+    float *m_lt,*m_rt,*m_dst[2];           // left total, right total (source arrays), destination arrays
+    fftwf_complex *m_dftL,*m_dftR,*m_src[2];// intermediate arrays (FFTs of lt & rt, processing sources)
     fftwf_plan m_loadL,m_loadR,m_store;    // plans for loading the data into the intermediate format and back
 #else
-    FFTContext *m_fftContextForward, *m_fftContextReverse;
+    FFTContext *m_fftContextForward[2], *m_fftContextReverse[2];
     FFTSample *m_lt,*m_rt;                 // left total, right total (source arrays), destination array
-    FFTComplexArray *m_dftL,*m_dftR,*m_src;// intermediate arrays (FFTs of lt & rt, processing source)
+    FFTComplexArray *m_dftL,*m_dftR,*m_src[2];// intermediate arrays (FFTs of lt & rt, processing sources)
 #endif
-    // buffers
-    std::vector<cfloat> m_frontL,m_frontR,m_avg,m_surL,m_surR; // the signal (phase-corrected) in the frequency domain
-    std::vector<cfloat> m_trueavg;       // for lfe generation
+    // buffers, the complex ones split into real and imaginary parts
+    std::vector<float> m_frontRe[2],m_frontIm[2]; // the signal (phase-corrected) in the frequency domain
+    std::vector<float> m_inRe[2],m_inIm[2];       // the input in the frequency domain, for lfe generation
     std::vector<float> m_xFs,m_yFs;      // the feature space positions for each frequency bin
     std::vector<float> m_wnd;            // the window function, precalculated
     std::vector<float> m_filter[6];      // a frequency filter for each output channel
@@ -551,8 +784,8 @@ private:
     float m_surroundLow     {0.0F};      // low surround mixing coefficient (e.g. 0.8165/0.5774)
     float m_surroundBalance {0.0F};      // the xfs balance that follows from the coeffs
     float m_surroundLevel   {0.0F};      // gain for the surround channels (follows from the coeffs
-    float m_phaseOffsetL    {0.0F};      // phase shifts to be applied to the rear channels
-    float m_phaseOffsetR    {0.0F};      // phase shifts to be applied to the rear channels
+    cfloat m_phaseShiftL    {1.0F};      // phase shifts to be applied to the rear channels
+    cfloat m_phaseShiftR    {1.0F};      // phase shifts to be applied to the rear channels
     float m_frontSeparation {0.0F};      // front stereo separation
     float m_rearSeparation  {0.0F};      // rear stereo separation
     bool  m_linearSteering  {false};     // whether the steering should be linear or not
@@ -560,6 +793,7 @@ private:
     int m_currentBuf;                    // specifies which buffer is 2nd half of input sliding buffer
     float * m_inbufs[2]  {};             // for passing back to driver
     float * m_outbufs[6] {};             // for passing back to driver
+    decoder_thread *m_thread {nullptr};  // runs half of each block, in parallel mode
 
     friend class fsurround_decoder;
 };
@@ -585,6 +819,8 @@ void fsurround_decoder::steering_mode(bool mode) { m_impl->steering_mode(mode);
 
 void fsurround_decoder::separation(float front, float rear) { m_impl->separation(front,rear); }
 
+void fsurround_decoder::parallel_mode(bool mode) { m_impl->parallel_mode(mode); }
+
 float ** fsurround_decoder::getInputBuffers()
 {
     return m_impl->getInputBuffers();
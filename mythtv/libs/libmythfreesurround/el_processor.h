@@ -66,6 +66,10 @@ public:
     // set samplerate for lfe filter
     void sample_rate(unsigned int samplerate);
 
+    // transform left and right, and synthesize half of the output channels, on a second thread
+    //  false = everything on the calling thread (default)
+    void parallel_mode(bool mode);
+
 private:
 	class decoder_impl *m_impl; // private implementation (details hidden)
 };
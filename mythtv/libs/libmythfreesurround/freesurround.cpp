@@ -36,6 +36,7 @@ using namespace std;
 
 #include <QString>
 #include <QDateTime>
+#include <QThread>
 
 // our default internal block size, in floats
 static const unsigned default_block_size = SURROUND_BUFSIZE;
@@ -104,6 +105,10 @@ FreeSurround::FreeSurround(uint srate, bool moviemode, SurroundMode smode) :
             break;
     }
 
+    m_parallel = (m_surroundMode == SurroundModeActiveSimple ||
+                  m_surroundMode == SurroundModeActiveLinear) &&
+                 QThread::idealThreadCount() > 1;
+
     m_bufs = new buffers(block_size/2);
     open();
 #ifdef SPEAKERTEST
@@ -125,9 +130,17 @@ void FreeSurround::SetParams()
         m_decoder->phase_mode(m_params.phasemode);
         m_decoder->surround_coefficients(m_params.coeff_a, m_params.coeff_b);
         m_decoder->separation(m_params.front_sep/100.0,m_params.rear_sep/100.0);
+        m_decoder->parallel_mode(m_parallel);
     }
 }
 
+void FreeSurround::SetParallel(bool parallel)
+{
+    m_parallel = parallel;
+    if (m_decoder)
+        m_decoder->parallel_mode(m_parallel);
+}
+
 FreeSurround::fsurround_params::fsurround_params(int32_t center_width,
                                                  int32_t dimension) :
     center_width(center_width),
@@ -51,6 +51,10 @@ public:
 
     static uint framesPerBlock();
 
+    // run half of the decoding on a second thread (the default for the
+    // active modes, when there is more than one CPU)
+    void SetParallel(bool parallel);
+
 protected:
     void process_block();
     void open();
@@ -86,6 +90,7 @@ private:
     SurroundMode m_surroundMode {SurroundModePassive}; // 1 of 3 surround modes supported
     int m_latencyFrames                {0};       // number of frames of incurred latency
     int m_channels                     {0};
+    bool m_parallel                    {false};   // decode on two threads
 };
 
 #endif
@@ -42,8 +42,20 @@ namespace
         }
     };
 
+    // Files are reported with their full path, or relative to base_path
+    // when host is set, as if found by scan_sg_dir
+    QString file_name_for(const QString &fq_file_name, const QString &host,
+                          const QString &base_path)
+    {
+        if (host.isEmpty())
+            return fq_file_name;
+        return fq_file_name.mid(base_path.length() + 1);
+    }
+
     bool scan_dir(const QString &start_path, DirectoryHandler *handler,
-                  const ext_lookup &ext_settings)
+                  const ext_lookup &ext_settings,
+                  const QString &host = QString(),
+                  const QString &base_path = QString())
     {
         QDir d(start_path);
 
@@ -92,7 +104,8 @@ namespace
 
                     // Since we are dealing with a subdirectory failure is fine,
                     // so we'll just ignore the failue and continue
-                    (void) scan_dir(entry.absoluteFilePath(), dh, ext_settings);
+                    (void) scan_dir(entry.absoluteFilePath(), dh, ext_settings,
+                                    host, base_path);
                 }
             }
 
@@ -102,8 +115,10 @@ namespace
                 LOG(VB_GENERAL, LOG_DEBUG,
                     QString(" -- File : %1").arg(entry.fileName()));
 #endif
-                handler->handleFile(entry.fileName(), entry.absoluteFilePath(),
-                                    entry.suffix(), "");
+                handler->handleFile(entry.fileName(),
+                                    file_name_for(entry.absoluteFilePath(),
+                                                  host, base_path),
+                                    entry.suffix(), host);
             }
         }
 
@@ -267,3 +282,55 @@ bool ScanVideoDirectory(const QString &start_path, DirectoryHandler *handler,
 
     return pathScanned;
 }
+
+bool ScanVideoPath(const QString &start_path, const QString &path,
+        DirectoryHandler *handler,
+        const FileAssociations::ext_ignore_list &ext_disposition,
+        bool list_unknown_extensions)
+{
+    ext_lookup extlookup(ext_disposition, list_unknown_extensions);
+
+    QString host;
+    QString base_path = start_path;
+    if (start_path.startsWith("myth://"))
+    {
+        QUrl sgurl = start_path;
+        host = sgurl.host();
+        base_path = sgurl.path();
+    }
+    base_path = QDir::cleanPath(base_path);
+
+    QString target = QDir::cleanPath(path);
+    if (target != base_path && !target.startsWith(base_path + "/"))
+        return false;
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("MythVideo::ScanVideoPath Scanning (%1)").arg(target));
+
+    QFileInfo fi(target);
+
+    // A file or directory that has gone is fine, there's nothing to add
+    if (!fi.exists())
+        return true;
+
+    if (fi.isDir())
+    {
+        if (target == base_path ||
+            (!QDir(target + "/VIDEO_TS").exists() &&
+             !QDir(target + "/BDMV").exists()))
+        {
+            return scan_dir(target, handler, extlookup, host, base_path);
+        }
+    }
+    else if (fi.fileName() == "Thumbs.db" ||
+             extlookup.extension_ignored(fi.suffix()))
+    {
+        return true;
+    }
+
+    // A file, or a DVD or Blu-ray directory
+    handler->handleFile(fi.fileName(),
+                        file_name_for(target, host, base_path),
+                        fi.suffix(), host);
+    return true;
+}
@@ -19,4 +19,13 @@ META_PUBLIC bool ScanVideoDirectory(const QString &start_path, DirectoryHandler
         const FileAssociations::ext_ignore_list &ext_disposition,
         bool list_unknown_extensions);
 
+/// Scan a single file or directory, given by its local path, below the
+/// local video directory or this host's storage group directory start_path.
+/// Files in a storage group are named relative to it, as ScanVideoDirectory
+/// names them.
+META_PUBLIC bool ScanVideoPath(const QString &start_path, const QString &path,
+        DirectoryHandler *handler,
+        const FileAssociations::ext_ignore_list &ext_disposition,
+        bool list_unknown_extensions);
+
 #endif // DIRSCAN_H_
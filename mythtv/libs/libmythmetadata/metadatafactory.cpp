@@ -9,6 +9,7 @@ using std::max;
 // QT
 #include <QApplication>
 #include <QList>
+#include <QTimer>
 #include <QUrl>
 
 // libmythbase
@@ -90,6 +91,14 @@ MetadataFactory::MetadataFactory(QObject *parent) :
 
 MetadataFactory::~MetadataFactory()
 {
+    if (m_videowatcher)
+    {
+        m_videowatcher->Stop();
+        m_videowatcher->wait();
+        delete m_videowatcher;
+        m_videowatcher = nullptr;
+    }
+
     if (m_lookupthread)
     {
         m_lookupthread->cancel();
@@ -293,6 +302,49 @@ void MetadataFactory::VideoScan(const QStringList& hosts)
 
     m_videoscanner->SetHosts(hosts);
     m_videoscanner->SetDirs(GetVideoDirs());
+    m_videoscanner->SetScope(QStringList());
+    m_videoscanner->start();
+}
+
+/**
+ * Scan the files and directories that change in this host's video
+ * directories, as they change, until this is deleted.
+ */
+void MetadataFactory::WatchVideoDirs()
+{
+    if (m_videowatcher)
+        return;
+
+    m_videowatcher = new VideoScanWatcher(this);
+    m_videowatcher->start();
+}
+
+void MetadataFactory::ScanPendingPaths()
+{
+    if (m_pendingPaths.isEmpty())
+        return;
+
+    // Try again once the running scan, or lookup, has finished
+    if (IsRunning())
+    {
+        if (!m_pendingRetry)
+        {
+            m_pendingRetry = true;
+            QTimer::singleShot(5000, this, [this]()
+            {
+                m_pendingRetry = false;
+                ScanPendingPaths();
+            });
+        }
+        return;
+    }
+
+    m_scanning = true;
+
+    m_videoscanner->SetHosts(QStringList(gCoreContext->GetHostName()));
+    m_videoscanner->SetDirs(GetVideoDirs());
+    m_videoscanner->SetScope(m_pendingPaths);
+    m_pendingPaths.clear();
     m_videoscanner->start();
 }
 
@@ -655,6 +707,19 @@ void MetadataFactory::customEvent(QEvent *levent)
         }
         m_videoscanner->ResetCounts();
     }
+    else if (levent->type() == VideoScanPaths::kEventType)
+    {
+        auto *vsp = dynamic_cast<VideoScanPaths *>(levent);
+        if (!vsp)
+            return;
+
+        for (const auto & path : qAsConst(vsp->m_paths))
+        {
+            if (!m_pendingPaths.contains(path))
+                m_pendingPaths.append(path);
+        }
+        ScanPendingPaths();
+    }
 }
 
 // These functions exist to determine if we have enough
@@ -109,6 +109,7 @@ class META_PUBLIC MetadataFactory : public QObject
 
     void VideoScan();
     void VideoScan(const QStringList& hosts);
+    void WatchVideoDirs();
 
     bool IsRunning() { return m_lookupthread->isRunning() ||
                               m_imagedownload->isRunning() ||
@@ -127,6 +128,8 @@ class META_PUBLIC MetadataFactory : public QObject
 
     void OnVideoResult(MetadataLookup *lookup);
 
+    void ScanPendingPaths();
+
     MetadataDownload      *m_lookupthread  {nullptr};
     MetadataImageDownload *m_imagedownload {nullptr};
 
@@ -134,6 +137,11 @@ class META_PUBLIC MetadataFactory : public QObject
     VideoMetadataListManager *m_mlm        {nullptr};
     bool m_scanning                        {false};
 
+    // Watch mode, changed paths wait here for the running scan to finish
+    VideoScanWatcher *m_videowatcher       {nullptr};
+    QStringList m_pendingPaths;
+    bool m_pendingRetry                    {false};
+
     // Variables used in synchronous mode
     MetadataLookupList m_returnList;
     bool m_sync                            {false};
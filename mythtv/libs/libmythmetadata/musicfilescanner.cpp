@@ -1,20 +1,83 @@
+// C++ headers
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <functional>
+#include <utility>
+
 // POSIX headers
 #include <sys/stat.h>
 #include <unistd.h>
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
 
 // Qt headers
+#include <QDataStream>
 #include <QDir>
+#include <QElapsedTimer>
+#include <QRunnable>
+#include <QSet>
+#include <QSaveFile>
+#include <QThread>
 
 // MythTV headers
 #include <mythdate.h>
 #include <mythdb.h>
+#include <mythdirs.h>
 #include <mythcontext.h>
+#include <mthreadpool.h>
 #include <musicmetadata.h>
 #include <metaio.h>
 #include <musicfilescanner.h>
 
-MusicFileScanner::MusicFileScanner(bool force) : m_forceupdate{force}
+#define LOC QString("MusicFileScanner: ")
+
+static const quint32 kIndexMagic = 0x4d4d5331; // MMS1
+
+/// A track read from disk by ReadTags, waiting for CommitTags
+struct MusicFileScanner::MusicFileTags
+{
+    QString        filename;
+    MusicFileData  fdata;
+    MusicMetadata *metadata {nullptr};
+    AlbumArtList   artList;
+};
+
+/// Runs a function on an MThreadPool
+class MusicScannerTask : public QRunnable
+{
+  public:
+    explicit MusicScannerTask(std::function<void()> func) : m_func(std::move(func)) {}
+    void run(void) override { m_func(); }
+
+  private:
+    std::function<void()> m_func;
+};
+
+/// Does filename lie within one of the given files or directories
+static bool InScope(const QString &filename, const QStringList &scope)
+{
+    if (scope.isEmpty())
+        return true;
+
+    return std::any_of(scope.cbegin(), scope.cend(),
+                       [&filename](const QString &path)
+                       { return filename == path || filename.startsWith(path + '/'); });
+}
+
+MusicFileScanner::MusicFileScanner(bool force) :
+    m_readPool(new MThreadPool("MusicFileScanner")),
+    m_forceupdate{force}
 {
+    // Tag reading is mostly waiting on the disk, so use a few threads
+    // even on a single core
+    m_readPool->setMaxThreadCount(std::max(4, QThread::idealThreadCount()));
+
+    m_indexFile = GetCacheDir() + "/musicscanner.index";
+    LoadIndex();
+
     MSqlQuery query(MSqlQuery::InitCon());
 
     // Cache the directory ids from the database
@@ -58,11 +121,130 @@ MusicFileScanner::MusicFileScanner(bool force) : m_forceupdate{force}
     }
 }
 
+MusicFileScanner::~MusicFileScanner(void)
+{
+    delete m_readPool;
+}
+
+/*!
+ * \brief Load the size, modification time and inode of every track
+ *        seen by the last scan on this host
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::LoadIndex(void)
+{
+    QFile file(m_indexFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 magic = 0;
+    QString host;
+    quint32 count = 0;
+    stream >> magic >> host >> count;
+    if (magic != kIndexMagic || host != gCoreContext->GetHostName())
+    {
+        LOG(VB_GENERAL, LOG_INFO, LOC + "Discarding out of date file index");
+        return;
+    }
+
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString filename;
+        MusicIndexEntry entry;
+        stream >> filename >> entry.size >> entry.modified >> entry.inode;
+        if (stream.status() == QDataStream::Ok)
+            m_index.insert(filename, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to read '%1'").arg(m_indexFile));
+        m_index.clear();
+        return;
+    }
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Loaded %1 tracks from '%2'")
+        .arg(m_index.size()).arg(m_indexFile));
+}
+
+void MusicFileScanner::SaveIndex(void)
+{
+    QSaveFile file(m_indexFile);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to open '%1' for writing").arg(m_indexFile));
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << kIndexMagic << gCoreContext->GetHostName()
+           << static_cast<quint32>(m_index.size());
+    for (auto it = m_index.cbegin(); it != m_index.cend(); ++it)
+        stream << it.key() << it->size << it->modified << it->inode;
+
+    if (!file.commit())
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to write '%1'").arg(m_indexFile));
+}
+
+/*!
+ * \brief Does the index hold the file as it is now on disk
+ *
+ * \param filename Full path to file.
+ * \param fdata    The file as found by BuildFileList
+ *
+ * \returns True if the file hasn't changed since it was last read
+ */
+bool MusicFileScanner::IsIndexed(const QString &filename, const MusicFileData &fdata) const
+{
+    auto it = m_index.constFind(filename);
+    return it != m_index.cend() && it->size == fdata.size &&
+           it->modified == fdata.modified && it->inode == fdata.inode;
+}
+
+/*!
+ * \brief Find the storage directory a file was found in
+ *
+ * \returns The directory, with a trailing slash, or an empty string
+ */
+QString MusicFileScanner::StartDirFor(const QString &filename) const
+{
+    for (const auto & startDir : qAsConst(m_startDirs))
+    {
+        if (filename.startsWith(startDir))
+            return startDir;
+    }
+    return QString();
+}
+
+/*!
+ * \brief Fill in the size, modification time and inode of a file
+ *
+ * \returns False if the file couldn't be examined
+ */
+bool MusicFileScanner::StatFile(const QString &filename, MusicFileData &fdata)
+{
+    struct stat st {};
+    if (stat(QFile::encodeName(filename).constData(), &st) != 0)
+        return false;
+
+    fdata.size     = st.st_size;
+    fdata.modified = static_cast<qint64>(st.st_mtime) * 1000;
+    fdata.inode    = st.st_ino;
+    return true;
+}
+
 /*!
  * \brief Builds a list of all the files found descending recursively
  *        into the given directory
  *
  * \param directory Directory to begin search
+ * \param startDir The storage directory, with a trailing slash, that
+ *                 directory is in
  * \param music_files A pointer to the MusicLoadedMap to store the results
  * \param art_files   A pointer to the MusicLoadedMap to store the results
  * \param parentid The id of the parent directory in the music_directories
@@ -70,7 +252,9 @@ MusicFileScanner::MusicFileScanner(bool force) : m_forceupdate{force}
  *
  * \returns Nothing.
  */
-void MusicFileScanner::BuildFileList(QString &directory, MusicLoadedMap &music_files, MusicLoadedMap &art_files, int parentid)
+void MusicFileScanner::BuildFileList(QString &directory, const QString &startDir,
+                                     MusicLoadedMap &music_files, MusicLoadedMap &art_files,
+                                     int parentid)
 {
     QDir d(directory);
 
@@ -96,7 +280,7 @@ void MusicFileScanner::BuildFileList(QString &directory, MusicLoadedMap &music_f
         {
 
             QString dir(filename);
-            dir.remove(0, m_startDirs.last().length());
+            dir.remove(0, startDir.length());
 
             newparentid = m_directoryid[dir];
 
@@ -117,22 +301,27 @@ void MusicFileScanner::BuildFileList(QString &directory, MusicLoadedMap &music_f
                 }
             }
 
-            BuildFileList(filename, music_files, art_files, newparentid);
+            BuildFileList(filename, startDir, music_files, art_files, newparentid);
         }
         else
         {
             if (IsArtFile(filename))
             {
                 MusicFileData fdata;
-                fdata.startDir = m_startDirs.last();
+                fdata.startDir = startDir;
                 fdata.location = MusicFileScanner::kFileSystem;
                 art_files[filename] = fdata;
             }
             else if (IsMusicFile(filename))
             {
                 MusicFileData fdata;
-                fdata.startDir = m_startDirs.last();
+                fdata.startDir = startDir;
                 fdata.location = MusicFileScanner::kFileSystem;
+                if (!StatFile(filename, fdata))
+                {
+                    LOG(VB_GENERAL, LOG_ERR, QString("Failed to stat file: %1")
+                        .arg(filename));
+                }
                 music_files[filename] = fdata;
             }
             else
@@ -217,17 +406,17 @@ int MusicFileScanner::GetDirectoryId(const QString &directory, const int &parent
  * \brief Check if file has been modified since given date/time
  *
  * \param filename File to examine
+ * \param fdata The file as found by BuildFileList
  * \param date_modified Date to use in comparison
  *
  * \returns True if file has been modified, otherwise false
  */
-bool MusicFileScanner::HasFileChanged(
-    const QString &filename, const QString &date_modified)
+bool MusicFileScanner::HasFileChanged(const QString &filename,
+    const MusicFileData &fdata, const QString &date_modified)
 {
-    QFileInfo fi(filename);
-    QDateTime dt = fi.lastModified();
-    if (dt.isValid())
+    if (fdata.modified > 0)
     {
+        QDateTime dt = QDateTime::fromMSecsSinceEpoch(fdata.modified, Qt::UTC);
         QDateTime old_dt = MythDate::fromString(date_modified);
         return !old_dt.isValid() || (dt > old_dt);
     }
@@ -237,12 +426,9 @@ bool MusicFileScanner::HasFileChanged(
 }
 
 /*!
- * \brief Insert file details into database.
- *        If it is an audio file, read the metadata and insert
- *        that information at the same time.
+ * \brief Insert an image file's details into the database.
  *
- *        If it is an image file, just insert the filename and
- *        type.
+ *        Audio files are read by ReadTags and inserted by CommitTags.
  *
  * \param filename Full path to file.
  * \param startDir The starting directory fir the search. This will be
@@ -285,82 +471,249 @@ void MusicFileScanner::AddFileToDB(const QString &filename, const QString &start
         return;
     }
 
-    if (extension.isEmpty() || !MetaIO::kValidFileExtensions.contains(extension.toLower()))
+    LOG(VB_GENERAL, LOG_WARNING, QString("Ignoring filename with unsupported filename: '%1'").arg(filename));
+}
+
+/*!
+ * \brief Read the tags, and any embedded images of new tracks, from a
+ *        batch of files using the thread pool.
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::ReadTags(QList<MusicFileTags> &batch)
+{
+    for (auto & track : batch)
     {
-        LOG(VB_GENERAL, LOG_WARNING, QString("Ignoring filename with unsupported filename: '%1'").arg(filename));
-        return;
+        MusicFileTags *tags = &track;
+        m_readPool->start(new MusicScannerTask([tags]()
+        {
+            LOG(VB_FILE, LOG_INFO, QString("Reading metadata from %1").arg(tags->filename));
+            tags->metadata = MetaIO::readMetadata(tags->filename);
+            if (!tags->metadata || tags->fdata.location == MusicFileScanner::kNeedUpdate)
+                return;
+
+            // read any embedded images from the tag
+            MetaIO *tagger = MetaIO::createTagger(tags->filename);
+            if (tagger)
+            {
+                if (tagger->supportsEmbeddedImages())
+                    tags->artList = tagger->getAlbumArtList(tags->filename);
+                delete tagger;
+            }
+        }), "MusicTagReader");
     }
 
-    LOG(VB_FILE, LOG_INFO, QString("Reading metadata from %1").arg(filename));
-    MusicMetadata *data = MetaIO::readMetadata(filename);
-    if (data)
+    m_readPool->waitForDone();
+}
+
+/*!
+ * \brief Write a batch of tracks read by ReadTags to the database in a
+ *        single transaction.
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::CommitTags(QList<MusicFileTags> &batch)
+{
+    // This holds the thread's connection until the batch is done, so the
+    // queries made by MusicMetadata all run inside the one transaction
+    MSqlQuery transaction(MSqlQuery::InitCon());
+    bool committed = false;
+    if (transaction.transaction())
     {
-        data->setFileSize((quint64)QFileInfo(filename).size());
-        data->setHostname(gCoreContext->GetHostName());
+        QList<MusicFileTags*> added;
+        for (auto & track : batch)
+        {
+            if (!track.metadata)
+                continue;
 
-        QString album_cache_string;
+            if (track.fdata.location == MusicFileScanner::kNeedUpdate)
+                UpdateTrack(track);
+            else
+                added.append(&track);
+        }
+        InsertTracks(added);
 
-        // Set values from cache
-        int did = m_directoryid[directory];
-        if (did >= 0)
-            data->setDirectoryId(did);
+        // Any failed query rolls back the whole batch
+        committed = transaction.commit();
+    }
 
-        int aid = m_artistid[data->Artist().toLower()];
-        if (aid > 0)
+    if (!committed)
+    {
+        // The files are left out of the index so the next scan tries them
+        // again. Artist, album and genre ids the batch created have gone
+        // with it, while directories are added before the batch.
+        LOG(VB_GENERAL, LOG_ERR, QString("Failed to store a batch of %1 tracks")
+            .arg(batch.size()));
+        m_artistid.clear();
+        m_genreid.clear();
+        m_albumid.clear();
+    }
+
+    for (auto & track : batch)
+    {
+        if (committed && track.metadata)
         {
-            data->setArtistId(aid);
+            MusicIndexEntry &entry = m_index[track.filename];
+            entry.size     = track.fdata.size;
+            entry.modified = track.fdata.modified;
+            entry.inode    = track.fdata.inode;
+        }
+        delete track.metadata;
+        qDeleteAll(track.artList);
+    }
+}
 
-            // The album cache depends on the artist id
-            album_cache_string = QString::number(data->getArtistId()) + "#"
-                + data->Album().toLower();
+/*!
+ * \brief Set any of the directory, artist, album and genre ids of a track
+ *        that are already known
+ *
+ * \param data Track to update
+ * \param directory Relative path to the track's directory, from base dir
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::SetCacheIds(MusicMetadata *data, const QString &directory)
+{
+    int did = m_directoryid[directory];
+    if (did >= 0)
+        data->setDirectoryId(did);
 
-            if (m_albumid[album_cache_string] > 0)
-                data->setAlbumId(m_albumid[album_cache_string]);
-        }
+    int aid = m_artistid[data->Artist().toLower()];
+    if (aid > 0)
+    {
+        data->setArtistId(aid);
 
-        int caid = m_artistid[data->CompilationArtist().toLower()];
-        if (caid > 0)
-            data->setCompilationArtistId(caid);
+        // The album cache depends on the artist id
+        QString album_cache_string = QString::number(data->getArtistId()) + "#"
+            + data->Album().toLower();
 
-        int gid = m_genreid[data->Genre().toLower()];
-        if (gid > 0)
-            data->setGenreId(gid);
+        if (m_albumid[album_cache_string] > 0)
+            data->setAlbumId(m_albumid[album_cache_string]);
+    }
 
-        // Commit track info to database
-        data->dumpToDatabase();
+    int caid = m_artistid[data->CompilationArtist().toLower()];
+    if (caid > 0)
+        data->setCompilationArtistId(caid);
 
-        // Update the cache
-        m_artistid[data->Artist().toLower()] =
-            data->getArtistId();
+    int gid = m_genreid[data->Genre().toLower()];
+    if (gid > 0)
+        data->setGenreId(gid);
+}
 
-        m_artistid[data->CompilationArtist().toLower()] =
-            data->getCompilationArtistId();
+void MusicFileScanner::UpdateCache(MusicMetadata *data)
+{
+    m_artistid[data->Artist().toLower()] = data->getArtistId();
+    m_artistid[data->CompilationArtist().toLower()] = data->getCompilationArtistId();
+    m_genreid[data->Genre().toLower()] = data->getGenreId();
 
-        m_genreid[data->Genre().toLower()] =
-            data->getGenreId();
+    QString album_cache_string = QString::number(data->getArtistId()) + "#"
+        + data->Album().toLower();
+    m_albumid[album_cache_string] = data->getAlbumId();
+}
 
-        album_cache_string = QString::number(data->getArtistId()) + "#"
-            + data->Album().toLower();
-        m_albumid[album_cache_string] = data->getAlbumId();
+/*!
+ * \brief Insert new tracks into the database.
+ *
+ *        Any new artists, albums and genres are added first, then the
+ *        tracks go in with a single INSERT, followed by their embedded
+ *        images and one update of each album they are on.
+ *
+ * \param tracks Tracks read by ReadTags
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::InsertTracks(QList<MusicFileTags*> &tracks)
+{
+    if (tracks.isEmpty())
+        return;
+
+    QString host = gCoreContext->GetHostName();
+
+    for (auto *track : qAsConst(tracks))
+    {
+        MusicMetadata *data = track->metadata;
+        QString directory = track->filename;
+        directory.remove(0, track->fdata.startDir.length());
+        directory = directory.section( '/', 0, -2);
+
+        data->setFileSize((quint64)track->fdata.size);
+        data->setHostname(host);
+
+        // Fill in the defaults first, so the cache sees the names that
+        // will be stored
+        data->checkEmptyFields();
+        SetCacheIds(data, directory);
+
+        data->getDirectoryId();
+        data->getArtistId();
+        data->getCompilationArtistId();
+        data->getAlbumId();
+        data->getGenreId();
+
+        UpdateCache(data);
+    }
+
+    QStringList rows;
+    for (int i = 0; i < tracks.size(); ++i)
+        rows << MusicMetadata::songInsertValues(QString(":S%1").arg(i));
+
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare("INSERT INTO music_songs " + MusicMetadata::songInsertColumns() +
+                  " VALUES " + rows.join(","));
 
-        // read any embedded images from the tag
-        MetaIO *tagger = MetaIO::createTagger(filename);
+    QDateTime now = MythDate::current();
+    for (int i = 0; i < tracks.size(); ++i)
+    {
+        QString prefix = QString(":S%1").arg(i);
+        tracks[i]->metadata->bindSongValues(query, prefix);
+        query.bindValue(prefix + "DATE_ADD", now);
+    }
 
-        if (tagger)
+    if (!query.exec() || !query.isActive())
+    {
+        MythDB::DBError("MusicFileScanner::InsertTracks - inserting music_songs", query);
+        return;
+    }
+
+    // Find the ids of the new tracks
+    QVariant firstid = query.lastInsertId();
+    QHash<QString, int> songids;
+    query.prepare("SELECT song_id, directory_id, filename FROM music_songs "
+                  "WHERE song_id >= :FIRSTID AND hostname = :HOSTNAME");
+    query.bindValue(":FIRSTID", firstid);
+    query.bindValue(":HOSTNAME", host);
+    if (!query.exec())
+        MythDB::DBError("MusicFileScanner::InsertTracks - selecting song ids", query);
+    while (query.next())
+        songids[query.value(1).toString() + '/' + query.value(2).toString()] = query.value(0).toInt();
+
+    QMap<int, MusicMetadata*> albums;
+    for (auto *track : qAsConst(tracks))
+    {
+        MusicMetadata *data = track->metadata;
+        int id = songids.value(QString::number(data->getDirectoryId()) + '/'
+                               + track->filename.section('/', -1));
+        if (id <= 0)
         {
-            if (tagger->supportsEmbeddedImages())
-            {
-                AlbumArtList artList = tagger->getAlbumArtList(data->Filename());
-                data->setEmbeddedAlbumArt(artList);
-                data->getAlbumArtImages()->dumpToDatabase();
-            }
-            delete tagger;
+            LOG(VB_GENERAL, LOG_ERR, QString("Failed to add track %1")
+                .arg(track->filename));
+            continue;
         }
+        data->setID(id);
 
-        delete data;
+        if (!track->artList.isEmpty())
+        {
+            data->setEmbeddedAlbumArt(track->artList);
+            data->getAlbumArtImages()->dumpToDatabase();
+        }
 
+        albums[data->getAlbumId()] = data;
         ++m_tracksAdded;
     }
+
+    // update the albums
+    for (auto *data : qAsConst(albums))
+        data->updateAlbum(query);
 }
 
 /*!
@@ -538,45 +891,45 @@ void MusicFileScanner::RemoveFileFromDB(const QString &filename, const QString &
     }
 
     MSqlQuery query(MSqlQuery::InitCon());
-    query.prepare("DELETE FROM music_songs WHERE filename = :NAME ;");
+    query.prepare("DELETE FROM music_songs WHERE filename = :NAME "
+                  "AND directory_id = :DIRID AND hostname = :HOSTNAME ;");
     query.bindValue(":NAME", sqlfilename);
+    query.bindValue(":DIRID", m_directoryid[directory]);
+    query.bindValue(":HOSTNAME", gCoreContext->GetHostName());
     if (!query.exec())
         MythDB::DBError("MusicFileScanner::RemoveFileFromDB - deleting music_songs",
                         query);
 
+    m_index.remove(filename);
+
     ++m_tracksRemoved;
 }
 
 /*!
- * \brief Updates a file in the database.
+ * \brief Updates a track in the database with the tags read by ReadTags.
  *
- * \param filename Full path to file.
- * \param startDir The starting directory fir the search. This will be
- *                 removed making the stored name relative to the
- *                 storage directory where it was found.
+ * \param track The track, its rating and play count are kept from the
+ *              database.
  *
  * \returns Nothing.
  */
-void MusicFileScanner::UpdateFileInDB(const QString &filename, const QString &startDir)
+void MusicFileScanner::UpdateTrack(MusicFileTags &track)
 {
-    QString dbFilename = filename;
-    dbFilename.remove(0, startDir.length());
+    QString dbFilename = track.filename;
+    dbFilename.remove(0, track.fdata.startDir.length());
 
-    QString directory = filename;
-    directory.remove(0, startDir.length());
-    directory = directory.section( '/', 0, -2);
+    QString directory = dbFilename.section( '/', 0, -2);
 
     MusicMetadata *db_meta   = MetaIO::getMetadata(dbFilename);
-    MusicMetadata *disk_meta = MetaIO::readMetadata(filename);
+    MusicMetadata *disk_meta = track.metadata;
 
-    if (db_meta && disk_meta)
+    if (db_meta)
     {
         if (db_meta->ID() <= 0)
         {
             LOG(VB_GENERAL, LOG_ERR, QString("Asked to update track with "
                                                 "invalid ID - %1")
                                             .arg(db_meta->ID()));
-            delete disk_meta;
             delete db_meta;
             return;
         }
@@ -586,55 +939,78 @@ void MusicFileScanner::UpdateFileInDB(const QString &filename, const QString &st
         if (db_meta->PlayCount() > disk_meta->PlayCount())
             disk_meta->setPlaycount(db_meta->Playcount());
 
-        QString album_cache_string;
-
         // Set values from cache
-        int did = m_directoryid[directory];
-        if (did > 0)
-            disk_meta->setDirectoryId(did);
+        disk_meta->checkEmptyFields();
+        SetCacheIds(disk_meta, directory);
 
-        int aid = m_artistid[disk_meta->Artist().toLower()];
-        if (aid > 0)
-        {
-            disk_meta->setArtistId(aid);
+        disk_meta->setFileSize((quint64)track.fdata.size);
 
-            // The album cache depends on the artist id
-            album_cache_string = QString::number(disk_meta->getArtistId()) + "#" +
-                disk_meta->Album().toLower();
+        disk_meta->setHostname(gCoreContext->GetHostName());
 
-            if (m_albumid[album_cache_string] > 0)
-                disk_meta->setAlbumId(m_albumid[album_cache_string]);
-        }
+        // Commit track info to database
+        disk_meta->dumpToDatabase();
 
-        int caid = m_artistid[disk_meta->CompilationArtist().toLower()];
-        if (caid > 0)
-            disk_meta->setCompilationArtistId(caid);
+        UpdateCache(disk_meta);
 
-        int gid = m_genreid[disk_meta->Genre().toLower()];
-        if (gid > 0)
-            disk_meta->setGenreId(gid);
+        ++m_tracksUpdated;
+    }
 
-        disk_meta->setFileSize((quint64)QFileInfo(filename).size());
+    delete db_meta;
+}
 
-        disk_meta->setHostname(gCoreContext->GetHostName());
+/*!
+ * \brief Add, update and remove the files found by ScanMusic and ScanArtwork.
+ *
+ *        Tracks are read kBatchSize at a time by the thread pool, and each
+ *        batch is written to the database as one transaction.
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::UpdateDB(MusicLoadedMap &music_files, MusicLoadedMap &art_files)
+{
+    LOG(VB_GENERAL, LOG_INFO, "Updating database");
 
-        // Commit track info to database
-        disk_meta->dumpToDatabase();
+    MusicLoadedMap::Iterator iter;
+    QList<MusicFileTags> batch;
+
+    for (iter = music_files.begin(); iter != music_files.end(); iter++)
+    {
+        if ((*iter).location == MusicFileScanner::kDatabase)
+        {
+            RemoveFileFromDB(iter.key(), (*iter).startDir);
+            continue;
+        }
+
+        if ((*iter).location != MusicFileScanner::kFileSystem &&
+            (*iter).location != MusicFileScanner::kNeedUpdate)
+            continue;
+
+        MusicFileTags track;
+        track.filename = iter.key();
+        track.fdata = *iter;
+        batch.append(track);
+
+        if (batch.size() >= kBatchSize)
+        {
+            ReadTags(batch);
+            CommitTags(batch);
+            batch.clear();
+        }
+    }
 
-        // Update the cache
-        m_artistid[disk_meta->Artist().toLower()]
-            = disk_meta->getArtistId();
-        m_artistid[disk_meta->CompilationArtist().toLower()]
-            = disk_meta->getCompilationArtistId();
-        m_genreid[disk_meta->Genre().toLower()]
-            = disk_meta->getGenreId();
-        album_cache_string = QString::number(disk_meta->getArtistId()) + "#" +
-            disk_meta->Album().toLower();
-        m_albumid[album_cache_string] = disk_meta->getAlbumId();
+    if (!batch.isEmpty())
+    {
+        ReadTags(batch);
+        CommitTags(batch);
     }
 
-    delete disk_meta;
-    delete db_meta;
+    for (iter = art_files.begin(); iter != art_files.end(); iter++)
+    {
+        if ((*iter).location == MusicFileScanner::kFileSystem)
+            AddFileToDB(iter.key(), (*iter).startDir);
+        else if ((*iter).location == MusicFileScanner::kDatabase)
+            RemoveFileFromDB(iter.key(), (*iter).startDir);
+    }
 }
 
 /*!
@@ -692,15 +1068,15 @@ void MusicFileScanner::SearchDirs(const QStringList &dirList)
 
     MusicLoadedMap music_files;
     MusicLoadedMap art_files;
-    MusicLoadedMap::Iterator iter;
 
+    m_startDirs.clear();
     for (int x = 0; x < dirList.count(); x++)
     {
         QString startDir = dirList[x];
         m_startDirs.append(startDir + '/');
         LOG(VB_GENERAL, LOG_INFO, QString("Searching '%1' for music files").arg(startDir));
 
-        BuildFileList(startDir, music_files, art_files, 0);
+        BuildFileList(startDir, m_startDirs.last(), music_files, art_files, 0);
     }
 
     m_tracksTotal = music_files.count();
@@ -709,50 +1085,13 @@ void MusicFileScanner::SearchDirs(const QStringList &dirList)
     ScanMusic(music_files);
     ScanArtwork(art_files);
 
-    LOG(VB_GENERAL, LOG_INFO, "Updating database");
-
-        /*
-        This can be optimised quite a bit by consolidating all commands
-        via a lot of refactoring.
-
-        1) group all files of the same decoder type, and don't
-        create/delete a Decoder pr. AddFileToDB. Or make Decoders be
-        singletons, it should be a fairly simple change.
-
-        2) RemoveFileFromDB should group the remove into one big SQL.
-
-        3) UpdateFileInDB, same as 1.
-        */
-
-    for (iter = music_files.begin(); iter != music_files.end(); iter++)
-    {
-        if ((*iter).location == MusicFileScanner::kFileSystem)
-            AddFileToDB(iter.key(), (*iter).startDir);
-        else if ((*iter).location == MusicFileScanner::kDatabase)
-            RemoveFileFromDB(iter.key(), (*iter).startDir);
-        else if ((*iter).location == MusicFileScanner::kNeedUpdate)
-        {
-            UpdateFileInDB(iter.key(), (*iter).startDir);
-            ++m_tracksUpdated;
-        }
-    }
-
-    for (iter = art_files.begin(); iter != art_files.end(); iter++)
-    {
-        if ((*iter).location == MusicFileScanner::kFileSystem)
-            AddFileToDB(iter.key(), (*iter).startDir);
-        else if ((*iter).location == MusicFileScanner::kDatabase)
-            RemoveFileFromDB(iter.key(), (*iter).startDir);
-        else if ((*iter).location == MusicFileScanner::kNeedUpdate)
-        {
-            UpdateFileInDB(iter.key(), (*iter).startDir);
-            ++m_coverartUpdated;
-        }
-    }
+    UpdateDB(music_files, art_files);
 
     // Cleanup orphaned entries from the database
     cleanDB();
 
+    SaveIndex();
+
     QString trackStatus = QString("total tracks found: %1 (unchanged: %2, added: %3, removed: %4, updated %5)")
                                   .arg(m_tracksTotal).arg(m_tracksUnchanged).arg(m_tracksAdded)
                                   .arg(m_tracksRemoved).arg(m_tracksUpdated);
@@ -774,14 +1113,261 @@ void MusicFileScanner::SearchDirs(const QStringList &dirList)
     updateLastRunStatus(status);
 }
 
+/*!
+ * \brief Bring the database up to date with a list of changed files and
+ *        directories. Any of them may no longer exist.
+ *
+ * \param paths Full paths within the directories being watched
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::ScanPaths(QStringList paths)
+{
+    QString host = gCoreContext->GetHostName();
+
+    m_tracksTotal = m_tracksAdded = m_tracksUnchanged = m_tracksRemoved = m_tracksUpdated = 0;
+    m_coverartTotal = m_coverartAdded = m_coverartUnchanged = m_coverartRemoved = m_coverartUpdated = 0;
+
+    MusicLoadedMap music_files;
+    MusicLoadedMap art_files;
+
+    // Parent directories sort before their contents
+    paths.sort();
+    for (const auto & path : qAsConst(paths))
+    {
+        QString startDir = StartDirFor(path);
+        if (startDir.isEmpty())
+            continue;
+
+        QFileInfo fi(path);
+        if (fi.isDir())
+        {
+            QString dir = path.mid(startDir.length());
+            int id = m_directoryid.value(dir, 0);
+            if (id == 0)
+            {
+                id = GetDirectoryId(dir, m_directoryid.value(dir.section('/', 0, -2), 0));
+                m_directoryid[dir] = id;
+            }
+
+            QString directory(path);
+            BuildFileList(directory, startDir, music_files, art_files, id);
+        }
+        else if (fi.exists() && IsArtFile(path))
+        {
+            MusicFileData fdata;
+            fdata.startDir = startDir;
+            fdata.location = MusicFileScanner::kFileSystem;
+            art_files[path] = fdata;
+        }
+        else if (fi.exists() && IsMusicFile(path))
+        {
+            MusicFileData fdata;
+            fdata.startDir = startDir;
+            fdata.location = MusicFileScanner::kFileSystem;
+            if (StatFile(path, fdata))
+                music_files[path] = fdata;
+        }
+    }
+
+    m_tracksTotal = music_files.count();
+    m_coverartTotal = art_files.count();
+
+    ScanMusic(music_files, paths);
+    ScanArtwork(art_files, paths);
+
+    UpdateDB(music_files, art_files);
+
+    cleanDB();
+
+    SaveIndex();
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("Music file scanner updated %1 changed paths (added: %2, removed: %3, updated %4)")
+            .arg(paths.size()).arg(m_tracksAdded + m_coverartAdded)
+            .arg(m_tracksRemoved + m_coverartRemoved).arg(m_tracksUpdated));
+
+    gCoreContext->SendMessage(QString("MUSIC_SCANNER_FINISHED %1 %2 %3 %4 %5")
+                                      .arg(host).arg(m_tracksTotal).arg(m_tracksAdded)
+                                      .arg(m_coverartTotal).arg(m_coverartAdded));
+}
+
+#ifdef __linux__
+static constexpr uint32_t kWatchMask { IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                                       IN_DELETE | IN_CREATE };
+// Wait for the changes to a directory to stop for this long (ms) before
+// scanning them, but don't put off a busy directory for longer than
+// kWatchMaxDelay (ms)
+static constexpr int kWatchDelay    { 5000 };
+static constexpr int kWatchMaxDelay { 60000 };
+
+/// Watch a directory and all the directories below it
+static void AddWatches(int fd, const QString &directory, QHash<int, QString> &watches)
+{
+    int wd = inotify_add_watch(fd, QFile::encodeName(directory).constData(),
+                               kWatchMask | IN_ONLYDIR);
+    if (wd < 0)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Can't watch '%1'").arg(directory) + ENO);
+        return;
+    }
+    watches[wd] = directory;
+
+    QDir d(directory);
+    const QStringList dirs = d.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    for (const auto & dir : dirs)
+        AddWatches(fd, directory + '/' + dir, watches);
+}
+#endif
+
+/*!
+ * \brief Keep the database up to date with the changes made to a list of
+ *        directories, until the process is stopped.
+ *
+ *        Only the files and directories that change are scanned. inotify
+ *        only sees changes made by this machine, so changes made to a
+ *        network share by another machine need a full scan.
+ *
+ * \param dirList List of directories to watch
+ *
+ * \returns Nothing.
+ */
+void MusicFileScanner::WatchDirs(const QStringList &dirList)
+{
+#ifdef __linux__
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to start watching for changes" + ENO);
+        return;
+    }
+
+    QHash<int, QString> watches;
+    m_startDirs.clear();
+    for (const auto & dir : dirList)
+    {
+        m_startDirs.append(dir + '/');
+        AddWatches(fd, dir, watches);
+    }
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Watching %1 directories for changes. "
+        "Changes made to network shares by other machines won't be seen.")
+        .arg(watches.size()));
+
+    QSet<QString> changed;
+    bool rescan = false;
+    QElapsedTimer pending;
+    alignas(struct inotify_event) std::array<char,4096> buffer {};
+
+    while (true)
+    {
+        int timeout = -1;
+        if (rescan || !changed.isEmpty())
+        {
+            timeout = std::clamp(kWatchMaxDelay - static_cast<int>(pending.elapsed()),
+                                 0, kWatchDelay);
+        }
+
+        pollfd pfd { fd, POLLIN, 0 };
+        int ret = poll(&pfd, 1, timeout);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to wait for changes" + ENO);
+            break;
+        }
+
+        if (ret == 0)
+        {
+            // Leave the changes to a full scan that's already running
+            if (IsRunning())
+            {
+                pending.start();
+                continue;
+            }
+
+            if (rescan)
+            {
+                LOG(VB_GENERAL, LOG_INFO, LOC + "Missed some changes, rescanning");
+                SearchDirs(dirList);
+                for (const auto & dir : dirList)
+                    AddWatches(fd, dir, watches);
+            }
+            else
+            {
+                ScanPaths(changed.values());
+            }
+
+            changed.clear();
+            rescan = false;
+            continue;
+        }
+
+        ssize_t len = read(fd, buffer.data(), buffer.size());
+        if (len < 0 && errno == EINTR)
+            continue;
+        if (len <= 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to read changes" + ENO);
+            break;
+        }
+
+        if (!rescan && changed.isEmpty())
+            pending.start();
+
+        for (ssize_t pos = 0; pos < len; )
+        {
+            const auto *event = reinterpret_cast<const struct inotify_event *>(buffer.data() + pos);
+            pos += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                rescan = true;
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                watches.remove(event->wd);
+                continue;
+            }
+
+            QString path = watches.value(event->wd);
+            if (path.isEmpty() || event->len == 0)
+                continue;
+            path += '/' + QFile::decodeName(event->name);
+
+            if (event->mask & IN_ISDIR)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    AddWatches(fd, path, watches);
+                changed.insert(path);
+            }
+            // A new file is scanned once it has been written and closed
+            else if (!(event->mask & IN_CREATE))
+            {
+                changed.insert(path);
+            }
+        }
+    }
+
+    close(fd);
+#else
+    Q_UNUSED(dirList);
+    LOG(VB_GENERAL, LOG_ERR, LOC + "Watching for changes is only supported on Linux");
+#endif
+}
+
 /*!
  * \brief Check a list of files against musics files already in the database
  *
  * \param music_files MusicLoadedMap
+ * \param scope Only check the database's tracks within these files and
+ *              directories, all of them when empty
  *
  * \returns Nothing.
  */
-void MusicFileScanner::ScanMusic(MusicLoadedMap &music_files)
+void MusicFileScanner::ScanMusic(MusicLoadedMap &music_files, const QStringList &scope)
 {
     MusicLoadedMap::Iterator iter;
 
@@ -800,32 +1386,59 @@ void MusicFileScanner::ScanMusic(MusicLoadedMap &music_files)
     LOG(VB_GENERAL, LOG_INFO, "Checking tracks");
 
     QString name;
+    QString startDir;
 
     if (query.isActive() && query.size() > 0)
     {
         while (query.next())
         {
+            iter = music_files.end();
+            name.clear();
             for (int x = 0; x < m_startDirs.count(); x++)
             {
-                name = m_startDirs[x] + query.value(0).toString();
-                if ((iter = music_files.find(name)) != music_files.end())
+                QString candidate = m_startDirs[x] + query.value(0).toString();
+                if ((iter = music_files.find(candidate)) != music_files.end())
+                {
+                    name = candidate;
                     break;
+                }
+                if (name.isEmpty() && InScope(candidate, scope))
+                {
+                    name = candidate;
+                    startDir = m_startDirs[x];
+                }
             }
 
             if (iter != music_files.end())
             {
                 if (music_files[name].location == MusicFileScanner::kDatabase)
                     continue;
-                if (m_forceupdate || HasFileChanged(name, query.value(1).toString()))
+
+                // Trust the index over the date the track was last updated
+                bool changed = m_forceupdate;
+                if (!changed && m_index.contains(name))
+                    changed = !IsIndexed(name, *iter);
+                else if (!changed)
+                    changed = HasFileChanged(name, *iter, query.value(1).toString());
+
+                if (changed)
                     music_files[name].location = MusicFileScanner::kNeedUpdate;
                 else
                 {
+                    MusicIndexEntry &entry = m_index[name];
+                    entry.size     = (*iter).size;
+                    entry.modified = (*iter).modified;
+                    entry.inode    = (*iter).inode;
+
                     ++m_tracksUnchanged;
                     music_files.erase(iter);
                 }
             }
-            else
+            else if (!name.isEmpty())
+            {
+                music_files[name].startDir = startDir;
                 music_files[name].location = MusicFileScanner::kDatabase;
+            }
         }
     }
 }
@@ -834,10 +1447,12 @@ void MusicFileScanner::ScanMusic(MusicLoadedMap &music_files)
  * \brief Check a list of files against images already in the database
  *
  * \param music_files MusicLoadedMap
+ * \param scope Only check the database's images within these files and
+ *              directories, all of them when empty
  *
  * \returns Nothing.
  */
-void MusicFileScanner::ScanArtwork(MusicLoadedMap &music_files)
+void MusicFileScanner::ScanArtwork(MusicLoadedMap &music_files, const QStringList &scope)
 {
     MusicLoadedMap::Iterator iter;
 
@@ -856,16 +1471,27 @@ void MusicFileScanner::ScanArtwork(MusicLoadedMap &music_files)
     LOG(VB_GENERAL, LOG_INFO, "Checking artwork");
 
     QString name;
+    QString startDir;
 
     if (query.isActive() && query.size() > 0)
     {
         while (query.next())
         {
+            iter = music_files.end();
+            name.clear();
             for (int x = 0; x < m_startDirs.count(); x++)
             {
-                name = m_startDirs[x] + query.value(0).toString();
-                if ((iter = music_files.find(name)) != music_files.end())
+                QString candidate = m_startDirs[x] + query.value(0).toString();
+                if ((iter = music_files.find(candidate)) != music_files.end())
+                {
+                    name = candidate;
                     break;
+                }
+                if (name.isEmpty() && InScope(candidate, scope))
+                {
+                    name = candidate;
+                    startDir = m_startDirs[x];
+                }
             }
 
             if (iter != music_files.end())
@@ -875,8 +1501,9 @@ void MusicFileScanner::ScanArtwork(MusicLoadedMap &music_files)
                 ++m_coverartUnchanged;
                 music_files.erase(iter);
             }
-            else
+            else if (!name.isEmpty())
             {
+                music_files[name].startDir = startDir;
                 music_files[name].location = MusicFileScanner::kDatabase;
             }
         }
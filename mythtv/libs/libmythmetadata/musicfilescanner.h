@@ -6,9 +6,13 @@
 
 // Qt headers
 #include <QCoreApplication>
+#include <QHash>
 
 using IdCache = QMap<QString, int>;
 
+class MThreadPool;
+class MusicMetadata;
+
 class META_PUBLIC MusicFileScanner
 {
     Q_DECLARE_TR_FUNCTIONS(MusicFileScanner)
@@ -25,26 +29,57 @@ class META_PUBLIC MusicFileScanner
     {
         QString startDir;
         MusicFileLocation location {kFileSystem};
+        // As found by BuildFileList
+        qint64  size     {0};
+        qint64  modified {0};  // ms since epoch
+        quint64 inode    {0};
+    };
+
+    // What the scanner saw of a file when it was last added or updated
+    struct MusicIndexEntry
+    {
+        qint64  size     {0};
+        qint64  modified {0};
+        quint64 inode    {0};
     };
 
+    struct MusicFileTags;
+
     using MusicLoadedMap = QMap <QString, MusicFileData>;
+    using MusicIndex     = QHash <QString, MusicIndexEntry>;
     public:
         explicit MusicFileScanner(bool force = false);
-        ~MusicFileScanner(void) = default;
+        ~MusicFileScanner(void);
 
         void SearchDirs(const QStringList &dirList);
+        void WatchDirs(const QStringList &dirList);
 
         static bool IsRunning(void);
 
+        // Tracks read from disk, then committed to the database, at a time
+        static constexpr int kBatchSize { 256 };
+
     private:
-        void BuildFileList(QString &directory, MusicLoadedMap &music_files, MusicLoadedMap &art_files, int parentid);
+        void BuildFileList(QString &directory, const QString &startDir, MusicLoadedMap &music_files, MusicLoadedMap &art_files, int parentid);
         static int  GetDirectoryId(const QString &directory, const int &parentid);
-        static bool HasFileChanged(const QString &filename, const QString &date_modified);
+        static bool HasFileChanged(const QString &filename, const MusicFileData &fdata, const QString &date_modified);
+        static bool StatFile(const QString &filename, MusicFileData &fdata);
+        bool IsIndexed(const QString &filename, const MusicFileData &fdata) const;
         void AddFileToDB(const QString &filename, const QString &startDir);
         void RemoveFileFromDB (const QString &filename, const QString &startDir);
-        void UpdateFileInDB(const QString &filename, const QString &startDir);
-        void ScanMusic(MusicLoadedMap &music_files);
-        void ScanArtwork(MusicLoadedMap &music_files);
+        void ReadTags(QList<MusicFileTags> &batch);
+        void CommitTags(QList<MusicFileTags> &batch);
+        void InsertTracks(QList<MusicFileTags*> &tracks);
+        void UpdateTrack(MusicFileTags &track);
+        void UpdateDB(MusicLoadedMap &music_files, MusicLoadedMap &art_files);
+        void SetCacheIds(MusicMetadata *data, const QString &directory);
+        void UpdateCache(MusicMetadata *data);
+        void ScanMusic(MusicLoadedMap &music_files, const QStringList &scope = QStringList());
+        void ScanArtwork(MusicLoadedMap &music_files, const QStringList &scope = QStringList());
+        void ScanPaths(QStringList paths);
+        void LoadIndex(void);
+        void SaveIndex(void);
+        QString StartDirFor(const QString &filename) const;
         static void cleanDB();
         static bool IsArtFile(const QString &filename);
         static bool IsMusicFile(const QString &filename);
@@ -58,6 +93,9 @@ class META_PUBLIC MusicFileScanner
         IdCache  m_artistid;
         IdCache  m_genreid;
         IdCache  m_albumid;
+        MusicIndex   m_index;
+        QString      m_indexFile;
+        MThreadPool *m_readPool  {nullptr};
 
         uint m_tracksTotal       {0};
         uint m_tracksUnchanged   {0};
@@ -698,19 +698,8 @@ void MusicMetadata::dumpToDatabase()
     QString strQuery;
     if (m_id < 1)
     {
-        strQuery = "INSERT INTO music_songs ( directory_id,"
-                   " artist_id, album_id,    name,         genre_id,"
-                   " year,      track,       length,       filename,"
-                   " rating,    format,      date_entered, date_modified,"
-                   " numplays,  track_count, disc_number,  disc_count,"
-                   " size,      hostname) "
-                   "VALUES ( "
-                   " :DIRECTORY, "
-                   " :ARTIST,   :ALBUM,      :TITLE,       :GENRE,"
-                   " :YEAR,     :TRACKNUM,   :LENGTH,      :FILENAME,"
-                   " :RATING,   :FORMAT,     :DATE_ADD,    :DATE_MOD,"
-                   " :PLAYCOUNT,:TRACKCOUNT, :DISC_NUMBER, :DISC_COUNT,"
-                   " :SIZE,     :HOSTNAME );";
+        strQuery = "INSERT INTO music_songs " + songInsertColumns() +
+                   " VALUES " + songInsertValues() + ";";
     }
     else
     {
@@ -736,38 +725,17 @@ void MusicMetadata::dumpToDatabase()
                    "WHERE song_id= :ID ;";
     }
 
-    QString sqldir = m_filename.section('/', 0, -2);
-    QString sqlfilename = m_filename.section('/', -1);
-
     MSqlQuery query(MSqlQuery::InitCon());
 
     query.prepare(strQuery);
 
-    query.bindValue(":DIRECTORY", m_directoryId);
-    query.bindValue(":ARTIST", m_artistId);
-    query.bindValue(":ALBUM", m_albumId);
-    query.bindValue(":TITLE", m_title);
-    query.bindValue(":GENRE", m_genreId);
-    query.bindValue(":YEAR", m_year);
-    query.bindValue(":TRACKNUM", m_trackNum);
-    query.bindValue(":LENGTH", m_length);
-    query.bindValue(":FILENAME", sqlfilename);
-    query.bindValue(":RATING", m_rating);
-    query.bindValueNoNull(":FORMAT", m_format);
-    query.bindValue(":DATE_MOD", MythDate::current());
-    query.bindValue(":PLAYCOUNT", m_playCount);
+    bindSongValues(query);
 
     if (m_id < 1)
         query.bindValue(":DATE_ADD",  MythDate::current());
     else
         query.bindValue(":ID", m_id);
 
-    query.bindValue(":TRACKCOUNT", m_trackCount);
-    query.bindValue(":DISC_NUMBER", m_discNum);
-    query.bindValue(":DISC_COUNT",m_discCount);
-    query.bindValue(":SIZE", (quint64)m_fileSize);
-    query.bindValue(":HOSTNAME", m_hostname);
-
     if (!query.exec())
         MythDB::DBError("MusicMetadata::dumpToDatabase - updating music_songs",
                         query);
@@ -780,6 +748,62 @@ void MusicMetadata::dumpToDatabase()
         m_albumArt->dumpToDatabase();
 
     // update the album
+    updateAlbum(query);
+}
+
+/// \brief The music_songs columns set when a track is added
+QString MusicMetadata::songInsertColumns(void)
+{
+    return "( directory_id,"
+           " artist_id, album_id,    name,         genre_id,"
+           " year,      track,       length,       filename,"
+           " rating,    format,      date_entered, date_modified,"
+           " numplays,  track_count, disc_number,  disc_count,"
+           " size,      hostname)";
+}
+
+/// \brief Placeholders matching songInsertColumns(), for bindSongValues()
+QString MusicMetadata::songInsertValues(const QString &prefix)
+{
+    return QString("( %1DIRECTORY,"
+                   " %1ARTIST,   %1ALBUM,      %1TITLE,       %1GENRE,"
+                   " %1YEAR,     %1TRACKNUM,   %1LENGTH,      %1FILENAME,"
+                   " %1RATING,   %1FORMAT,     %1DATE_ADD,    %1DATE_MOD,"
+                   " %1PLAYCOUNT,%1TRACKCOUNT, %1DISC_NUMBER, %1DISC_COUNT,"
+                   " %1SIZE,     %1HOSTNAME )").arg(prefix);
+}
+
+/*!
+ * \brief Bind the track's music_songs values to a prepared query
+ *
+ * Everything but DATE_ADD and ID is bound, and the ids must already have
+ * been looked up.
+ */
+void MusicMetadata::bindSongValues(MSqlQuery &query, const QString &prefix) const
+{
+    query.bindValue(prefix + "DIRECTORY", m_directoryId);
+    query.bindValue(prefix + "ARTIST", m_artistId);
+    query.bindValue(prefix + "ALBUM", m_albumId);
+    query.bindValue(prefix + "TITLE", m_title);
+    query.bindValue(prefix + "GENRE", m_genreId);
+    query.bindValue(prefix + "YEAR", m_year);
+    query.bindValue(prefix + "TRACKNUM", m_trackNum);
+    query.bindValue(prefix + "LENGTH", m_length);
+    query.bindValue(prefix + "FILENAME", m_filename.section('/', -1));
+    query.bindValue(prefix + "RATING", m_rating);
+    query.bindValueNoNull(prefix + "FORMAT", m_format);
+    query.bindValue(prefix + "DATE_MOD", MythDate::current());
+    query.bindValue(prefix + "PLAYCOUNT", m_playCount);
+    query.bindValue(prefix + "TRACKCOUNT", m_trackCount);
+    query.bindValue(prefix + "DISC_NUMBER", m_discNum);
+    query.bindValue(prefix + "DISC_COUNT",m_discCount);
+    query.bindValue(prefix + "SIZE", (quint64)m_fileSize);
+    query.bindValue(prefix + "HOSTNAME", m_hostname);
+}
+
+/// \brief Store the track's album name, year and compilation status in music_albums
+bool MusicMetadata::updateAlbum(MSqlQuery &query) const
+{
     query.prepare("UPDATE music_albums SET album_name = :ALBUM_NAME, "
                   "artist_id = :COMP_ARTIST_ID, compilation = :COMPILATION, "
                   "year = :YEAR "
@@ -793,8 +817,9 @@ void MusicMetadata::dumpToDatabase()
     if (!query.exec() || !query.isActive())
     {
         MythDB::DBError("music compilation update", query);
-        return;
+        return false;
     }
+    return true;
 }
 
 // Default values for formats
@@ -24,6 +24,7 @@ class AllMusic;
 class AlbumArtImages;
 class LyricsData;
 class MetaIO;
+class MSqlQuery;
 
 enum ImageType
 {
@@ -286,6 +287,8 @@ class META_PUBLIC MusicMetadata
 
     void reloadMetadata(void);
     void dumpToDatabase(void);
+    void bindSongValues(MSqlQuery &query, const QString &prefix = ":") const;
+    bool updateAlbum(MSqlQuery &query) const;
     void setField(const QString &field, const QString &data);
     void getField(const QString& field, QString *data);
     void toMap(InfoMap &metadataMap, const QString &prefix = "");
@@ -302,6 +305,8 @@ class META_PUBLIC MusicMetadata
     static void setArtistAndTrackFormats();
     static QStringList fillFieldList(const QString& field);
     static bool updateStreamList(void);
+    static QString songInsertColumns(void);
+    static QString songInsertValues(const QString &prefix = ":");
 
     // this looks for any image available - preferring a front cover if available
     QString getAlbumArtFile(void);
@@ -315,10 +320,12 @@ class META_PUBLIC MusicMetadata
 
     MetaIO *getTagger(void);
 
+    // fill in the default artist, album, title and genre of an untagged track
+    void checkEmptyFields(void);
+
   private:
     void setCompilationFormatting(bool cd = false);
     QString formatReplaceSymbols(const QString &format);
-    void checkEmptyFields(void);
     void ensureSortFields(void);
     void saveHostname(void);
 
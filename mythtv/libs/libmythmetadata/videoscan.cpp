@@ -1,15 +1,34 @@
 
 #include "videoscan.h"
 
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <utility>
+
+// POSIX headers
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
 #include <QApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QHash>
 #include <QImageReader>
+#include <QRunnable>
+#include <QSet>
+#include <QThread>
 #include <QUrl>
-#include <utility>
 
 // libmythbase
 #include "mythevent.h"
 #include "mythlogging.h"
 #include "mythdate.h"
+#include "mythdb.h"
+#include "mthreadpool.h"
 
 // libmyth
 #include "mythcontext.h"
@@ -31,6 +50,9 @@
 QEvent::Type VideoScanChanges::kEventType =
     (QEvent::Type) QEvent::registerEventType();
 
+QEvent::Type VideoScanPaths::kEventType =
+    (QEvent::Type) QEvent::registerEventType();
+
 namespace
 {
     template <typename DirListType>
@@ -76,6 +98,39 @@ namespace
         image_ext    m_imageExt;
         DirListType &m_videoFiles;
     };
+
+    /// Runs a function on an MThreadPool
+    class VideoScannerTask : public QRunnable
+    {
+      public:
+        explicit VideoScannerTask(std::function<void()> func) :
+            m_func(std::move(func)) {}
+        void run(void) override { m_func(); } // QRunnable
+
+      private:
+        std::function<void()> m_func;
+    };
+
+    /// The local path of a video directory on this host, or an empty
+    /// string for a storage group directory on another host
+    QString LocalVideoDir(const QString &dir)
+    {
+        if (!dir.startsWith("myth://"))
+            return QDir::cleanPath(dir);
+
+        QUrl sgurl = dir;
+        if (sgurl.host().toLower() != gCoreContext->GetHostName().toLower())
+            return QString();
+        return QDir::cleanPath(sgurl.path());
+    }
+
+    /// Does filename lie within one of the given files or directories
+    bool InScope(const QString &filename, const QStringList &scope)
+    {
+        return std::any_of(scope.cbegin(), scope.cend(),
+                           [&filename](const QString &path)
+                           { return filename == path || filename.startsWith(path + '/'); });
+    }
 }
 
 class VideoMetadataListManager;
@@ -86,12 +141,17 @@ VideoScannerThread::VideoScannerThread(QObject *parent) :
 {
     m_parent = parent;
     m_dbMetadata = new VideoMetadataListManager;
+    // Scanning and hashing mostly wait on disks and other backends, so
+    // use a few threads even on a single core
+    m_pool = new MThreadPool("VideoScanner");
+    m_pool->setMaxThreadCount(std::max(4, QThread::idealThreadCount()));
     m_hasGUI = gCoreContext->HasGUI();
     m_listUnknown = gCoreContext->GetBoolSetting("VideoListUnknownFiletypes", false);
 }
 
 VideoScannerThread::~VideoScannerThread()
 {
+    delete m_pool;
     delete m_dbMetadata;
 }
 
@@ -102,6 +162,33 @@ void VideoScannerThread::SetHosts(const QStringList &hosts)
         m_liveSGHosts << host.toLower();
 }
 
+/*
+ * Only scan these local files and directories on this host, and only check
+ * the videos in the database that are within them. Everything is scanned
+ * when the list is empty.
+ */
+void VideoScannerThread::SetScope(const QStringList &paths)
+{
+    m_scope.clear();
+    for (const auto& path : qAsConst(paths))
+    {
+        // A change within a DVD or Blu-ray structure is a change to the disc
+        QStringList parts = QDir::cleanPath(path).split('/');
+        for (int i = 2; i < parts.size(); ++i)
+        {
+            if (parts[i] == "VIDEO_TS" || parts[i] == "BDMV")
+            {
+                parts = parts.mid(0, i);
+                break;
+            }
+        }
+
+        QString scope = parts.join('/');
+        if (!scope.isEmpty() && !m_scope.contains(scope))
+            m_scope.append(scope);
+    }
+}
+
 void VideoScannerThread::SetDirs(QStringList dirs)
 {
     QString master = gCoreContext->GetMasterHostName().toLower();
@@ -178,33 +265,18 @@ void VideoScannerThread::run()
         imageExtensions.push_back(QString(*p));
     }
 
-    LOG(VB_GENERAL, LOG_INFO, QString("Beginning Video Scan."));
-
-    uint counter = 0;
     FileCheckList fs_files;
 
-    if (m_hasGUI)
-        SendProgressEvent(counter, (uint)m_directories.size(),
-                          tr("Searching for video files"));
-    for (QStringList::const_iterator iter = m_directories.begin();
-         iter != m_directories.end(); ++iter)
+    if (m_scope.isEmpty())
     {
-        if (!buildFileList(*iter, imageExtensions, fs_files))
-        {
-            if (iter->startsWith("myth://"))
-            {
-                QUrl sgurl = *iter;
-                QString host = sgurl.host().toLower();
-                QString path = sgurl.path();
-
-                m_liveSGHosts.removeAll(host);
-
-                LOG(VB_GENERAL, LOG_ERR,
-                    QString("Failed to scan :%1:").arg(*iter));
-            }
-        }
-        if (m_hasGUI)
-            SendProgressEvent(++counter);
+        LOG(VB_GENERAL, LOG_INFO, QString("Beginning Video Scan."));
+        buildFileLists(imageExtensions, fs_files);
+    }
+    else
+    {
+        LOG(VB_GENERAL, LOG_INFO, QString("Beginning Video Scan of %1 "
+                                          "changed paths.").arg(m_scope.size()));
+        buildScopeFileList(imageExtensions, fs_files);
     }
 
     PurgeList db_remove;
@@ -269,7 +341,7 @@ void VideoScannerThread::verifyFiles(FileCheckList &files,
     {
         QString lname = file->GetFilename();
         QString lhost = file->GetHost().toLower();
-        if (!lname.isEmpty())
+        if (!lname.isEmpty() && isInScope(lname, lhost))
         {
             iter = files.find(lname);
             if (iter != files.end())
@@ -322,15 +394,51 @@ bool VideoScannerThread::updateDB(const FileCheckList &add, const PurgeList &rem
         SendProgressEvent(counter, (uint)(add.size() + remove.size()),
                           tr("Updating video database"));
 
+    // add files not already in the DB
+    bool failed = false;
+    std::vector<FileCheckList::const_iterator> newFiles;
     for (auto p = add.cbegin(); p != add.cend(); ++p)
     {
-        // add files not already in the DB
         if (!p->second.check)
+            newFiles.push_back(p);
+        else if (m_hasGUI)
+            SendProgressEvent(++counter);
+    }
+
+    for (size_t batch = 0; batch < newFiles.size(); batch += kBatchSize)
+    {
+        size_t batchEnd = std::min(newFiles.size(), batch + kBatchSize);
+
+        // Read the files of the batch at the same time
+        std::vector<QString> hashes(batchEnd - batch);
+        for (size_t i = batch; i < batchEnd; ++i)
+        {
+            auto p = newFiles[i];
+            QString *hash = &hashes[i - batch];
+            m_pool->start(new VideoScannerTask([p, hash]()
+                { *hash = VideoMetadata::VideoFileHash(p->first, p->second.host); }),
+                "VideoFileHash");
+        }
+        m_pool->waitForDone();
+
+        // This holds the thread's connection until the batch is done, so the
+        // queries made by VideoMetadata all run inside the one transaction
+        MSqlQuery transaction(MSqlQuery::InitCon());
+        if (!transaction.transaction())
         {
+            failed = true;
+            break;
+        }
+
+        int added = m_addList.size();
+        int moved = m_movList.size();
+        for (size_t i = batch; i < batchEnd; ++i)
+        {
+            auto p = newFiles[i];
+            const QString &hash = hashes[i - batch];
             int id = -1;
 
             // Are we sure this needs adding?  Let's check our Hash list.
-            QString hash = VideoMetadata::VideoFileHash(p->first, p->second.host);
             if (hash != "NULL" && !hash.isEmpty())
             {
                 id = VideoMetadata::UpdateHashedDBRecord(hash, p->first, p->second.host);
@@ -374,22 +482,57 @@ bool VideoScannerThread::updateDB(const FileCheckList &add, const PurgeList &rem
                 m_addList << newFile.GetID();
             }
             ret += 1;
+            if (m_hasGUI)
+                SendProgressEvent(++counter);
         }
-        if (m_hasGUI)
-            SendProgressEvent(++counter);
+
+        // Any failed query rolls back the whole batch
+        if (!transaction.commit())
+        {
+            m_addList.erase(m_addList.begin() + added, m_addList.end());
+            m_movList.erase(m_movList.begin() + moved, m_movList.end());
+            failed = true;
+            break;
+        }
+    }
+
+    // A file that failed to be added may be the new name of one that has
+    // gone, so leave everything to be tried again by the next scan
+    if (failed)
+    {
+        LOG(VB_GENERAL, LOG_ERR, "Failed to add new videos, not removing "
+                                 "missing ones until the next scan");
+        return ret > 0;
     }
 
     // When prompting is restored, account for the answer here.
     ret += remove.size();
-    for (const auto & item : remove)
+    if (!remove.empty())
     {
-        if (!m_movList.contains(item.first))
+        MSqlQuery transaction(MSqlQuery::InitCon());
+        if (!transaction.transaction())
         {
-            removeOrphans(item.first, item.second);
-            m_delList << item.first;
+            LOG(VB_GENERAL, LOG_ERR, "Failed to remove missing videos");
+            return ret > 0;
+        }
+
+        int deleted = m_delList.size();
+        for (const auto & item : remove)
+        {
+            if (!m_movList.contains(item.first))
+            {
+                removeOrphans(item.first, item.second);
+                m_delList << item.first;
+            }
+            if (m_hasGUI)
+                SendProgressEvent(++counter);
+        }
+
+        if (!transaction.commit())
+        {
+            LOG(VB_GENERAL, LOG_ERR, "Failed to remove missing videos");
+            m_delList.erase(m_delList.begin() + deleted, m_delList.end());
         }
-        if (m_hasGUI)
-            SendProgressEvent(++counter);
     }
 
     return ret > 0;
@@ -414,6 +557,129 @@ bool VideoScannerThread::buildFileList(const QString &directory,
     return ScanVideoDirectory(directory, &dh, ext_list, m_listUnknown);
 }
 
+/*
+ * The directories on a host are listed one after the other, as each is a
+ * file list request to that host's backend, but the hosts, and the local
+ * directories, are listed at the same time.
+ */
+void VideoScannerThread::buildFileLists(const QStringList &imageExtensions,
+                                        FileCheckList &filelist)
+{
+    struct DirectoryScan
+    {
+        FileCheckList files;
+        bool          ok {false};
+    };
+    std::vector<DirectoryScan> scans(m_directories.size());
+
+    QMap<QString, QList<int> > hostDirs;
+    for (int i = 0; i < m_directories.size(); ++i)
+    {
+        const QString &dir = m_directories[i];
+        hostDirs[dir.startsWith("myth://") ? QUrl(dir).host().toLower()
+                                           : QString()] << i;
+    }
+
+    std::atomic<uint> counter {0};
+    if (m_hasGUI)
+        SendProgressEvent(0, (uint)m_directories.size(),
+                          tr("Searching for video files"));
+
+    for (const auto & dirs : qAsConst(hostDirs))
+    {
+        m_pool->start(new VideoScannerTask(
+            [this, dirs, &scans, &imageExtensions, &counter]()
+            {
+                for (int i : dirs)
+                {
+                    scans[i].ok = buildFileList(m_directories[i], imageExtensions,
+                                                scans[i].files);
+                    if (m_hasGUI)
+                        SendProgressEvent(++counter);
+                }
+            }), "VideoScanHost");
+    }
+    m_pool->waitForDone();
+
+    for (int i = 0; i < m_directories.size(); ++i)
+    {
+        const QString &dir = m_directories[i];
+        if (!scans[i].ok && dir.startsWith("myth://"))
+        {
+            QUrl sgurl = dir;
+            m_liveSGHosts.removeAll(sgurl.host().toLower());
+
+            LOG(VB_GENERAL, LOG_ERR,
+                QString("Failed to scan :%1:").arg(dir));
+        }
+
+        // A later directory wins, as when they were listed one at a time
+        for (const auto & file : scans[i].files)
+            filelist[file.first] = file.second;
+    }
+}
+
+/*
+ * Lists the changed files and directories set by SetScope, each within the
+ * first of this host's video directories that holds it.
+ */
+void VideoScannerThread::buildScopeFileList(const QStringList &imageExtensions,
+                                            FileCheckList &filelist)
+{
+    FileAssociations::ext_ignore_list ext_list;
+    FileAssociations::getFileAssociation().getExtensionIgnoreList(ext_list);
+    dirhandler<FileCheckList> dh(filelist, imageExtensions);
+
+    QStringList startPaths;
+    m_scopeRoots.clear();
+    for (const auto & dir : qAsConst(m_directories))
+    {
+        QString root = LocalVideoDir(dir);
+        if (!root.isEmpty() && !m_scopeRoots.contains(root))
+        {
+            m_scopeRoots << root;
+            startPaths << dir;
+        }
+    }
+
+    uint counter = 0;
+    if (m_hasGUI)
+        SendProgressEvent(counter, (uint)m_scope.size(),
+                          tr("Searching for video files"));
+
+    for (const auto & path : qAsConst(m_scope))
+    {
+        for (int i = 0; i < m_scopeRoots.size(); ++i)
+        {
+            if (InScope(path, QStringList(m_scopeRoots[i])))
+            {
+                ScanVideoPath(startPaths[i], path, &dh, ext_list, m_listUnknown);
+                break;
+            }
+        }
+        if (m_hasGUI)
+            SendProgressEvent(++counter);
+    }
+}
+
+/// Is a video in the database within the paths set by SetScope
+bool VideoScannerThread::isInScope(const QString &filename,
+                                   const QString &host) const
+{
+    if (m_scope.isEmpty())
+        return true;
+
+    if (host.isEmpty())
+        return InScope(filename, m_scope);
+
+    if (host != gCoreContext->GetHostName().toLower())
+        return false;
+
+    return std::any_of(m_scopeRoots.cbegin(), m_scopeRoots.cend(),
+                       [this, &filename](const QString &root)
+                       { return InScope(root + '/' + filename, m_scope); });
+}
+
 void VideoScannerThread::SendProgressEvent(uint progress, uint total,
                                            QString messsage)
 {
@@ -497,3 +763,169 @@ void VideoScanner::finishedScan()
 }
 
 ////////////////////////////////////////////////////////////////////////
+
+#ifdef __linux__
+static constexpr uint32_t kWatchMask { IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM |
+                                       IN_DELETE | IN_CREATE };
+// Wait for the changes to stop for kWatchDelay (ms) before passing them on,
+// but don't put off a busy directory for longer than kWatchMaxDelay (ms).
+// Look for Stop() every kWatchPoll (ms).
+static constexpr int kWatchDelay    { 5000 };
+static constexpr int kWatchMaxDelay { 60000 };
+static constexpr int kWatchPoll     { 1000 };
+
+/// Watch a directory and all the directories below it
+static void AddWatches(int fd, const QString &directory, QHash<int, QString> &watches)
+{
+    int wd = inotify_add_watch(fd, QFile::encodeName(directory).constData(),
+                               kWatchMask | IN_ONLYDIR);
+    if (wd < 0)
+    {
+        LOG(VB_GENERAL, LOG_WARNING,
+            QString("VideoScanWatcher: Can't watch '%1'").arg(directory) + ENO);
+        return;
+    }
+    watches[wd] = directory;
+
+    // Symlinked directories could loop or lead out of the storage group
+    QDir d(directory);
+    const QStringList dirs = d.entryList(QDir::Dirs | QDir::NoDotAndDotDot |
+                                         QDir::NoSymLinks);
+    for (const auto & dir : dirs)
+        AddWatches(fd, directory + '/' + dir, watches);
+}
+#endif
+
+/*
+ * Only the files and directories that change are passed on to be scanned.
+ * inotify only sees changes made by this machine, so changes made to a
+ * network share by another machine still need a full scan.
+ */
+void VideoScanWatcher::run()
+{
+    RunProlog();
+
+#ifdef __linux__
+    int fd = inotify_init1(IN_CLOEXEC);
+    if (fd < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "VideoScanWatcher: Failed to start watching for changes" + ENO);
+        RunEpilog();
+        return;
+    }
+
+    QStringList roots;
+    QHash<int, QString> watches;
+    const QStringList dirs = GetVideoDirs();
+    for (const auto & dir : dirs)
+    {
+        QString root = LocalVideoDir(dir);
+        if (!root.isEmpty() && !roots.contains(root))
+        {
+            roots << root;
+            AddWatches(fd, root, watches);
+        }
+    }
+
+    LOG(VB_GENERAL, LOG_INFO,
+        QString("VideoScanWatcher: Watching %1 directories for changes. "
+                "Changes made to network shares by other machines won't be seen.")
+            .arg(watches.size()));
+
+    QSet<QString> changed;
+    bool rescan = false;
+    QElapsedTimer pending;
+    QElapsedTimer quiet;
+    alignas(struct inotify_event) std::array<char,4096> buffer {};
+
+    while (!m_stop)
+    {
+        if ((rescan || !changed.isEmpty()) &&
+            (quiet.elapsed() >= kWatchDelay || pending.elapsed() >= kWatchMaxDelay))
+        {
+            QStringList paths = changed.values();
+            if (rescan)
+            {
+                // Some changes were missed, so look at everything
+                LOG(VB_GENERAL, LOG_INFO, "VideoScanWatcher: Missed some changes");
+                paths = roots;
+                for (const auto & root : qAsConst(roots))
+                    AddWatches(fd, root, watches);
+            }
+            QCoreApplication::postEvent(m_parent, new VideoScanPaths(paths));
+
+            changed.clear();
+            rescan = false;
+        }
+
+        pollfd pfd { fd, POLLIN, 0 };
+        int ret = poll(&pfd, 1, kWatchPoll);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            LOG(VB_GENERAL, LOG_ERR,
+                "VideoScanWatcher: Failed to wait for changes" + ENO);
+            break;
+        }
+        if (ret == 0)
+            continue;
+
+        ssize_t len = read(fd, buffer.data(), buffer.size());
+        if (len < 0 && errno == EINTR)
+            continue;
+        if (len <= 0)
+        {
+            LOG(VB_GENERAL, LOG_ERR,
+                "VideoScanWatcher: Failed to read changes" + ENO);
+            break;
+        }
+
+        if (!rescan && changed.isEmpty())
+            pending.start();
+        quiet.start();
+
+        for (ssize_t pos = 0; pos < len; )
+        {
+            const auto *event = reinterpret_cast<const struct inotify_event *>(buffer.data() + pos);
+            pos += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                rescan = true;
+                continue;
+            }
+            if (event->mask & IN_IGNORED)
+            {
+                watches.remove(event->wd);
+                continue;
+            }
+
+            QString path = watches.value(event->wd);
+            if (path.isEmpty() || event->len == 0)
+                continue;
+            path += '/' + QFile::decodeName(event->name);
+
+            if (event->mask & IN_ISDIR)
+            {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    AddWatches(fd, path, watches);
+                changed.insert(path);
+            }
+            // A new file is scanned once it has been written and closed
+            else if (!(event->mask & IN_CREATE))
+            {
+                changed.insert(path);
+            }
+        }
+    }
+
+    close(fd);
+#else
+    LOG(VB_GENERAL, LOG_ERR,
+        "VideoScanWatcher: Watching for changes is only supported on Linux");
+#endif
+
+    RunEpilog();
+}
@@ -1,6 +1,7 @@
 #ifndef VIDEO_SCANNER_H
 #define VIDEO_SCANNER_H
 
+#include <atomic>
 #include <map>
 #include <set>
 #include <utility>
@@ -17,6 +18,7 @@
 #include "mthread.h"
 #include "mythprogressdialog.h"
 
+class MThreadPool;
 class VideoMetadataListManager;
 
 class META_PUBLIC VideoScanner : public QObject
@@ -57,6 +59,18 @@ class META_PUBLIC VideoScanChanges : public QEvent
     static Type kEventType;
 };
 
+class META_PUBLIC VideoScanPaths : public QEvent
+{
+  public:
+    explicit VideoScanPaths(QStringList paths) : QEvent(kEventType),
+                     m_paths(std::move(paths)) {}
+    ~VideoScanPaths() override = default;
+
+    QStringList m_paths; // changed local files and directories
+
+    static Type kEventType;
+};
+
 class META_PUBLIC VideoScannerThread : public MThread
 {
     Q_DECLARE_TR_FUNCTIONS(VideoScannerThread);
@@ -68,12 +82,16 @@ class META_PUBLIC VideoScannerThread : public MThread
     void run() override; // MThread
     void SetDirs(QStringList dirs);
     void SetHosts(const QStringList &hosts);
+    void SetScope(const QStringList &paths);
     void SetProgressDialog(MythUIProgressDialog *dialog) { m_dialog = dialog; };
     QStringList GetOfflineSGHosts(void) { return m_offlineSGHosts; };
     bool getDataChanged() const { return m_dbDataChanged; };
 
     void ResetCounts() { m_addList.clear(); m_movList.clear(); m_delList.clear(); };
 
+    // New files hashed, then added to the database, at a time
+    static constexpr size_t kBatchSize { 64 };
+
   private:
 
     struct CheckStruct
@@ -92,6 +110,11 @@ class META_PUBLIC VideoScannerThread : public MThread
     bool buildFileList(const QString &directory,
                                         const QStringList &imageExtensions,
                                         FileCheckList &filelist) const;
+    void buildFileLists(const QStringList &imageExtensions,
+                        FileCheckList &filelist);
+    void buildScopeFileList(const QStringList &imageExtensions,
+                            FileCheckList &filelist);
+    bool isInScope(const QString &filename, const QString &host) const;
 
     void SendProgressEvent(uint progress, uint total = 0,
             QString messsage = QString());
@@ -105,6 +128,10 @@ class META_PUBLIC VideoScannerThread : public MThread
     QStringList m_directories;
     QStringList m_liveSGHosts;
     QStringList m_offlineSGHosts;
+    QStringList m_scope;      // changed paths on this host, all when empty
+    QStringList m_scopeRoots; // this host's video directories
+
+    MThreadPool              *m_pool       {nullptr};
 
     VideoMetadataListManager *m_dbMetadata {nullptr};
     MythUIProgressDialog     *m_dialog     {nullptr};
@@ -115,4 +142,20 @@ class META_PUBLIC VideoScannerThread : public MThread
     bool m_dbDataChanged {false};
 };
 
+/// Watches this host's video directories, and posts a VideoScanPaths
+/// event listing what changed to its parent
+class META_PUBLIC VideoScanWatcher : public MThread
+{
+  public:
+    explicit VideoScanWatcher(QObject *parent) :
+        MThread("VideoScanWatcher"), m_parent(parent) {}
+
+    void run() override; // MThread
+    void Stop() { m_stop = true; }
+
+  private:
+    QObject          *m_parent {nullptr};
+    std::atomic<bool> m_stop   {false};
+};
+
 #endif
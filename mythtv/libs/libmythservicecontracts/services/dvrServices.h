@@ -39,13 +39,17 @@
 //    type.  Defaults to "BOTH", available values:
 //          "GET", "POST" or "BOTH"
 //
+//  * Q_CLASSINFO( "<methodName>_Cache", ...) lists the data generations
+//    ("Guide", "Schedule", "Recordings") a read only method's result depends
+//    on, so the response can be cached until one of them changes.
+//
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
 class SERVICE_PUBLIC DvrServices : public Service  //, public QScriptable ???
 {
     Q_OBJECT
-    Q_CLASSINFO( "version"    , "6.7" )
+    Q_CLASSINFO( "version"    , "6.8" )
     Q_CLASSINFO( "RemoveRecorded_Method",                       "POST" )
     Q_CLASSINFO( "DeleteRecording_Method",                      "POST" )
     Q_CLASSINFO( "UnDeleteRecording",                           "POST" )
@@ -58,6 +62,14 @@ class SERVICE_PUBLIC DvrServices : public Service  //, public QScriptable ???
     Q_CLASSINFO( "EnableRecordSchedule_Method",                 "POST" )
     Q_CLASSINFO( "DisableRecordSchedule_Method",                "POST" )
     Q_CLASSINFO( "ManageJobQueue_Method",                       "POST" )
+    Q_CLASSINFO( "GetRecordedList_Cache",                       "Recordings" )
+    Q_CLASSINFO( "GetExpiringList_Cache",                       "Recordings" )
+    Q_CLASSINFO( "GetRecGroupList_Cache",                       "Recordings" )
+    Q_CLASSINFO( "GetTitleList_Cache",                          "Recordings" )
+    Q_CLASSINFO( "GetTitleInfoList_Cache",                      "Recordings" )
+    Q_CLASSINFO( "GetUpcomingList_Cache",                       "Schedule" )
+    Q_CLASSINFO( "GetConflictList_Cache",                       "Schedule" )
+    Q_CLASSINFO( "GetRecordScheduleList_Cache",                 "Schedule" )
 
 
     public:
@@ -88,7 +100,8 @@ class SERVICE_PUBLIC DvrServices : public Service  //, public QScriptable ???
                                                            const QString   &RecGroup,
                                                            const QString   &StorageGroup,
                                                            const QString   &Category,
-                                                           const QString   &Sort) = 0;
+                                                           const QString   &Sort,
+                                                           int              AfterRecordedId) = 0;
 
         virtual DTC::ProgramList* GetOldRecordedList     ( bool             Descending,
                                                            int              StartIndex,
@@ -34,6 +34,10 @@
 //    type.  Defaults to "BOTH", available values:
 //          "GET", "POST" or "BOTH"
 //
+//  * Q_CLASSINFO( "<methodName>_Cache", ...) lists the data generations
+//    ("Guide", "Schedule", "Recordings") a read only method's result depends
+//    on, so the response can be cached until one of them changes.
+//
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 
@@ -43,6 +47,10 @@ class SERVICE_PUBLIC GuideServices : public Service  //, public QScriptable ???
     Q_CLASSINFO( "version"    , "2.4" )
     Q_CLASSINFO( "AddToChannelGroup_Method",                     "POST" )
     Q_CLASSINFO( "RemoveFromChannelGroup_Method",                "POST" )
+    Q_CLASSINFO( "GetProgramGuide_Cache",                        "Guide,Schedule" )
+    Q_CLASSINFO( "GetProgramList_Cache",                         "Guide,Schedule" )
+    Q_CLASSINFO( "GetProgramDetails_Cache",                      "Guide,Schedule" )
+    Q_CLASSINFO( "GetCategoryList_Cache",                        "Guide" )
 
     public:
 
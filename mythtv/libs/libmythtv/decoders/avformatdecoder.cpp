@@ -2729,20 +2729,54 @@ void AvFormatDecoder::RemoveAudioStreams()
     }
 }
 
+static bool is_direct_render_format(VideoFrameType* Supported, VideoFrameType Type)
+{
+    while (Supported && (*Supported != FMT_NONE))
+    {
+        if (*Supported == Type)
+            return true;
+        Supported++;
+    }
+    return false;
+}
+
+/*! \brief Allocate AVFrame buffers directly from the player's VideoBuffers pool.
+ *
+ * Software decoders then decode straight into the memory that is used for
+ * display and no copy is required. The VideoFrame is returned to the pool
+ * (via DeLimboFrame) when the last reference to the AVBufferRef is released.
+ *
+ * If the format cannot be displayed directly or our frame layout does not
+ * meet the decoder's stride requirements, FFmpeg allocates the buffer and
+ * the decoded frame is copied/converted in ProcessVideoFrame.
+*/
 int get_avf_buffer(struct AVCodecContext *c, AVFrame *pic, int flags)
 {
     auto *decoder = static_cast<AvFormatDecoder*>(c->opaque);
     VideoFrameType type = PixelFormatToFrameType(c->pix_fmt);
-    VideoFrameType* supported = decoder->GetPlayer()->DirectRenderFormats();
-    bool found = false;
-    while (*supported != FMT_NONE)
-    {
-        if (*supported == type)
-        {
-            found = true;
-            break;
+    bool found = is_direct_render_format(decoder->GetPlayer()->DirectRenderFormats(), type);
+
+    if (found)
+    {
+        // Our buffers are allocated with MYTH_WIDTH_ALIGNMENT. Check that the
+        // resulting pitches meet the decoder's requirements.
+        int alignedwidth  = pic->width;
+        int alignedheight = pic->height;
+        int linesizealign[AV_NUM_DATA_POINTERS] { 0 };
+        avcodec_align_dimensions2(c, &alignedwidth, &alignedheight, linesizealign);
+        int mythwidth = (pic->width + MYTH_WIDTH_ALIGNMENT - 1) & ~(MYTH_WIDTH_ALIGNMENT - 1);
+        uint count = planes(type);
+        for (uint plane = 0; found && (plane < count); ++plane)
+        {
+            int pitch = pitch_for_plane(type, mythwidth, plane);
+            if (linesizealign[plane] > 0 && (pitch % linesizealign[plane]))
+            {
+                LOG(VB_PLAYBACK, LOG_WARNING, LOC + QString("Plane %1 pitch %2 does not meet "
+                    "decoder alignment %3 - disabling direct rendering")
+                    .arg(plane).arg(pitch).arg(linesizealign[plane]));
+                found = false;
+            }
         }
-        supported++;
     }
 
     if (!found)
@@ -2755,6 +2789,7 @@ int get_avf_buffer(struct AVCodecContext *c, AVFrame *pic, int flags)
     VideoFrame *frame = decoder->GetPlayer()->GetNextVideoFrame();
     if (!frame)
         return -1;
+    decoder->AddDirectFrame();
 
     // We pre-allocate frames to certain alignments. If the coded size differs from
     // those alignments then re-allocate the frame. Changes in frame type (e.g.
@@ -3639,32 +3674,60 @@ bool AvFormatDecoder::ProcessVideoFrame(AVStream *Stream, AVFrame *AvFrame)
         frame = m_parent->GetNextVideoFrame();
         frame->directrendering = false;
 
+        // N.B. Hardware contexts account for any copy back themselves
         if (!m_mythCodecCtx->RetrieveFrame(context, frame, AvFrame))
         {
-            AVFrame tmppicture;
-            av_image_fill_arrays(tmppicture.data, tmppicture.linesize,
-                                 frame->buf, AV_PIX_FMT_YUV420P, AvFrame->width,
-                                 AvFrame->height, IMAGE_ALIGN);
-            tmppicture.data[0] = frame->buf + frame->offsets[0];
-            tmppicture.data[1] = frame->buf + frame->offsets[1];
-            tmppicture.data[2] = frame->buf + frame->offsets[2];
-            tmppicture.linesize[0] = frame->pitches[0];
-            tmppicture.linesize[1] = frame->pitches[1];
-            tmppicture.linesize[2] = frame->pitches[2];
-
-            QSize dim = get_video_dim(*context);
-            m_swsCtx = sws_getCachedContext(m_swsCtx, AvFrame->width,
-                                        AvFrame->height, static_cast<AVPixelFormat>(AvFrame->format),
-                                        AvFrame->width, AvFrame->height,
-                                        AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR,
-                                        nullptr, nullptr, nullptr);
-            if (!m_swsCtx)
+            VideoFrameType type = PixelFormatToFrameType(static_cast<AVPixelFormat>(AvFrame->format));
+            if (!is_direct_render_format(m_parent->DirectRenderFormats(), type))
+                type = FMT_YV12;
+            if ((frame->codec != type) || (frame->width != AvFrame->width) ||
+                (frame->height != AvFrame->height))
             {
-                LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to allocate sws context");
-                return false;
+                if (!VideoBuffers::ReinitBuffer(frame, type, m_videoCodecId, AvFrame->width, AvFrame->height))
+                    return false;
+            }
+
+            if (FrameTypeToPixelFormat(type) == AvFrame->format)
+            {
+                // The display supports this format but the decoder used its own
+                // buffers - copy rather than convert.
+                uint count = planes(type);
+                for (uint plane = 0; plane < count; ++plane)
+                {
+                    copyplane(frame->buf + frame->offsets[plane], frame->pitches[plane],
+                              AvFrame->data[plane], AvFrame->linesize[plane],
+                              pitch_for_plane(type, AvFrame->width, plane),
+                              height_for_plane(type, AvFrame->height, plane));
+                }
+            }
+            else
+            {
+                AVFrame tmppicture;
+                av_image_fill_arrays(tmppicture.data, tmppicture.linesize,
+                                     frame->buf, AV_PIX_FMT_YUV420P, AvFrame->width,
+                                     AvFrame->height, IMAGE_ALIGN);
+                tmppicture.data[0] = frame->buf + frame->offsets[0];
+                tmppicture.data[1] = frame->buf + frame->offsets[1];
+                tmppicture.data[2] = frame->buf + frame->offsets[2];
+                tmppicture.linesize[0] = frame->pitches[0];
+                tmppicture.linesize[1] = frame->pitches[1];
+                tmppicture.linesize[2] = frame->pitches[2];
+
+                QSize dim = get_video_dim(*context);
+                m_swsCtx = sws_getCachedContext(m_swsCtx, AvFrame->width,
+                                            AvFrame->height, static_cast<AVPixelFormat>(AvFrame->format),
+                                            AvFrame->width, AvFrame->height,
+                                            AV_PIX_FMT_YUV420P, SWS_FAST_BILINEAR,
+                                            nullptr, nullptr, nullptr);
+                if (!m_swsCtx)
+                {
+                    LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to allocate sws context");
+                    return false;
+                }
+                sws_scale(m_swsCtx, AvFrame->data, AvFrame->linesize, 0, dim.height(),
+                          tmppicture.data, tmppicture.linesize);
             }
-            sws_scale(m_swsCtx, AvFrame->data, AvFrame->linesize, 0, dim.height(),
-                      tmppicture.data, tmppicture.linesize);
+            AddCopiedBytes(static_cast<quint64>(GetBufferSize(frame->codec, frame->width, frame->height)));
         }
 
         // Discard any old VideoFrames
@@ -1458,4 +1458,32 @@ AVPixelFormat DecoderBase::GetBestVideoFormat(AVPixelFormat* Formats)
     return AV_PIX_FMT_NONE;
 }
 
+/*! \brief Return the rate at which decoded video data is being copied.
+ *
+ * Frames that are decoded directly into VideoBuffers memory (direct rendering)
+ * are not counted. Anything that is copied or converted into a VideoFrame
+ * after decoding (software fallback, hardware frame copy back etc) is.
+ *
+ * Direct rendering is only reported when nothing was copied and frames were
+ * actually decoded into VideoBuffers memory. Otherwise (e.g. hardware decoding
+ * without copy back, or a paused decoder) an idle rate is shown.
+ *
+ * \note The rate is measured since the last call, so this should only be called
+ * from one place (the playback OSD debug info).
+*/
+QString DecoderBase::GetFrameCopyRate(void)
+{
+    quint64 bytes = m_copiedBytes.fetchAndStoreRelaxed(0);
+    quint64 direct = m_directFrames.fetchAndStoreRelaxed(0);
+    qint64 elapsed = m_copiedBytesTimer.isValid() ? m_copiedBytesTimer.restart() : 0;
+    if (!m_copiedBytesTimer.isValid())
+        m_copiedBytesTimer.start();
+    if (elapsed <= 0)
+        return QString();
+    if (bytes == 0 && direct > 0)
+        return QObject::tr("None (direct rendering)");
+    double rate = static_cast<double>(bytes) * 1000.0 / (elapsed * 1024.0 * 1024.0);
+    return QObject::tr("%1 MB/s").arg(rate, 0, 'f', 1);
+}
+
 /* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -5,6 +5,9 @@
 #include <vector>
 using namespace std;
 
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+
 #include "io/mythmediabuffer.h"
 #include "remoteencoder.h"
 #include "mythcontext.h"
@@ -263,6 +266,9 @@ class DecoderBase
     MythCodecContext *GetMythCodecContext(void) { return m_mythCodecCtx; }
     VideoDisplayProfile * GetVideoDisplayProfile(void) { return &m_videoDisplayProfile; }
     AVPixelFormat GetBestVideoFormat(AVPixelFormat* Formats);
+    void          AddCopiedBytes(quint64 Bytes) { m_copiedBytes.fetchAndAddRelaxed(Bytes); }
+    void          AddDirectFrame(void) { m_directFrames.fetchAndAddRelaxed(1); }
+    QString       GetFrameCopyRate(void);
 
   protected:
     virtual int  AutoSelectTrack(uint Type);
@@ -357,5 +363,11 @@ class DecoderBase
     vector<int>          m_languagePreference;
     MythCodecContext    *m_mythCodecCtx         { nullptr };
     VideoDisplayProfile  m_videoDisplayProfile;
+
+    /// Video frame data copied (rather than directly rendered) since last checked
+    QAtomicInteger<quint64> m_copiedBytes       { 0 };
+    /// Video frames decoded directly into VideoBuffers memory since last checked
+    QAtomicInteger<quint64> m_directFrames      { 0 };
+    QElapsedTimer        m_copiedBytesTimer;
 };
 #endif
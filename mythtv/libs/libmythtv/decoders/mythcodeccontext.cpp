@@ -645,8 +645,12 @@ bool MythCodecContext::RetrieveHWFrame(VideoFrame *Frame, AVFrame *AvFrame)
 
     // retrieve data from GPU to CPU
     if (ret >= 0)
+    {
         if ((ret = av_hwframe_transfer_data(temp, AvFrame, 0)) < 0)
             LOG(VB_GENERAL, LOG_ERR, LOC + QString("Error %1 transferring the data to system memory").arg(ret));
+        else
+            m_parent->AddCopiedBytes(static_cast<quint64>(GetBufferSize(Frame->codec, Frame->width, Frame->height)));
+    }
 
     Frame->colorshifted = true;
     av_frame_free(&temp);
@@ -205,6 +205,7 @@ bool MythMMALContext::GetBuffer(AVCodecContext *Context, VideoFrame *Frame, AVFr
     for (uint plane = 0; plane < count; ++plane)
         copyplane(Frame->buf + Frame->offsets[plane], Frame->pitches[plane], AvFrame->data[plane], AvFrame->linesize[plane],
                   pitch_for_plane(Frame->codec, AvFrame->width, plane), height_for_plane(Frame->codec, AvFrame->height, plane));
+    decoder->AddCopiedBytes(static_cast<quint64>(GetBufferSize(Frame->codec, Frame->width, Frame->height)));
 
     AvFrame->reordered_opaque = Context->reordered_opaque;
     return true;
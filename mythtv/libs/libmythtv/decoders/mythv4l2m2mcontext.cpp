@@ -211,6 +211,7 @@ bool MythV4L2M2MContext::GetBuffer(AVCodecContext *Context, VideoFrame *Frame, A
     for (uint plane = 0; plane < count; ++plane)
         copyplane(Frame->buf + Frame->offsets[plane], Frame->pitches[plane], AvFrame->data[plane], AvFrame->linesize[plane],
                   pitch_for_plane(Frame->codec, AvFrame->width, plane), height_for_plane(Frame->codec, AvFrame->height, plane));
+    decoder->AddCopiedBytes(static_cast<quint64>(GetBufferSize(Frame->codec, Frame->width, Frame->height)));
 
     return true;
 }
@@ -221,6 +221,12 @@ MythMediaBuffer::MythMediaBuffer(MythBufferType Type)
         s_subExtNoCheck += ".png";
     }
     s_subExtLock.unlock();
+
+    if (gCoreContext)
+    {
+        int cap = gCoreContext->GetNumSetting("ReadAheadBufferCap", DEFAULT_BUFFER_SIZE_CAP);
+        m_bufferSizeCap = static_cast<uint>(max(cap, BUFFER_SIZE_MINIMUM >> 20)) << 20;
+    }
 }
 
 MythBufferType MythMediaBuffer::GetType(void) const
@@ -362,6 +368,9 @@ void MythMediaBuffer::SetBufferSizeFactors(bool EstBitrate, bool Matroska)
  *  \brief Calculates m_fillMin, m_fillThreshold, and m_readBlockSize
  *         from the estimated effective bitrate of the stream.
  *
+ *  Once the read ahead thread has measured the actual consumption rate and
+ *  storage latency, these take precedence over the estimate when larger.
+ *
  *  \warning Must be called with rwlock in write lock state.
  *
  */
@@ -387,7 +396,9 @@ void MythMediaBuffer::CalcReadAheadThresh(void)
 
     estbitrate     = static_cast<uint>(max(abs(m_rawBitrate * m_playSpeed), 0.5F * m_rawBitrate));
     estbitrate     = min(m_rawBitrate * 3, estbitrate);
-    int const rbs  = (estbitrate > 18000) ? KB512 :
+    // allow 25% headroom over the measured rate (Kb)
+    estbitrate     = max(estbitrate, static_cast<uint>(m_consumeRate / 100));
+    int rbs        = (estbitrate > 18000) ? KB512 :
                      (estbitrate >  9000) ? KB256 :
                      (estbitrate >  5000) ? KB128 :
                      (estbitrate >  2500) ? KB64  :
@@ -395,13 +406,17 @@ void MythMediaBuffer::CalcReadAheadThresh(void)
                      (estbitrate >=  500) ? KB16  :
                      (estbitrate >   250) ? KB8   :
                      (estbitrate >   125) ? KB4   : KB2;
+    // each request should cover at least two storage round trips
+    auto latencyblock = static_cast<int>(m_consumeRate * static_cast<uint64_t>(m_readLatency) / 500);
+    latencyblock = ((latencyblock + DEFAULT_CHUNK_SIZE - 1) / DEFAULT_CHUNK_SIZE) * DEFAULT_CHUNK_SIZE;
+    rbs = min(max(rbs, latencyblock), MaxReadBlockSize());
     if (rbs < DEFAULT_CHUNK_SIZE)
         m_readBlockSize = rbs;
     else
         m_readBlockSize = m_bitrateInitialized ? max(rbs, m_readBlockSize) : rbs;
 
     // minimum seconds of buffering before allowing read
-    float secs_min = 0.3F;
+    float secs_min = max(0.3F, static_cast<float>(m_readLatency) / 500.0F);
     // set the minimum buffering before allowing ffmpeg read
     m_fillMin = static_cast<int>((estbitrate * 1000 * secs_min) * 0.125F);
     // make this a multiple of ffmpeg block size..
@@ -610,6 +625,7 @@ void MythMediaBuffer::ResetReadAhead(long long NewInternal)
     m_readsDesired    = false;
     m_recentSeek      = true;
     m_setSwitchToNext = false;
+    m_prefetch        = true;
 
     m_generalWait.wakeAll();
 
@@ -806,6 +822,12 @@ void MythMediaBuffer::CreateReadAheadBuffer(void)
             newsize *= BUFFER_FACTOR_BITRATE;
     }
 
+    // grow to suit the measured consumption rate (rounded up to 1MB)
+    uint wanted = (m_bufferSizeWanted + (1 << 20) - 1) & ~((1U << 20) - 1);
+    wanted = min(wanted, m_bufferSizeCap);
+    if (m_bufferSizeWanted && (wanted > newsize))
+        newsize = wanted;
+
     // N.B. Don't try and make it smaller - bad things happen...
     if (m_readAheadBuffer && (oldsize >= newsize))
     {
@@ -851,6 +873,9 @@ void MythMediaBuffer::run(void)
 
     gettimeofday(&lastread, nullptr); // this is just to keep gcc happy
 
+    MythTimer adaptTimer;
+    adaptTimer.start();
+
     CreateReadAheadBuffer();
     m_rwLock.lockForWrite();
     m_posLock.lockForWrite();
@@ -893,6 +918,9 @@ void MythMediaBuffer::run(void)
             continue;
         }
 
+        if (adaptTimer.elapsed() >= 1000)
+            AdaptReadAhead(adaptTimer.restart());
+
         long long totfree = ReadBufFree();
 
         const uint KB32  = 32*1024;
@@ -939,16 +967,16 @@ void MythMediaBuffer::run(void)
                                     (now.tv_usec - lastread.tv_usec) / 1000;
                 readTimeAvg = (readTimeAvg * 9 + readinterval) / 10;
 
+                int maxblocksize = MaxReadBlockSize();
                 if (readTimeAvg < 150 &&
-                    static_cast<uint>(m_readBlockSize) < (BUFFER_SIZE_MINIMUM >>2) &&
                     m_readBlockSize >= DEFAULT_CHUNK_SIZE /* low_buffers */ &&
-                    m_readBlockSize <= KB512)
+                    m_readBlockSize < maxblocksize)
                 {
                     int old_block_size = m_readBlockSize;
                     m_readBlockSize = 3 * m_readBlockSize / 2;
                     m_readBlockSize = ((m_readBlockSize+DEFAULT_CHUNK_SIZE-1) / DEFAULT_CHUNK_SIZE) * DEFAULT_CHUNK_SIZE;
-                    if (m_readBlockSize > KB512)
-                        m_readBlockSize = KB512;
+                    if (m_readBlockSize > maxblocksize)
+                        m_readBlockSize = maxblocksize;
                     LOG(VB_FILE, LOG_INFO, LOC + QString("Avg read interval was %1 msec. "
                                                          "%2K -> %3K block size")
                             .arg(readTimeAvg).arg(old_block_size/1024).arg(m_readBlockSize/1024));
@@ -974,10 +1002,13 @@ void MythMediaBuffer::run(void)
                 LOG(VB_FILE, LOG_DEBUG, LOC + "Shrinking read, near end of buffer");
             }
 
-            if (m_internalReadPos == 0)
+            // After a seek, request everything needed to restart playback in
+            // one go rather than paying the storage latency for each block
+            if ((m_internalReadPos == 0 || m_prefetch) && (m_rbwPos == 0))
             {
                 totfree = max(m_fillMin, m_readBlockSize);
-                LOG(VB_FILE, LOG_DEBUG, LOC + "Reading enough data to start playback");
+                LOG(VB_FILE, LOG_DEBUG, LOC + QString("Reading %1K to start playback")
+                    .arg(totfree / 1024));
             }
 
             LOG(VB_FILE, LOG_DEBUG, LOC + QString("safe_read(...@%1, %2) -- begin")
@@ -1003,6 +1034,8 @@ void MythMediaBuffer::run(void)
                 .arg(QString("(%1Mbps)").arg(static_cast<double>(bps) / 1000000.0))
                 .arg(readTimeAvg));
             UpdateStorageRate(bps);
+            if (readResult > 0)
+                m_readLatency = m_readLatency ? (m_readLatency * 7 + sr_elapsed) / 8 : sr_elapsed;
 
             if (readResult >= 0)
             {
@@ -1011,6 +1044,7 @@ void MythMediaBuffer::run(void)
 
                 if (rbwposcopy == m_rbwPos)
                 {
+                    m_prefetch = false;
                     m_internalReadPos += readResult;
                     m_rbwPos = (m_rbwPos + readResult) % static_cast<int>(m_bufferSize);
                     LOG(VB_FILE, LOG_DEBUG, LOC + QString("rbwpos += %1K requested %2K in read")
@@ -1500,6 +1534,7 @@ int MythMediaBuffer::Read(void *Buffer, int Count)
         m_posLock.lockForWrite();
         m_readPos += ret;
         m_posLock.unlock();
+        m_consumedBytes.fetchAndAddRelaxed(static_cast<quint64>(ret));
         UpdateDecoderRate(static_cast<uint64_t>(ret));
     }
 
@@ -1564,6 +1599,77 @@ uint MythMediaBuffer::GetBufferSize(void) const
     return m_bufferSize;
 }
 
+/// \brief Return the playback time held in the buffer at the measured consumption rate.
+QString MythMediaBuffer::GetBufferHealth(void)
+{
+    if (m_type == kMythBufferDVD || m_type == kMythBufferBD)
+        return "N/A";
+
+    uint64_t rate = m_consumeRate;
+    if (!rate)
+        return "-";
+
+    int avail = (m_rbwPos >= m_rbrPos) ? m_rbwPos - m_rbrPos
+                                       : static_cast<int>(m_bufferSize) - m_rbrPos + m_rbwPos;
+    return QObject::tr("%1s (%2ms latency)")
+        .arg(static_cast<double>(avail) / static_cast<double>(rate), 0, 'f', 1)
+        .arg(m_readLatency);
+}
+
+/// \brief The largest single request the read ahead thread will make.
+int MythMediaBuffer::MaxReadBlockSize(void) const
+{
+    return static_cast<int>(min(m_bufferSize / 8, static_cast<uint>(READ_BLOCK_SIZE_MAXIMUM)));
+}
+
+/*! \brief Update the measured consumption rate and resize the read ahead to suit.
+ *
+ * Called roughly once a second by the read ahead thread. The buffer is grown
+ * to hold around four seconds of media at the measured rate (up to the
+ * ReadAheadBufferCap setting) and the read thresholds are recalculated
+ * whenever the rate changes by more than 25%.
+ *
+ * \warning Must be called with rwlock in read lock state.
+ * \param Elapsed Milliseconds since the last call.
+*/
+void MythMediaBuffer::AdaptReadAhead(int Elapsed)
+{
+    uint64_t consumed = m_consumedBytes.fetchAndStoreRelaxed(0);
+    // keep the last rate while the player is paused
+    if (Elapsed <= 0 || !consumed)
+        return;
+
+    uint64_t rate = consumed * 1000 / static_cast<uint64_t>(Elapsed);
+    uint64_t old  = m_consumeRate;
+    // react quickly to increases (e.g. after a seek) and slowly to decreases
+    m_consumeRate = (rate > old) ? (old + rate) / 2 : (old * 7 + rate) / 8;
+
+    if (old && (m_consumeRate < old * 5 / 4) && (m_consumeRate > old * 3 / 4))
+        return;
+
+    auto wanted = static_cast<uint>(min(m_consumeRate * 4, static_cast<uint64_t>(m_bufferSizeCap)));
+    bool grow = wanted > m_bufferSize;
+
+    LOG(VB_FILE, LOG_INFO, LOC + QString("Consumption %1 storage latency %2ms%3")
+        .arg(BitrateToString(m_consumeRate * 8)).arg(m_readLatency)
+        .arg(grow ? QString(" - growing buffer to %1Mb").arg((wanted >> 20) + 1) : ""));
+
+    m_rwLock.unlock();
+    if (grow)
+    {
+        m_bufferSizeWanted = wanted;
+        // N.B. this also recalculates the thresholds
+        CreateReadAheadBuffer();
+    }
+    else
+    {
+        m_rwLock.lockForWrite();
+        CalcReadAheadThresh();
+        m_rwLock.unlock();
+    }
+    m_rwLock.lockForRead();
+}
+
 uint64_t MythMediaBuffer::UpdateDecoderRate(uint64_t Latest)
 {
     if (!m_bitrateMonitorEnabled)
@@ -2,6 +2,7 @@
 #define MYTHMEDIABUFFER_H
 
 // Qt
+#include <QAtomicInteger>
 #include <QReadWriteLock>
 #include <QWaitCondition>
 #include <QString>
@@ -29,6 +30,11 @@ extern "C" {
 
 #define DEFAULT_CHUNK_SIZE 32768
 
+// Default upper limit for the adaptive read ahead buffer (in MB)
+#define DEFAULT_BUFFER_SIZE_CAP 64
+// Never request more than this from storage in one read
+#define READ_BLOCK_SIZE_MAXIMUM (4 * 1024 * 1024)
+
 class ThreadedFileWriter;
 class MythDVDBuffer;
 class MythBDBuffer;
@@ -79,6 +85,7 @@ class MTV_PUBLIC MythMediaBuffer : protected MThread
     QString   GetDecoderRate       (void);
     QString   GetStorageRate       (void);
     QString   GetAvailableBuffer   (void);
+    QString   GetBufferHealth      (void);
     uint      GetBufferSize        (void) const;
     bool      IsNearEnd            (double Framerate, uint Frames) const;
     long long GetWritePosition     (void) const;
@@ -150,6 +157,8 @@ class MTV_PUBLIC MythMediaBuffer : protected MThread
     void     KillReadAheadThread   (void);
     uint64_t UpdateDecoderRate     (uint64_t Latest = 0);
     uint64_t UpdateStorageRate     (uint64_t Latest = 0);
+    void     AdaptReadAhead        (int Elapsed);
+    int      MaxReadBlockSize      (void) const;
 
     virtual int       SafeRead     (void *Buffer, uint Size) = 0;
     virtual long long GetRealFileSizeInternal(void) const { return -1; }
@@ -225,6 +234,15 @@ class MTV_PUBLIC MythMediaBuffer : protected MThread
     QMutex                 m_storageReadLock;
     QMap<qint64, uint64_t> m_storageReads;
 
+    // Adaptive read ahead. Only the read ahead thread updates these,
+    // apart from m_consumedBytes which is updated by the reader.
+    QAtomicInteger<quint64> m_consumedBytes  { 0 };
+    uint64_t               m_consumeRate     { 0 }; // bytes per second
+    int                    m_readLatency     { 0 }; // ms per storage request
+    uint                   m_bufferSizeCap   { DEFAULT_BUFFER_SIZE_CAP * 1024 * 1024 };
+    uint                   m_bufferSizeWanted { 0 };
+    bool                   m_prefetch        { false }; // protected by rwLock
+
     // note 1: numfailures is modified with only a read lock in the
     // read ahead thread, but this is safe since all other places
     // that use it are protected by a write lock. But this is a
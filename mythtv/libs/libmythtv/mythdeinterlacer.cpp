@@ -1,6 +1,7 @@
 // MythTV
 #include "config.h"
 #include "mythlogging.h"
+#include "mthread.h"
 #include "mythavutil.h"
 #include "mythdeinterlacer.h"
 
@@ -27,6 +28,117 @@ bool MythDeinterlacer::s_haveSIMD = false;
 
 #define LOC QString("MythDeint: ")
 
+// Upper limit for the number of software deinterlacing threads
+#define MAX_DEINT_THREADS 8
+
+/*! \class MythDeintWorker
+ * \brief A persistent worker thread owned by MythDeintSlicer.
+ *
+ * Each worker waits for a new job generation, processes its own slice and
+ * signals completion. Threads are only torn down when the slicer is deleted.
+*/
+class MythDeintWorker : public MThread
+{
+  public:
+    MythDeintWorker(MythDeintSlicer *Parent, uint Index)
+      : MThread(QString("DeintSlice%1").arg(Index)),
+        m_parent(Parent),
+        m_index(Index)
+    {
+    }
+
+    void run(void) override
+    {
+        RunProlog();
+        uint generation = 0;
+        m_parent->m_lock.lock();
+        while (true)
+        {
+            while (!m_parent->m_quit && (generation == m_parent->m_generation))
+                m_parent->m_start.wait(&m_parent->m_lock);
+            if (m_parent->m_quit)
+                break;
+
+            generation = m_parent->m_generation;
+            const std::function<void(uint,uint)> *job = m_parent->m_job;
+            auto count = static_cast<uint>(m_parent->m_workers.size() + 1);
+            m_parent->m_lock.unlock();
+            if (job)
+                (*job)(m_index, count);
+            m_parent->m_lock.lock();
+            if (--m_parent->m_pending == 0)
+                m_parent->m_done.wakeAll();
+        }
+        m_parent->m_lock.unlock();
+        RunEpilog();
+    }
+
+  private:
+    MythDeintSlicer* m_parent { nullptr };
+    uint             m_index  { 0 };
+};
+
+/*! \class MythDeintSlicer
+ * \brief A small, persistent thread pool used to process horizontal slices
+ * of a frame in parallel.
+ *
+ * The calling thread always processes the first slice, so a slicer created
+ * for N threads starts N - 1 workers. Run blocks until all slices are complete.
+*/
+MythDeintSlicer::MythDeintSlicer(uint Threads)
+{
+    for (uint i = 1; i < Threads; ++i)
+    {
+        auto *worker = new MythDeintWorker(this, i);
+        m_workers.push_back(worker);
+        worker->start();
+    }
+}
+
+MythDeintSlicer::~MythDeintSlicer()
+{
+    m_lock.lock();
+    m_quit = true;
+    m_start.wakeAll();
+    m_lock.unlock();
+
+    for (auto *worker : m_workers)
+    {
+        worker->wait();
+        delete worker;
+    }
+    m_workers.clear();
+}
+
+uint MythDeintSlicer::Threads(void) const
+{
+    return static_cast<uint>(m_workers.size() + 1);
+}
+
+/// \brief Run Job for each slice, passing the slice index and slice count.
+void MythDeintSlicer::Run(const std::function<void(uint,uint)> &Job)
+{
+    uint count = Threads();
+    if (count > 1)
+    {
+        QMutexLocker locker(&m_lock);
+        m_job = &Job;
+        m_pending = count - 1;
+        m_generation++;
+        m_start.wakeAll();
+    }
+
+    Job(0, count);
+
+    if (count > 1)
+    {
+        QMutexLocker locker(&m_lock);
+        while (m_pending)
+            m_done.wait(&m_lock);
+        m_job = nullptr;
+    }
+}
+
 /*! \class MythDeinterlacer
  * \brief Handles software based deinterlacing of video frames.
  *
@@ -39,6 +151,12 @@ bool MythDeinterlacer::s_haveSIMD = false;
  * Medium - linearblend with custom code (SSE2 and Neon assisted where available)
  * High - libavfilter's yadif (with multithreading)
  *
+ * Linearblend splits the frame into horizontal slices that are processed in
+ * parallel by a MythDeintSlicer. The number of threads is taken from
+ * VideoDisplayProfile's max CPUs setting (see SetMaxThreads when there is no
+ * profile). libavfilter uses its own slice threading with the same limit.
+ * Onefield scales the whole field with a single scaler.
+ *
  * \note libavfilter frame doubling filters expect frames to be presented
  * in the correct order and will break if they do not receive a frame followed
  * by the retrieval of 2 'fields'.
@@ -266,14 +384,25 @@ void MythDeinterlacer::Filter(VideoFrame *Frame, FrameScanType Scan,
     av_frame_unref(m_frame);
 }
 
+/*! \brief Set the number of threads to use when no VideoDisplayProfile is available.
+ *
+ * \note Only takes effect when the deinterlacer is next (re)initialised.
+*/
+void MythDeinterlacer::SetMaxThreads(uint Threads)
+{
+    m_maxThreads = Threads;
+}
+
 void MythDeinterlacer::Cleanup(void)
 {
-    if (m_graph || m_swsContext)
+    if (m_graph || m_swsContext || m_slicer)
         LOG(VB_PLAYBACK, LOG_INFO, LOC + "Removing CPU deinterlacer");
 
     avfilter_graph_free(&m_graph);
     sws_freeContext(m_swsContext);
     m_swsContext = nullptr;
+    delete m_slicer;
+    m_slicer = nullptr;
     m_discontinuityCounter = 0;
     m_autoFieldOrder = false;
     m_lastFieldChange = 0;
@@ -308,6 +437,8 @@ bool MythDeinterlacer::Initialise(VideoFrame *Frame, MythDeintType Deinterlacer,
     m_inputFmt  = FrameTypeToPixelFormat(Frame->codec);
     QString name = DeinterlacerName(Deinterlacer | DEINT_CPU, DoubleRate);
 
+    uint threads = GetThreads(Profile);
+
     // simple onefield/bob?
     if (Deinterlacer == DEINT_BASIC || Deinterlacer == DEINT_MEDIUM)
     {
@@ -316,13 +447,22 @@ bool MythDeinterlacer::Initialise(VideoFrame *Frame, MythDeintType Deinterlacer,
         m_topFirst   = TopFieldFirst;
         if (Deinterlacer == DEINT_BASIC)
         {
+            // A single scaler, as slices scaled separately would each
+            // restart the vertical filter and leave seams at their edges
             m_swsContext = sws_getCachedContext(m_swsContext, m_width, m_height >> 1, m_inputFmt,
                                                 m_width, m_height, m_inputFmt, SWS_FAST_BILINEAR,
                                                 nullptr, nullptr, nullptr);
             if (m_swsContext == nullptr)
                 return false;
+            LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Using deinterlacer '%1'").arg(name));
+            return true;
         }
-        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Using deinterlacer '%1'").arg(name));
+
+        // Don't slice frames into unreasonably small pieces
+        auto maxslices = static_cast<uint>(qMax(1, m_height / 64));
+        m_slicer = new MythDeintSlicer(qMin(threads, maxslices));
+        LOG(VB_PLAYBACK, LOG_INFO, LOC + QString("Using deinterlacer '%1' (%2 threads)")
+            .arg(name).arg(m_slicer->Threads()));
         return true;
     }
 
@@ -337,13 +477,10 @@ bool MythDeinterlacer::Initialise(VideoFrame *Frame, MythDeintType Deinterlacer,
     if (!m_graph)
         return false;
 
-    uint threads = 1;
-    if (Profile)
-    {
-        threads = Profile->GetMaxCPUs();
-        if (threads < 1 || threads > 8)
-            threads = 1;
-    }
+    // Allow the graph to use slice threading. This is in addition to the
+    // per filter thread option below.
+    m_graph->nb_threads  = static_cast<int>(threads);
+    m_graph->thread_type = AVFILTER_THREAD_SLICE;
 
     AVFilterInOut* inputs = nullptr;
     AVFilterInOut* outputs = nullptr;
@@ -384,6 +521,15 @@ bool MythDeinterlacer::Initialise(VideoFrame *Frame, MythDeintType Deinterlacer,
     return false;
 }
 
+/// \brief Return the number of threads to use for software deinterlacing.
+uint MythDeinterlacer::GetThreads(VideoDisplayProfile *Profile) const
+{
+    uint threads = Profile ? Profile->GetMaxCPUs() : m_maxThreads;
+    if (threads < 1 || threads > MAX_DEINT_THREADS)
+        threads = 1;
+    return threads;
+}
+
 bool MythDeinterlacer::SetUpCache(VideoFrame *Frame)
 {
     if (!Frame)
@@ -634,7 +780,7 @@ static inline void BlendSIMD8x4(unsigned char *Src, int Width, int FirstRow, int
 
 void MythDeinterlacer::Blend(VideoFrame *Frame, FrameScanType Scan)
 {
-    if (Frame->height < 16 || Frame->width < 16)
+    if (Frame->height < 16 || Frame->width < 16 || !m_slicer)
         return;
 
     bool second = false;
@@ -655,49 +801,62 @@ void MythDeinterlacer::Blend(VideoFrame *Frame, FrameScanType Scan)
     bool hidepth = ColorDepth(src->codec) > 8;
     bool top = second ? !m_topFirst : m_topFirst;
     uint count = planes(src->codec);
-    for (uint plane = 0; plane < count; plane++)
-    {
-        int  height  = height_for_plane(src->codec, src->height, plane);
-        int firstrow = top ? 1 : 2;
-        bool height4 = (height % 4) == 0;
-        bool width4  = (src->pitches[plane] % 4) == 0;
-        // N.B. all frames allocated by MythTV should have 16 byte alignment
-        // for all planes
-#if (HAVE_SSE2 && ARCH_X86_64) || HAVE_INTRINSICS_NEON
-        bool width16 = (src->pitches[plane] % 16) == 0;
-        // profiling SSE2 suggests it is usually 4x faster - as expected
-        if (s_haveSIMD && height4 && width16)
+
+    // Each slice covers a 4 row aligned range of every plane. Destination
+    // rows are only ever written by the slice that owns them and source field
+    // rows are never written (single rate) or live in the cache frame (double
+    // rate) - so slices can safely read across their boundaries.
+    std::function<void(uint,uint)> blend = [&](uint Slice, uint Slices)
+    {
+        for (uint plane = 0; plane < count; plane++)
         {
-            if (hidepth)
+            int  height  = height_for_plane(src->codec, src->height, plane);
+            int firstrow = top ? 1 : 2;
+            bool height4 = (height % 4) == 0;
+            bool width4  = (src->pitches[plane] % 4) == 0;
+            int  start   = (height * static_cast<int>(Slice) / static_cast<int>(Slices)) & ~3;
+            int  end     = (height * static_cast<int>(Slice + 1) / static_cast<int>(Slices)) & ~3;
+            int  last    = (Slice + 1 == Slices) ? height : end + firstrow;
+            firstrow += start;
+            // N.B. all frames allocated by MythTV should have 16 byte alignment
+            // for all planes
+#if (HAVE_SSE2 && ARCH_X86_64) || HAVE_INTRINSICS_NEON
+            bool width16 = (src->pitches[plane] % 16) == 0;
+            // profiling SSE2 suggests it is usually 4x faster - as expected
+            if (s_haveSIMD && height4 && width16)
             {
-                BlendSIMD8x4(src->buf + src->offsets[plane],
-                             pitch_for_plane(src->codec, src->width, plane),
-                             firstrow, height, src->pitches[plane],
-                             Frame->buf + Frame->offsets[plane], Frame->pitches[plane],
-                             second);
+                if (hidepth)
+                {
+                    BlendSIMD8x4(src->buf + src->offsets[plane],
+                                 pitch_for_plane(src->codec, src->width, plane),
+                                 firstrow, last, src->pitches[plane],
+                                 Frame->buf + Frame->offsets[plane], Frame->pitches[plane],
+                                 second);
+                }
+                else
+                {
+                    BlendSIMD16x4(src->buf + src->offsets[plane],
+                                  width_for_plane(src->codec, src->width, plane),
+                                  firstrow, last, src->pitches[plane],
+                                  Frame->buf + Frame->offsets[plane], Frame->pitches[plane],
+                                  second);
+                }
             }
             else
+#endif
+            // N.B. There is no 10bit support here - but it shouldn't be necessary
+            // as everything should be 16byte aligned and 10/12bit interlaced video
+            // is virtually unheard of.
+            if (width4 && height4 && !hidepth)
             {
-                BlendSIMD16x4(src->buf + src->offsets[plane],
-                              width_for_plane(src->codec, src->width, plane),
-                              firstrow, height, src->pitches[plane],
-                              Frame->buf + Frame->offsets[plane], Frame->pitches[plane],
-                              second);
+                BlendC4x4(src->buf + src->offsets[plane],
+                          width_for_plane(src->codec, src->width, plane),
+                          firstrow, last, src->pitches[plane],
+                          Frame->buf + Frame->offsets[plane], Frame->pitches[plane],
+                          second);
             }
         }
-        else
-#endif
-        // N.B. There is no 10bit support here - but it shouldn't be necessary
-        // as everything should be 16byte aligned and 10/12bit interlaced video
-        // is virtually unheard of.
-        if (width4 && height4 && !hidepth)
-        {
-            BlendC4x4(src->buf + src->offsets[plane],
-                      width_for_plane(src->codec, src->width, plane),
-                      firstrow, height, src->pitches[plane],
-                      Frame->buf + Frame->offsets[plane], Frame->pitches[plane],
-                      second);
-        }
-    }
+    };
+    m_slicer->Run(blend);
     Frame->already_deinterlaced = true;
 }
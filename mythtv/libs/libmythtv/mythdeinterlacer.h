@@ -1,6 +1,14 @@
 #ifndef MYTHDEINTERLACER_H
 #define MYTHDEINTERLACER_H
 
+// Std
+#include <functional>
+#include <vector>
+
+// Qt
+#include <QMutex>
+#include <QWaitCondition>
+
 // MythTV
 #include "videoouttypes.h"
 #include "mythavutil.h"
@@ -11,6 +19,32 @@ extern "C" {
 #include "libswscale/swscale.h"
 }
 
+class MythDeintWorker;
+
+class MythDeintSlicer
+{
+    friend class MythDeintWorker;
+
+  public:
+    explicit MythDeintSlicer(uint Threads);
+   ~MythDeintSlicer();
+
+    uint             Threads      (void) const;
+    void             Run          (const std::function<void(uint,uint)> &Job);
+
+  private:
+    Q_DISABLE_COPY(MythDeintSlicer)
+
+    QMutex           m_lock;
+    QWaitCondition   m_start;
+    QWaitCondition   m_done;
+    const std::function<void(uint,uint)> *m_job { nullptr };
+    uint             m_generation { 0 };
+    uint             m_pending    { 0 };
+    bool             m_quit       { false };
+    std::vector<MythDeintWorker*> m_workers;
+};
+
 class MythDeinterlacer
 {
   public:
@@ -19,12 +53,14 @@ class MythDeinterlacer
 
     void             Filter       (VideoFrame *Frame, FrameScanType Scan,
                                    VideoDisplayProfile *Profile, bool Force = false);
+    void             SetMaxThreads(uint Threads);
 
   private:
     bool             Initialise   (VideoFrame *Frame, MythDeintType Deinterlacer,
                                    bool DoubleRate, bool TopFieldFirst,
                                    VideoDisplayProfile *Profile);
     inline void      Cleanup      (void);
+    uint             GetThreads   (VideoDisplayProfile *Profile) const;
     void             OneField     (VideoFrame *Frame, FrameScanType Scan);
     void             Blend        (VideoFrame *Frame, FrameScanType Scan);
     bool             SetUpCache   (VideoFrame *Frame);
@@ -45,6 +81,8 @@ class MythDeinterlacer
     AVFilterContext* m_sink       { nullptr };
     VideoFrame*      m_bobFrame   { nullptr };
     SwsContext*      m_swsContext { nullptr };
+    MythDeintSlicer* m_slicer     { nullptr };
+    uint             m_maxThreads { 0 };
     long long        m_discontinuityCounter { 0 };
     bool             m_autoFieldOrder  { false };
     long long        m_lastFieldChange { 0 };
@@ -30,6 +30,25 @@
 #include "mythcorecontext.h"
 #include "mythlogging.h"
 
+extern "C" {
+#include "libavutil/cpu.h"
+}
+
+#if ARCH_X86 && HAVE_AVX2 && defined(__GNUC__)
+#define MYTH_FRAME_AVX2 1
+#include <immintrin.h>
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+#if HAVE_INTRINSICS_NEON
+#if ARCH_AARCH64
+#include "libavutil/aarch64/cpu.h"
+#elif ARCH_ARM
+#include "libavutil/arm/cpu.h"
+#endif
+#include <arm_neon.h>
+#endif
+
 const char* format_description(VideoFrameType Type)
 {
     switch (Type)
@@ -319,11 +338,466 @@ static void splitplanes(uint8_t* dstu, int dstu_pitch,
     }
 }
 
+static void mergeplanes(uint8_t* dst, int dst_pitch,
+                        const uint8_t* srcu, int srcu_pitch,
+                        const uint8_t* srcv, int srcv_pitch,
+                        int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            dst[2*x+0] = srcu[x];
+            dst[2*x+1] = srcv[x];
+        }
+        dst  += dst_pitch;
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+    }
+}
+
+// N.B. For the 16bit kernels, width is in samples and pitches are in bytes
+static inline void splitline16(uint16_t* dstu, uint16_t* dstv, const uint16_t* src,
+                               int start, int width, int shift)
+{
+    for (int x = start; x < width; x++)
+    {
+        dstu[x] = static_cast<uint16_t>(src[2*x+0] >> shift);
+        dstv[x] = static_cast<uint16_t>(src[2*x+1] >> shift);
+    }
+}
+
+static inline void mergeline16(uint16_t* dst, const uint16_t* srcu, const uint16_t* srcv,
+                               int start, int width, int shift)
+{
+    for (int x = start; x < width; x++)
+    {
+        dst[2*x+0] = static_cast<uint16_t>(srcu[x] << shift);
+        dst[2*x+1] = static_cast<uint16_t>(srcv[x] << shift);
+    }
+}
+
+static inline void shiftline16(uint16_t* dst, const uint16_t* src,
+                               int start, int width, int shift)
+{
+    if (shift < 0)
+    {
+        for (int x = start; x < width; x++)
+            dst[x] = static_cast<uint16_t>(src[x] >> -shift);
+    }
+    else
+    {
+        for (int x = start; x < width; x++)
+            dst[x] = static_cast<uint16_t>(src[x] << shift);
+    }
+}
+
+static void splitplanes16(uint8_t* dstu, int dstu_pitch,
+                          uint8_t* dstv, int dstv_pitch,
+                          const uint8_t* src, int src_pitch,
+                          int width, int height, int shift)
+{
+    for (int y = 0; y < height; y++)
+    {
+        splitline16(reinterpret_cast<uint16_t*>(dstu), reinterpret_cast<uint16_t*>(dstv),
+                    reinterpret_cast<const uint16_t*>(src), 0, width, shift);
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+
+static void mergeplanes16(uint8_t* dst, int dst_pitch,
+                          const uint8_t* srcu, int srcu_pitch,
+                          const uint8_t* srcv, int srcv_pitch,
+                          int width, int height, int shift)
+{
+    for (int y = 0; y < height; y++)
+    {
+        mergeline16(reinterpret_cast<uint16_t*>(dst), reinterpret_cast<const uint16_t*>(srcu),
+                    reinterpret_cast<const uint16_t*>(srcv), 0, width, shift);
+        dst  += dst_pitch;
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+    }
+}
+
+/// \brief Shift 16bit samples left (positive Shift) or right (negative Shift)
+static void shiftplane16(uint8_t* dst, int dst_pitch,
+                         const uint8_t* src, int src_pitch,
+                         int width, int height, int shift)
+{
+    for (int y = 0; y < height; y++)
+    {
+        shiftline16(reinterpret_cast<uint16_t*>(dst), reinterpret_cast<const uint16_t*>(src),
+                    0, width, shift);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+}
+
+#if ARCH_X86
+static void SSE2_splitplanes(uint8_t* dstu, int dstu_pitch,
+                             uint8_t* dstv, int dstv_pitch,
+                             const uint8_t* src, int src_pitch,
+                             int width, int height)
+{
+    SSE_splitplanes(dstu, dstu_pitch, dstv, dstv_pitch, src, src_pitch, width, height);
+    asm volatile ("emms");
+}
+#endif
+
+#ifdef MYTH_FRAME_AVX2
+AVX2_TARGET static void AVX2_splitplanes(uint8_t* dstu, int dstu_pitch,
+                                         uint8_t* dstv, int dstv_pitch,
+                                         const uint8_t* src, int src_pitch,
+                                         int width, int height)
+{
+    const __m256i mask = _mm256_set1_epi16(0x00FF);
+    for (int y = 0; y < height; y++)
+    {
+        int x = 0;
+        for (; x < (width & ~31); x += 32)
+        {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[2*x]));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[2*x+32]));
+            __m256i u = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+            __m256i v = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+            // packus works per 128bit lane - restore the sample order
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dstu[x]), _mm256_permute4x64_epi64(u, 0xD8));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dstv[x]), _mm256_permute4x64_epi64(v, 0xD8));
+        }
+        for (; x < width; x++)
+        {
+            dstu[x] = src[2*x+0];
+            dstv[x] = src[2*x+1];
+        }
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+
+AVX2_TARGET static void AVX2_mergeplanes(uint8_t* dst, int dst_pitch,
+                                         const uint8_t* srcu, int srcu_pitch,
+                                         const uint8_t* srcv, int srcv_pitch,
+                                         int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        int x = 0;
+        for (; x < (width & ~31); x += 32)
+        {
+            __m256i u  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&srcu[x]));
+            __m256i v  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&srcv[x]));
+            __m256i lo = _mm256_unpacklo_epi8(u, v);
+            __m256i hi = _mm256_unpackhi_epi8(u, v);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[2*x]),    _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[2*x+32]), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+        for (; x < width; x++)
+        {
+            dst[2*x+0] = srcu[x];
+            dst[2*x+1] = srcv[x];
+        }
+        dst  += dst_pitch;
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+    }
+}
+
+AVX2_TARGET static void AVX2_splitplanes16(uint8_t* dstu, int dstu_pitch,
+                                           uint8_t* dstv, int dstv_pitch,
+                                           const uint8_t* src, int src_pitch,
+                                           int width, int height, int shift)
+{
+    const __m256i mask = _mm256_set1_epi32(0x0000FFFF);
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    for (int y = 0; y < height; y++)
+    {
+        auto *s = reinterpret_cast<const uint16_t*>(src);
+        auto *u = reinterpret_cast<uint16_t*>(dstu);
+        auto *v = reinterpret_cast<uint16_t*>(dstv);
+        int x = 0;
+        for (; x < (width & ~15); x += 16)
+        {
+            __m256i a  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s[2*x]));
+            __m256i b  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s[2*x+16]));
+            __m256i uu = _mm256_packus_epi32(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+            __m256i vv = _mm256_packus_epi32(_mm256_srli_epi32(a, 16), _mm256_srli_epi32(b, 16));
+            uu = _mm256_srl_epi16(_mm256_permute4x64_epi64(uu, 0xD8), count);
+            vv = _mm256_srl_epi16(_mm256_permute4x64_epi64(vv, 0xD8), count);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&u[x]), uu);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&v[x]), vv);
+        }
+        splitline16(u, v, s, x, width, shift);
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+
+AVX2_TARGET static void AVX2_mergeplanes16(uint8_t* dst, int dst_pitch,
+                                           const uint8_t* srcu, int srcu_pitch,
+                                           const uint8_t* srcv, int srcv_pitch,
+                                           int width, int height, int shift)
+{
+    const __m128i count = _mm_cvtsi32_si128(shift);
+    for (int y = 0; y < height; y++)
+    {
+        auto *d = reinterpret_cast<uint16_t*>(dst);
+        auto *u = reinterpret_cast<const uint16_t*>(srcu);
+        auto *v = reinterpret_cast<const uint16_t*>(srcv);
+        int x = 0;
+        for (; x < (width & ~15); x += 16)
+        {
+            __m256i uu = _mm256_sll_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&u[x])), count);
+            __m256i vv = _mm256_sll_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&v[x])), count);
+            __m256i lo = _mm256_unpacklo_epi16(uu, vv);
+            __m256i hi = _mm256_unpackhi_epi16(uu, vv);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&d[2*x]),    _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&d[2*x+16]), _mm256_permute2x128_si256(lo, hi, 0x31));
+        }
+        mergeline16(d, u, v, x, width, shift);
+        dst  += dst_pitch;
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+    }
+}
+
+AVX2_TARGET static void AVX2_shiftplane16(uint8_t* dst, int dst_pitch,
+                                          const uint8_t* src, int src_pitch,
+                                          int width, int height, int shift)
+{
+    const __m128i count = _mm_cvtsi32_si128(shift < 0 ? -shift : shift);
+    for (int y = 0; y < height; y++)
+    {
+        auto *d = reinterpret_cast<uint16_t*>(dst);
+        auto *s = reinterpret_cast<const uint16_t*>(src);
+        int x = 0;
+        for (; x < (width & ~15); x += 16)
+        {
+            __m256i val = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&s[x]));
+            val = (shift < 0) ? _mm256_srl_epi16(val, count) : _mm256_sll_epi16(val, count);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&d[x]), val);
+        }
+        shiftline16(d, s, x, width, shift);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+}
+#endif // MYTH_FRAME_AVX2
+
+#if HAVE_INTRINSICS_NEON
+static void NEON_splitplanes(uint8_t* dstu, int dstu_pitch,
+                             uint8_t* dstv, int dstv_pitch,
+                             const uint8_t* src, int src_pitch,
+                             int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        int x = 0;
+        for (; x < (width & ~15); x += 16)
+        {
+            uint8x16x2_t uv = vld2q_u8(&src[2*x]);
+            vst1q_u8(&dstu[x], uv.val[0]);
+            vst1q_u8(&dstv[x], uv.val[1]);
+        }
+        for (; x < width; x++)
+        {
+            dstu[x] = src[2*x+0];
+            dstv[x] = src[2*x+1];
+        }
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+
+static void NEON_mergeplanes(uint8_t* dst, int dst_pitch,
+                             const uint8_t* srcu, int srcu_pitch,
+                             const uint8_t* srcv, int srcv_pitch,
+                             int width, int height)
+{
+    for (int y = 0; y < height; y++)
+    {
+        int x = 0;
+        for (; x < (width & ~15); x += 16)
+        {
+            uint8x16x2_t uv;
+            uv.val[0] = vld1q_u8(&srcu[x]);
+            uv.val[1] = vld1q_u8(&srcv[x]);
+            vst2q_u8(&dst[2*x], uv);
+        }
+        for (; x < width; x++)
+        {
+            dst[2*x+0] = srcu[x];
+            dst[2*x+1] = srcv[x];
+        }
+        dst  += dst_pitch;
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+    }
+}
+
+static void NEON_splitplanes16(uint8_t* dstu, int dstu_pitch,
+                               uint8_t* dstv, int dstv_pitch,
+                               const uint8_t* src, int src_pitch,
+                               int width, int height, int shift)
+{
+    // vshlq with a negative count is a right shift
+    const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(-shift));
+    for (int y = 0; y < height; y++)
+    {
+        auto *s = reinterpret_cast<const uint16_t*>(src);
+        auto *u = reinterpret_cast<uint16_t*>(dstu);
+        auto *v = reinterpret_cast<uint16_t*>(dstv);
+        int x = 0;
+        for (; x < (width & ~7); x += 8)
+        {
+            uint16x8x2_t uv = vld2q_u16(&s[2*x]);
+            vst1q_u16(&u[x], vshlq_u16(uv.val[0], count));
+            vst1q_u16(&v[x], vshlq_u16(uv.val[1], count));
+        }
+        splitline16(u, v, s, x, width, shift);
+        src  += src_pitch;
+        dstu += dstu_pitch;
+        dstv += dstv_pitch;
+    }
+}
+
+static void NEON_mergeplanes16(uint8_t* dst, int dst_pitch,
+                               const uint8_t* srcu, int srcu_pitch,
+                               const uint8_t* srcv, int srcv_pitch,
+                               int width, int height, int shift)
+{
+    const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(shift));
+    for (int y = 0; y < height; y++)
+    {
+        auto *d = reinterpret_cast<uint16_t*>(dst);
+        auto *u = reinterpret_cast<const uint16_t*>(srcu);
+        auto *v = reinterpret_cast<const uint16_t*>(srcv);
+        int x = 0;
+        for (; x < (width & ~7); x += 8)
+        {
+            uint16x8x2_t uv;
+            uv.val[0] = vshlq_u16(vld1q_u16(&u[x]), count);
+            uv.val[1] = vshlq_u16(vld1q_u16(&v[x]), count);
+            vst2q_u16(&d[2*x], uv);
+        }
+        mergeline16(d, u, v, x, width, shift);
+        dst  += dst_pitch;
+        srcu += srcu_pitch;
+        srcv += srcv_pitch;
+    }
+}
+
+static void NEON_shiftplane16(uint8_t* dst, int dst_pitch,
+                              const uint8_t* src, int src_pitch,
+                              int width, int height, int shift)
+{
+    const int16x8_t count = vdupq_n_s16(static_cast<int16_t>(shift));
+    for (int y = 0; y < height; y++)
+    {
+        auto *d = reinterpret_cast<uint16_t*>(dst);
+        auto *s = reinterpret_cast<const uint16_t*>(src);
+        int x = 0;
+        for (; x < (width & ~7); x += 8)
+            vst1q_u16(&d[x], vshlq_u16(vld1q_u16(&s[x]), count));
+        shiftline16(d, s, x, width, shift);
+        src += src_pitch;
+        dst += dst_pitch;
+    }
+}
+#endif // HAVE_INTRINSICS_NEON
+
+using SplitPlanesFn   = void(*)(uint8_t*, int, uint8_t*, int, const uint8_t*, int, int, int);
+using MergePlanesFn   = void(*)(uint8_t*, int, const uint8_t*, int, const uint8_t*, int, int, int);
+using SplitPlanes16Fn = void(*)(uint8_t*, int, uint8_t*, int, const uint8_t*, int, int, int, int);
+using MergePlanes16Fn = void(*)(uint8_t*, int, const uint8_t*, int, const uint8_t*, int, int, int, int);
+using ShiftPlane16Fn  = void(*)(uint8_t*, int, const uint8_t*, int, int, int, int);
+
+/*! \brief The set of frame conversion kernels in use.
+ *
+ * The optimised set is selected once, on first use, from the CPU flags
+ * reported by FFmpeg (which also checks for OS support of AVX state).
+*/
+struct FrameKernels
+{
+    const char*     m_name;
+    SplitPlanesFn   m_split;
+    MergePlanesFn   m_merge;
+    SplitPlanes16Fn m_split16;
+    MergePlanes16Fn m_merge16;
+    ShiftPlane16Fn  m_shift16;
+};
+
+static FrameKernels select_frame_kernels(void)
+{
+    FrameKernels result { "C", splitplanes, mergeplanes, splitplanes16, mergeplanes16, shiftplane16 };
+    int flags = av_get_cpu_flags();
+#if ARCH_X86
+    if (sse2_check())
+    {
+        result.m_name  = "SSE2";
+        result.m_split = SSE2_splitplanes;
+    }
+#endif
+#ifdef MYTH_FRAME_AVX2
+    if (flags & AV_CPU_FLAG_AVX2)
+    {
+        result = { "AVX2", AVX2_splitplanes, AVX2_mergeplanes, AVX2_splitplanes16,
+                   AVX2_mergeplanes16, AVX2_shiftplane16 };
+    }
+#endif
+#if HAVE_INTRINSICS_NEON
+    if (have_neon(flags))
+    {
+        result = { "NEON", NEON_splitplanes, NEON_mergeplanes, NEON_splitplanes16,
+                   NEON_mergeplanes16, NEON_shiftplane16 };
+    }
+#endif
+    (void)flags;
+    LOG(VB_PLAYBACK, LOG_INFO, QString("Using %1 frame conversion kernels").arg(result.m_name));
+    return result;
+}
+
+static const FrameKernels& get_frame_kernels(bool Optimised)
+{
+    static const FrameKernels s_scalar { "C", splitplanes, mergeplanes, splitplanes16,
+                                         mergeplanes16, shiftplane16 };
+    static const FrameKernels s_optimised = select_frame_kernels();
+    return Optimised ? s_optimised : s_scalar;
+}
+
+/// \brief Return the name of the optimised frame conversion kernels in use.
+const char* framecopy_kernels(void)
+{
+    return get_frame_kernels(true).m_name;
+}
+
+/// \brief Return true if framecopy can copy or convert From into To.
+bool framecopy_supported(VideoFrameType From, VideoFrameType To)
+{
+    if (From == To)
+        return planes(From) > 0;
+    return (From == FMT_NV12 && To == FMT_YV12) || (From == FMT_YV12 && To == FMT_NV12) ||
+           (From == FMT_P010 && To == FMT_YUV420P10) || (From == FMT_YUV420P10 && To == FMT_P010) ||
+           (From == FMT_P016 && To == FMT_YUV420P16) || (From == FMT_YUV420P16 && To == FMT_P016);
+}
+
+/*! \brief Copy src into dst, converting between semi-planar and planar formats if needed.
+ *
+ * Identical formats are copied plane by plane. NV12 <-> YV12, P010 <-> YUV420P10
+ * and P016 <-> YUV420P16 are converted, with 10bit samples shifted between
+ * MSB (P010) and LSB (YUV420P10) alignment.
+ *
+ * \param useSSE If false, the plain C kernels are always used (for testing).
+*/
 void framecopy(VideoFrame* dst, const VideoFrame* src, bool useSSE)
 {
     VideoFrameType codec = dst->codec;
-    if (!(dst->codec == src->codec ||
-          (src->codec == FMT_NV12 && dst->codec == FMT_YV12)))
+    if (!framecopy_supported(src->codec, codec))
         return;
 
     dst->interlaced_frame = src->interlaced_frame;
@@ -336,75 +810,88 @@ void framecopy(VideoFrame* dst, const VideoFrame* src, bool useSSE)
     dst->colortransfer    = src->colortransfer;
     dst->chromalocation   = src->chromalocation;
 
-    if (FMT_YV12 == codec)
+    const FrameKernels& kernels = get_frame_kernels(useSSE);
+    int width  = (dst->width  < src->width)  ? dst->width  : src->width;
+    int height = (dst->height < src->height) ? dst->height : src->height;
+    int cwidth  = (width  + 1) >> 1;
+    int cheight = (height + 1) >> 1;
+
+    if (src->codec != codec)
     {
-        int width   = src->width;
-        int height  = src->height;
-        int dwidth  = dst->width;
-        int dheight = dst->height;
+        uint8_t* dbuf = dst->buf;
+        const uint8_t* sbuf = src->buf;
+        bool sixteen = ColorDepth(codec) > 8;
+        int shift = 16 - ColorDepth(format_is_nv12(codec) ? src->codec : codec);
 
-        if (src->codec == FMT_NV12 &&
-            height == dheight && width == dwidth)
+        // Luma
+        if (!sixteen)
         {
-            copyplane(dst->buf + dst->offsets[0], dst->pitches[0],
-                      src->buf + src->offsets[0], src->pitches[0],
-                      width, height);
-#if ARCH_X86
-            if (useSSE && sse2_check())
+            copyplane(dbuf + dst->offsets[0], dst->pitches[0],
+                      sbuf + src->offsets[0], src->pitches[0], width, height);
+        }
+        else
+        {
+            kernels.m_shift16(dbuf + dst->offsets[0], dst->pitches[0],
+                              sbuf + src->offsets[0], src->pitches[0], width, height,
+                              format_is_nv12(codec) ? shift : -shift);
+        }
+
+        // Chroma
+        if (format_is_nv12(src->codec))
+        {
+            if (sixteen)
             {
-                SSE_splitplanes(dst->buf + dst->offsets[1], dst->pitches[1],
-                                dst->buf + dst->offsets[2], dst->pitches[2],
-                                src->buf + src->offsets[1], src->pitches[1],
-                                (width+1) / 2, (height+1) / 2);
-                asm volatile ("emms");
-                return;
+                kernels.m_split16(dbuf + dst->offsets[1], dst->pitches[1],
+                                  dbuf + dst->offsets[2], dst->pitches[2],
+                                  sbuf + src->offsets[1], src->pitches[1],
+                                  cwidth, cheight, shift);
+            }
+            else
+            {
+                kernels.m_split(dbuf + dst->offsets[1], dst->pitches[1],
+                                dbuf + dst->offsets[2], dst->pitches[2],
+                                sbuf + src->offsets[1], src->pitches[1],
+                                cwidth, cheight);
+            }
+        }
+        else
+        {
+            if (sixteen)
+            {
+                kernels.m_merge16(dbuf + dst->offsets[1], dst->pitches[1],
+                                  sbuf + src->offsets[1], src->pitches[1],
+                                  sbuf + src->offsets[2], src->pitches[2],
+                                  cwidth, cheight, shift);
+            }
+            else
+            {
+                kernels.m_merge(dbuf + dst->offsets[1], dst->pitches[1],
+                                sbuf + src->offsets[1], src->pitches[1],
+                                sbuf + src->offsets[2], src->pitches[2],
+                                cwidth, cheight);
             }
-#else
-            Q_UNUSED(useSSE);
-#endif
-            splitplanes(dst->buf + dst->offsets[1], dst->pitches[1],
-                        dst->buf + dst->offsets[2], dst->pitches[2],
-                        src->buf + src->offsets[1], src->pitches[1],
-                        (width+1) / 2, (height+1) / 2);
-            return;
         }
+        return;
+    }
 
-        if (dst->pitches[0] != src->pitches[0] ||
-            dst->pitches[1] != src->pitches[1] ||
-            dst->pitches[2] != src->pitches[2])
+    uint count = planes(codec);
+    for (uint plane = 0; plane < count; ++plane)
+    {
+        int planeheight = height_for_plane(codec, height, plane);
+        if (dst->pitches[plane] == src->pitches[plane])
+        {
+            // Same stride - copy the plane in one go
+            memcpy(dst->buf + dst->offsets[plane], src->buf + src->offsets[plane],
+                   static_cast<size_t>(dst->pitches[plane] * planeheight));
+        }
+        else
         {
             // We have a different stride between the two frames
             // drop the garbage data
-            height = (dst->height < src->height) ? dst->height : src->height;
-            width = (dst->width < src->width) ? dst->width : src->width;
-            copyplane(dst->buf + dst->offsets[0], dst->pitches[0],
-                      src->buf + src->offsets[0], src->pitches[0],
-                      width, height);
-            copyplane(dst->buf + dst->offsets[1], dst->pitches[1],
-                      src->buf + src->offsets[1], src->pitches[1],
-                      (width+1) / 2, (height+1) / 2);
-            copyplane(dst->buf + dst->offsets[2], dst->pitches[2],
-                      src->buf + src->offsets[2], src->pitches[2],
-                      (width+1) / 2, (height+1) / 2);
-            return;
+            copyplane(dst->buf + dst->offsets[plane], dst->pitches[plane],
+                      src->buf + src->offsets[plane], src->pitches[plane],
+                      pitch_for_plane(codec, width, plane), planeheight);
         }
-
-        int height0 = (dst->height < src->height) ? dst->height : src->height;
-        int height1 = (height0+1) >> 1;
-        int height2 = (height0+1) >> 1;
-        int pitch0  = ((dst->pitches[0] < src->pitches[0]) ?
-                       dst->pitches[0] : src->pitches[0]);
-        int pitch1  = ((dst->pitches[1] < src->pitches[1]) ?
-                       dst->pitches[1] : src->pitches[1]);
-        int pitch2  = ((dst->pitches[2] < src->pitches[2]) ?
-                       dst->pitches[2] : src->pitches[2]);
-
-        memcpy(dst->buf + dst->offsets[0],
-               src->buf + src->offsets[0], pitch0 * height0);
-        memcpy(dst->buf + dst->offsets[1],
-               src->buf + src->offsets[1], pitch1 * height1);
-        memcpy(dst->buf + dst->offsets[2],
-               src->buf + src->offsets[2], pitch2 * height2);
     }
 }
 
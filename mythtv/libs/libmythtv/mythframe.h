@@ -217,6 +217,8 @@ private:
 
 void MTV_PUBLIC framecopy(VideoFrame *dst, const VideoFrame *src,
                           bool useSSE = true);
+bool MTV_PUBLIC framecopy_supported(VideoFrameType From, VideoFrameType To);
+MTV_PUBLIC const char* framecopy_kernels(void);
 
 static inline void init(VideoFrame *vf, VideoFrameType _codec,
                         unsigned char *_buf, int _width, int _height, int _size,
@@ -365,12 +367,14 @@ static inline int pitch_for_plane(VideoFrameType Type, int Width, uint Plane)
             if (Plane < 3)  return Width;
             break;
         case FMT_YUV444P:
+            if (Plane < 3)  return Width;
+            break;
         case FMT_YUV444P9:
         case FMT_YUV444P10:
         case FMT_YUV444P12:
         case FMT_YUV444P14:
         case FMT_YUV444P16:
-            if (Plane < 3)  return Width;
+            if (Plane < 3)  return Width << 1;
             break;
         case FMT_NV12:
             if (Plane < 2) return Width;
@@ -4826,6 +4826,7 @@ void MythPlayer::GetPlaybackData(InfoMap &infoMap)
     infoMap.insert("storagerate", m_playerCtx->m_buffer->GetStorageRate());
     infoMap.insert("bufferavail", m_playerCtx->m_buffer->GetAvailableBuffer());
     infoMap.insert("buffersize",  QString::number(m_playerCtx->m_buffer->GetBufferSize() >> 20));
+    infoMap.insert("bufferhealth", m_playerCtx->m_buffer->GetBufferHealth());
     int avsync = m_avsyncAvg / 1000;
     infoMap.insert("avsync", tr("%1 ms").arg(avsync));
 
@@ -4836,7 +4837,10 @@ void MythPlayer::GetPlaybackData(InfoMap &infoMap)
         infoMap.insert("videoframes", frames);
     }
     if (m_decoder)
-        infoMap["videodecoder"] = m_decoder->GetCodecDecoderName();
+    {
+        infoMap["videodecoder"]  = m_decoder->GetCodecDecoderName();
+        infoMap["framecopyrate"] = m_decoder->GetFrameCopyRate();
+    }
     if (m_outputJmeter)
     {
         infoMap["framerate"] = QString("%1%2%3")
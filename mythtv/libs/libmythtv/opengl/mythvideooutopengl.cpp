@@ -764,6 +764,7 @@ void MythVideoOutputOpenGL::Show(FrameScanType /*scan*/)
             // With the default of averaging over 30 samples this should give a 30 sample
             // average over 60 frames
             m_openGLPerf->RecordSample();
+            m_openGLPerf->RecordDrawCalls(m_render->GetDrawCalls());
             m_openGLPerf->LogSamples();
         }
         m_render->doneCurrent();
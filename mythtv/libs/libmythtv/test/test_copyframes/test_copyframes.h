@@ -28,10 +28,100 @@
 #define WIDTH   720
 #define HEIGHT  576
 
+Q_DECLARE_METATYPE(VideoFrameType)
+
 class TestCopyFrames: public QObject
 {
     Q_OBJECT
 
+  private:
+    static unsigned char* CreateFrame(VideoFrame *Frame, VideoFrameType Type,
+                                      int Width, int Align = 64)
+    {
+        int size = GetBufferSize(Type, Width, HEIGHT, Align);
+        auto* buf = static_cast<unsigned char*>(av_malloc(static_cast<size_t>(size)));
+        memset(buf, 0, static_cast<size_t>(size));
+        init(Frame, Type, buf, Width, HEIGHT, size, nullptr, nullptr, 0, 0, Align);
+        return buf;
+    }
+
+    // Fill the frame with repeatable noise that is valid for the frame's depth
+    static void FillFrame(VideoFrame *Frame)
+    {
+        uint seed = 0x1234567;
+        for (int i = 0; i < Frame->size; ++i)
+        {
+            seed = seed * 1103515245 + 12345;
+            Frame->buf[i] = static_cast<unsigned char>(seed >> 16);
+        }
+        int depth = ColorDepth(Frame->codec);
+        if (depth > 8 && depth < 16 && !format_is_nv12(Frame->codec))
+        {
+            auto *samples = reinterpret_cast<uint16_t*>(Frame->buf);
+            for (int i = 0; i < Frame->size / 2; ++i)
+                samples[i] &= (1 << depth) - 1;
+        }
+    }
+
+    static bool ComparePlanes(const VideoFrame *First, const VideoFrame *Second)
+    {
+        for (uint plane = 0; plane < planes(First->codec); ++plane)
+        {
+            int width  = pitch_for_plane(First->codec, First->width, plane);
+            int height = height_for_plane(First->codec, First->height, plane);
+            for (int row = 0; row < height; ++row)
+            {
+                if (memcmp(First->buf + First->offsets[plane] + row * First->pitches[plane],
+                           Second->buf + Second->offsets[plane] + row * Second->pitches[plane],
+                           static_cast<size_t>(width)) != 0)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    static void AddFormatRows(void)
+    {
+        QTest::addColumn<VideoFrameType>("Format");
+        QTest::addColumn<bool>("SSE");
+        const VideoFrameType formats[] = {
+            FMT_YV12, FMT_YUV420P9, FMT_YUV420P10, FMT_YUV420P12, FMT_YUV420P14, FMT_YUV420P16,
+            FMT_YUV422P, FMT_YUV422P9, FMT_YUV422P10, FMT_YUV422P12, FMT_YUV422P14, FMT_YUV422P16,
+            FMT_YUV444P, FMT_YUV444P9, FMT_YUV444P10, FMT_YUV444P12, FMT_YUV444P14, FMT_YUV444P16,
+            FMT_NV12, FMT_P010, FMT_P016, FMT_YUY2,
+            FMT_RGB24, FMT_BGRA, FMT_RGB32, FMT_ARGB32, FMT_RGBA32 };
+        for (auto format : formats)
+        {
+            QTest::newRow(QString("%1 SIMD").arg(format_description(format)).toLocal8Bit().constData())
+                << format << true;
+            QTest::newRow(QString("%1 C").arg(format_description(format)).toLocal8Bit().constData())
+                << format << false;
+        }
+    }
+
+    static void AddConversionRows(void)
+    {
+        QTest::addColumn<VideoFrameType>("From");
+        QTest::addColumn<VideoFrameType>("To");
+        QTest::addColumn<int>("Width");
+        const VideoFrameType pairs[][2] = {
+            { FMT_NV12, FMT_YV12 }, { FMT_YV12, FMT_NV12 },
+            { FMT_P010, FMT_YUV420P10 }, { FMT_YUV420P10, FMT_P010 },
+            { FMT_P016, FMT_YUV420P16 }, { FMT_YUV420P16, FMT_P016 } };
+        for (const auto & pair : pairs)
+        {
+            // An odd chroma width exercises the scalar tails of the SIMD kernels
+            for (int width : { WIDTH, WIDTH + 2 })
+            {
+                QTest::newRow(QString("%1->%2 %3").arg(format_description(pair[0]))
+                              .arg(format_description(pair[1])).arg(width).toLocal8Bit().constData())
+                    << pair[0] << pair[1] << width;
+            }
+        }
+    }
+
   private slots:
     // called at the beginning of these sets of tests
     static void initTestCase(void)
@@ -1276,4 +1366,108 @@ class TestCopyFrames: public QObject
         av_freep(&bufsrc);
         av_freep(&bufdst);
     }
+
+    static void AllFormatsCopy_data(void)
+    {
+        AddFormatRows();
+    }
+
+    // Same format copies between frames with different strides
+    static void AllFormatsCopy(void)
+    {
+        QFETCH(VideoFrameType, Format);
+        QFETCH(bool, SSE);
+        VideoFrame src {};
+        VideoFrame dst {};
+        unsigned char* bufsrc = CreateFrame(&src, Format, WIDTH, 64);
+        unsigned char* bufdst = CreateFrame(&dst, Format, WIDTH, 0);
+        FillFrame(&src);
+
+        QVERIFY(framecopy_supported(Format, Format));
+        framecopy(&dst, &src, SSE);
+        QVERIFY(ComparePlanes(&src, &dst));
+
+        av_freep(&bufsrc);
+        av_freep(&bufdst);
+    }
+
+    static void Conversion_data(void)
+    {
+        AddConversionRows();
+    }
+
+    // The optimised kernels must be bit exact with the C versions and
+    // planar -> semi-planar -> planar must be lossless
+    static void Conversion(void)
+    {
+        QFETCH(VideoFrameType, From);
+        QFETCH(VideoFrameType, To);
+        QFETCH(int, Width);
+        VideoFrame src {};
+        VideoFrame simd {};
+        VideoFrame purec {};
+        VideoFrame back {};
+        unsigned char* bufsrc   = CreateFrame(&src, From, Width);
+        unsigned char* bufsimd  = CreateFrame(&simd, To, Width);
+        unsigned char* bufpurec = CreateFrame(&purec, To, Width);
+        unsigned char* bufback  = CreateFrame(&back, From, Width);
+        FillFrame(&src);
+
+        QVERIFY(framecopy_supported(From, To));
+        framecopy(&simd, &src, true);
+        framecopy(&purec, &src, false);
+        QCOMPARE(memcmp(bufsimd, bufpurec, static_cast<size_t>(simd.size)), 0);
+
+        if (!format_is_nv12(From))
+        {
+            framecopy(&back, &simd, true);
+            QVERIFY(ComparePlanes(&src, &back));
+        }
+
+        av_freep(&bufsrc);
+        av_freep(&bufsimd);
+        av_freep(&bufpurec);
+        av_freep(&bufback);
+    }
+
+    static void ConversionThroughput_data(void)
+    {
+        QTest::addColumn<VideoFrameType>("From");
+        QTest::addColumn<VideoFrameType>("To");
+        QTest::addColumn<bool>("SSE");
+        const VideoFrameType pairs[][2] = {
+            { FMT_NV12, FMT_YV12 }, { FMT_YV12, FMT_NV12 },
+            { FMT_P010, FMT_YUV420P10 }, { FMT_YUV420P10, FMT_P010 } };
+        for (const auto & pair : pairs)
+        {
+            for (bool sse : { true, false })
+            {
+                QTest::newRow(QString("%1->%2 %3").arg(format_description(pair[0]))
+                              .arg(format_description(pair[1]))
+                              .arg(sse ? framecopy_kernels() : "C").toLocal8Bit().constData())
+                    << pair[0] << pair[1] << sse;
+            }
+        }
+    }
+
+    static void ConversionThroughput(void)
+    {
+        QFETCH(VideoFrameType, From);
+        QFETCH(VideoFrameType, To);
+        QFETCH(bool, SSE);
+        VideoFrame src {};
+        VideoFrame dst {};
+        unsigned char* bufsrc = CreateFrame(&src, From, WIDTH);
+        unsigned char* bufdst = CreateFrame(&dst, To, WIDTH);
+        FillFrame(&src);
+
+        QBENCHMARK
+        {
+            for (int i = 0; i < ITER; i++)
+                framecopy(&dst, &src, SSE);
+        }
+
+        av_freep(&bufsrc);
+        av_freep(&bufdst);
+    }
 };
@@ -0,0 +1,3 @@
+#include "test_deinterlacer.h"
+
+QTEST_APPLESS_MAIN(TestDeinterlacer)
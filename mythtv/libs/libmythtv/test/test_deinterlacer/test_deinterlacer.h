@@ -0,0 +1,263 @@
+/*
+ *  Class TestDeinterlacer
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <array>
+
+#include <QtTest/QtTest>
+
+#include "mythcorecontext.h"
+#include "mythframe.h"
+#include "mythavutil.h"
+#include "mythdeinterlacer.h"
+
+#define ITER    (25*4)
+#define WIDTH   1920
+#define HEIGHT  1080
+#define ALIGN   64
+
+class TestDeinterlacer: public QObject
+{
+    Q_OBJECT
+
+  private:
+    static unsigned char* CreateFrame(VideoFrame *Frame, MythDeintType Deint, bool DoubleRate)
+    {
+        int size = GetBufferSize(FMT_YV12, WIDTH, HEIGHT, ALIGN);
+        auto* buf = static_cast<unsigned char*>(av_malloc(static_cast<size_t>(size)));
+        init(Frame, FMT_YV12, buf, WIDTH, HEIGHT, size, nullptr, nullptr, 0, 0, ALIGN);
+        Frame->deinterlace_allowed = DEINT_ALL;
+        if (DoubleRate)
+            Frame->deinterlace_double = Deint | DEINT_CPU;
+        else
+            Frame->deinterlace_single = Deint | DEINT_CPU;
+        return buf;
+    }
+
+    // Fill each field with a different pattern so the result is not trivial
+    static void FillFrame(VideoFrame *Frame)
+    {
+        for (uint plane = 0; plane < 3; ++plane)
+        {
+            int height = height_for_plane(Frame->codec, Frame->height, plane);
+            int width  = width_for_plane(Frame->codec, Frame->width, plane);
+            for (int row = 0; row < height; ++row)
+            {
+                unsigned char *line = Frame->buf + Frame->offsets[plane] + (row * Frame->pitches[plane]);
+                for (int col = 0; col < width; ++col)
+                    line[col] = static_cast<unsigned char>((row & 1) ? (col + row) : (255 - col));
+            }
+        }
+    }
+
+    static void Deinterlace(bool DoubleRate, uint Threads, VideoFrame *Frame)
+    {
+        MythDeinterlacer deinterlacer;
+        deinterlacer.SetMaxThreads(Threads);
+        deinterlacer.Filter(Frame, kScan_Interlaced, nullptr, true);
+        if (DoubleRate)
+            deinterlacer.Filter(Frame, kScan_Intr2ndField, nullptr, true);
+    }
+
+    // Scale one field of Source to full height with a single scaler, as a
+    // reference for onefield
+    static void ScaleField(const VideoFrame *Source, bool TopField, unsigned char *Dest)
+    {
+        SwsContext *context = sws_getContext(WIDTH, HEIGHT >> 1, AV_PIX_FMT_YUV420P,
+                                             WIDTH, HEIGHT, AV_PIX_FMT_YUV420P,
+                                             SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+        QVERIFY(context != nullptr);
+        std::array<const uint8_t*,4> src { nullptr };
+        std::array<uint8_t*,4> dst { nullptr };
+        std::array<int,4> srcpitch { 0 };
+        std::array<int,4> dstpitch { 0 };
+        for (uint plane = 0; plane < 3; ++plane)
+        {
+            src[plane] = Source->buf + Source->offsets[plane] +
+                         (TopField ? 0 : Source->pitches[plane]);
+            srcpitch[plane] = Source->pitches[plane] << 1;
+            dst[plane] = Dest + Source->offsets[plane];
+            dstpitch[plane] = Source->pitches[plane];
+        }
+        QCOMPARE(sws_scale(context, src.data(), srcpitch.data(), 0, HEIGHT >> 1,
+                           dst.data(), dstpitch.data()), HEIGHT);
+        sws_freeContext(context);
+    }
+
+    static void AddThreadRows(void)
+    {
+        QTest::newRow("1 thread")  << 1U;
+        QTest::newRow("2 threads") << 2U;
+        QTest::newRow("4 threads") << 4U;
+        QTest::newRow("8 threads") << 8U;
+    }
+
+    static void Benchmark(MythDeintType Deint, bool DoubleRate, uint Threads)
+    {
+        VideoFrame frame {};
+        unsigned char *buf = CreateFrame(&frame, Deint, DoubleRate);
+        FillFrame(&frame);
+
+        MythDeinterlacer deinterlacer;
+        deinterlacer.SetMaxThreads(Threads);
+        int count = 0;
+        QElapsedTimer timer;
+        timer.start();
+        QBENCHMARK
+        {
+            for (int i = 0; i < ITER; i++)
+            {
+                frame.already_deinterlaced = false;
+                frame.frameCounter = count++;
+                deinterlacer.Filter(&frame, kScan_Interlaced, nullptr);
+                if (DoubleRate)
+                {
+                    frame.already_deinterlaced = false;
+                    deinterlacer.Filter(&frame, kScan_Intr2ndField, nullptr);
+                }
+            }
+        }
+        qint64 elapsed = timer.elapsed();
+        if (elapsed > 0)
+        {
+            qInfo() << QString("%1x%2 %3 threads: %4 frames/sec")
+                .arg(WIDTH).arg(HEIGHT).arg(Threads)
+                .arg(count * (DoubleRate ? 2000.0 : 1000.0) / elapsed, 0, 'f', 1);
+        }
+        QVERIFY(frame.already_deinterlaced);
+        av_freep(&buf);
+    }
+
+  private slots:
+    // called at the beginning of these sets of tests
+    static void initTestCase(void)
+    {
+        gCoreContext = new MythCoreContext("bin_version", nullptr);
+    }
+
+    static void SliceCompare_data(void)
+    {
+        QTest::addColumn<bool>("DoubleRate");
+        QTest::addColumn<uint>("Threads");
+        QTest::newRow("Single rate 2 threads") << false << 2U;
+        QTest::newRow("Single rate 4 threads") << false << 4U;
+        QTest::newRow("Double rate 3 threads") << true  << 3U;
+        QTest::newRow("Double rate 8 threads") << true  << 8U;
+    }
+
+    // Sliced linearblend must be bit exact with the single threaded version
+    static void SliceCompare(void)
+    {
+        QFETCH(bool, DoubleRate);
+        QFETCH(uint, Threads);
+
+        VideoFrame reference {};
+        VideoFrame sliced {};
+        unsigned char *refbuf = CreateFrame(&reference, DEINT_MEDIUM, DoubleRate);
+        unsigned char *slicebuf = CreateFrame(&sliced, DEINT_MEDIUM, DoubleRate);
+        FillFrame(&reference);
+        FillFrame(&sliced);
+
+        Deinterlace(DoubleRate, 1, &reference);
+        Deinterlace(DoubleRate, Threads, &sliced);
+        QVERIFY(reference.already_deinterlaced);
+        QVERIFY(sliced.already_deinterlaced);
+        QCOMPARE(memcmp(refbuf, slicebuf, static_cast<size_t>(reference.size)), 0);
+
+        av_freep(&refbuf);
+        av_freep(&slicebuf);
+    }
+
+    static void OneFieldCompare_data(void)
+    {
+        QTest::addColumn<bool>("DoubleRate");
+        QTest::addColumn<uint>("Threads");
+        QTest::newRow("Single rate 1 thread")  << false << 1U;
+        QTest::newRow("Single rate 4 threads") << false << 4U;
+        QTest::newRow("Double rate 1 thread")  << true  << 1U;
+        QTest::newRow("Double rate 8 threads") << true  << 8U;
+    }
+
+    // Onefield must match scaling the whole field at once, with no seams
+    static void OneFieldCompare(void)
+    {
+        QFETCH(bool, DoubleRate);
+        QFETCH(uint, Threads);
+
+        VideoFrame frame {};
+        unsigned char *buf = CreateFrame(&frame, DEINT_BASIC, DoubleRate);
+        FillFrame(&frame);
+        frame.top_field_first = true;
+
+        // The second field comes from the original frame
+        auto *refbuf = static_cast<unsigned char*>(av_mallocz(static_cast<size_t>(frame.size)));
+        ScaleField(&frame, !DoubleRate, refbuf);
+
+        Deinterlace(DoubleRate, Threads, &frame);
+        QVERIFY(frame.already_deinterlaced);
+        for (uint plane = 0; plane < 3; ++plane)
+        {
+            int height = height_for_plane(frame.codec, frame.height, plane);
+            int width  = width_for_plane(frame.codec, frame.width, plane);
+            for (int row = 0; row < height; ++row)
+            {
+                int offset = frame.offsets[plane] + (row * frame.pitches[plane]);
+                if (memcmp(buf + offset, refbuf + offset, static_cast<size_t>(width)) != 0)
+                    QFAIL(qPrintable(QString("Plane %1 row %2 differs").arg(plane).arg(row)));
+            }
+        }
+
+        av_freep(&refbuf);
+        av_freep(&buf);
+    }
+
+    static void OneField_data(void)
+    {
+        QTest::addColumn<uint>("Threads");
+        AddThreadRows();
+    }
+
+    static void OneField(void)
+    {
+        QFETCH(uint, Threads);
+        Benchmark(DEINT_BASIC, true, Threads);
+    }
+
+    static void LinearBlend_data(void)
+    {
+        QTest::addColumn<uint>("Threads");
+        AddThreadRows();
+    }
+
+    static void LinearBlend(void)
+    {
+        QFETCH(uint, Threads);
+        Benchmark(DEINT_MEDIUM, true, Threads);
+    }
+
+    static void Yadif_data(void)
+    {
+        QTest::addColumn<uint>("Threads");
+        AddThreadRows();
+    }
+
+    static void Yadif(void)
+    {
+        QFETCH(uint, Threads);
+        Benchmark(DEINT_HIGH, true, Threads);
+    }
+};
@@ -0,0 +1,451 @@
+// Std
+#include <algorithm>
+
+// Qt
+#include <QBuffer>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QImage>
+#include <QRunnable>
+#include <QSaveFile>
+#include <QVector>
+
+// MythTV
+#include "mythlogging.h"
+#include "mythdb.h"
+#include "mythdirs.h"
+#include "mythdate.h"
+#include "mthreadpool.h"
+#include "mythdownloadmanager.h"
+#include "remotefile.h"
+#include "mythartworkcache.h"
+
+#define LOC QString("ArtworkCache: ")
+
+// Increment when the index format changes
+static const quint32 kIndexMagic          = 0x4d414331; // MAC1
+// Remote sources are checked for changes at most this often
+static const qint64  kRevalidateInterval  = 15LL * 60 * 1000;
+// Sources that have not been looked up for this long are forgotten
+static const qint64  kSourceLifetime      = 30LL * 24 * 60 * 60 * 1000;
+// The index is written at most this often, and when the frontend exits
+static const qint64  kSaveInterval        = 60LL * 1000;
+// Files not in the index may be still being stored if they are newer than this
+static const qint64  kOrphanAge           = 60LL * 60;
+
+/// Revalidates the queued sources on a background thread.
+class ArtworkValidator : public QRunnable
+{
+  public:
+    void run(void) override { MythArtworkCache::GetCache()->Validate(); }
+};
+
+MythArtworkCache* MythArtworkCache::GetCache(void)
+{
+    static MythArtworkCache s_cache;
+    return &s_cache;
+}
+
+MythArtworkCache::MythArtworkCache()
+  : m_lastSave(QDateTime::currentMSecsSinceEpoch())
+{
+}
+
+/// \brief Return true if images with this cache label are stored in the artwork cache.
+bool MythArtworkCache::IsArtwork(const QString &Label)
+{
+    return Label.startsWith("myth:") || Label.startsWith("http:") ||
+           Label.startsWith("https:") || Label.startsWith("ftp:") ||
+           Label.startsWith("-");
+}
+
+static qint64 CacheLimit(void)
+{
+    return GetMythDB()->GetNumSetting("UIArtworkCacheSize", 256) * 1024LL * 1024LL;
+}
+
+QString MythArtworkCache::DataPath(const QByteArray &Hash) const
+{
+    QString hex = Hash.toHex();
+    return m_dir + "/" + hex.left(2) + "/" + hex + ".png";
+}
+
+void MythArtworkCache::Load(void)
+{
+    m_loaded = true;
+    m_dir = GetThumbnailDir() + "/artwork";
+    QDir().mkpath(m_dir);
+
+    QFile file(m_dir + "/index");
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    quint32 entries = 0;
+    stream >> magic >> entries;
+    if (magic != kIndexMagic)
+    {
+        LOG(VB_GUI, LOG_INFO, LOC + "Discarding out of date index");
+        return;
+    }
+
+    for (quint32 i = 0; i < entries && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString label;
+        Entry entry;
+        stream >> label >> entry.m_hash >> entry.m_size >> entry.m_cached >> entry.m_accessed;
+        m_entries.insert(label, entry);
+    }
+
+    quint32 sources = 0;
+    stream >> sources;
+    for (quint32 i = 0; i < sources && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString url;
+        Source source;
+        stream >> url >> source.m_modified >> source.m_checked;
+        m_sources.insert(url, source);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to read '%1'").arg(file.fileName()));
+        m_entries.clear();
+        m_sources.clear();
+        return;
+    }
+
+    for (const auto & entry : qAsConst(m_entries))
+        if (m_references[entry.m_hash]++ == 0)
+            m_totalSize += entry.m_size;
+
+    LOG(VB_GUI, LOG_INFO, LOC + QString("Loaded %1 entries (%2 images, %3KB)")
+        .arg(m_entries.size()).arg(m_references.size()).arg(m_totalSize / 1024));
+}
+
+/// \brief Write the index if it has changed and was not written recently. The lock must be held.
+void MythArtworkCache::SaveIfNeeded(void)
+{
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (!m_dirty || (now - m_lastSave) < kSaveInterval)
+        return;
+
+    m_dirty    = false;
+    m_lastSave = now;
+
+    QSaveFile file(m_dir + "/index");
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to open '%1' for writing")
+            .arg(file.fileName()));
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << kIndexMagic << static_cast<quint32>(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+    {
+        stream << it.key() << it->m_hash << it->m_size << it->m_cached << it->m_accessed;
+    }
+    stream << static_cast<quint32>(m_sources.size());
+    for (auto it = m_sources.cbegin(); it != m_sources.cend(); ++it)
+        stream << it.key() << it->m_modified << it->m_checked;
+
+    if (!file.commit())
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to write '%1'").arg(file.fileName()));
+}
+
+/// \brief Write the index if it has changed.
+void MythArtworkCache::Save(void)
+{
+    QMutexLocker locker(&m_lock);
+    if (m_loaded)
+    {
+        m_lastSave = 0;
+        SaveIfNeeded();
+    }
+}
+
+/*! \brief Find the cached image for Label.
+ *
+ * On success Path is the file holding the image and Cached is the time it
+ * was stored.
+*/
+bool MythArtworkCache::Lookup(const QString &Label, QString &Path, QDateTime &Cached)
+{
+    QMutexLocker locker(&m_lock);
+    if (!m_loaded)
+        Load();
+
+    auto entry = m_entries.find(Label);
+    if (entry == m_entries.end())
+        return false;
+
+    entry->m_accessed = MythDate::current().toSecsSinceEpoch();
+    m_dirty = true;
+    Path   = DataPath(entry->m_hash);
+    Cached = QDateTime::fromMSecsSinceEpoch(entry->m_cached, Qt::UTC);
+    SaveIfNeeded();
+    return true;
+}
+
+void MythArtworkCache::Store(const QString &Label, const QImage &Image)
+{
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    if (!Image.save(&buffer, "PNG"))
+        return;
+    QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha1);
+    qint64 limit = CacheLimit();
+
+    bool exists = false;
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_loaded)
+            Load();
+        exists = m_references.contains(hash);
+    }
+
+    // Rewrite the data if it has gone missing while still referenced
+    QString path = DataPath(hash);
+    if (exists && !QFile::exists(path))
+        exists = false;
+
+    // Write outside the lock. Concurrent stores of the same image are harmless.
+    if (!exists)
+    {
+        QDir().mkpath(QFileInfo(path).path());
+        QSaveFile file(path);
+        if (!file.open(QIODevice::WriteOnly) || file.write(data) != data.size() || !file.commit())
+        {
+            LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to write '%1'").arg(path));
+            return;
+        }
+        LOG(VB_GUI | VB_FILE, LOG_INFO, LOC + QString("Saved '%1' as '%2'").arg(Label).arg(path));
+    }
+
+    QMutexLocker locker(&m_lock);
+    Entry entry;
+    entry.m_hash     = hash;
+    entry.m_size     = data.size();
+    entry.m_cached   = MythDate::current().toMSecsSinceEpoch();
+    entry.m_accessed = entry.m_cached / 1000;
+    // Reference the new data before releasing any old data, which may be the same
+    if (m_references[hash]++ == 0)
+        m_totalSize += entry.m_size;
+    auto old = m_entries.find(Label);
+    if (old != m_entries.end())
+        RemoveEntry(old);
+    m_entries.insert(Label, entry);
+    m_dirty = true;
+
+    if (m_totalSize > limit)
+        Expire(limit - (limit / 10));
+    SaveIfNeeded();
+}
+
+/// \brief Remove an entry, deleting its file if nothing else refers to it. The lock must be held.
+void MythArtworkCache::RemoveEntry(QHash<QString,Entry>::iterator Item)
+{
+    QByteArray hash = Item->m_hash;
+    qint64 size = Item->m_size;
+    m_entries.erase(Item);
+    m_dirty = true;
+
+    auto reference = m_references.find(hash);
+    if (reference == m_references.end() || --(*reference) > 0)
+        return;
+    m_references.erase(reference);
+    m_totalSize -= size;
+    QFile::remove(DataPath(hash));
+}
+
+void MythArtworkCache::Remove(const QString &Label)
+{
+    QMutexLocker locker(&m_lock);
+    if (!m_loaded)
+        Load();
+    auto entry = m_entries.find(Label);
+    if (entry != m_entries.end())
+    {
+        LOG(VB_GUI | VB_FILE, LOG_INFO, LOC + QString("Removed '%1'").arg(Label));
+        RemoveEntry(entry);
+    }
+}
+
+/// \brief Remove all entries whose label contains Partial.
+void MythArtworkCache::RemoveMatching(const QString &Partial)
+{
+    QMutexLocker locker(&m_lock);
+    if (!m_loaded)
+        Load();
+    QStringList labels;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+        if (it.key().contains(Partial))
+            labels.append(it.key());
+    for (const auto & label : qAsConst(labels))
+        RemoveEntry(m_entries.find(label));
+}
+
+/// \brief Discard the least recently used entries until the cache is no larger than Limit.
+void MythArtworkCache::Expire(qint64 Limit)
+{
+    if (m_totalSize <= Limit)
+        return;
+
+    QVector<QPair<qint64,QString>> order;
+    order.reserve(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+        order.append(qMakePair(it->m_accessed, it.key()));
+    std::sort(order.begin(), order.end());
+
+    int expired = 0;
+    for (const auto & item : qAsConst(order))
+    {
+        if (m_totalSize <= Limit)
+            break;
+        RemoveEntry(m_entries.find(item.second));
+        expired++;
+    }
+
+    LOG(VB_GUI | VB_FILE, LOG_INFO, LOC + QString("Expired %1 entries, %2KB remaining")
+        .arg(expired).arg(m_totalSize / 1024));
+}
+
+/*! \brief Return the last modified time recorded for a remote source.
+ *
+ * If the source has not been checked recently it is queued for revalidation
+ * in the background. Until then the recorded time (or an invalid time, if
+ * the source is unknown) is returned and the cached image is used.
+*/
+QDateTime MythArtworkCache::SourceModified(const QString &Source)
+{
+    QMutexLocker locker(&m_lock);
+    if (!m_loaded)
+        Load();
+
+    QDateTime result;
+    qint64 now = MythDate::current().toMSecsSinceEpoch();
+    auto source = m_sources.constFind(Source);
+    if (source != m_sources.constEnd() && source->m_modified >= 0)
+        result = QDateTime::fromMSecsSinceEpoch(source->m_modified, Qt::UTC);
+
+    if (source == m_sources.constEnd() || (now - source->m_checked) > kRevalidateInterval)
+    {
+        m_pending.insert(Source);
+        if (!m_validating)
+        {
+            m_validating = true;
+            MThreadPool::globalInstance()->start(new ArtworkValidator(), "ArtworkValidator");
+        }
+    }
+
+    return result;
+}
+
+QDateTime MythArtworkCache::CheckSource(const QString &Source)
+{
+    if (Source.startsWith("http://") || Source.startsWith("https://") ||
+        Source.startsWith("ftp://"))
+    {
+        return GetMythDownloadManager()->GetLastModified(Source);
+    }
+    return RemoteFile::LastModified(Source);
+}
+
+/// \brief Check all of the queued sources, including any queued while checking.
+void MythArtworkCache::Validate(void)
+{
+    while (true)
+    {
+        QSet<QString> pending;
+        {
+            QMutexLocker locker(&m_lock);
+            if (m_pending.isEmpty())
+            {
+                m_validating = false;
+                SaveIfNeeded();
+                return;
+            }
+            pending.swap(m_pending);
+        }
+
+        LOG(VB_GUI | VB_FILE, LOG_DEBUG, LOC + QString("Revalidating %1 sources")
+            .arg(pending.size()));
+
+        QHash<QString,Source> checked;
+        for (const auto & url : qAsConst(pending))
+        {
+            QDateTime modified = CheckSource(url);
+            Source source;
+            source.m_modified = modified.isValid() ? modified.toMSecsSinceEpoch() : -1;
+            source.m_checked  = MythDate::current().toMSecsSinceEpoch();
+            checked.insert(url, source);
+        }
+
+        QMutexLocker locker(&m_lock);
+        for (auto it = checked.cbegin(); it != checked.cend(); ++it)
+            m_sources.insert(it.key(), it.value());
+        m_dirty = true;
+    }
+}
+
+/*! \brief Enforce the size limit, forget old sources and remove files that
+ * are not in the index (e.g. if the frontend exited before saving it).
+*/
+void MythArtworkCache::Prune(void)
+{
+    QSet<QString> known;
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_loaded)
+            Load();
+
+        Expire(CacheLimit());
+
+        qint64 cutoff = MythDate::current().toMSecsSinceEpoch() - kSourceLifetime;
+        for (auto it = m_sources.begin(); it != m_sources.end(); )
+        {
+            if (it->m_checked < cutoff)
+            {
+                it = m_sources.erase(it);
+                m_dirty = true;
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        for (auto it = m_references.cbegin(); it != m_references.cend(); ++it)
+            known.insert(it.key().toHex());
+    }
+
+    int removed = 0;
+    qint64 cutoff = MythDate::current().toSecsSinceEpoch() - kOrphanAge;
+    QDirIterator it(m_dir, { "*.png" }, QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext())
+    {
+        it.next();
+        QFileInfo info = it.fileInfo();
+        if (!known.contains(info.completeBaseName()) &&
+            info.lastModified().toSecsSinceEpoch() < cutoff)
+        {
+            QFile::remove(info.absoluteFilePath());
+            removed++;
+        }
+    }
+
+    if (removed)
+        LOG(VB_GUI | VB_FILE, LOG_INFO, LOC + QString("Removed %1 unindexed files").arg(removed));
+
+    Save();
+}
@@ -0,0 +1,86 @@
+#ifndef MYTHARTWORKCACHE_H
+#define MYTHARTWORKCACHE_H
+
+// Qt
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+
+class QImage;
+
+/*! \class MythArtworkCache
+ *  \brief A size bounded, content addressed disk cache for artwork images.
+ *
+ * Artwork (images loaded from myth://, http(s):// and ftp:// URLs and from
+ * absolute local paths such as recording previews) is stored by the SHA-1
+ * of its encoded data, so identical images cached under different labels
+ * share a file. A compact binary index maps each cache label to its data,
+ * size and the time it was cached, so lookups do not need to stat the disk.
+ * When the cache grows beyond UIArtworkCacheSize MB the least recently used
+ * entries are discarded.
+ *
+ * The index also records when each remote source was last modified and when
+ * that was last checked. Lookups use the recorded time and queue sources that
+ * have not been checked recently for revalidation, which is done in batches
+ * on a background thread rather than by blocking the image loader on a
+ * backend or HTTP round trip for every image.
+ *
+ * \note All methods are thread safe.
+*/
+class MythArtworkCache
+{
+  public:
+    static MythArtworkCache* GetCache(void);
+    static bool IsArtwork(const QString &Label);
+
+    bool      Lookup         (const QString &Label, QString &Path, QDateTime &Cached);
+    void      Store          (const QString &Label, const QImage &Image);
+    void      Remove         (const QString &Label);
+    void      RemoveMatching (const QString &Partial);
+    QDateTime SourceModified (const QString &Source);
+    void      Prune          (void);
+    void      Save           (void);
+
+  private:
+    friend class ArtworkValidator;
+
+    struct Entry
+    {
+        QByteArray m_hash;
+        qint64     m_size     { 0 };
+        qint64     m_cached   { 0 };
+        qint64     m_accessed { 0 };
+    };
+
+    struct Source
+    {
+        qint64     m_modified { -1 };
+        qint64     m_checked  { 0 };
+    };
+
+    MythArtworkCache();
+    void    Load           (void);
+    void    SaveIfNeeded   (void);
+    void    Expire         (qint64 Limit);
+    void    RemoveEntry    (QHash<QString,Entry>::iterator Item);
+    QString DataPath       (const QByteArray &Hash) const;
+    void    Validate       (void);
+    static QDateTime CheckSource(const QString &Source);
+
+    QMutex                 m_lock;
+    QString                m_dir;
+    QHash<QString,Entry>   m_entries;
+    QHash<QByteArray,int>  m_references;
+    QHash<QString,Source>  m_sources;
+    QSet<QString>          m_pending;
+    qint64                 m_totalSize  { 0 };
+    qint64                 m_lastSave   { 0 };
+    bool                   m_loaded     { false };
+    bool                   m_dirty      { false };
+    bool                   m_validating { false };
+};
+
+#endif
@@ -0,0 +1,170 @@
+// Std
+#include <algorithm>
+
+// Qt
+#include <QGlyphRun>
+#include <QPainter>
+
+// MythTV
+#include "mythlogging.h"
+#include "mythimage.h"
+#include "mythpainter.h"
+#include "mythglyphatlas.h"
+
+#define LOC QString("GlyphAtlas: ")
+
+// Page size is kept small enough that adding glyphs (which requires the page
+// to be uploaded again) is cheap.
+static const int kPageSize  = 512;
+static const int kMaxPages  = 8;
+static const int kPadding   = 1;
+
+MythGlyphAtlas::MythGlyphAtlas(MythPainter *Painter)
+  : m_painter(Painter)
+{
+}
+
+MythGlyphAtlas::~MythGlyphAtlas()
+{
+    Reset();
+}
+
+void MythGlyphAtlas::Reset(void)
+{
+    for (auto * page : qAsConst(m_pages))
+        page->DecrRef();
+    m_pages.clear();
+    m_glyphs.clear();
+    m_lastKey.clear();
+    m_lastFont    = QRawFont();
+    m_lastMap     = nullptr;
+    m_shelf       = { 0, 0 };
+    m_shelfHeight = 0;
+    m_full        = false;
+}
+
+/// \brief Discard all glyphs if the atlas ran out of space for the last string.
+void MythGlyphAtlas::ResetIfFull(void)
+{
+    if (!m_full)
+        return;
+    LOG(VB_GUI, LOG_INFO, LOC + QString("Atlas full - resetting %1 pages").arg(m_pages.size()));
+    Reset();
+}
+
+QString MythGlyphAtlas::FontKey(const QRawFont &Font)
+{
+    return QString("%1:%2:%3:%4:%5:%6").arg(Font.familyName()).arg(Font.styleName())
+        .arg(Font.pixelSize()).arg(Font.weight()).arg(Font.style())
+        .arg(Font.hintingPreference());
+}
+
+/// \brief Find space for a glyph of the given size, adding a page if needed.
+bool MythGlyphAtlas::Allocate(const QSize &Size, MythImage *&Page, QPoint &Position)
+{
+    QSize size = Size + QSize(kPadding, kPadding);
+    if (size.width() > kPageSize || size.height() > kPageSize)
+        return false;
+
+    if (!m_pages.isEmpty())
+    {
+        // start a new shelf
+        if (m_shelf.x() + size.width() > kPageSize)
+        {
+            m_shelf = QPoint(0, m_shelf.y() + m_shelfHeight);
+            m_shelfHeight = 0;
+        }
+
+        if (m_shelf.y() + size.height() <= kPageSize)
+        {
+            Page = m_pages.back();
+            Position = m_shelf;
+            m_shelf.rx() += size.width();
+            m_shelfHeight = std::max(m_shelfHeight, size.height());
+            return true;
+        }
+    }
+
+    if (m_pages.size() >= kMaxPages)
+    {
+        m_full = true;
+        return false;
+    }
+
+    QImage blank(kPageSize, kPageSize, QImage::Format_ARGB32);
+    blank.fill(0);
+    MythImage *page = m_painter->GetFormatImage();
+    page->Assign(blank);
+    page->SetFileName(QString("GlyphAtlas%1").arg(m_pages.size()));
+    m_pages.append(page);
+    LOG(VB_GUI, LOG_DEBUG, LOC + QString("Added page %1").arg(m_pages.size()));
+
+    Page          = page;
+    Position      = { 0, 0 };
+    m_shelf       = { size.width(), 0 };
+    m_shelfHeight = size.height();
+    return true;
+}
+
+/*! \brief Retrieve the atlas entry for the given glyph, rasterising it if needed.
+ *
+ * Returns false if the glyph cannot be added, in which case the caller should
+ * fall back to rendering the complete string.
+*/
+bool MythGlyphAtlas::GetGlyph(const QRawFont &Font, quint32 Index, MythGlyph &Glyph)
+{
+    if (!m_painter)
+        return false;
+
+    if (!m_lastMap || !(Font == m_lastFont))
+    {
+        m_lastKey  = FontKey(Font);
+        m_lastFont = Font;
+        m_lastMap  = &m_glyphs[m_lastKey];
+    }
+
+    auto found = m_lastMap->constFind(Index);
+    if (found != m_lastMap->constEnd())
+    {
+        Glyph = found.value();
+        return true;
+    }
+
+    MythGlyph glyph;
+    QRect bounds = Font.boundingRect(Index).toAlignedRect();
+    if (!bounds.isEmpty())
+    {
+        // Allow for antialiasing beyond the nominal bounds
+        bounds.adjust(-1, -1, 1, 1);
+        MythImage *page = nullptr;
+        QPoint position;
+        if (!Allocate(bounds.size(), page, position))
+            return false;
+
+        QImage image(bounds.size(), QImage::Format_ARGB32_Premultiplied);
+        image.fill(0);
+        QGlyphRun run;
+        run.setRawFont(Font);
+        run.setGlyphIndexes({ Index });
+        run.setPositions({ QPointF(-bounds.left(), -bounds.top()) });
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::TextAntialiasing);
+        painter.setPen(Qt::white);
+        painter.drawGlyphRun(QPointF(0, 0), run);
+        painter.end();
+
+        QPainter pagepainter(page);
+        pagepainter.setCompositionMode(QPainter::CompositionMode_Source);
+        pagepainter.drawImage(position, image.convertToFormat(QImage::Format_ARGB32));
+        pagepainter.end();
+        page->SetChanged();
+
+        glyph.m_page   = page;
+        glyph.m_source = QRect(position, bounds.size());
+        glyph.m_offset = bounds.topLeft();
+    }
+
+    m_lastMap->insert(Index, glyph);
+    Glyph = glyph;
+    return true;
+}
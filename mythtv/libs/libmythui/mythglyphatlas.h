@@ -0,0 +1,68 @@
+#ifndef MYTHGLYPHATLAS_H
+#define MYTHGLYPHATLAS_H
+
+// Qt
+#include <QHash>
+#include <QRect>
+#include <QRawFont>
+#include <QVector>
+
+class MythPainter;
+class MythImage;
+
+/*! \class MythGlyph
+ *  \brief The location of a rasterised glyph within a MythGlyphAtlas page.
+ *
+ * m_offset is the position of the top left of the glyph image relative to the
+ * glyph origin (i.e. the start of the baseline). Glyphs with no visible
+ * pixels (e.g. spaces) have an empty m_source.
+*/
+class MythGlyph
+{
+  public:
+    MythImage* m_page   { nullptr };
+    QRect      m_source { };
+    QPoint     m_offset { };
+};
+
+/*! \class MythGlyphAtlas
+ *  \brief A cache of glyphs rasterised into a small number of shared images.
+ *
+ * Each glyph is rasterised once per font and size, in white, and packed into
+ * an atlas page. Painters that support it then draw text as a batch of quads
+ * from the page, tinted with the font color, rather than rendering every
+ * distinct string into its own image and texture.
+ *
+ * When all pages are full the atlas is flagged and is reset before the next
+ * string is added - never while a string is being built.
+*/
+class MythGlyphAtlas
+{
+  public:
+    explicit MythGlyphAtlas(MythPainter *Painter);
+   ~MythGlyphAtlas();
+
+    void  ResetIfFull (void);
+    bool  GetGlyph    (const QRawFont &Font, quint32 Index, MythGlyph &Glyph);
+
+  private:
+    Q_DISABLE_COPY(MythGlyphAtlas)
+
+    using GlyphMap = QHash<quint32,MythGlyph>;
+
+    void  Reset       (void);
+    bool  Allocate    (const QSize &Size, MythImage *&Page, QPoint &Position);
+    static QString FontKey(const QRawFont &Font);
+
+    MythPainter*         m_painter    { nullptr };
+    QVector<MythImage*>  m_pages;
+    QHash<QString,GlyphMap> m_glyphs;
+    QString              m_lastKey;
+    QRawFont             m_lastFont;
+    GlyphMap*            m_lastMap    { nullptr };
+    QPoint               m_shelf      { 0, 0 };
+    int                  m_shelfHeight { 0 };
+    bool                 m_full       { false };
+};
+
+#endif
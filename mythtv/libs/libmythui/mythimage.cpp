@@ -21,6 +21,7 @@
 // MythUI headers
 #include "mythuihelper.h"
 #include "mythmainwindow.h"
+#include "mythimageeffects.h"
 
 MythUIHelper *MythImage::s_ui = nullptr;
 
@@ -193,10 +194,8 @@ void MythImage::Reflect(ReflectAxis axis, int shear, int scale, int length,
         fillDirection = FillDirection::LeftToRight;
     }
 
-    QImage alphaChannel(mirrorImage.size(), QImage::Format_ARGB32);
-    MakeGradient(alphaChannel, QColor("#AAAAAA"), QColor("#000000"), 255,
-                 BoundaryWanted::No, fillDirection);
-    mirrorImage.setAlphaChannel(alphaChannel);
+    // Fade the reflection out from 2/3 opacity
+    MythImageEffects::FadeAlpha(mirrorImage, 0xAA, 0x00, fillDirection);
 
     QTransform shearTransform;
     if (axis == ReflectAxis::Vertical)
@@ -264,15 +263,9 @@ void MythImage::ToGreyscale()
     if (isGrayscale())
         return;
 
-    for (int y = 0; y < height(); ++y)
-    {
-        for (int x = 0; x < width(); ++x)
-        {
-            QRgb oldPixel = pixel(x, y);
-            int greyVal = qGray(oldPixel);
-            setPixel(x, y, qRgba(greyVal, greyVal, greyVal, qAlpha(oldPixel)));
-        }
-    }
+    QImage grey = *(static_cast<QImage*>(this));
+    MythImageEffects::Greyscale(grey);
+    Assign(grey);
 }
 
 bool MythImage::Load(MythImageReader *reader)
@@ -382,37 +375,20 @@ void MythImage::MakeGradient(QImage &image, const QColor &begin,
     startColor.setAlpha(alpha);
     endColor.setAlpha(alpha);
 
-    // Define Gradient
-    QPoint pointA(0,0);
-    QPoint pointB;
-    if (direction == FillDirection::TopToBottom)
-    {
-        pointB = QPoint(0,image.height());
-    }
-    else if (direction == FillDirection::LeftToRight)
-    {
-        pointB = QPoint(image.width(),0);
-    }
-
-    QLinearGradient gradient(pointA, pointB);
-    gradient.setColorAt(0, startColor);
-    gradient.setColorAt(1, endColor);
-
     // Draw Gradient
-    QPainter painter(&image);
-    painter.setCompositionMode(QPainter::CompositionMode_Source);
-    painter.fillRect(0, 0, image.width(), image.height(), gradient);
+    MythImageEffects::Gradient(image, startColor, endColor, direction);
 
     if (drawBoundary == BoundaryWanted::Yes)
     {
         // Draw boundary rect
+        QPainter painter(&image);
         QColor black(0, 0, 0, alpha);
         painter.setPen(black);
         QPen pen = painter.pen();
         pen.setWidth(1);
         painter.drawRect(image.rect());
+        painter.end();
     }
-    painter.end();
 }
 
 MythImage *MythImage::Gradient(MythPainter *painter,
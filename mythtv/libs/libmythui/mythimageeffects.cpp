@@ -0,0 +1,345 @@
+// Std
+#include <algorithm>
+#include <cstring>
+
+// Qt
+#include <QColor>
+#include <QVector>
+
+// MythTV
+#include "config.h"
+#include "mythimageeffects.h"
+
+// All of the SIMD code assumes the little endian (B, G, R, A) byte order of
+// QImage::Format_ARGB32 and its variants.
+#if (Q_BYTE_ORDER == Q_LITTLE_ENDIAN)
+#if (HAVE_SSE2 && ARCH_X86_64)
+#include <emmintrin.h>
+#define MYTHIMAGE_SSE2 1
+#elif HAVE_INTRINSICS_NEON && (ARCH_AARCH64 || defined(__ARM_NEON))
+#include <arm_neon.h>
+#define MYTHIMAGE_NEON 1
+#endif
+#endif
+
+/// Returns A * B / 255, correctly rounded
+static inline uint MulDiv255(uint A, uint B)
+{
+    uint t = (A * B) + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+#if MYTHIMAGE_SSE2
+static inline __m128i MulDiv255(__m128i A, __m128i B)
+{
+    __m128i t = _mm_add_epi16(_mm_mullo_epi16(A, B), _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/// Repeat each of 4 bytes 4 times, one per channel of 4 pixels
+static inline __m128i Expand4(const uchar *Bytes)
+{
+    int packed = 0;
+    memcpy(&packed, Bytes, sizeof(packed));
+    __m128i result = _mm_cvtsi32_si128(packed);
+    result = _mm_unpacklo_epi8(result, result);
+    return _mm_unpacklo_epi16(result, result);
+}
+#endif
+
+#if MYTHIMAGE_NEON
+static inline uint8x8_t MulDiv255(uint8x8_t A, uint8x8_t B)
+{
+    uint16x8_t t = vmull_u8(A, B);
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+#endif
+
+bool MythImageEffects::HaveSIMD(void)
+{
+#if MYTHIMAGE_SSE2 || MYTHIMAGE_NEON
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// \brief Convert the image to greyscale using the same weights as qGray, preserving alpha.
+void MythImageEffects::Greyscale(QImage &Image)
+{
+    if (Image.isNull())
+        return;
+
+    QImage::Format format = Image.format();
+    if (format != QImage::Format_RGB32 && format != QImage::Format_ARGB32 &&
+        format != QImage::Format_ARGB32_Premultiplied)
+    {
+        Image = Image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    int width = Image.width();
+    for (int y = 0; y < Image.height(); ++y)
+    {
+        auto *line = reinterpret_cast<quint32*>(Image.scanLine(y));
+        int x = 0;
+#if MYTHIMAGE_SSE2
+        const __m128i mask  = _mm_set1_epi32(0xff);
+        const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+        const __m128i red   = _mm_set1_epi32(11);
+        const __m128i blue  = _mm_set1_epi32(5);
+        for ( ; x + 4 <= width; x += 4)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<__m128i*>(line + x));
+            __m128i b = _mm_and_si128(pixels, mask);
+            __m128i g = _mm_and_si128(_mm_srli_epi32(pixels, 8), mask);
+            __m128i r = _mm_and_si128(_mm_srli_epi32(pixels, 16), mask);
+            // Products fit in the low 16 bits of each 32 bit lane
+            __m128i grey = _mm_add_epi32(_mm_mullo_epi16(r, red), _mm_slli_epi32(g, 4));
+            grey = _mm_srli_epi32(_mm_add_epi32(grey, _mm_mullo_epi16(b, blue)), 5);
+            grey = _mm_or_si128(grey, _mm_or_si128(_mm_slli_epi32(grey, 8), _mm_slli_epi32(grey, 16)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(line + x),
+                             _mm_or_si128(grey, _mm_and_si128(pixels, alpha)));
+        }
+#endif
+#if MYTHIMAGE_NEON
+        for ( ; x + 8 <= width; x += 8)
+        {
+            auto *pixels = reinterpret_cast<uint8_t*>(line + x);
+            uint8x8x4_t p = vld4_u8(pixels);
+            uint16x8_t sum = vmull_u8(p.val[2], vdup_n_u8(11));
+            sum = vmlal_u8(sum, p.val[1], vdup_n_u8(16));
+            sum = vmlal_u8(sum, p.val[0], vdup_n_u8(5));
+            uint8x8_t grey = vshrn_n_u16(sum, 5);
+            p.val[0] = grey;
+            p.val[1] = grey;
+            p.val[2] = grey;
+            vst4_u8(pixels, p);
+        }
+#endif
+        for ( ; x < width; ++x)
+        {
+            QRgb pixel = line[x];
+            int grey = qGray(pixel);
+            line[x] = qRgba(grey, grey, grey, qAlpha(pixel));
+        }
+    }
+}
+
+/// Multiply every channel of each (premultiplied) pixel by its factor / 255
+static void ScaleRow(quint32 *Row, const uchar *Factors, int Width)
+{
+    int x = 0;
+#if MYTHIMAGE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for ( ; x + 4 <= Width; x += 4)
+    {
+        __m128i pixels  = _mm_loadu_si128(reinterpret_cast<__m128i*>(Row + x));
+        __m128i factors = Expand4(Factors + x);
+        __m128i low  = MulDiv255(_mm_unpacklo_epi8(pixels, zero), _mm_unpacklo_epi8(factors, zero));
+        __m128i high = MulDiv255(_mm_unpackhi_epi8(pixels, zero), _mm_unpackhi_epi8(factors, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Row + x), _mm_packus_epi16(low, high));
+    }
+#endif
+#if MYTHIMAGE_NEON
+    for ( ; x + 8 <= Width; x += 8)
+    {
+        auto *pixels = reinterpret_cast<uint8_t*>(Row + x);
+        uint8x8x4_t p = vld4_u8(pixels);
+        uint8x8_t factors = vld1_u8(Factors + x);
+        for (auto & channel : p.val)
+            channel = MulDiv255(channel, factors);
+        vst4_u8(pixels, p);
+    }
+#endif
+    for ( ; x < Width; ++x)
+    {
+        auto *pixel = reinterpret_cast<uchar*>(Row + x);
+        for (int channel = 0; channel < 4; ++channel)
+            pixel[channel] = static_cast<uchar>(MulDiv255(pixel[channel], Factors[x]));
+    }
+}
+
+/*! \brief Fade the image linearly from Start to End opacity (0-255).
+ *
+ * The image is converted to Format_ARGB32_Premultiplied, so that fading is
+ * a single multiplication of every channel.
+*/
+void MythImageEffects::FadeAlpha(QImage &Image, int Start, int End, FillDirection Direction)
+{
+    if (Image.isNull())
+        return;
+    if (Image.format() != QImage::Format_ARGB32_Premultiplied)
+        Image = Image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    Start = std::clamp(Start, 0, 255);
+    End   = std::clamp(End, 0, 255);
+    int width  = Image.width();
+    int height = Image.height();
+    bool vertical = Direction == FillDirection::TopToBottom;
+    int length = vertical ? height : width;
+
+    // Sample at the centre of each pixel, as QLinearGradient does
+    auto factor = [&](int Index)
+    {
+        return static_cast<uchar>(Start + ((End - Start) * (2 * Index + 1)) / (2 * length));
+    };
+
+    QVector<uchar> factors(width);
+    if (!vertical)
+        for (int x = 0; x < width; ++x)
+            factors[x] = factor(x);
+
+    for (int y = 0; y < height; ++y)
+    {
+        if (vertical)
+            memset(factors.data(), factor(y), static_cast<size_t>(width));
+        ScaleRow(reinterpret_cast<quint32*>(Image.scanLine(y)), factors.constData(), width);
+    }
+}
+
+/// \brief Fill the image with a linear gradient from Begin to End, replacing its contents.
+void MythImageEffects::Gradient(QImage &Image, const QColor &Begin, const QColor &End,
+                                FillDirection Direction)
+{
+    if (Image.isNull())
+        return;
+    QImage::Format format = Image.format();
+    if (format != QImage::Format_RGB32 && format != QImage::Format_ARGB32 &&
+        format != QImage::Format_ARGB32_Premultiplied)
+    {
+        Image = Image.convertToFormat(QImage::Format_ARGB32);
+    }
+
+    bool premultiply = Image.format() == QImage::Format_ARGB32_Premultiplied;
+    int width  = Image.width();
+    int height = Image.height();
+    bool vertical = Direction == FillDirection::TopToBottom;
+    int length = vertical ? height : width;
+    QRgb begin = Begin.rgba();
+    QRgb end   = End.rgba();
+
+    auto colour = [&](int Index)
+    {
+        int num = 2 * Index + 1;
+        int den = 2 * length;
+        auto lerp = [&](int First, int Second) { return First + ((Second - First) * num) / den; };
+        QRgb result = qRgba(lerp(qRed(begin),   qRed(end)),   lerp(qGreen(begin), qGreen(end)),
+                            lerp(qBlue(begin),  qBlue(end)),  lerp(qAlpha(begin), qAlpha(end)));
+        return premultiply ? qPremultiply(result) : result;
+    };
+
+    if (vertical)
+    {
+        // Every row is a single colour
+        for (int y = 0; y < height; ++y)
+        {
+            auto *line = reinterpret_cast<quint32*>(Image.scanLine(y));
+            std::fill_n(line, width, colour(y));
+        }
+        return;
+    }
+
+    // Every row is the same
+    auto *first = reinterpret_cast<quint32*>(Image.scanLine(0));
+    for (int x = 0; x < width; ++x)
+        first[x] = colour(x);
+    for (int y = 1; y < height; ++y)
+        memcpy(Image.scanLine(y), first, static_cast<size_t>(width) * sizeof(quint32));
+}
+
+/// Composite a shadow of the given coverage and colour beneath the row
+static void ShadowRow(quint32 *Row, const uchar *Shadow, QRgb Colour, int Width)
+{
+    int x = 0;
+#if MYTHIMAGE_SSE2
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i opaque = _mm_set1_epi16(255);
+    const __m128i colours = _mm_unpacklo_epi8(_mm_set1_epi32(static_cast<int>(Colour)), zero);
+    for ( ; x + 4 <= Width; x += 4)
+    {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<__m128i*>(Row + x));
+        __m128i shadow = Expand4(Shadow + x);
+        __m128i low    = _mm_unpacklo_epi8(pixels, zero);
+        __m128i high   = _mm_unpackhi_epi8(pixels, zero);
+        __m128i slow   = MulDiv255(colours, _mm_unpacklo_epi8(shadow, zero));
+        __m128i shigh  = MulDiv255(colours, _mm_unpackhi_epi8(shadow, zero));
+        // Replicate each pixel's alpha across its channels
+        __m128i alow   = _mm_shufflehi_epi16(_mm_shufflelo_epi16(low, 0xff), 0xff);
+        __m128i ahigh  = _mm_shufflehi_epi16(_mm_shufflelo_epi16(high, 0xff), 0xff);
+        slow  = MulDiv255(slow, _mm_sub_epi16(opaque, alow));
+        shigh = MulDiv255(shigh, _mm_sub_epi16(opaque, ahigh));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(Row + x),
+                         _mm_packus_epi16(_mm_add_epi16(low, slow), _mm_add_epi16(high, shigh)));
+    }
+#endif
+#if MYTHIMAGE_NEON
+    const uint8_t channels[4] = { static_cast<uint8_t>(qBlue(Colour)), static_cast<uint8_t>(qGreen(Colour)),
+                                  static_cast<uint8_t>(qRed(Colour)),  static_cast<uint8_t>(qAlpha(Colour)) };
+    for ( ; x + 8 <= Width; x += 8)
+    {
+        auto *pixels = reinterpret_cast<uint8_t*>(Row + x);
+        uint8x8x4_t p = vld4_u8(pixels);
+        uint8x8_t shadow  = vld1_u8(Shadow + x);
+        uint8x8_t inverse = vmvn_u8(p.val[3]);
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            uint8x8_t s = MulDiv255(vdup_n_u8(channels[channel]), shadow);
+            p.val[channel] = vqadd_u8(p.val[channel], MulDiv255(s, inverse));
+        }
+        vst4_u8(pixels, p);
+    }
+#endif
+    auto *colour = reinterpret_cast<const uchar*>(&Colour);
+    for ( ; x < Width; ++x)
+    {
+        if (!Shadow[x])
+            continue;
+        auto *pixel = reinterpret_cast<uchar*>(Row + x);
+        uint inverse = 255 - qAlpha(Row[x]);
+        for (int channel = 0; channel < 4; ++channel)
+        {
+            uint shadow = MulDiv255(colour[channel], Shadow[x]);
+            pixel[channel] = static_cast<uchar>(pixel[channel] + MulDiv255(shadow, inverse));
+        }
+    }
+}
+
+/*! \brief Add a drop shadow, in the given colour, beneath the image contents.
+ *
+ * The shadow is the image's own coverage (alpha), displaced by Offset. The
+ * image is converted to Format_ARGB32_Premultiplied.
+*/
+void MythImageEffects::DropShadow(QImage &Image, QPoint Offset, const QColor &Color)
+{
+    if (Image.isNull())
+        return;
+    if (Image.format() != QImage::Format_ARGB32_Premultiplied)
+        Image = Image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    int width  = Image.width();
+    int height = Image.height();
+
+    // The image is composited in place, so keep a copy of the original coverage
+    QVector<uchar> coverage(width * height);
+    for (int y = 0; y < height; ++y)
+    {
+        const auto *line = reinterpret_cast<const quint32*>(Image.constScanLine(y));
+        uchar *dest = coverage.data() + (y * width);
+        for (int x = 0; x < width; ++x)
+            dest[x] = static_cast<uchar>(line[x] >> 24);
+    }
+
+    QRgb colour = qPremultiply(Color.rgba());
+    int first = std::clamp(Offset.x(), 0, width);
+    int last  = std::clamp(width + Offset.x(), 0, width);
+    QVector<uchar> shadow(width, 0);
+    for (int y = 0; y < height; ++y)
+    {
+        int source = y - Offset.y();
+        if (source < 0 || source >= height || first >= last)
+            continue;
+        memcpy(shadow.data() + first, coverage.constData() + (source * width) + first - Offset.x(),
+               static_cast<size_t>(last - first));
+        ShadowRow(reinterpret_cast<quint32*>(Image.scanLine(y)), shadow.constData(), colour, width);
+    }
+}
@@ -0,0 +1,26 @@
+#ifndef MYTHIMAGEEFFECTS_H
+#define MYTHIMAGEEFFECTS_H
+
+// MythTV
+#include "mythuiexp.h"
+#include "mythimage.h"
+
+/*! \class MythImageEffects
+ *  \brief Per pixel image effects used by MythImage and MythPainter.
+ *
+ * Each effect works directly on the image's scanlines, using SSE2 or NEON
+ * when available, rather than through QPainter or per pixel QImage calls.
+ * The effects are reentrant and may be used from image loading threads.
+*/
+class MUI_PUBLIC MythImageEffects
+{
+  public:
+    static void Greyscale  (QImage &Image);
+    static void FadeAlpha  (QImage &Image, int Start, int End, FillDirection Direction);
+    static void Gradient   (QImage &Image, const QColor &Begin, const QColor &End,
+                            FillDirection Direction);
+    static void DropShadow (QImage &Image, QPoint Offset, const QColor &Color);
+    static bool HaveSIMD   (void);
+};
+
+#endif
@@ -69,6 +69,12 @@ using namespace std;
 
 #define LOC QString("MythMainWindow: ")
 
+// Pulse at 4Hz after 2 seconds with nothing to draw
+static constexpr int kIdlePulses       { 2 * MythMainWindow::drawRefresh };
+static constexpr int kIdleDrawInterval { 250 };
+// Frames averaged for redrawn pixel statistics
+static constexpr int kDrawStatsFrames  { 60 };
+
 static MythMainWindow *mainWin = nullptr;
 static QMutex mainLock;
 
@@ -332,6 +338,8 @@ void MythMainWindow::animate(void)
     d->m_drawTimer->blockSignals(true);
 
     bool redraw = false;
+    d->m_pulseRequired = false;
+    d->m_pulsing = true;
 
     if (!m_repaintRegion.isEmpty())
         redraw = true;
@@ -360,6 +368,20 @@ void MythMainWindow::animate(void)
     if (redraw && !m_painterWin->RenderIsShared())
         m_painterWin->update(m_repaintRegion);
 
+    // Drop to the idle rate when nothing has been drawn for a while and no
+    // widget is waiting on the pulse (e.g. paused scrolling text)
+    if (redraw || d->m_pulseRequired || m_painterWin->RenderIsShared())
+    {
+        d->m_quietPulses = 0;
+        if (d->m_drawIdle)
+            SetDrawIdle(false);
+    }
+    else if (!d->m_drawIdle && (++d->m_quietPulses > kIdlePulses))
+    {
+        SetDrawIdle(true);
+    }
+    d->m_pulsing = false;
+
     for (auto *widget : qAsConst(d->m_stackList))
         widget->ScheduleInitIfNeeded();
 
@@ -420,10 +442,12 @@ void MythMainWindow::drawScreen(QPaintEvent* Event)
         }
     }
 
+    // N.B. Draw resets the repaint region (to anything the painter could
+    // not draw in this update)
     if (!m_painterWin->RenderIsShared())
         Draw();
-
-    m_repaintRegion = QRegion();
+    else
+        m_repaintRegion = QRegion();
 }
 
 void MythMainWindow::Draw(MythPainter *Painter /* = nullptr */)
@@ -437,6 +461,23 @@ void MythMainWindow::Draw(MythPainter *Painter /* = nullptr */)
 
     if (!Painter->SupportsClipping())
         m_repaintRegion = QRegion(d->m_uiScreenRect);
+    else
+        Painter->Clear(m_painterWin, m_repaintRegion);
+
+    if (VERBOSE_LEVEL_CHECK(VB_GPU, LOG_INFO))
+    {
+        for (const QRect& rect : m_repaintRegion)
+            d->m_drawnPixels += static_cast<int64_t>(rect.width()) * rect.height();
+        if (++d->m_drawnFrames >= kDrawStatsFrames)
+        {
+            int64_t screen = static_cast<int64_t>(d->m_uiScreenRect.width()) * d->m_uiScreenRect.height();
+            int64_t pixels = d->m_drawnPixels / d->m_drawnFrames;
+            LOG(VB_GPU, LOG_INFO, LOC + QString("Redrawn pixels/frame: %1 (%2% of screen)")
+                .arg(pixels).arg(screen ? (pixels * 100) / screen : 0));
+            d->m_drawnPixels = 0;
+            d->m_drawnFrames = 0;
+        }
+    }
 
     for (const QRect& rect : m_repaintRegion)
     {
@@ -458,7 +499,8 @@ void MythMainWindow::Draw(MythPainter *Painter /* = nullptr */)
     }
 
     Painter->End();
-    m_repaintRegion = QRegion();
+    // Anything deferred by the painter is drawn on the next update
+    m_repaintRegion = Painter->TakeDeferredArea();
 }
 
 // virtual
@@ -934,6 +976,7 @@ void MythMainWindow::ReinitDone(void)
     ShowPainterWindow();
     MoveResize(d->m_screenRect);
 
+    d->m_drawIdle = false;
     d->m_drawTimer->start(1000 / drawRefresh);
 }
 
@@ -1010,6 +1053,7 @@ void MythMainWindow::SetDrawEnabled(bool enable)
             QApplication::postEvent(this, new QEvent(QEvent::UpdateRequest), Qt::LowEventPriority);
             d->m_pendingUpdate = false;
         }
+        d->m_drawIdle = false;
         d->m_drawTimer->start(1000 / drawRefresh);
         ShowPainterWindow();
     }
@@ -2264,6 +2308,34 @@ int MythMainWindow::GetDrawInterval() const
     return d->m_drawInterval;
 }
 
+/*! \brief Keep the UI pulsing at the full rate.
+ *
+ * Widgets that change over time without redrawing on every pulse call this
+ * from Pulse. It is also called when any screen is marked for redraw, which
+ * wakes the draw timer if it is idle.
+*/
+void MythMainWindow::RequestPulse(void)
+{
+    d->m_pulseRequired = true;
+    if (!d->m_drawIdle || d->m_pulsing)
+        return;
+
+    SetDrawIdle(false);
+    // Don't wait for the next (idle) pulse to draw whatever woke us
+    QMetaObject::invokeMethod(this, "animate", Qt::QueuedConnection);
+}
+
+void MythMainWindow::SetDrawIdle(bool idle)
+{
+    d->m_drawIdle = idle;
+    d->m_quietPulses = 0;
+    if (!d->m_drawEnabled)
+        return;
+
+    LOG(VB_GUI, LOG_DEBUG, LOC + (idle ? "Entering" : "Leaving") + " idle mode");
+    d->m_drawTimer->start(idle ? kIdleDrawInterval : d->m_drawInterval);
+}
+
 void MythMainWindow::RestartInputHandlers(void)
 {
     m_deviceHandler->Reset();
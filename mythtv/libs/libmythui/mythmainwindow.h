@@ -113,6 +113,7 @@ class MUI_PUBLIC MythMainWindow : public QWidget
     void  SetUIScreenRect(QRect &rect);
 
     int GetDrawInterval() const;
+    void RequestPulse(void);
     int NormalizeFontSize(int pointSize);
     MythRect NormRect(const MythRect &rect);
     QPoint NormPoint(const QPoint &point);
@@ -163,6 +164,7 @@ class MUI_PUBLIC MythMainWindow : public QWidget
     bool event(QEvent* e) override; // QWidget
     void ExitToMainMenu();
     void ShowMouseCursor(bool show);
+    void SetDrawIdle(bool idle);
 
     MythMainWindowPrivate *d {nullptr}; // NOLINT(readability-identifier-naming)
 
@@ -79,6 +79,14 @@ class MythMainWindowPrivate
     int      m_escapekey                 { 0       };
     int      m_drawInterval              { 1000 / MythMainWindow::drawRefresh };
     MythSignalingTimer *m_drawTimer      { nullptr };
+    /// The draw timer runs at a low rate when nothing has changed for a while
+    bool             m_drawIdle          { false   };
+    bool             m_pulseRequired     { false   };
+    bool             m_pulsing           { false   };
+    int              m_quietPulses       { 0       };
+    /// Redrawn pixel statistics for -v gpu
+    int64_t          m_drawnPixels       { 0       };
+    int              m_drawnFrames       { 0       };
     QVector<MythScreenStack *> m_stackList;
     MythScreenStack *m_mainStack         { nullptr };
     MythGesture      m_gesture;
@@ -6,6 +6,7 @@
 #include <QRect>
 #include <QPainter>
 #include <QPainterPath>
+#include <QGlyphRun>
 
 // libmythbase headers
 #include "mythlogging.h"
@@ -15,6 +16,8 @@
 // libmythui headers
 #include "mythfontproperties.h"
 #include "mythimage.h"
+#include "mythimageeffects.h"
+#include "mythglyphatlas.h"
 #include "mythuianimation.h"    // UIEffects
 
 // Own header
@@ -27,6 +30,9 @@ MythPainter::MythPainter()
 
 void MythPainter::Teardown(void)
 {
+    delete m_glyphAtlas;
+    m_glyphAtlas = nullptr;
+
     ExpireImages(0);
 
     QMutexLocker locker(&m_allocationLock);
@@ -129,6 +135,12 @@ void MythPainter::DrawTextLayout(const QRect & canvasRect,
     if (canvasRect.isNull())
         return;
 
+    if (SupportsGlyphAtlas() &&
+        DrawTextLayoutGlyphs(canvasRect, layouts, font, alpha, destRect))
+    {
+        return;
+    }
+
     QRect      canvas(canvasRect);
     QRect      dest(destRect);
 
@@ -154,6 +166,77 @@ void MythPainter::DrawTextLayout(const QRect & canvasRect,
     im->DecrRef();
 }
 
+/*! \brief Draw text from the glyph atlas.
+ *
+ * Plain text in a solid color is drawn as a set of quads from the shared glyph
+ * atlas, which avoids rendering and uploading an image for every distinct
+ * string. Text that needs effects (shadow, outline or formatting) is left to
+ * the string image cache.
+ *
+ * \return false if the text cannot be drawn from the atlas.
+*/
+bool MythPainter::DrawTextLayoutGlyphs(const QRect &canvasRect,
+                                       const LayoutVector &layouts,
+                                       const MythFontProperties &font,
+                                       int alpha, const QRect &destRect)
+{
+    if (font.hasShadow() || font.hasOutline() ||
+        font.GetBrush().style() != Qt::SolidPattern)
+    {
+        return false;
+    }
+
+    for (auto *layout : qAsConst(layouts))
+        if (!layout->formats().isEmpty())
+            return false;
+
+    if (!m_glyphAtlas)
+        m_glyphAtlas = new MythGlyphAtlas(this);
+    m_glyphAtlas->ResetIfFull();
+
+    // Match the clipping and offset used by GetImageFromTextLayout
+    QRect clip(destRect.topLeft(), destRect.size().boundedTo(canvasRect.size()));
+    QPointF origin = destRect.topLeft() + canvasRect.topLeft();
+
+    // Gather every glyph first, so that nothing is drawn if the atlas fills up
+    QHash<MythImage*, QPair<QVector<QRect>,QVector<QRect> > > quads;
+    MythGlyph glyph;
+    for (auto *layout : qAsConst(layouts))
+    {
+        QPointF position = origin + layout->position();
+        const QList<QGlyphRun> runs = layout->glyphRuns();
+        for (const auto & run : runs)
+        {
+            QRawFont rawfont = run.rawFont();
+            QVector<quint32> indexes = run.glyphIndexes();
+            QVector<QPointF> positions = run.positions();
+            for (int i = 0; i < indexes.size() && i < positions.size(); ++i)
+            {
+                if (!m_glyphAtlas->GetGlyph(rawfont, indexes[i], glyph))
+                    return false;
+                if (glyph.m_source.isEmpty())
+                    continue;
+
+                QRect dest(QPoint(qRound(position.x() + positions[i].x()),
+                                  qRound(position.y() + positions[i].y())) + glyph.m_offset,
+                           glyph.m_source.size());
+                QRect visible = dest.intersected(clip);
+                if (visible.isEmpty())
+                    continue;
+
+                auto & quad = quads[glyph.m_page];
+                quad.first.append(QRect(glyph.m_source.topLeft() + (visible.topLeft() - dest.topLeft()),
+                                        visible.size()));
+                quad.second.append(visible);
+            }
+        }
+    }
+
+    for (auto it = quads.cbegin(); it != quads.cend(); ++it)
+        DrawGlyphs(it.key(), it.value().first, it.value().second, font.color(), alpha);
+    return true;
+}
+
 void MythPainter::DrawRect(const QRect &area, const QBrush &fillBrush,
                            const QPen &linePen, int alpha)
 {
@@ -248,6 +331,31 @@ void MythPainter::DrawTextPriv(MythImage *im, const QString &msg, int flags,
     int textOffsetY =
         initialPaddingY + std::max(outlineSize, -shadowOffset.y());
 
+    QFont tmpfont = font.face();
+#if QT_VERSION < QT_VERSION_CHECK(5,15,0)
+    tmpfont.setStyleStrategy(QFont::OpenGLCompatible);
+#endif
+
+    // A shadow beneath opaque text is the text's own coverage, so rasterise
+    // the text once and derive the shadow from it.
+    if (font.hasShadow() && !font.hasOutline() && font.GetBrush().isOpaque())
+    {
+        QImage pm(r.size(), QImage::Format_ARGB32_Premultiplied);
+        pm.fill(Qt::transparent);
+        QPainter tmp(&pm);
+        tmp.setFont(tmpfont);
+        tmp.setPen(QPen(font.GetBrush(), 0));
+        tmp.setBrush(font.GetBrush());
+        tmp.drawText(textOffsetX, textOffsetY, r.width(), r.height(),
+                     flags, msg);
+        tmp.end();
+
+        shadowColor.setAlpha(shadowAlpha);
+        MythImageEffects::DropShadow(pm, shadowOffset, shadowColor);
+        im->Assign(pm);
+        return;
+    }
+
     QImage pm(r.size(), QImage::Format_ARGB32);
     QColor fillcolor = font.color();
     if (font.hasOutline())
@@ -256,10 +364,6 @@ void MythPainter::DrawTextPriv(MythImage *im, const QString &msg, int flags,
     pm.fill(fillcolor.rgba());
 
     QPainter tmp(&pm);
-    QFont tmpfont = font.face();
-#if QT_VERSION < QT_VERSION_CHECK(5,15,0)
-    tmpfont.setStyleStrategy(QFont::OpenGLCompatible);
-#endif
     tmp.setFont(tmpfont);
 
     QPainterPath path;
@@ -6,6 +6,7 @@
 #include <QTextLayout>
 #include <QWidget>
 #include <QPaintDevice>
+#include <QRegion>
 #include <QMutex>
 #include <QSet>
 
@@ -24,6 +25,7 @@ class QColor;
 
 class MythFontProperties;
 class MythImage;
+class MythGlyphAtlas;
 class UIEffects;
 
 using LayoutVector = QVector<QTextLayout *>;
@@ -48,6 +50,7 @@ class MUI_PUBLIC MythPainter : public QObject
     virtual bool SupportsAnimation(void) = 0;
     virtual bool SupportsAlpha(void) = 0;
     virtual bool SupportsClipping(void) = 0;
+    virtual bool SupportsGlyphAtlas(void) { return false; }
     virtual void FreeResources(void) { }
     virtual void Begin(QPaintDevice *parent) { m_parent = parent; }
     virtual void End() { m_parent = nullptr; }
@@ -100,6 +103,14 @@ class MUI_PUBLIC MythPainter : public QObject
 
     void SetMaximumCacheSizes(int hardware, int software);
 
+    /// Convert a newly loaded image into the form preferred by this painter.
+    /// \note Called from image loader threads. Must not use the render device.
+    virtual void PrepareImage(MythImage */*Image*/) { }
+
+    /// Returns (and resets) the area that could not be completely drawn in the
+    /// last frame, and which should be redrawn as soon as possible.
+    virtual QRegion TakeDeferredArea(void) { return {}; }
+
   protected:
     static void DrawTextPriv(MythImage *im, const QString &msg, int flags,
                              const QRect &r, const MythFontProperties &font);
@@ -116,6 +127,12 @@ class MUI_PUBLIC MythPainter : public QObject
                                 const QBrush &fillBrush,
                                 const QPen &linePen);
 
+    /// Draw a set of glyphs from a glyph atlas page, tinted with the given
+    /// color. Only used by painters that return true from SupportsGlyphAtlas().
+    virtual void DrawGlyphs(MythImage */*Atlas*/, const QVector<QRect> &/*Sources*/,
+                            const QVector<QRect> &/*Destinations*/,
+                            const QColor &/*Color*/, int /*Alpha*/) { }
+
     /// Creates a reference counted image, call DecrRef() to delete.
     virtual MythImage* GetFormatImagePriv(void) = 0;
     virtual void DeleteFormatImagePriv(MythImage *im) = 0;
@@ -132,6 +149,11 @@ class MUI_PUBLIC MythPainter : public QObject
     int m_maxHardwareCacheSize  {0};
 
   private:
+    bool DrawTextLayoutGlyphs(const QRect &canvasRect,
+                              const LayoutVector &layouts,
+                              const MythFontProperties &font, int alpha,
+                              const QRect &destRect);
+
     int64_t m_softwareCacheSize {0};
     int64_t m_maxSoftwareCacheSize {1024 * 1024 * 48};
 
@@ -141,6 +163,8 @@ class MUI_PUBLIC MythPainter : public QObject
     QMap<QString, MythImage *> m_stringToImageMap;
     std::list<QString>         m_stringExpireList;
 
+    MythGlyphAtlas  *m_glyphAtlas {nullptr};
+
     bool m_showBorders          {false};
     bool m_showNames            {false};
 };
@@ -1,5 +1,6 @@
 #include "mythuibuttonlist.h"
 
+#include <algorithm>
 #include <cmath>
 #include <utility>
 
@@ -114,6 +115,8 @@ void MythUIButtonList::SetActive(bool active)
 void MythUIButtonList::Reset()
 {
     m_ButtonToItem.clear();
+    m_provider = nullptr;
+    m_loadedItems.clear();
 
     if (m_itemList.isEmpty())
         return;
@@ -206,7 +209,7 @@ MythUIGroup *MythUIButtonList::PrepareButton(int buttonIdx, int itemIdx,
                                              int &selectedIdx,
                                              int &button_shift)
 {
-    MythUIButtonListItem *buttonItem = m_itemList[itemIdx];
+    MythUIButtonListItem *buttonItem = ItemAt(itemIdx);
 
     buttonIdx += button_shift;
 
@@ -1341,12 +1344,12 @@ void MythUIButtonList::CalculateButtonPositions(void)
     if (it < m_itemList.begin())
         it = m_itemList.begin();
 
-    int curItem = it < m_itemList.end() ? GetItemPos(*it) : 0;
+    int curItem = it < m_itemList.end() ? static_cast<int>(it - m_itemList.begin()) : 0;
 
     while (it < m_itemList.end() && button < m_itemsVisible)
     {
         realButton = m_ButtonList[button];
-        buttonItem = *it;
+        buttonItem = ItemAt(curItem);
 
         if (!realButton || !buttonItem)
             break;
@@ -1421,6 +1424,7 @@ void MythUIButtonList::CalculateArrowStates()
     else
         DistributeButtons();
 
+    UpdateVirtualWindow();
     updateLCD();
 
     m_needsUpdate = false;
@@ -1458,6 +1462,17 @@ void MythUIButtonList::ItemVisible(MythUIButtonListItem *item)
 
 void MythUIButtonList::InsertItem(MythUIButtonListItem *item, int listPosition)
 {
+    // Items created by LoadItem are placed by the caller
+    if (m_loadingItem)
+        return;
+
+    if (m_provider)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Cannot add items to a list with a provider");
+        item->m_parent = nullptr;
+        return;
+    }
+
     bool wasEmpty = m_itemList.isEmpty();
 
     if (listPosition >= 0 && listPosition <= m_itemList.count())
@@ -1495,6 +1510,22 @@ void MythUIButtonList::RemoveItem(MythUIButtonListItem *item)
     if (curIndex == -1)
         return;
 
+    // The item is being deleted - in virtual mode it is reloaded when needed
+    if (m_provider)
+    {
+        m_itemList[curIndex] = nullptr;
+        m_loadedItems.remove(curIndex);
+        for (auto it = m_ButtonToItem.begin(); it != m_ButtonToItem.end(); )
+        {
+            if (it.value() == item)
+                it = m_ButtonToItem.erase(it);
+            else
+                ++it;
+        }
+        Update();
+        return;
+    }
+
     QMap<int, MythUIButtonListItem*>::iterator it = m_ButtonToItem.begin();
     while (it != m_ButtonToItem.end())
     {
@@ -1531,7 +1562,7 @@ void MythUIButtonList::RemoveItem(MythUIButtonListItem *item)
     Update();
 
     if (m_selPosition < m_itemCount)
-        emit itemSelected(m_itemList.at(m_selPosition));
+        emit itemSelected(ItemAt(m_selPosition));
     else
         emit itemSelected(nullptr);
 
@@ -1544,9 +1575,20 @@ void MythUIButtonList::SetValueByData(const QVariant& data)
     if (!m_initialized)
         Init();
 
+    if (m_provider)
+    {
+        int pos = m_provider->GetDataPosition(data);
+        if (pos >= 0 && pos < m_itemCount)
+        {
+            SetItemCurrent(pos);
+            return;
+        }
+    }
+
+    // N.B. In virtual mode, this only finds items that are currently loaded
     for (auto *item : qAsConst(m_itemList))
     {
-        if (item->GetData() == data)
+        if (item && item->GetData() == data)
         {
             SetItemCurrent(item);
             return;
@@ -1568,7 +1610,7 @@ void MythUIButtonList::SetItemCurrent(int current, int topPosition)
     if (current == -1 || current >= m_itemList.size())
         return;
 
-    if (!m_itemList.at(current)->isEnabled())
+    if (!ItemAt(current)->isEnabled())
         return;
 
     if (current == m_selPosition &&
@@ -1593,7 +1635,7 @@ MythUIButtonListItem *MythUIButtonList::GetItemCurrent() const
         m_selPosition < 0)
         return nullptr;
 
-    return m_itemList.at(m_selPosition);
+    return ItemAt(m_selPosition);
 }
 
 int MythUIButtonList::GetIntValue() const
@@ -1636,7 +1678,7 @@ MythRect MythUIButtonList::GetButtonArea(void) const
 MythUIButtonListItem *MythUIButtonList::GetItemFirst() const
 {
     if (!m_itemList.empty())
-        return m_itemList[0];
+        return ItemAt(0);
 
     return nullptr;
 }
@@ -1644,12 +1686,12 @@ MythUIButtonListItem *MythUIButtonList::GetItemFirst() const
 MythUIButtonListItem *MythUIButtonList::GetItemNext(MythUIButtonListItem *item)
 const
 {
-    QListIterator<MythUIButtonListItem *> it(m_itemList);
-
-    if (!it.findNext(item))
+    // In virtual mode the next item is loaded if needed
+    int pos = item ? m_itemList.indexOf(item) : -1;
+    if (pos < 0 || pos + 1 >= m_itemList.size())
         return nullptr;
 
-    return it.previous();
+    return ItemAt(pos + 1);
 }
 
 int MythUIButtonList::GetCount() const
@@ -1678,7 +1720,7 @@ MythUIButtonListItem *MythUIButtonList::GetItemAt(int pos) const
     if (pos < 0 || pos >= m_itemList.size())
         return nullptr;
 
-    return m_itemList.at(pos);
+    return ItemAt(pos);
 }
 
 MythUIButtonListItem *MythUIButtonList::GetItemByData(const QVariant& data)
@@ -1686,9 +1728,17 @@ MythUIButtonListItem *MythUIButtonList::GetItemByData(const QVariant& data)
     if (!m_initialized)
         Init();
 
+    if (m_provider)
+    {
+        int pos = m_provider->GetDataPosition(data);
+        if (pos >= 0 && pos < m_itemCount)
+            return ItemAt(pos);
+    }
+
+    // N.B. In virtual mode, this only finds items that are currently loaded
     for (auto *item : qAsConst(m_itemList))
     {
-        if (item->GetData() == data)
+        if (item && item->GetData() == data)
             return item;
     }
 
@@ -1706,7 +1756,7 @@ int MythUIButtonList::GetItemPos(MythUIButtonListItem *item) const
 void MythUIButtonList::InitButton(int itemIdx, MythUIStateType* & realButton,
                                   MythUIButtonListItem* & buttonItem)
 {
-    buttonItem = m_itemList[itemIdx];
+    buttonItem = ItemAt(itemIdx);
 
     if (m_maxVisible == 0)
     {
@@ -2072,7 +2122,7 @@ bool MythUIButtonList::MoveUp(MovementUnit unit, uint amount)
 void MythUIButtonList::FindEnabledDown(MovementUnit unit)
 {
     if (m_selPosition < 0 || m_selPosition >= m_itemList.size() ||
-        m_itemList.at(m_selPosition)->isEnabled())
+        ItemAt(m_selPosition)->isEnabled())
         return;
 
     int step = (unit == MoveRow) ? m_columns : 1;
@@ -2082,32 +2132,32 @@ void MythUIButtonList::FindEnabledDown(MovementUnit unit)
     {
         while (m_selPosition < m_itemList.size() &&
                (m_selPosition + 1) % m_columns > 0 &&
-               !m_itemList.at(m_selPosition)->isEnabled())
+               !ItemAt(m_selPosition)->isEnabled())
             ++m_selPosition;
 
-        if (m_itemList.at(m_selPosition)->isEnabled())
+        if (ItemAt(m_selPosition)->isEnabled())
             return;
 
         if (m_wrapStyle > WrapNone)
         {
             m_selPosition = m_selPosition - (m_columns - 1);
             while ((m_selPosition + 1) % m_columns > 0 &&
-                   !m_itemList.at(m_selPosition)->isEnabled())
+                   !ItemAt(m_selPosition)->isEnabled())
                 ++m_selPosition;
         }
     }
     else
     {
-        while (!m_itemList.at(m_selPosition)->isEnabled() &&
+        while (!ItemAt(m_selPosition)->isEnabled() &&
                (m_selPosition < m_itemList.size() - step))
             m_selPosition += step;
 
-        if (!m_itemList.at(m_selPosition)->isEnabled() &&
+        if (!ItemAt(m_selPosition)->isEnabled() &&
             m_wrapStyle > WrapNone)
         {
             m_selPosition = (m_selPosition + step) % m_itemList.size();
 
-            while (!m_itemList.at(m_selPosition)->isEnabled() &&
+            while (!ItemAt(m_selPosition)->isEnabled() &&
                    (m_selPosition < m_itemList.size() - step))
                 m_selPosition += step;
         }
@@ -2117,7 +2167,7 @@ void MythUIButtonList::FindEnabledDown(MovementUnit unit)
 void MythUIButtonList::FindEnabledUp(MovementUnit unit)
 {
     if (m_selPosition < 0 || m_selPosition >= m_itemList.size() ||
-        m_itemList.at(m_selPosition)->isEnabled())
+        ItemAt(m_selPosition)->isEnabled())
         return;
 
     int step = (unit == MoveRow) ? m_columns : 1;
@@ -2126,33 +2176,33 @@ void MythUIButtonList::FindEnabledUp(MovementUnit unit)
     if (unit == MoveColumn)
     {
         while (m_selPosition > 0 && (m_selPosition - 1) % m_columns > 0 &&
-               !m_itemList.at(m_selPosition)->isEnabled())
+               !ItemAt(m_selPosition)->isEnabled())
             --m_selPosition;
 
-        if (m_itemList.at(m_selPosition)->isEnabled())
+        if (ItemAt(m_selPosition)->isEnabled())
             return;
 
         if (m_wrapStyle > WrapNone)
         {
             m_selPosition = m_selPosition + (m_columns - 1);
             while ((m_selPosition - 1) % m_columns > 0 &&
-                   !m_itemList.at(m_selPosition)->isEnabled())
+                   !ItemAt(m_selPosition)->isEnabled())
                 --m_selPosition;
         }
     }
     else
     {
-        while (!m_itemList.at(m_selPosition)->isEnabled() &&
+        while (!ItemAt(m_selPosition)->isEnabled() &&
                (m_selPosition - step >= 0))
             m_selPosition -= step;
 
-        if (!m_itemList.at(m_selPosition)->isEnabled() &&
+        if (!ItemAt(m_selPosition)->isEnabled() &&
             m_wrapStyle > WrapNone)
         {
             m_selPosition = m_itemList.size() - 1;
 
             while (m_selPosition > 0 &&
-                   !m_itemList.at(m_selPosition)->isEnabled() &&
+                   !ItemAt(m_selPosition)->isEnabled() &&
                    (m_selPosition - step >= 0))
                 m_selPosition -= step;
         }
@@ -2287,13 +2337,24 @@ bool MythUIButtonList::MoveToNamedPosition(const QString &position_name)
     if (m_selPosition < 0 || m_itemList.isEmpty() || !m_initialized)
         return false;
 
+    // Match the sort key in virtual mode, rather than loading every item
+    if (m_provider && m_provider->HasSortKey())
+    {
+        int pos = FindSortKey(position_name);
+        if (pos >= m_itemCount || m_provider->GetSortKey(pos) != position_name ||
+            pos == m_selPosition)
+            return false;
+        SetItemCurrent(pos);
+        return true;
+    }
+
     bool found_it = false;
     int selectedPosition = 0;
     QList<MythUIButtonListItem *>::iterator it = m_itemList.begin();
 
     while (it != m_itemList.end())
     {
-        if ((*it)->GetText() == position_name)
+        if (ItemAt(selectedPosition)->GetText() == position_name)
         {
             found_it = true;
             break;
@@ -2312,7 +2373,8 @@ bool MythUIButtonList::MoveToNamedPosition(const QString &position_name)
 
 bool MythUIButtonList::MoveItemUpDown(MythUIButtonListItem *item, bool up)
 {
-    if (GetItemCurrent() != item)
+    // The order of virtual items is determined by the provider
+    if (m_provider || GetItemCurrent() != item)
         return false;
 
     if (item == m_itemList.first() && up)
@@ -2358,10 +2420,16 @@ bool MythUIButtonList::MoveItemUpDown(MythUIButtonListItem *item, bool up)
 
 void MythUIButtonList::SetAllChecked(MythUIButtonListItem::CheckState state)
 {
+    // N.B. In virtual mode the check state belongs to the provider and only
+    // the items that are currently loaded are changed
     QMutableListIterator<MythUIButtonListItem *> it(m_itemList);
 
     while (it.hasNext())
-        it.next()->setChecked(state);
+    {
+        MythUIButtonListItem *item = it.next();
+        if (item)
+            item->setChecked(state);
+    }
 }
 
 void MythUIButtonList::Init()
@@ -2759,6 +2827,10 @@ void MythUIButtonList::customEvent(QEvent *event)
 
 void MythUIButtonList::LoadInBackground(int start, int pageSize)
 {
+    // Virtual items are only loaded when needed
+    if (m_provider)
+        return;
+
     m_nextItemLoaded = start;
     QCoreApplication::
         postEvent(this, new NextButtonListPageEvent(start, pageSize));
@@ -2771,6 +2843,235 @@ int MythUIButtonList::StopLoad(void)
     return m_nextItemLoaded;
 }
 
+/**
+ *  \brief Use a provider to supply the items, rather than adding them.
+ *
+ * Any existing items are removed. The list is positioned on the item at
+ * \p current without loading any other items.
+ *
+ *  \sa MythUIButtonListProvider
+ */
+void MythUIButtonList::SetProvider(MythUIButtonListProvider *provider, int current)
+{
+    Reset();
+    m_provider = provider;
+    if (m_provider)
+        ProviderChanged(current);
+}
+
+/**
+ *  \brief Reload the list after the provider's items have changed.
+ *
+ * All loaded items are discarded and the item count is read again. The list
+ * is positioned on \p current or, if that is -1, the current position.
+ */
+void MythUIButtonList::ProviderChanged(int current)
+{
+    if (!m_provider)
+        return;
+
+    if (current < 0)
+        current = m_selPosition;
+
+    DropVirtualItems();
+    m_itemList.clear();
+
+    int count = std::max(m_provider->GetItemCount(), 0);
+    m_itemList.reserve(count);
+    for (int i = 0; i < count; ++i)
+        m_itemList.append(nullptr);
+    m_itemCount = count;
+
+    m_selPosition = std::max(std::min(current, count - 1), 0);
+    m_topPosition = 0;
+
+    LOG(VB_GUI, LOG_DEBUG, LOC + QString("Provider has %1 items").arg(count));
+
+    Update();
+    emit DependChanged(count == 0);
+    emit itemSelected(GetItemCurrent());
+}
+
+/// \brief Reload a single item if it is loaded.
+void MythUIButtonList::ProviderItemChanged(int position)
+{
+    if (!m_provider || position < 0 || position >= m_itemList.size() ||
+        !m_itemList.at(position))
+        return;
+
+    DropItem(position);
+    Update();
+}
+
+/// \brief Return the item at \p pos, loading it from the provider if needed.
+MythUIButtonListItem *MythUIButtonList::ItemAt(int pos) const
+{
+    MythUIButtonListItem *item = m_itemList.at(pos);
+    if (item || !m_provider)
+        return item;
+
+    // Loading an item does not change the logical contents of the list
+    return const_cast<MythUIButtonList*>(this)->LoadItem(pos);
+}
+
+MythUIButtonListItem *MythUIButtonList::LoadItem(int pos)
+{
+    m_loadingItem = true;
+    auto *item = new MythUIButtonListItem(this, QString());
+    m_loadingItem = false;
+
+    m_itemList[pos] = item;
+    m_loadedItems.insert(pos);
+    m_provider->FillItem(item, pos);
+    return item;
+}
+
+void MythUIButtonList::DropItem(int pos)
+{
+    MythUIButtonListItem *item = m_itemList.at(pos);
+    m_itemList[pos] = nullptr;
+    m_loadedItems.remove(pos);
+    if (!item)
+        return;
+
+    for (auto it = m_ButtonToItem.begin(); it != m_ButtonToItem.end(); )
+    {
+        if (it.value() == item)
+            it = m_ButtonToItem.erase(it);
+        else
+            ++it;
+    }
+
+    item->m_parent = nullptr;
+    delete item;
+}
+
+void MythUIButtonList::DropVirtualItems(void)
+{
+    QList<int> loaded = m_loadedItems.values();
+    for (int pos : qAsConst(loaded))
+        DropItem(pos);
+    m_loadedItems.clear();
+}
+
+/**
+ *  \brief Load the items around the visible window and discard those that are
+ *         well outside it.
+ *
+ * A page either side of the window is loaded in advance, so that scrolling
+ * does not stall on the provider, and items more than 2 pages away are deleted.
+ */
+void MythUIButtonList::UpdateVirtualWindow(void)
+{
+    if (!m_provider || m_itemCount < 1)
+        return;
+
+    int page  = std::max(m_itemsVisible, 1);
+    int first = std::max(m_topPosition - page, 0);
+    int last  = std::min(m_topPosition + m_itemsVisible + page, m_itemCount);
+    for (int pos = first; pos < last; ++pos)
+        ItemAt(pos);
+
+    int keepfirst = m_topPosition - (page * 2);
+    int keeplast  = m_topPosition + m_itemsVisible + (page * 2);
+    QSet<MythUIButtonListItem*> shown;
+    for (auto * item : qAsConst(m_ButtonToItem))
+        shown.insert(item);
+
+    QList<int> expired;
+    for (int pos : qAsConst(m_loadedItems))
+    {
+        if ((pos < keepfirst || pos >= keeplast) && pos != m_selPosition &&
+            !shown.contains(m_itemList.at(pos)))
+        {
+            expired.append(pos);
+        }
+    }
+
+    for (int pos : qAsConst(expired))
+        DropItem(pos);
+}
+
+/// \brief Return the position of the first sort key that is not less than \p key.
+int MythUIButtonList::FindSortKey(const QString &key) const
+{
+    int first = 0;
+    int count = m_itemCount;
+    while (count > 0)
+    {
+        int step = count / 2;
+        int pos  = first + step;
+        if (QString::compare(m_provider->GetSortKey(pos), key, Qt::CaseInsensitive) < 0)
+        {
+            first = pos + 1;
+            count -= step + 1;
+        }
+        else
+        {
+            count = step;
+        }
+    }
+    return first;
+}
+
+/**
+ *  \brief Search the provider's sort keys.
+ *
+ * A 'starts with' search uses a binary search, as the matching items are
+ * adjacent. Other searches check each key in turn, without loading any items.
+ */
+bool MythUIButtonList::DoVirtualFind(bool doMove, bool searchForward)
+{
+    auto matches = [&](int pos)
+    {
+        QString key = m_provider->GetSortKey(pos);
+        if (m_searchStartsWith)
+            return key.startsWith(m_searchStr, Qt::CaseInsensitive);
+        return key.contains(m_searchStr, Qt::CaseInsensitive);
+    };
+
+    int current = GetCurrentPos();
+
+    if (m_searchStartsWith)
+    {
+        int pos = FindSortKey(m_searchStr);
+        if (doMove)
+        {
+            int next = searchForward ? current + 1 : current - 1;
+            if (next >= pos && next < m_itemCount && matches(next))
+                pos = next;
+            else if (!searchForward)
+            {
+                // wrap to the last match
+                int end = pos;
+                while (end + 1 < m_itemCount && matches(end + 1))
+                    ++end;
+                pos = end;
+            }
+        }
+
+        if (pos < m_itemCount && matches(pos))
+        {
+            SetItemCurrent(pos);
+            return true;
+        }
+        return false;
+    }
+
+    int pos = current;
+    for (int i = 0; i < m_itemCount; ++i)
+    {
+        if (doMove || i > 0)
+            pos = (pos + (searchForward ? 1 : m_itemCount - 1)) % m_itemCount;
+        if (matches(pos))
+        {
+            SetItemCurrent(pos);
+            return true;
+        }
+    }
+    return false;
+}
+
 QPoint MythUIButtonList::GetButtonPosition(int column, int row) const
 {
     int x = m_contentsRect.x() +
@@ -3156,6 +3457,9 @@ bool MythUIButtonList::DoFind(bool doMove, bool searchForward)
     if (GetCount() == 0)
         return false;
 
+    if (m_provider && m_provider->HasSortKey())
+        return DoVirtualFind(doMove, searchForward);
+
     int startPos = GetCurrentPos();
     int currPos = startPos;
     bool found = false;
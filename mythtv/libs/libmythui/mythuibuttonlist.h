@@ -6,6 +6,7 @@
 // Qt headers
 #include <QHash>
 #include <QList>
+#include <QSet>
 #include <QString>
 #include <QVariant>
 
@@ -131,6 +132,43 @@ class MUI_PUBLIC MythUIButtonListItem
     friend class MythGenericTree;
 };
 
+/**
+ * \class MythUIButtonListProvider
+ *
+ * \brief Supplies the items of a MythUIButtonList in virtual mode.
+ *
+ * In virtual mode the list only knows the number of items. Items are created
+ * when they are needed (i.e. for the visible window and a page either side)
+ * and passed to FillItem to be populated, and items that have scrolled well
+ * out of view are deleted again. Jumping to any position is immediate and the
+ * memory used does not grow with the size of the list.
+ *
+ * If the provider supplies a sort key for every item, in ascending order
+ * (compared case insensitively), then searching and MoveToNamedPosition use a
+ * binary search over the keys rather than creating items to search their text.
+ *
+ * GetItemByData() and SetValueByData() ask GetDataPosition() for the position
+ * of an item's data. A provider that doesn't implement it can only be searched
+ * by data among the items that are currently loaded.
+ *
+ * \note Item pointers are only valid while the item is near the visible
+ * window. Use positions (or GetDataValue()) to identify items. GetItemNext()
+ * loads each item it steps to, so walking a whole large list that way
+ * defeats the purpose of virtual mode.
+ */
+class MUI_PUBLIC MythUIButtonListProvider
+{
+  public:
+    virtual ~MythUIButtonListProvider() = default;
+
+    virtual int     GetItemCount(void) const = 0;
+    virtual void    FillItem(MythUIButtonListItem *item, int position) = 0;
+    virtual bool    HasSortKey(void) const { return false; }
+    virtual QString GetSortKey(int /*position*/) const { return QString(); }
+    /// Return the position of the item with \p data, or -1 if unknown
+    virtual int     GetDataPosition(const QVariant &/*data*/) const { return -1; }
+};
+
 /**
  * \class MythUIButtonList
  *
@@ -212,6 +250,11 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
     void LoadInBackground(int start = 0, int pageSize = 20);
     int  StopLoad(void);
 
+    void SetProvider(MythUIButtonListProvider *provider, int current = 0);
+    MythUIButtonListProvider *GetProvider(void) const { return m_provider; }
+    void ProviderChanged(int current = -1);
+    void ProviderItemChanged(int position);
+
   public slots:
     void Select();
     void Deselect();
@@ -285,6 +328,14 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
 
     void SanitizePosition(void);
 
+    MythUIButtonListItem *ItemAt(int pos) const;
+    MythUIButtonListItem *LoadItem(int pos);
+    void DropItem(int pos);
+    void DropVirtualItems(void);
+    void UpdateVirtualWindow(void);
+    int  FindSortKey(const QString &key) const;
+    bool DoVirtualFind(bool doMove, bool searchForward);
+
     /**/
 
     LayoutType  m_layout              {LayoutVertical};
@@ -339,6 +390,11 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
     QList<MythUIButtonListItem*> m_itemList;
     int m_nextItemLoaded              {0};
 
+    // Virtual mode
+    MythUIButtonListProvider *m_provider {nullptr};
+    QSet<int> m_loadedItems;
+    bool m_loadingItem                {false};
+
     bool m_drawFromBottom             {false};
 
     QString     m_lcdTitle;
@@ -346,6 +402,7 @@ class MUI_PUBLIC MythUIButtonList : public MythUIType
 
     friend class MythUIButtonListItem;
     friend class MythUIButtonTree;
+    friend class TestMythUIButtonList;
 };
 
 class MUI_PUBLIC SearchButtonListDialog : public MythScreenType
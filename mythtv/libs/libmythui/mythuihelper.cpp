@@ -20,6 +20,8 @@
 #include <QEventLoop>
 #include <QTimer>
 #include <QScreen>
+#include <QElapsedTimer>
+#include <QRunnable>
 
 // mythbase headers
 #include "mythdirs.h"
@@ -40,6 +42,7 @@
 #include "themeinfo.h"
 #include "x11colors.h"
 #include "mythdisplay.h"
+#include "mythartworkcache.h"
 
 #define LOC      QString("MythUIHelper: ")
 
@@ -72,6 +75,7 @@ void MythUIHelper::destroyMythUI(void)
 {
     MythUIHelper::PruneCacheDir(GetRemoteCacheDir());
     MythUIHelper::PruneCacheDir(GetThumbnailDir());
+    MythArtworkCache::GetCache()->Save();
     uiLock.lock();
     delete mythui;
     mythui = nullptr;
@@ -361,6 +365,33 @@ void MythUIHelper::LoadQtConfig(void)
     d->m_menuthemepathname = FindMenuThemeDir(themename);
 }
 
+/// Removes stale theme caches and prunes the remote and thumbnail caches.
+class ImageCachePruner : public QRunnable
+{
+  public:
+    explicit ImageCachePruner(QString themecachedir)
+      : m_themecachedir(std::move(themecachedir)) {}
+
+    void run(void) override
+    {
+        // Theme changes can queue another prune before this one has finished
+        static QMutex s_pruneLock;
+        QMutexLocker locker(&s_pruneLock);
+
+        QElapsedTimer timer;
+        timer.start();
+        MythUIHelper::ClearOldImageCache(m_themecachedir);
+        MythUIHelper::PruneCacheDir(GetRemoteCacheDir());
+        MythUIHelper::PruneCacheDir(GetThumbnailDir());
+        MythArtworkCache::GetCache()->Prune();
+        LOG(VB_GUI | VB_FILE, LOG_INFO, LOC +
+            QString("Image cache pruning took %1ms").arg(timer.elapsed()));
+    }
+
+  private:
+    QString m_themecachedir;
+};
+
 void MythUIHelper::UpdateImageCache(void)
 {
     QMutexLocker locker(d->m_cacheLock);
@@ -379,9 +410,13 @@ void MythUIHelper::UpdateImageCache(void)
 
     d->m_cacheSize.fetchAndStoreOrdered(0);
 
-    ClearOldImageCache();
-    PruneCacheDir(GetRemoteCacheDir());
-    PruneCacheDir(GetThumbnailDir());
+    QString themecachedir = GetThemeCacheDir();
+    d->m_themecachedir = themecachedir + '/';
+
+    // Scanning the disk caches touches every file in them, which can take
+    // some time with large caches, so don't hold up startup or theme changes.
+    MThreadPool::globalInstance()->start(new ImageCachePruner(themecachedir),
+                                         "ImageCachePruner");
 }
 
 MythImage *MythUIHelper::GetImageFromCache(const QString &url)
@@ -437,7 +472,11 @@ MythImage *MythUIHelper::CacheImage(const QString &url, MythImage *im,
     if (!im)
         return nullptr;
 
-    if (!nodisk)
+    if (!nodisk && MythArtworkCache::IsArtwork(url))
+    {
+        MythArtworkCache::GetCache()->Store(url, *im);
+    }
+    else if (!nodisk)
     {
         QString dstfile = GetCacheDirByUrl(url) + '/' + url;
 
@@ -549,6 +588,12 @@ void MythUIHelper::RemoveFromCacheByURL(const QString &url)
         d->m_cacheTrack.remove(url);
     }
 
+    if (MythArtworkCache::IsArtwork(url))
+    {
+        MythArtworkCache::GetCache()->Remove(url);
+        return;
+    }
+
     QString dstfile;
 
     dstfile = GetCacheDirByUrl(url) + '/' + url;
@@ -574,6 +619,8 @@ void MythUIHelper::RemoveFromCacheByFile(const QString &fname)
             RemoveFromCacheByURL(*it);
     }
 
+    MythArtworkCache::GetCache()->RemoveMatching(partialKey);
+
     // Loop through files to cache any that were not caught by
     // RemoveFromCacheByURL
     QDir dir(GetThemeCacheDir());
@@ -643,14 +690,8 @@ QString MythUIHelper::GetCacheDirByUrl(const QString& url)
     return GetThemeCacheDir();
 }
 
-void MythUIHelper::ClearOldImageCache(void)
+void MythUIHelper::ClearOldImageCache(const QString &themecachedir)
 {
-    d->m_themecachedir = GetThemeCacheDir();
-
-    QString themecachedir = d->m_themecachedir;
-
-    d->m_themecachedir += '/';
-
     QDir dir(GetThemeBaseCacheDir());
     dir.setFilter(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
     QFileInfoList list = dir.entryInfoList();
@@ -1241,13 +1282,26 @@ MythImage *MythUIHelper::LoadCacheImage(QString srcfile, const QString& label,
     {
         // Create url to image in disk cache
         QString cachefilepath;
-        cachefilepath = GetCacheDirByUrl(label) + '/' + label;
-        QFileInfo cacheFileInfo(cachefilepath);
+        QDateTime cacheLastModified;
+        bool artwork = MythArtworkCache::IsArtwork(label);
+        if (artwork)
+        {
+            // The artwork cache index avoids any disk access here
+            if (!MythArtworkCache::GetCache()->Lookup(label, cachefilepath,
+                                                      cacheLastModified))
+                return nullptr;
+        }
+        else
+        {
+            cachefilepath = GetCacheDirByUrl(label) + '/' + label;
+            QFileInfo cacheFileInfo(cachefilepath);
 
-        // If the file isn't in the disk cache, then we don't want to bother
-        // checking the last modified times of the original
-        if (!cacheFileInfo.exists())
-            return nullptr;
+            // If the file isn't in the disk cache, then we don't want to bother
+            // checking the last modified times of the original
+            if (!cacheFileInfo.exists())
+                return nullptr;
+            cacheLastModified = cacheFileInfo.lastModified();
+        }
 
         // Now compare the time on the source versus our cached copy
         QDateTime srcLastModified;
@@ -1262,8 +1316,10 @@ MythImage *MythUIHelper::LoadCacheImage(QString srcfile, const QString& label,
             // check, since memory cached images are loaded in the foreground
             // this can cause an intolerable delay. The images won't stay in
             // the cache forever and so eventually they will be checked.
-            if (ret)
-                srcLastModified = cacheFileInfo.lastModified();
+            if (artwork)
+                srcLastModified = MythArtworkCache::GetCache()->SourceModified(srcfile);
+            else if (ret)
+                srcLastModified = cacheLastModified;
             else
             {
                 srcLastModified =
@@ -1271,7 +1327,14 @@ MythImage *MythUIHelper::LoadCacheImage(QString srcfile, const QString& label,
             }
         }
         else if (srcfile.startsWith("myth://"))
-            srcLastModified = RemoteFile::LastModified(srcfile);
+        {
+            // Backend round trips are batched in the background and the last
+            // known modification time is used in the meantime
+            if (artwork)
+                srcLastModified = MythArtworkCache::GetCache()->SourceModified(srcfile);
+            else
+                srcLastModified = RemoteFile::LastModified(srcfile);
+        }
         else
         {
             if (!FindThemeFile(srcfile))
@@ -1286,7 +1349,7 @@ MythImage *MythUIHelper::LoadCacheImage(QString srcfile, const QString& label,
         // Now compare the timestamps, if the cached image is newer than the
         // source image we can use it, otherwise we want to remove it from the
         // cache
-        if (cacheFileInfo.lastModified() >= srcLastModified)
+        if (cacheLastModified >= srcLastModified)
         {
             // If we haven't already loaded the image from the memory cache
             // and we're not ignoring the disk cache, then it's time to load
@@ -1301,6 +1364,7 @@ MythImage *MythUIHelper::LoadCacheImage(QString srcfile, const QString& label,
                     // Load file from disk cache to memory cache
                     if (ret->Load(cachefilepath))
                     {
+                        painter->PrepareImage(ret);
                         // Add to ram cache, and skip saving to disk since that is
                         // where we found this in the first place.
                         CacheImage(label, ret, true);
@@ -1311,6 +1375,10 @@ MythImage *MythUIHelper::LoadCacheImage(QString srcfile, const QString& label,
                             QString("LoadCacheImage: Could not load :%1")
                             .arg(cachefilepath));
 
+                        // Drop the stale index entry so the image is fetched
+                        // and stored again
+                        if (artwork)
+                            MythArtworkCache::GetCache()->Remove(label);
                         ret->SetIsInCache(false);
                         ret->DecrRef();
                         ret = nullptr;
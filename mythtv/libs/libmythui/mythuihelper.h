@@ -133,8 +133,9 @@ class MUI_PUBLIC MythUIHelper
   private:
     void InitializeScreenSettings(void);
 
-    void ClearOldImageCache(void);
-    void RemoveCacheDir(const QString &dirname);
+    friend class ImageCachePruner;
+    static void ClearOldImageCache(const QString &themecachedir);
+    static void RemoveCacheDir(const QString &dirname);
     static void PruneCacheDir(const QString& dirname);
 
     MythUIHelperPrivate *d {nullptr}; // NOLINT(readability-identifier-naming)
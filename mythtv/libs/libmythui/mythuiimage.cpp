@@ -164,7 +164,13 @@ class ImageLoader
             s_Attrib = "masked";
 
         if (imProps.m_isReflected)
-            s_Attrib += "reflected";
+        {
+            // Images reflected with different parameters must not share a cache entry
+            s_Attrib += QString("reflected%1,%2,%3,%4,%5")
+                .arg(imProps.m_reflectAxis == ReflectAxis::Horizontal ? "h" : "v")
+                .arg(imProps.m_reflectShear).arg(imProps.m_reflectScale)
+                .arg(imProps.m_reflectLength).arg(imProps.m_reflectSpacing);
+        }
 
         if (imProps.m_isGreyscale)
             s_Attrib += "greyscale";
@@ -370,6 +376,10 @@ class ImageLoader
                 image->setAlphaChannel(mask.convertToFormat(QImage::Format_Alpha8));
             }
 
+            // Convert to the painter's upload format here, rather than
+            // when the image is first drawn
+            painter->PrepareImage(image);
+
             if (!imageReader)
                 GetMythUI()->CacheImage(cacheKey, image);
         }
@@ -1149,6 +1159,10 @@ void MythUIImage::Pulse(void)
     else if (m_Delay > 0)
         delay = m_Delay;
 
+    // Keep animations smooth while the main window is otherwise idle
+    if (delay > 0 && delay < 1000)
+        GetMythMainWindow()->RequestPulse();
+
     if (delay > 0 &&
         abs(m_LastDisplay.msecsTo(QTime::currentTime())) > delay)
     {
@@ -1197,6 +1197,10 @@ void MythUIText::Pulse(void)
 
     MythUIType::Pulse();
 
+    // Scroll pauses and color steps are counted in pulses
+    if (m_colorCycling || m_scrolling)
+        GetMythMainWindow()->RequestPulse();
+
     if (m_colorCycling)
     {
         m_curR += m_incR;
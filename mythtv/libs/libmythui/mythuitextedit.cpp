@@ -82,6 +82,9 @@ void MythUITextEdit::Pulse(void)
 
     if (m_HasFocus)
     {
+        // The cursor blink rate is counted in pulses
+        GetMythMainWindow()->RequestPulse();
+
         if (m_lastKeyPress.elapsed() < 500)
         {
             m_cursorImage->SetVisible(true);
@@ -304,6 +304,8 @@ void MythUIType::SetRedraw(void)
 
     if (m_Parent)
         m_Parent->SetChildNeedsRedraw(this);
+    else if (HasMythMainWindow())
+        GetMythMainWindow()->RequestPulse();
 }
 
 void MythUIType::SetChildNeedsRedraw(MythUIType *child)
@@ -326,6 +328,8 @@ void MythUIType::SetChildNeedsRedraw(MythUIType *child)
 
     if (m_Parent)
         m_Parent->SetChildNeedsRedraw(this);
+    else if (HasMythMainWindow())
+        GetMythMainWindow()->RequestPulse();
 }
 
 /**
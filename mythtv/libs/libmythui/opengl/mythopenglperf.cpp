@@ -8,11 +8,16 @@
 
 /*! \class MythOpenGLPerf
  *  \brief A simple overload of QOpenGLTimeMonitor to record and log OpenGL execution intervals
+ *
+ * The number of draw calls per frame can also be recorded, and is logged as an
+ * average alongside the timer results.
 */
 MythOpenGLPerf::MythOpenGLPerf(QString Name,
                                QVector<QString> Names,
-                               int SampleCount)
+                               int SampleCount,
+                               uint64_t LogMask)
   : m_name(std::move(Name)),
+    m_logMask(LogMask),
     m_totalSamples(SampleCount),
     m_timerNames(std::move(Names))
 {
@@ -45,6 +50,13 @@ void MythOpenGLPerf::RecordSample(void)
     }
 }
 
+/// \brief Record the number of draw calls for a frame.
+void MythOpenGLPerf::RecordDrawCalls(int Count)
+{
+    m_drawCalls += Count;
+    m_drawFrames++;
+}
+
 void MythOpenGLPerf::LogSamples(void)
 {
     if (!(isCreated() && isResultAvailable()))
@@ -81,9 +93,16 @@ void MythOpenGLPerf::LogSamples(void)
             total += m_timerData[i];
             m_timerData[i] = 0;
         }
-        LOG(VB_GPUVIDEO, LOG_INFO, m_name + results.join(" ") +
+        if (m_drawFrames)
+        {
+            results.append(QString("Draws/frame:") +
+                           QString::number(static_cast<double>(m_drawCalls) / m_drawFrames, 'f', 1));
+        }
+        LOG(m_logMask, LOG_INFO, m_name + results.join(" ") +
             QString(" Total fps: %1").arg(1000000000.0 / (static_cast<double>(total) / m_sampleCount)));
         m_sampleCount = 0;
+        m_drawCalls   = 0;
+        m_drawFrames  = 0;
     }
 
     // clear timers
@@ -33,23 +33,29 @@ class QOpenGLTimeMonitor
 
 // MythTV
 #include "mythuiexp.h"
+#include "mythlogging.h"
 
 class MUI_PUBLIC MythOpenGLPerf : public QOpenGLTimeMonitor
 {
   public:
-    MythOpenGLPerf(QString Name, QVector<QString> Names, int SampleCount = 30);
+    MythOpenGLPerf(QString Name, QVector<QString> Names, int SampleCount = 30,
+                   uint64_t LogMask = VB_GPUVIDEO);
     void RecordSample    (void);
+    void RecordDrawCalls (int Count);
     void LogSamples      (void);
     int  GetTimersRunning(void) const;
 
   private:
     QString m_name                 { };
+    uint64_t m_logMask             { VB_GPUVIDEO };
     int  m_sampleCount             { 0 };
     int  m_totalSamples            { 30 };
     bool m_timersReady             { true };
     int  m_timersRunning           { 0 };
     QVector<GLuint64> m_timerData  { 0 };
     QVector<QString>  m_timerNames { };
+    int64_t m_drawCalls            { 0 };
+    int  m_drawFrames              { 0 };
 };
 
 #endif // MYTHOPENGLPERF_H
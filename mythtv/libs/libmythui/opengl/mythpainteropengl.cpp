@@ -7,16 +7,21 @@
 
 // MythTV
 #include "mythrenderopengl.h"
+#include "mythopenglperf.h"
 #include "mythpainteropengl.h"
 
 using namespace std;
 
+// Maximum size of new images uploaded per frame, once one has been uploaded
+static const int kUploadBudget       = 8 * 1024 * 1024;
+// Images smaller than this are always uploaded immediately
+static const int kDeferredUploadSize = 256 * 1024;
+
 MythOpenGLPainter::MythOpenGLPainter(MythRenderOpenGL *Render, QWidget *Parent)
   : m_widget(Parent),
-    m_render(Render)
+    m_render(Render),
+    m_partialRedraw(qEnvironmentVariableIsEmpty("MYTHTV_OPENGL_FULLREDRAW"))
 {
-    m_mappedTextures.reserve(MAX_BUFFER_POOL);
-
     if (!m_render)
         LOG(VB_GENERAL, LOG_ERR, "OpenGL painter has no render device");
 
@@ -49,17 +54,11 @@ MythOpenGLPainter::~MythOpenGLPainter()
 void MythOpenGLPainter::FreeResources(void)
 {
     OpenGLLocker locker(m_render);
+    DeleteUIFramebuffer();
     ClearCache();
     DeleteTextures();
-    if (m_mappedBufferPoolReady)
-    {
-        for (auto & buf : m_mappedBufferPool)
-        {
-            delete buf;
-            buf = nullptr;
-        }
-        m_mappedBufferPoolReady = false;
-    }
+    delete m_openglPerf;
+    m_openglPerf = nullptr;
 
     MythPainter::FreeResources();
 }
@@ -85,14 +84,79 @@ void MythOpenGLPainter::ClearCache(void)
     LOG(VB_GENERAL, LOG_INFO, "Clearing OpenGL painter cache.");
 
     QMutexLocker locker(&m_textureDeleteLock);
-    QMapIterator<MythImage *, MythGLTexture*> it(m_imageToTextureMap);
-    while (it.hasNext())
+    for (auto * texture : qAsConst(m_imageToTextureMap))
+        m_textureDeleteList.push_back(texture);
+    m_imageToTextureMap.clear();
+    m_ImageExpireList.clear();
+    m_imageExpireIndex.clear();
+}
+
+void MythOpenGLPainter::SetTarget(QOpenGLFramebufferObject *NewTarget)
+{
+    m_target = NewTarget;
+    m_drawTarget = NewTarget;
+    m_fullRedraw = true;
+}
+
+void MythOpenGLPainter::SetSwapControl(bool Swap)
+{
+    if (Swap != m_swapControl)
+        m_fullRedraw = true;
+    m_swapControl = Swap;
+}
+
+/*! \brief Whether the UI is drawn to our own framebuffer, allowing partial redraws.
+ *
+ * The contents of the default framebuffer are undefined after a swap, so only
+ * the changed areas can be drawn if the UI is retained in a separate
+ * framebuffer that is copied to the display every frame. This only applies
+ * when we own the display. It can be disabled by setting
+ * MYTHTV_OPENGL_FULLREDRAW.
+*/
+bool MythOpenGLPainter::UsePartialRedraw(void) const
+{
+    return m_partialRedraw && m_render && m_swapControl && !m_target &&
+           ((m_render->GetFeatures() & QOpenGLFunctions::Framebuffers) != 0U);
+}
+
+/// \brief Returns true if the main window should only redraw the dirty areas.
+bool MythOpenGLPainter::SupportsClipping(void)
+{
+    return UsePartialRedraw() && !m_fullRedraw;
+}
+
+bool MythOpenGLPainter::CreateUIFramebuffer(const QSize &Size)
+{
+    if (m_uiFramebuffer && m_uiFramebuffer->size() == Size)
+        return true;
+
+    DeleteUIFramebuffer();
+    QSize size = Size;
+    m_uiFramebuffer = m_render->CreateFramebuffer(size);
+    m_uiTexture = m_render->CreateFramebufferTexture(m_uiFramebuffer);
+    if (!m_uiFramebuffer || !m_uiTexture)
     {
-        it.next();
-        m_textureDeleteList.push_back(m_imageToTextureMap[it.key()]);
-        m_ImageExpireList.remove(it.key());
+        LOG(VB_GENERAL, LOG_WARNING, "Failed to create UI framebuffer - disabling partial redraws");
+        DeleteUIFramebuffer();
+        m_partialRedraw = false;
+        return false;
     }
-    m_imageToTextureMap.clear();
+
+    LOG(VB_GPU, LOG_INFO, QString("Created %1x%2 UI framebuffer")
+        .arg(size.width()).arg(size.height()));
+    m_fullRedraw = true;
+    return true;
+}
+
+void MythOpenGLPainter::DeleteUIFramebuffer(void)
+{
+    if (!m_render || !(m_uiFramebuffer || m_uiTexture))
+        return;
+    m_render->DeleteTexture(m_uiTexture);
+    m_render->DeleteFramebuffer(m_uiFramebuffer);
+    m_uiTexture = nullptr;
+    m_uiFramebuffer = nullptr;
+    m_fullRedraw = true;
 }
 
 void MythOpenGLPainter::CurrentDPIChanged(qreal DPI)
@@ -119,14 +183,6 @@ void MythOpenGLPainter::Begin(QPaintDevice *Parent)
         return;
     }
 
-    if (!m_mappedBufferPoolReady)
-    {
-        m_mappedBufferPoolReady = true;
-        // initialise the VBO pool
-        for (auto & buf : m_mappedBufferPool)
-            buf = m_render->CreateVBO(static_cast<int>(MythRenderOpenGL::kVertexSize));
-    }
-
     QSize currentsize = m_widget->size();
 
     // check if we need to adjust cache sizes
@@ -149,17 +205,74 @@ void MythOpenGLPainter::Begin(QPaintDevice *Parent)
 
     DeleteTextures();
     m_render->makeCurrent();
+    m_uploadedBytes = 0;
+
+    // Time the UI render and swap, and count draw calls, when we own the display
+    if (m_swapControl && !m_target && !m_openglPerf && VERBOSE_LEVEL_CHECK(VB_GPU, LOG_INFO))
+    {
+        m_openglPerf = new MythOpenGLPerf("GLUIPerf: ", { "Render:", "Swap:" }, 30, VB_GPU);
+        if (!m_openglPerf->isCreated())
+        {
+            delete m_openglPerf;
+            m_openglPerf = nullptr;
+        }
+    }
+
+    if (m_openglPerf)
+        m_openglPerf->RecordSample();
+
+    // If we are master and using high DPI then scale the viewport
+    if (m_swapControl && m_usingHighDPI)
+        currentsize *= m_pixelRatio;
+
+    m_drawTarget   = m_target;
+    m_partialFrame = UsePartialRedraw() && CreateUIFramebuffer(currentsize);
+    if (m_partialFrame)
+        m_drawTarget = m_uiFramebuffer;
+    else
+        DeleteUIFramebuffer();
 
     if (m_target || m_swapControl)
     {
-        // If we are master and using high DPI then scale the viewport
-        if (m_swapControl && m_usingHighDPI)
-            currentsize *= m_pixelRatio;
-        m_render->BindFramebuffer(m_target);
+        m_render->BindFramebuffer(m_drawTarget);
         m_render->SetViewPort(QRect(0, 0, currentsize.width(), currentsize.height()));
         m_render->SetBackground(0, 0, 0, 0);
+        // For partial redraws, only the dirty areas are cleared (in Clear)
+        if (!m_partialFrame || m_fullRedraw)
+            m_render->ClearFramebuffer();
+    }
+}
+
+/// \brief Restrict drawing to the given area when redrawing part of the UI.
+void MythOpenGLPainter::SetClipRect(const QRect &ClipRect)
+{
+    if (!m_partialFrame || !m_render || ClipRect == m_clipRect)
+        return;
+
+    m_clipRect = ClipRect;
+    QRect scissor = m_clipRect;
+#ifdef Q_OS_MACOS
+    scissor = QRect(static_cast<int>(scissor.left()   * m_pixelRatio),
+                    static_cast<int>(scissor.top()    * m_pixelRatio),
+                    static_cast<int>(scissor.width()  * m_pixelRatio),
+                    static_cast<int>(scissor.height() * m_pixelRatio));
+#endif
+    m_render->SetScissor(scissor);
+}
+
+/// \brief Clear the areas that are about to be redrawn.
+void MythOpenGLPainter::Clear(QPaintDevice */*Device*/, const QRegion &Region)
+{
+    if (!m_partialFrame || !m_render)
+        return;
+
+    for (const QRect &rect : Region)
+    {
+        SetClipRect(rect);
         m_render->ClearFramebuffer();
     }
+    m_clipRect = QRect();
+    m_render->SetScissor(QRect());
 }
 
 void MythOpenGLPainter::End(void)
@@ -172,14 +285,44 @@ void MythOpenGLPainter::End(void)
 
     if (VERBOSE_LEVEL_CHECK(VB_GPU, LOG_INFO))
         m_render->logDebugMarker("PAINTER_FRAME_END");
+    // Draw anything still batched
+    m_render->FlushBatch();
+
+    if (m_partialFrame)
+    {
+        // Copy the retained UI to the display. Blending is disabled as the
+        // framebuffer already holds the blended result.
+        m_render->SetScissor(QRect());
+        m_render->BindFramebuffer(nullptr);
+        m_render->ClearFramebuffer();
+        QRect rect(QPoint(0, 0), m_uiFramebuffer->size());
+        m_render->SetBlend(false);
+        m_render->DrawBitmap(m_uiTexture, nullptr, rect, rect, nullptr);
+        m_render->SetBlend(true);
+        m_drawTarget   = m_target;
+        m_partialFrame = false;
+        m_clipRect     = QRect();
+        // Transformed (e.g. zoomed) widgets may have been drawn outside of the
+        // dirty area, so redraw everything next time.
+        m_fullRedraw   = m_transformed;
+    }
+    m_transformed = false;
+
     if (m_target == nullptr && m_swapControl)
     {
         m_render->Flush();
+        if (m_openglPerf)
+            m_openglPerf->RecordSample();
         m_render->swapBuffers();
+        if (m_openglPerf)
+        {
+            m_openglPerf->RecordSample();
+            m_openglPerf->RecordDrawCalls(m_render->GetDrawCalls());
+            m_openglPerf->LogSamples();
+        }
     }
     m_render->doneCurrent();
 
-    m_mappedTextures.clear();
     MythPainter::End();
 }
 
@@ -188,13 +331,15 @@ MythGLTexture* MythOpenGLPainter::GetTextureFromCache(MythImage *Image)
     if (!m_render)
         return nullptr;
 
-    if (m_imageToTextureMap.contains(Image))
+    auto cached = m_imageToTextureMap.constFind(Image);
+    if (cached != m_imageToTextureMap.constEnd())
     {
         if (!Image->IsChanged())
         {
-            m_ImageExpireList.remove(Image);
-            m_ImageExpireList.push_back(Image);
-            return m_imageToTextureMap[Image];
+            auto expire = m_imageExpireIndex.constFind(Image);
+            if (expire != m_imageExpireIndex.constEnd())
+                m_ImageExpireList.splice(m_ImageExpireList.end(), m_ImageExpireList, expire.value());
+            return cached.value();
         }
         DeleteFormatImagePriv(Image);
     }
@@ -221,10 +366,9 @@ MythGLTexture* MythOpenGLPainter::GetTextureFromCache(MythImage *Image)
                 "Shrinking UIPainterMaxCacheHW to %1KB")
             .arg(m_maxHardwareCacheSize / 1024));
 
-        while (m_hardwareCacheSize > m_maxHardwareCacheSize)
+        while (m_hardwareCacheSize > m_maxHardwareCacheSize && !m_ImageExpireList.empty())
         {
             MythImage *expiredIm = m_ImageExpireList.front();
-            m_ImageExpireList.pop_front();
             DeleteFormatImagePriv(expiredIm);
             DeleteTextures();
         }
@@ -232,13 +376,13 @@ MythGLTexture* MythOpenGLPainter::GetTextureFromCache(MythImage *Image)
 
     CheckFormatImage(Image);
     m_hardwareCacheSize += MythRenderOpenGL::GetTextureDataSize(texture);
+    m_uploadedBytes += MythRenderOpenGL::GetTextureDataSize(texture);
     m_imageToTextureMap[Image] = texture;
-    m_ImageExpireList.push_back(Image);
+    m_imageExpireIndex[Image] = m_ImageExpireList.insert(m_ImageExpireList.end(), Image);
 
-    while (m_hardwareCacheSize > m_maxHardwareCacheSize)
+    while (m_hardwareCacheSize > m_maxHardwareCacheSize && m_ImageExpireList.size() > 1)
     {
         MythImage *expiredIm = m_ImageExpireList.front();
-        m_ImageExpireList.pop_front();
         DeleteFormatImagePriv(expiredIm);
         DeleteTextures();
     }
@@ -246,44 +390,65 @@ MythGLTexture* MythOpenGLPainter::GetTextureFromCache(MythImage *Image)
     return texture;
 }
 
-#ifdef Q_OS_MACOS
-#define DEST dest
-#else
-#define DEST Dest
-#endif
-
+/*! \brief Draw an image.
+ *
+ * Images are batched by the render device, so consecutive draws from the same
+ * texture (e.g. the repeated backgrounds of a button list) are submitted with a
+ * single draw call.
+*/
 void MythOpenGLPainter::DrawImage(const QRect &Dest, MythImage *Image,
                                   const QRect &Source, int Alpha)
 {
-    if (m_render)
+    if (!m_render)
+        return;
+
+    if (DeferUpload(Image))
     {
+        m_deferredArea += Dest;
+        return;
+    }
+
+    MythGLTexture *texture = GetTextureFromCache(Image);
+    if (!texture)
+        return;
+
 #ifdef Q_OS_MACOS
-        QRect dest = QRect(static_cast<int>(Dest.left()   * m_pixelRatio),
-                           static_cast<int>(Dest.top()    * m_pixelRatio),
-                           static_cast<int>(Dest.width()  * m_pixelRatio),
-                           static_cast<int>(Dest.height() * m_pixelRatio));
+    QRect dest = QRect(static_cast<int>(Dest.left()   * m_pixelRatio),
+                       static_cast<int>(Dest.top()    * m_pixelRatio),
+                       static_cast<int>(Dest.width()  * m_pixelRatio),
+                       static_cast<int>(Dest.height() * m_pixelRatio));
+    m_render->BatchBitmap(texture, m_drawTarget, Source, dest, Qt::white, Alpha);
+#else
+    m_render->BatchBitmap(texture, m_drawTarget, Source, Dest, Qt::white, Alpha);
 #endif
+}
 
-        // Drawing an image multiple times with the same VBO will stall most GPUs as
-        // the VBO is re-mapped whilst still in use. Use a pooled VBO instead.
-        MythGLTexture *texture = GetTextureFromCache(Image);
-        if (texture && m_mappedTextures.contains(texture))
-        {
-            QOpenGLBuffer *vbo = texture->m_vbo;
-            texture->m_vbo = m_mappedBufferPool[m_mappedBufferPoolIdx];
-            texture->m_destination = QRect();
-            m_render->DrawBitmap(texture, m_target, Source, DEST, nullptr, Alpha, m_pixelRatio);
-            texture->m_destination = QRect();
-            texture->m_vbo = vbo;
-            if (++m_mappedBufferPoolIdx >= MAX_BUFFER_POOL)
-                m_mappedBufferPoolIdx = 0;
-        }
-        else
-        {
-            m_render->DrawBitmap(texture, m_target, Source, DEST, nullptr, Alpha, m_pixelRatio);
-            m_mappedTextures.append(texture);
-        }
+/// \brief Draw glyphs from a glyph atlas page, batched with other draws from the page.
+void MythOpenGLPainter::DrawGlyphs(MythImage *Atlas, const QVector<QRect> &Sources,
+                                   const QVector<QRect> &Destinations,
+                                   const QColor &Color, int Alpha)
+{
+    if (!m_render)
+        return;
+
+    MythGLTexture *texture = GetTextureFromCache(Atlas);
+    if (!texture)
+        return;
+
+#ifdef Q_OS_MACOS
+    QVector<QRect> dests;
+    dests.reserve(Destinations.size());
+    for (const auto & dest : Destinations)
+    {
+        dests.append(QRect(static_cast<int>(dest.left()   * m_pixelRatio),
+                           static_cast<int>(dest.top()    * m_pixelRatio),
+                           static_cast<int>(dest.width()  * m_pixelRatio),
+                           static_cast<int>(dest.height() * m_pixelRatio)));
     }
+    m_render->DrawQuads(texture, m_drawTarget, Sources, dests, Color, Alpha);
+#else
+    m_render->DrawQuads(texture, m_drawTarget, Sources, Destinations, Color, Alpha);
+#endif
 }
 
 /*! \brief Draw a rectangle
@@ -301,7 +466,7 @@ void MythOpenGLPainter::DrawRect(const QRect &Area, const QBrush &FillBrush,
     if ((FillBrush.style() == Qt::SolidPattern ||
          FillBrush.style() == Qt::NoBrush) && m_render && !m_usingHighDPI)
     {
-        m_render->DrawRect(m_target, Area, FillBrush, LinePen, Alpha);
+        m_render->DrawRect(m_drawTarget, Area, FillBrush, LinePen, Alpha);
         return;
     }
     MythPainter::DrawRect(Area, FillBrush, LinePen, Alpha);
@@ -314,7 +479,7 @@ void MythOpenGLPainter::DrawRoundRect(const QRect &Area, int CornerRadius,
     if ((FillBrush.style() == Qt::SolidPattern ||
          FillBrush.style() == Qt::NoBrush) && m_render && !m_usingHighDPI)
     {
-        m_render->DrawRoundRect(m_target, Area, CornerRadius, FillBrush,
+        m_render->DrawRoundRect(m_drawTarget, Area, CornerRadius, FillBrush,
                                   LinePen, Alpha);
         return;
     }
@@ -323,17 +488,67 @@ void MythOpenGLPainter::DrawRoundRect(const QRect &Area, int CornerRadius,
 
 void MythOpenGLPainter::DeleteFormatImagePriv(MythImage *Image)
 {
-    if (m_imageToTextureMap.contains(Image))
+    auto cached = m_imageToTextureMap.find(Image);
+    if (cached != m_imageToTextureMap.end())
     {
         QMutexLocker locker(&m_textureDeleteLock);
-        m_textureDeleteList.push_back(m_imageToTextureMap[Image]);
-        m_imageToTextureMap.remove(Image);
-        m_ImageExpireList.remove(Image);
+        m_textureDeleteList.push_back(cached.value());
+        m_imageToTextureMap.erase(cached);
+        auto expire = m_imageExpireIndex.find(Image);
+        if (expire != m_imageExpireIndex.end())
+        {
+            m_ImageExpireList.erase(expire.value());
+            m_imageExpireIndex.erase(expire);
+        }
     }
 }
 
+/*! \brief Convert an image to the format used for texture uploads.
+ *
+ * QOpenGLTexture converts every image to RGBA8888 before upload. Doing that
+ * when the image is loaded moves the conversion off the UI thread and allows
+ * the upload to be streamed through a pixel buffer.
+*/
+void MythOpenGLPainter::PrepareImage(MythImage *Image)
+{
+    if (Image && !Image->isNull() && Image->format() != QImage::Format_RGBA8888)
+        Image->Assign(Image->convertToFormat(QImage::Format_RGBA8888));
+}
+
+/*! \brief Decide whether the upload of a new image should wait for a later frame.
+ *
+ * Large images (typically artwork) are uploaded up to a fixed budget per frame,
+ * so that scrolling through a grid of new images does not stall a single
+ * frame. The first upload of each frame is always allowed, so progress is
+ * guaranteed. Only applies when we own the display, as only the main window
+ * redraws the deferred area.
+*/
+bool MythOpenGLPainter::DeferUpload(MythImage *Image)
+{
+    if (!m_swapControl || m_target || m_uploadedBytes == 0)
+        return false;
+
+    if (!Image->IsChanged() && m_imageToTextureMap.contains(Image))
+        return false;
+
+    int size = Image->bytesPerLine() * Image->height();
+    if (size < kDeferredUploadSize)
+        return false;
+
+    return m_uploadedBytes + size > kUploadBudget;
+}
+
+QRegion MythOpenGLPainter::TakeDeferredArea(void)
+{
+    QRegion result = m_deferredArea;
+    m_deferredArea = QRegion();
+    return result;
+}
+
 void MythOpenGLPainter::PushTransformation(const UIEffects &Fx, QPointF Center)
 {
+    if (Fx.m_hzoom != 1.0F || Fx.m_vzoom != 1.0F || Fx.m_angle != 0.0F)
+        m_transformed = true;
     if (m_render)
         m_render->PushTransformation(Fx, Center);
 }
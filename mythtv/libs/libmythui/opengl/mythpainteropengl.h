@@ -2,8 +2,10 @@
 #define MYTHPAINTER_OPENGL_H_
 
 // Qt
+#include <QHash>
 #include <QMutex>
 #include <QQueue>
+#include <QRegion>
 
 // MythTV
 #include "mythdisplay.h"
@@ -16,10 +18,8 @@
 class QWidget;
 class MythGLTexture;
 class MythRenderOpenGL;
-class QOpenGLBuffer;
 class QOpenGLFramebufferObject;
-
-#define MAX_BUFFER_POOL 70
+class MythOpenGLPerf;
 
 class MUI_PUBLIC MythOpenGLPainter : public MythPainter
 {
@@ -29,18 +29,21 @@ class MUI_PUBLIC MythOpenGLPainter : public MythPainter
     explicit MythOpenGLPainter(MythRenderOpenGL *Render = nullptr, QWidget *Parent = nullptr);
    ~MythOpenGLPainter() override;
 
-    void SetTarget(QOpenGLFramebufferObject* NewTarget) { m_target = NewTarget; }
-    void SetSwapControl(bool Swap) { m_swapControl = Swap; }
+    void SetTarget(QOpenGLFramebufferObject* NewTarget);
+    void SetSwapControl(bool Swap);
     void DeleteTextures(void);
 
     // MythPainter
     QString GetName(void) override { return QString("OpenGL"); }
     bool SupportsAnimation(void) override { return true; }
     bool SupportsAlpha(void) override { return true; }
-    bool SupportsClipping(void) override { return false; }
+    bool SupportsClipping(void) override;
+    bool SupportsGlyphAtlas(void) override { return true; }
     void FreeResources(void) override;
     void Begin(QPaintDevice *Parent) override;
     void End() override;
+    void SetClipRect(const QRect &ClipRect) override;
+    void Clear(QPaintDevice *Device, const QRegion &Region) override;
     void DrawImage(const QRect &Dest, MythImage *Image, const QRect &Source, int Alpha) override;
     void DrawRect(const QRect &Area, const QBrush &FillBrush,
                   const QPen &LinePen, int Alpha) override;
@@ -48,6 +51,8 @@ class MUI_PUBLIC MythOpenGLPainter : public MythPainter
                        const QBrush &FillBrush, const QPen &LinePen, int Alpha) override;
     void PushTransformation(const UIEffects &Fx, QPointF Center = QPointF()) override;
     void PopTransformation(void) override;
+    void PrepareImage(MythImage *Image) override;
+    QRegion TakeDeferredArea(void) override;
 
   public slots:
     void CurrentDPIChanged(qreal DPI);
@@ -55,30 +60,47 @@ class MUI_PUBLIC MythOpenGLPainter : public MythPainter
   protected:
     void  ClearCache(void);
     MythGLTexture* GetTextureFromCache(MythImage *Image);
+    bool  DeferUpload(MythImage *Image);
+    bool  UsePartialRedraw(void) const;
+    bool  CreateUIFramebuffer(const QSize &Size);
+    void  DeleteUIFramebuffer(void);
 
     // MythPainter
     MythImage* GetFormatImagePriv(void) override { return new MythImage(this); }
     void  DeleteFormatImagePriv(MythImage *Image) override;
+    void  DrawGlyphs(MythImage *Atlas, const QVector<QRect> &Sources,
+                     const QVector<QRect> &Destinations,
+                     const QColor &Color, int Alpha) override;
 
   protected:
     QWidget          *m_widget { nullptr };
     MythRenderOpenGL *m_render { nullptr };
     QOpenGLFramebufferObject* m_target { nullptr };
+    QOpenGLFramebufferObject* m_drawTarget { nullptr };
     bool              m_swapControl { true };
     QSize             m_lastSize { };
     qreal             m_pixelRatio   { 1.0     };
     MythDisplay*      m_display      { nullptr };
     bool              m_usingHighDPI { false   };
+    MythOpenGLPerf*   m_openglPerf   { nullptr };
+
+    int               m_uploadedBytes { 0 };
+    QRegion           m_deferredArea { };
 
-    QMap<MythImage *, MythGLTexture*> m_imageToTextureMap;
+    // Partial redraws
+    bool              m_partialRedraw { true };
+    QOpenGLFramebufferObject* m_uiFramebuffer { nullptr };
+    MythGLTexture*    m_uiTexture     { nullptr };
+    bool              m_partialFrame  { false };
+    bool              m_fullRedraw    { true };
+    bool              m_transformed   { false };
+    QRect             m_clipRect      { };
+
+    QHash<MythImage *, MythGLTexture*> m_imageToTextureMap;
     std::list<MythImage *>     m_ImageExpireList;
+    QHash<MythImage *, std::list<MythImage *>::iterator> m_imageExpireIndex;
     std::list<MythGLTexture*>  m_textureDeleteList;
     QMutex                     m_textureDeleteLock;
-
-    QVector<MythGLTexture*>    m_mappedTextures;
-    QOpenGLBuffer*             m_mappedBufferPool[MAX_BUFFER_POOL] { nullptr };
-    int                        m_mappedBufferPoolIdx { 0 };
-    bool                       m_mappedBufferPoolReady { false };
 };
 
 #endif
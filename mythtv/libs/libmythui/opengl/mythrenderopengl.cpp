@@ -1,10 +1,12 @@
 // Std
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
 using std::min;
 
 // Qt
 #include <QLibrary>
+#include <QOpenGLPixelTransferOptions>
 #include <QPainter>
 #include <QWindow>
 #include <QWidget>
@@ -37,6 +39,9 @@ const GLuint MythRenderOpenGL::kVertexSize = 16 * sizeof(GLfloat);
 
 #define MAX_VERTEX_CACHE 500
 
+// Maximum number of vertices (6 per quad) in a batch before it is flushed
+static const int kMaxBatchVertices = 6 * 4096;
+
 MythGLTexture::MythGLTexture(QOpenGLTexture *Texture)
   : m_texture(Texture)
 {
@@ -330,6 +335,16 @@ bool MythRenderOpenGL::Init(void)
         (hasExtension("GL_ARB_vertex_buffer_object") && buffer_procs))
         m_extraFeatures |= kGLBufferMap;
 
+    // Pixel unpack buffers - GL2.1 or GLES3. Used to stream UI image uploads.
+    if ((m_extraFeatures & kGLBufferMap) &&
+        ((isOpenGLES() && fmt.majorVersion() >= 3) ||
+         (!isOpenGLES() && (hasExtension("GL_ARB_pixel_buffer_object") ||
+                            (fmt.majorVersion() > 2) ||
+                            (fmt.majorVersion() == 2 && fmt.minorVersion() >= 1)))))
+    {
+        m_extraFeatures |= kGLPixelBuffers;
+    }
+
     // Rectangular textures
     if (!isOpenGLES() && (hasExtension("GL_NV_texture_rectangle") ||
                           hasExtension("GL_ARB_texture_rectangle") ||
@@ -435,6 +450,7 @@ void MythRenderOpenGL::DebugFeatures(void)
     LOG(VB_GENERAL, LOG_INFO, LOC + QString("Rectangular textures : %1").arg(GLYesNo(m_extraFeatures & kGLExtRects)));
     //LOG(VB_GENERAL, LOG_INFO, LOC + QString("RGBA16 textures      : %1").arg(GLYesNo(m_extraFeatures & kGLExtRGBA16)));
     LOG(VB_GENERAL, LOG_INFO, LOC + QString("Buffer mapping       : %1").arg(GLYesNo(m_extraFeatures & kGLBufferMap)));
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Pixel buffers        : %1").arg(GLYesNo(m_extraFeatures & kGLPixelBuffers)));
     LOG(VB_GENERAL, LOG_INFO, LOC + QString("Framebuffer objects  : %1").arg(GLYesNo(m_features & Framebuffers)));
     LOG(VB_GENERAL, LOG_INFO, LOC + QString("16bit framebuffers   : %1").arg(GLYesNo(m_extraFeatures & kGL16BitFBO)));
     LOG(VB_GENERAL, LOG_INFO, LOC + QString("Unpack Subimage      : %1").arg(GLYesNo(m_extraFeatures & kGLExtSubimage)));
@@ -519,6 +535,7 @@ bool MythRenderOpenGL::IsReady(void)
 
 void MythRenderOpenGL::swapBuffers()
 {
+    FlushBatch();
     QOpenGLContext::swapBuffers(m_window);
 }
 
@@ -578,6 +595,7 @@ void MythRenderOpenGL::SetViewPort(const QRect &Rect, bool ViewportOnly)
     if (Rect == m_viewport)
         return;
     makeCurrent();
+    FlushBatch();
     m_viewport = Rect;
     glViewport(m_viewport.left(), m_viewport.top(),
                m_viewport.width(), m_viewport.height());
@@ -588,6 +606,7 @@ void MythRenderOpenGL::SetViewPort(const QRect &Rect, bool ViewportOnly)
 
 void MythRenderOpenGL::Flush(void)
 {
+    FlushBatch();
     if (!m_flushEnabled)
         return;
 
@@ -599,6 +618,8 @@ void MythRenderOpenGL::Flush(void)
 void MythRenderOpenGL::SetBlend(bool Enable)
 {
     makeCurrent();
+    if (Enable != m_blend)
+        FlushBatch();
     if (Enable && !m_blend)
         glEnable(GL_BLEND);
     else if (!Enable && m_blend)
@@ -607,6 +628,32 @@ void MythRenderOpenGL::SetBlend(bool Enable)
     doneCurrent();
 }
 
+/*! \brief Restrict drawing (and clearing) to the given area of the viewport.
+ *
+ * Area uses the same top left origin as drawing operations. An empty area
+ * disables the scissor test.
+*/
+void MythRenderOpenGL::SetScissor(const QRect &Area)
+{
+    if (Area == m_scissor)
+        return;
+
+    makeCurrent();
+    FlushBatch();
+    m_scissor = Area;
+    if (m_scissor.isEmpty())
+    {
+        glDisable(GL_SCISSOR_TEST);
+    }
+    else
+    {
+        glEnable(GL_SCISSOR_TEST);
+        glScissor(m_scissor.left(), m_viewport.height() - m_scissor.top() - m_scissor.height(),
+                  m_scissor.width(), m_scissor.height());
+    }
+    doneCurrent();
+}
+
 void MythRenderOpenGL::SetBackground(int Red, int Green, int Blue, int Alpha)
 {
     int32_t tmp = (Red << 24) + (Green << 16) + (Blue << 8) + Alpha;
@@ -625,7 +672,13 @@ MythGLTexture* MythRenderOpenGL::CreateTextureFromQImage(QImage *Image)
         return nullptr;
 
     OpenGLLocker locker(this);
-    auto *texture = new QOpenGLTexture(*Image, QOpenGLTexture::DontGenerateMipMaps);
+    QOpenGLTexture *texture = nullptr;
+    // Images prepared by MythOpenGLPainter::PrepareImage are already in the
+    // upload format and can be streamed through a pixel buffer.
+    if ((m_extraFeaturesUsed & kGLPixelBuffers) && (Image->format() == QImage::Format_RGBA8888))
+        texture = CreateTextureFromBuffer(*Image);
+    if (!texture)
+        texture = new QOpenGLTexture(*Image, QOpenGLTexture::DontGenerateMipMaps);
     if (!texture->textureId())
     {
         LOG(VB_GENERAL, LOG_INFO, LOC + "Failed to create texure");
@@ -647,6 +700,70 @@ MythGLTexture* MythRenderOpenGL::CreateTextureFromQImage(QImage *Image)
     return result;
 }
 
+/*! \brief Create an RGBA texture, uploading the image through a pixel unpack buffer.
+ *
+ * The buffer is orphaned before each upload, so the driver can transfer the
+ * data asynchronously rather than stalling until the previous upload is used.
+*/
+QOpenGLTexture* MythRenderOpenGL::CreateTextureFromBuffer(const QImage &Image)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    auto size = static_cast<int>(Image.sizeInBytes());
+#else
+    auto size = Image.byteCount();
+#endif
+    if (size <= 0)
+        return nullptr;
+
+    if (!m_uploadBuffer)
+    {
+        m_uploadBuffer = new QOpenGLBuffer(QOpenGLBuffer::PixelUnpackBuffer);
+        m_uploadBuffer->setUsagePattern(QOpenGLBuffer::StreamDraw);
+        if (!m_uploadBuffer->create())
+        {
+            LOG(VB_GENERAL, LOG_WARNING, LOC + "Failed to create pixel buffer - disabling");
+            delete m_uploadBuffer;
+            m_uploadBuffer = nullptr;
+            m_extraFeaturesUsed &= ~kGLPixelBuffers;
+            return nullptr;
+        }
+    }
+
+    m_uploadBuffer->bind();
+    m_uploadBuffer->allocate(size);
+    void* target = m_uploadBuffer->map(QOpenGLBuffer::WriteOnly);
+    if (!target)
+    {
+        m_uploadBuffer->release();
+        return nullptr;
+    }
+    memcpy(target, Image.constBits(), static_cast<size_t>(size));
+    m_uploadBuffer->unmap();
+
+    auto *texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+    texture->setAutoMipMapGenerationEnabled(false);
+    texture->setMipLevels(1);
+    texture->setSize(Image.width(), Image.height());
+    texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
+    texture->allocateStorage(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8);
+    if (texture->isStorageAllocated())
+    {
+        // N.B. with an unpack buffer bound, the data pointer is an offset into the buffer
+        QOpenGLPixelTransferOptions options;
+        options.setAlignment(4);
+        texture->setData(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8,
+                         static_cast<const void*>(nullptr), &options);
+    }
+    m_uploadBuffer->release();
+
+    if (!texture->isStorageAllocated())
+    {
+        delete texture;
+        return nullptr;
+    }
+    return texture;
+}
+
 QSize MythRenderOpenGL::GetTextureSize(const QSize &Size, bool Normalised)
 {
     if (((m_features & NPOTTextures) != 0U) || !Normalised)
@@ -711,6 +828,8 @@ void MythRenderOpenGL::DeleteTexture(MythGLTexture *Texture)
         return;
 
     makeCurrent();
+    if (Texture == m_batchTexture)
+        FlushBatch();
     // N.B. Don't delete m_textureId - it is owned externally
     delete Texture->m_texture;
     delete [] Texture->m_data;
@@ -768,6 +887,7 @@ void MythRenderOpenGL::DeleteFramebuffer(QOpenGLFramebufferObject *Framebuffer)
     if (Framebuffer)
     {
         makeCurrent();
+        FlushBatch();
         delete Framebuffer;
         doneCurrent();
     }
@@ -780,6 +900,7 @@ void MythRenderOpenGL::BindFramebuffer(QOpenGLFramebufferObject *Framebuffer)
         return;
 
     makeCurrent();
+    FlushBatch();
     if (Framebuffer == nullptr)
     {
         QOpenGLFramebufferObject::bindDefault();
@@ -796,6 +917,7 @@ void MythRenderOpenGL::BindFramebuffer(QOpenGLFramebufferObject *Framebuffer)
 void MythRenderOpenGL::ClearFramebuffer(void)
 {
     makeCurrent();
+    FlushBatch();
     glClear(GL_COLOR_BUFFER_BIT);
     doneCurrent();
 }
@@ -805,6 +927,7 @@ void MythRenderOpenGL::DrawBitmap(MythGLTexture *Texture, QOpenGLFramebufferObje
                                   QOpenGLShaderProgram *Program, int Alpha, qreal Scale)
 {
     makeCurrent();
+    FlushBatch();
 
     if (!Texture || (Texture && !((Texture->m_texture || Texture->m_textureId) && Texture->m_vbo)))
         return;
@@ -845,7 +968,7 @@ void MythRenderOpenGL::DrawBitmap(MythGLTexture *Texture, QOpenGLFramebufferObje
     glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
     glVertexAttrib4f(COLOR_INDEX, 1.0F, 1.0F, 1.0F, Alpha / 255.0F);
     glVertexAttribPointerI(TEXTURE_INDEX, TEXTURE_SIZE, GL_FLOAT, GL_FALSE, TEXTURE_SIZE * sizeof(GLfloat), kTextureOffset);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glDisableVertexAttribArray(TEXTURE_INDEX);
     glDisableVertexAttribArray(VERTEX_INDEX);
     QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
@@ -862,6 +985,7 @@ void MythRenderOpenGL::DrawBitmap(MythGLTexture **Textures, uint TextureCount,
         return;
 
     makeCurrent();
+    FlushBatch();
     BindFramebuffer(Target);
 
     if (Program == nullptr)
@@ -907,13 +1031,171 @@ void MythRenderOpenGL::DrawBitmap(MythGLTexture **Textures, uint TextureCount,
     glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
     glVertexAttrib4f(COLOR_INDEX, 1.0, 1.0, 1.0, 1.0);
     glVertexAttribPointerI(TEXTURE_INDEX, TEXTURE_SIZE, GL_FLOAT, GL_FALSE, TEXTURE_SIZE * sizeof(GLfloat), kTextureOffset);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
     glDisableVertexAttribArray(TEXTURE_INDEX);
     glDisableVertexAttribArray(VERTEX_INDEX);
     QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
     doneCurrent();
 }
 
+/*! \brief Draw multiple regions of a texture, tinted by Color.
+ *
+ * The quads are added to the current batch. Rotation is not supported. The
+ * texture is modulated by Color (and Alpha) which allows a single white glyph
+ * atlas to be used for text in any color.
+*/
+void MythRenderOpenGL::DrawQuads(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                                 const QVector<QRect> &Sources, const QVector<QRect> &Destinations,
+                                 const QColor &Color, int Alpha)
+{
+    int count = std::min(Sources.size(), Destinations.size());
+    if (count < 1)
+        return;
+
+    makeCurrent();
+    for (int i = 0; i < count; ++i)
+        if (!BatchQuad(Texture, Target, Sources[i], Destinations[i], Color, Alpha))
+            break;
+    doneCurrent();
+}
+
+/*! \brief Queue a texture for drawing in a batch with other quads.
+ *
+ * Consecutive quads that use the same texture, framebuffer and transform are
+ * drawn with a single draw call when the batch is flushed. Any other drawing,
+ * or a change of framebuffer, viewport, transform or shader, flushes the batch
+ * first - so the draw order is unchanged.
+ *
+ * \note Only the default shader is supported and the texture is never rotated
+ * or cropped. Use DrawBitmap for anything else.
+*/
+void MythRenderOpenGL::BatchBitmap(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                                   const QRect &Source, const QRect &Destination,
+                                   const QColor &Color, int Alpha)
+{
+    makeCurrent();
+    if (Texture && Texture->m_crop)
+        DrawBitmap(Texture, Target, Source, Destination, nullptr, Alpha);
+    else
+        BatchQuad(Texture, Target, Source, Destination, Color, Alpha);
+    doneCurrent();
+}
+
+bool MythRenderOpenGL::BatchQuad(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                                 const QRect &Source, const QRect &Destination,
+                                 const QColor &Color, int Alpha)
+{
+    if (!Texture || !(Texture->m_texture || Texture->m_textureId) || Texture->m_size.isEmpty())
+        return false;
+
+    BindFramebuffer(Target);
+    if ((Texture != m_batchTexture) || (m_batchVertices.size() >= kMaxBatchVertices))
+        FlushBatch();
+    m_batchTexture = Texture;
+
+    bool normalised = Texture->m_target != QOpenGLTexture::TargetRectangle;
+    auto width  = static_cast<GLfloat>(normalised ? Texture->m_size.width()  : 1);
+    auto height = static_cast<GLfloat>(normalised ? Texture->m_size.height() : 1);
+    GLfloat left   = Destination.left();
+    GLfloat top    = Destination.top();
+    GLfloat right  = Destination.left() + Destination.width();
+    GLfloat bottom = Destination.top() + Destination.height();
+    GLfloat sleft  = Source.left() / width;
+    GLfloat sright = (Source.left() + Source.width()) / width;
+    GLfloat stop   = (Texture->m_flip ? Source.top() : Source.top() + Source.height()) / height;
+    GLfloat sbot   = (Texture->m_flip ? Source.top() + Source.height() : Source.top()) / height;
+
+    auto red   = static_cast<GLubyte>(Color.red());
+    auto green = static_cast<GLubyte>(Color.green());
+    auto blue  = static_cast<GLubyte>(Color.blue());
+    auto alpha = static_cast<GLubyte>((Color.alpha() * std::clamp(Alpha, 0, 255)) / 255);
+
+    // 2 triangles per quad
+    m_batchVertices.append({ left,  top,    sleft,  stop, { red, green, blue, alpha } });
+    m_batchVertices.append({ left,  bottom, sleft,  sbot, { red, green, blue, alpha } });
+    m_batchVertices.append({ right, top,    sright, stop, { red, green, blue, alpha } });
+    m_batchVertices.append({ right, top,    sright, stop, { red, green, blue, alpha } });
+    m_batchVertices.append({ left,  bottom, sleft,  sbot, { red, green, blue, alpha } });
+    m_batchVertices.append({ right, bottom, sright, sbot, { red, green, blue, alpha } });
+    return true;
+}
+
+/// \brief Draw any queued quads with a single draw call.
+void MythRenderOpenGL::FlushBatch(void)
+{
+    if (m_batchVertices.isEmpty() || !m_batchTexture)
+    {
+        m_batchVertices.clear();
+        m_batchTexture = nullptr;
+        return;
+    }
+
+    // Clear the batch state first, as the calls below may otherwise try to
+    // flush the batch again.
+    MythGLTexture* texture = m_batchTexture;
+    QVector<BatchVertex> vertices;
+    vertices.swap(m_batchVertices);
+    m_batchTexture = nullptr;
+
+    makeCurrent();
+    if (!m_batchBuffer)
+    {
+        m_batchBuffer = CreateVBO(static_cast<int>(kVertexSize), false);
+        if (!m_batchBuffer)
+        {
+            doneCurrent();
+            return;
+        }
+        QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
+    }
+
+    QOpenGLShaderProgram *program = m_defaultPrograms[kShaderDefault];
+    SetShaderProjection(program);
+    program->setUniformValue("s_texture0", 0);
+    ActiveTexture(GL_TEXTURE0);
+    if (texture->m_texture)
+        texture->m_texture->bind();
+    else
+        glBindTexture(texture->m_target, texture->m_textureId);
+
+    // Orphan and refill the buffer
+    m_batchBuffer->bind();
+    m_batchBuffer->allocate(vertices.constData(), vertices.size() * static_cast<int>(sizeof(BatchVertex)));
+
+    const auto stride = static_cast<GLsizei>(sizeof(BatchVertex));
+    glEnableVertexAttribArray(VERTEX_INDEX);
+    glEnableVertexAttribArray(COLOR_INDEX);
+    glEnableVertexAttribArray(TEXTURE_INDEX);
+    glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, stride, static_cast<GLuint>(offsetof(BatchVertex, m_x)));
+    glVertexAttribPointerI(COLOR_INDEX, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, static_cast<GLuint>(offsetof(BatchVertex, m_color)));
+    glVertexAttribPointerI(TEXTURE_INDEX, TEXTURE_SIZE, GL_FLOAT, GL_FALSE, stride, static_cast<GLuint>(offsetof(BatchVertex, m_s)));
+    DrawArrays(GL_TRIANGLES, 0, vertices.size());
+    glDisableVertexAttribArray(TEXTURE_INDEX);
+    glDisableVertexAttribArray(COLOR_INDEX);
+    glDisableVertexAttribArray(VERTEX_INDEX);
+    QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
+
+    // Re-use the allocation for the next batch
+    vertices.clear();
+    m_batchVertices.swap(vertices);
+    doneCurrent();
+}
+
+/// \brief Return the number of draw calls since the last reset.
+int MythRenderOpenGL::GetDrawCalls(bool Reset)
+{
+    auto result = static_cast<int>(m_drawCalls);
+    if (Reset)
+        m_drawCalls = 0;
+    return result;
+}
+
+inline void MythRenderOpenGL::DrawArrays(GLenum Mode, GLint First, GLsizei Count)
+{
+    m_drawCalls++;
+    glDrawArrays(Mode, First, Count);
+}
+
 static const float kLimitedRangeOffset = (16.0F / 255.0F);
 static const float kLimitedRangeScale  = (219.0F / 255.0F);
 
@@ -921,6 +1203,7 @@ static const float kLimitedRangeScale  = (219.0F / 255.0F);
 void MythRenderOpenGL::ClearRect(QOpenGLFramebufferObject *Target, const QRect &Area, int Color)
 {
     makeCurrent();
+    FlushBatch();
     BindFramebuffer(Target);
     glEnableVertexAttribArray(VERTEX_INDEX);
 
@@ -931,7 +1214,7 @@ void MythRenderOpenGL::ClearRect(QOpenGLFramebufferObject *Target, const QRect &
 
     GetCachedVBO(GL_TRIANGLE_STRIP, Area);
     glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
     QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
     glDisableVertexAttribArray(VERTEX_INDEX);
@@ -951,6 +1234,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
                                      const QPen &LinePen, int Alpha)
 {
     makeCurrent();
+    FlushBatch();
     BindFramebuffer(Target);
 
     int lineWidth = LinePen.width();
@@ -1011,7 +1295,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(elip, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, tl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the top right segment
         m_parameters(0,0) = tr.left();
@@ -1019,7 +1303,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(elip, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, tr);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the bottom left segment
         m_parameters(0,0) = bl.left() + rad;
@@ -1027,7 +1311,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(elip, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, bl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the bottom right segment
         m_parameters(0,0) = br.left();
@@ -1035,7 +1319,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(elip, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, br);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Fill the remaining areas
         QRect main(r.left() + rad, r.top(), r.width() - dia, r.height());
@@ -1046,13 +1330,13 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
 
         GetCachedVBO(GL_TRIANGLE_STRIP, main);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         GetCachedVBO(GL_TRIANGLE_STRIP, left);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         GetCachedVBO(GL_TRIANGLE_STRIP, right);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
     }
 
@@ -1094,7 +1378,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(edge, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, tl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the top right edge segment
         m_parameters(0,0) = tr.left();
@@ -1102,7 +1386,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(edge, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, tr);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat),kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the bottom left edge segment
         m_parameters(0,0) = bl.left() + rad;
@@ -1110,7 +1394,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(edge, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, bl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the bottom right edge segment
         m_parameters(0,0) = br.left();
@@ -1118,7 +1402,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(edge, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, br);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Vertical lines
         SetShaderProjection(vline);
@@ -1131,7 +1415,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(vline, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, vl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the right line segment
         vl.translate(r.width() - lineWidth, 0);
@@ -1139,7 +1423,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(vline, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, vl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Horizontal lines
         SetShaderProjection(hline);
@@ -1150,7 +1434,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(hline, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, hl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
 
         // Draw the bottom line segment
         hl.translate(0, r.height() - lineWidth);
@@ -1158,7 +1442,7 @@ void MythRenderOpenGL::DrawRoundRect(QOpenGLFramebufferObject *Target,
         SetShaderProgramParams(hline, m_parameters, "u_parameters");
         GetCachedVBO(GL_TRIANGLE_STRIP, hl);
         glVertexAttribPointerI(VERTEX_INDEX, VERTEX_SIZE, GL_FLOAT, GL_FALSE, VERTEX_SIZE * sizeof(GLfloat), kVertexOffset);
-        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        DrawArrays(GL_TRIANGLE_STRIP, 0, 4);
         QOpenGLBuffer::release(QOpenGLBuffer::VertexBuffer);
     }
     glDisableVertexAttribArray(VERTEX_INDEX);
@@ -1229,6 +1513,12 @@ void MythRenderOpenGL::ReleaseResources(void)
     DeleteDefaultShaders();
     ExpireVertices();
     ExpireVBOS();
+    m_batchVertices.clear();
+    m_batchTexture = nullptr;
+    delete m_batchBuffer;
+    m_batchBuffer = nullptr;
+    delete m_uploadBuffer;
+    m_uploadBuffer = nullptr;
     if (m_vao)
     {
         extraFunctions()->glDeleteVertexArrays(1, &m_vao);
@@ -1495,13 +1785,16 @@ void MythRenderOpenGL::PushTransformation(const UIEffects &Fx, QPointF &Center)
         newtop.scale(Fx.m_hzoom, Fx.m_vzoom);
         newtop.rotate(Fx.m_angle, 0, 0, 1);
         newtop.translate(static_cast<GLfloat>(-Center.x()), static_cast<GLfloat>(-Center.y()));
+        FlushBatch();
     }
     m_transforms.push(newtop);
 }
 
 void MythRenderOpenGL::PopTransformation(void)
 {
-    m_transforms.pop();
+    QMatrix4x4 top = m_transforms.pop();
+    if (top != m_transforms.top())
+        FlushBatch();
 }
 
 inline QOpenGLShaderProgram* ShaderError(QOpenGLShaderProgram *Shader, const QString &Source)
@@ -1587,6 +1880,7 @@ bool MythRenderOpenGL::EnableShaderProgram(QOpenGLShaderProgram* Program)
         return true;
 
     makeCurrent();
+    FlushBatch();
     Program->bind();
     m_activeProgram = Program;
     doneCurrent();
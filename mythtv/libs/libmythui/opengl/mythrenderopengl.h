@@ -20,6 +20,7 @@
 #include <QtOpenGL/QOpenGLBuffer>
 #include <QtOpenGL/QOpenGLDebugLogger>
 #endif
+#include <QColor>
 #include <QHash>
 #include <QMutex>
 #include <QMatrix4x4>
@@ -44,7 +45,8 @@ enum GLFeatures
     kGLLegacyTextures = 0x0020,
     kGLNVMemory       = 0x0040,
     kGL16BitFBO       = 0x0080,
-    kGLComputeShaders = 0x0100
+    kGLComputeShaders = 0x0100,
+    kGLPixelBuffers   = 0x0200
 };
 
 #define TEX_OFFSET 8
@@ -121,6 +123,7 @@ class MUI_PUBLIC MythRenderOpenGL : public QOpenGLContext, public QOpenGLFunctio
     void  PopTransformation(void);
     void  Flush(void);
     void  SetBlend(bool Enable);
+    void  SetScissor(const QRect &Area);
     void  SetBackground(int Red, int Green, int Blue, int Alpha);
     QFunctionPointer GetProcAddress(const QString &Proc) const;
 
@@ -156,6 +159,14 @@ class MUI_PUBLIC MythRenderOpenGL : public QOpenGLContext, public QOpenGLFunctio
                      QOpenGLFramebufferObject *Target,
                      const QRect &Source, const QRect &Destination,
                      QOpenGLShaderProgram *Program, int Rotation);
+    void  DrawQuads(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                    const QVector<QRect> &Sources, const QVector<QRect> &Destinations,
+                    const QColor &Color, int Alpha = 255);
+    void  BatchBitmap(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                      const QRect &Source, const QRect &Destination,
+                      const QColor &Color = Qt::white, int Alpha = 255);
+    void  FlushBatch(void);
+    int   GetDrawCalls(bool Reset = true);
     void  DrawRect(QOpenGLFramebufferObject *Target,
                    const QRect &Area, const QBrush &FillBrush,
                    const QPen &LinePen, int Alpha);
@@ -187,6 +198,10 @@ class MUI_PUBLIC MythRenderOpenGL : public QOpenGLContext, public QOpenGLFunctio
     bool  CreateDefaultShaders(void);
     void  DeleteDefaultShaders(void);
     void  Check16BitFBO(void);
+    bool  BatchQuad(MythGLTexture *Texture, QOpenGLFramebufferObject *Target,
+                    const QRect &Source, const QRect &Destination, const QColor &Color, int Alpha);
+    void  DrawArrays(GLenum Mode, GLint First, GLsizei Count);
+    QOpenGLTexture* CreateTextureFromBuffer(const QImage &Image);
 
   protected:
     // Prevent compiler complaints about using 0 as a null pointer.
@@ -212,6 +227,21 @@ class MUI_PUBLIC MythRenderOpenGL : public QOpenGLContext, public QOpenGLFunctio
     QMap<uint64_t,QOpenGLBuffer*>m_cachedVBOS;
     QList<uint64_t>              m_vboExpiry;
 
+    // Batched quads
+    struct BatchVertex
+    {
+        GLfloat m_x;
+        GLfloat m_y;
+        GLfloat m_s;
+        GLfloat m_t;
+        GLubyte m_color[4];
+    };
+    QOpenGLBuffer*               m_batchBuffer  { nullptr };
+    QOpenGLBuffer*               m_uploadBuffer { nullptr };
+    QVector<BatchVertex>         m_batchVertices;
+    MythGLTexture*               m_batchTexture { nullptr };
+    uint64_t                     m_drawCalls    { 0 };
+
     // Locking
     QMutex     m_lock { QMutex::Recursive };
     int        m_lockLevel { 0 };
@@ -228,6 +258,7 @@ class MUI_PUBLIC MythRenderOpenGL : public QOpenGLContext, public QOpenGLFunctio
     QRect      m_viewport;
     GLuint     m_activeTexture { 0 };
     bool       m_blend { false };
+    QRect      m_scissor;
     int32_t    m_background { 0x00000000 };
     bool       m_fullRange { true };
     QMatrix4x4 m_projection;
@@ -0,0 +1,181 @@
+/*
+ *  Class TestMythImageEffects
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include <QPainter>
+
+#include "test_mythimageeffects.h"
+
+// An odd width exercises both the vector loops and the scalar tails
+static const QSize kTestSize { 37, 21 };
+static const QSize kTimingSize { 1920, 1080 };
+
+static QImage TestImage(QSize Size)
+{
+    QImage image(Size, QImage::Format_ARGB32);
+    for (int y = 0; y < Size.height(); ++y)
+        for (int x = 0; x < Size.width(); ++x)
+            image.setPixel(x, y, qRgba((x * 7) & 0xff, (y * 13) & 0xff, (x * y) & 0xff, 255));
+    return image;
+}
+
+static bool Near(int First, int Second, int Tolerance = 1)
+{
+    return std::abs(First - Second) <= Tolerance;
+}
+
+void TestMythImageEffects::Greyscale_test(void)
+{
+    QImage source = TestImage(kTestSize);
+    QImage grey = source;
+    MythImageEffects::Greyscale(grey);
+    for (int y = 0; y < source.height(); ++y)
+    {
+        for (int x = 0; x < source.width(); ++x)
+        {
+            QRgb pixel = source.pixel(x, y);
+            int expected = qGray(pixel);
+            QCOMPARE(grey.pixel(x, y), qRgba(expected, expected, expected, qAlpha(pixel)));
+        }
+    }
+}
+
+void TestMythImageEffects::FadeAlpha_test(void)
+{
+    QImage source = TestImage(kTestSize);
+    QImage vertical = source;
+    QImage horizontal = source;
+    MythImageEffects::FadeAlpha(vertical, 0xAA, 0x00, FillDirection::TopToBottom);
+    MythImageEffects::FadeAlpha(horizontal, 0xAA, 0x00, FillDirection::LeftToRight);
+    QCOMPARE(vertical.format(), QImage::Format_ARGB32_Premultiplied);
+
+    int height = source.height();
+    int width = source.width();
+    for (int y = 0; y < height; ++y)
+    {
+        for (int x = 0; x < width; ++x)
+        {
+            QRgb pixel = source.pixel(x, y);
+            int valpha = 0xAA - ((0xAA * (2 * y + 1)) / (2 * height));
+            int halpha = 0xAA - ((0xAA * (2 * x + 1)) / (2 * width));
+            QRgb vpixel = vertical.pixel(x, y);
+            QRgb hpixel = horizontal.pixel(x, y);
+            QVERIFY(Near(qAlpha(vpixel), valpha));
+            QVERIFY(Near(qAlpha(hpixel), halpha));
+            // Colours are only accurate to within rounding when alpha is small
+            if (valpha > 32)
+                QVERIFY(Near(qRed(vpixel), qRed(pixel), 255 / valpha + 1));
+            if (halpha > 32)
+                QVERIFY(Near(qGreen(hpixel), qGreen(pixel), 255 / halpha + 1));
+        }
+    }
+}
+
+void TestMythImageEffects::Gradient_test(void)
+{
+    QColor begin(0x20, 0x40, 0xF0, 200);
+    QColor end(0xF0, 0x10, 0x00, 200);
+    for (auto direction : { FillDirection::TopToBottom, FillDirection::LeftToRight })
+    {
+        QImage expected(kTestSize, QImage::Format_ARGB32);
+        QLinearGradient gradient(QPoint(0, 0), direction == FillDirection::TopToBottom ?
+                                 QPoint(0, expected.height()) : QPoint(expected.width(), 0));
+        gradient.setColorAt(0, begin);
+        gradient.setColorAt(1, end);
+        QPainter painter(&expected);
+        painter.setCompositionMode(QPainter::CompositionMode_Source);
+        painter.fillRect(expected.rect(), gradient);
+        painter.end();
+
+        QImage actual(kTestSize, QImage::Format_ARGB32);
+        MythImageEffects::Gradient(actual, begin, end, direction);
+        for (int y = 0; y < actual.height(); ++y)
+        {
+            for (int x = 0; x < actual.width(); ++x)
+            {
+                QRgb first = expected.pixel(x, y);
+                QRgb second = actual.pixel(x, y);
+                QVERIFY(Near(qRed(first), qRed(second), 3));
+                QVERIFY(Near(qGreen(first), qGreen(second), 3));
+                QVERIFY(Near(qBlue(first), qBlue(second), 3));
+                QVERIFY(Near(qAlpha(first), qAlpha(second), 3));
+            }
+        }
+    }
+}
+
+void TestMythImageEffects::DropShadow_test(void)
+{
+    QImage image(kTestSize, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QRect square(4, 4, 10, 10);
+    QPainter painter(&image);
+    painter.fillRect(square, Qt::white);
+    painter.end();
+
+    QPoint offset(3, 2);
+    MythImageEffects::DropShadow(image, offset, QColor(0, 0, 0, 128));
+    for (int y = 0; y < image.height(); ++y)
+    {
+        for (int x = 0; x < image.width(); ++x)
+        {
+            QRgb pixel = image.pixel(x, y);
+            if (square.contains(x, y))
+                QCOMPARE(pixel, qRgba(255, 255, 255, 255));
+            else if (square.translated(offset).contains(x, y))
+                QVERIFY(Near(qAlpha(pixel), 128) && qRed(pixel) == 0);
+            else
+                QCOMPARE(qAlpha(pixel), 0);
+        }
+    }
+}
+
+void TestMythImageEffects::Greyscale_timing(void)
+{
+    QImage source = TestImage(kTimingSize);
+    QBENCHMARK {
+        QImage image = source;
+        MythImageEffects::Greyscale(image);
+    }
+}
+
+void TestMythImageEffects::FadeAlpha_timing(void)
+{
+    QImage source = TestImage(kTimingSize).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        QImage image = source;
+        MythImageEffects::FadeAlpha(image, 0xAA, 0x00, FillDirection::TopToBottom);
+    }
+}
+
+void TestMythImageEffects::Gradient_timing(void)
+{
+    QImage image(kTimingSize, QImage::Format_ARGB32);
+    QBENCHMARK {
+        MythImageEffects::Gradient(image, Qt::white, Qt::black, FillDirection::LeftToRight);
+    }
+}
+
+void TestMythImageEffects::DropShadow_timing(void)
+{
+    QImage source = TestImage(kTimingSize).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QBENCHMARK {
+        QImage image = source;
+        MythImageEffects::DropShadow(image, QPoint(2, 2), QColor(0, 0, 0, 128));
+    }
+}
+
+QTEST_APPLESS_MAIN(TestMythImageEffects)
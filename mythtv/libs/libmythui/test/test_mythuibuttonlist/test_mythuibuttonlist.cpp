@@ -0,0 +1,162 @@
+/*
+ *  Class TestMythUIButtonList
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include "test_mythuibuttonlist.h"
+
+static const int kItemCount { 5000 };
+
+// Item n has the sort key "item0000n" and the data n * 10
+class TestProvider : public MythUIButtonListProvider
+{
+  public:
+    int GetItemCount(void) const override { return kItemCount; }
+
+    void FillItem(MythUIButtonListItem *item, int position) override
+    {
+        ++m_filled;
+        item->SetText(GetSortKey(position));
+        item->SetData(position * 10);
+    }
+
+    bool HasSortKey(void) const override { return true; }
+
+    QString GetSortKey(int position) const override
+    {
+        return QString("item%1").arg(position, 5, 10, QChar('0'));
+    }
+
+    int GetDataPosition(const QVariant &data) const override
+    {
+        bool ok = false;
+        int value = data.toInt(&ok);
+        if (!ok || value < 0 || value % 10 || value / 10 >= kItemCount)
+            return -1;
+        return value / 10;
+    }
+
+    int m_filled { 0 };
+};
+
+static QSet<int> Range(int First, int Last)
+{
+    QSet<int> result;
+    for (int i = First; i < Last; ++i)
+        result.insert(i);
+    return result;
+}
+
+void TestMythUIButtonList::Provider_count(void)
+{
+    TestProvider provider;
+    MythUIButtonList list(nullptr, "list");
+    list.SetProvider(&provider);
+
+    QCOMPARE(list.GetCount(), kItemCount);
+    QCOMPARE(list.GetCurrentPos(), 0);
+    // Only the current item is created
+    QCOMPARE(provider.m_filled, 1);
+    QCOMPARE(list.m_loadedItems, QSet<int>({ 0 }));
+    QCOMPARE(list.GetItemAt(kItemCount - 1)->GetText(), QString("item04999"));
+
+    list.SetProvider(nullptr);
+    QCOMPARE(list.GetCount(), 0);
+}
+
+void TestMythUIButtonList::Provider_window(void)
+{
+    TestProvider provider;
+    MythUIButtonList list(nullptr, "list");
+    list.SetProvider(&provider);
+
+    // A page either side of the visible items is loaded
+    list.m_itemsVisible = 10;
+    list.m_topPosition  = 500;
+    list.UpdateVirtualWindow();
+    QCOMPARE(list.m_loadedItems, Range(490, 520) + QSet<int>({ 0 }));
+    QCOMPARE(provider.m_filled, 31);
+
+    // Nearby items are kept, so scrolling back does not reload them
+    list.m_topPosition = 505;
+    list.UpdateVirtualWindow();
+    QCOMPARE(list.m_loadedItems, Range(490, 525) + QSet<int>({ 0 }));
+    QCOMPARE(provider.m_filled, 36);
+
+    // Items well away from the window are dropped, except the selected item
+    list.m_topPosition = 2000;
+    list.UpdateVirtualWindow();
+    QCOMPARE(list.m_loadedItems, Range(1990, 2020) + QSet<int>({ 0 }));
+    QCOMPARE(provider.m_filled, 66);
+    QVERIFY(list.m_itemList.at(500) == nullptr);
+    QCOMPARE(list.GetItemCurrent()->GetText(), QString("item00000"));
+
+    // Dropped items are reloaded on demand
+    QCOMPARE(list.GetItemAt(500)->GetData().toInt(), 5000);
+    QCOMPARE(provider.m_filled, 67);
+}
+
+void TestMythUIButtonList::Provider_sortkey_data(void)
+{
+    QTest::addColumn<QString>("key");
+    QTest::addColumn<int>("position");
+
+    QTest::newRow("empty")   << ""          << 0;
+    QTest::newRow("first")   << "item00000" << 0;
+    QTest::newRow("exact")   << "item01234" << 1234;
+    QTest::newRow("case")    << "ITEM01234" << 1234;
+    QTest::newRow("between") << "item012345" << 1235;
+    QTest::newRow("prefix")  << "item02"    << 2000;
+    QTest::newRow("last")    << "item04999" << 4999;
+    QTest::newRow("after")   << "zzz"       << kItemCount;
+}
+
+void TestMythUIButtonList::Provider_sortkey(void)
+{
+    QFETCH(QString, key);
+    QFETCH(int, position);
+
+    TestProvider provider;
+    MythUIButtonList list(nullptr, "list");
+    list.SetProvider(&provider);
+
+    QCOMPARE(list.FindSortKey(key), position);
+    // Searching the keys does not load any items
+    QCOMPARE(provider.m_filled, 1);
+}
+
+void TestMythUIButtonList::Provider_data(void)
+{
+    TestProvider provider;
+    MythUIButtonList list(nullptr, "list");
+    list.SetProvider(&provider);
+
+    // None of these items are loaded
+    MythUIButtonListItem *item = list.GetItemByData(30000);
+    QVERIFY(item != nullptr);
+    QCOMPARE(item->GetText(), QString("item03000"));
+    QVERIFY(list.GetItemByData(kItemCount * 10) == nullptr);
+
+    list.SetValueByData(42000);
+    QCOMPARE(list.GetCurrentPos(), 4200);
+    QCOMPARE(list.GetItemCurrent()->GetText(), QString("item04200"));
+
+    MythUIButtonListItem *next = list.GetItemNext(list.GetItemAt(4998));
+    QVERIFY(next != nullptr);
+    QCOMPARE(next->GetText(), QString("item04999"));
+    QVERIFY(list.GetItemNext(next) == nullptr);
+}
+
+QTEST_GUILESS_MAIN(TestMythUIButtonList)
@@ -18,11 +18,14 @@ void MythComboBufferVulkan::PopData(void)
 }
 
 void MythComboBufferVulkan::PushData(const QMatrix4x4 &Transform, const QRect& Source,
-                                     const QRect& Destination, int Alpha)
+                                     const QRect& Destination, int Alpha,
+                                     const QColor &Color)
 {
     m_data.push_back({});
     Buffer* data = &m_data.back();
-    data->color[0] = data->color[1] = data->color[2] = 1.0F;
+    data->color[0] = static_cast<float>(Color.redF());
+    data->color[1] = static_cast<float>(Color.greenF());
+    data->color[2] = static_cast<float>(Color.blueF());
 
     float width  = std::min(static_cast<float>(Source.width()), m_width);
     float height = std::min(static_cast<float>(Source.height()), m_height);
@@ -43,5 +46,5 @@ void MythComboBufferVulkan::PushData(const QMatrix4x4 &Transform, const QRect& S
     data->texcoords[3] = (Source.top() + height) / m_height;
 
     // Alpha/color
-    data->color[3] = Alpha / 255.0F;
+    data->color[3] = static_cast<float>(Color.alphaF()) * (Alpha / 255.0F);
 }
@@ -2,6 +2,7 @@
 #define MYTHCOMBOBUFFERVULKAN_H
 
 // Qt
+#include <QColor>
 #include <QRect>
 #include <QMatrix4x4>
 
@@ -24,7 +25,8 @@ class MythComboBufferVulkan
 
     const void* Data(void) const;
     void        PushData(const QMatrix4x4 &Transform, const QRect& Source,
-                         const QRect& Destination, int Alpha);
+                         const QRect& Destination, int Alpha,
+                         const QColor &Color = Qt::white);
     void        PopData(void);
 
     std::vector<Buffer> m_data;
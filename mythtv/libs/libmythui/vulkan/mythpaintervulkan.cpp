@@ -363,11 +363,20 @@ void MythPainterVulkan::End(void)
     m_devFuncs->vkCmdBindDescriptorSets(currentcmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
                                         m_textureLayout, 0, 1, &m_projectionDescriptor, 0, nullptr);
 
+    // Consecutive quads from the same texture (e.g. glyphs or repeated button
+    // backgrounds) share the descriptor set bound for the first.
+    MythTextureVulkan* lasttexture = nullptr;
+    int binds = 0;
     for (auto * texture : m_queuedTextures)
     {
         // Bind descriptor set 1 for this texture - sampler
-        m_devFuncs->vkCmdBindDescriptorSets(currentcmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                                            m_textureLayout, 1, 1, &texture->m_descriptor, 0, nullptr);
+        if (texture != lasttexture)
+        {
+            m_devFuncs->vkCmdBindDescriptorSets(currentcmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                                                m_textureLayout, 1, 1, &texture->m_descriptor, 0, nullptr);
+            lasttexture = texture;
+            binds++;
+        }
 
         // Push constants - transform, vertex data and color (alpha)
         m_devFuncs->vkCmdPushConstants(currentcmdbuf, m_textureLayout,
@@ -381,6 +390,21 @@ void MythPainterVulkan::End(void)
     if (m_debugMarker)
         m_debugMarker->EndRegion(currentcmdbuf);
 
+    if (VERBOSE_LEVEL_CHECK(VB_GPU, LOG_INFO))
+    {
+        m_statsDraws += static_cast<int64_t>(m_queuedTextures.size());
+        m_statsBinds += binds;
+        if (++m_statsFrames >= 30)
+        {
+            LOG(VB_GPU, LOG_INFO, LOC + QString("Draws/frame: %1 Texture binds/frame: %2")
+                .arg(static_cast<double>(m_statsDraws) / m_statsFrames, 0, 'f', 1)
+                .arg(static_cast<double>(m_statsBinds) / m_statsFrames, 0, 'f', 1));
+            m_statsFrames = 0;
+            m_statsDraws  = 0;
+            m_statsBinds  = 0;
+        }
+    }
+
     m_queuedTextures.clear();
 
     if (m_master)
@@ -402,6 +426,31 @@ void MythPainterVulkan::DrawImage(const QRect &Dest, MythImage *Image, const QRe
     }
 }
 
+/*! \brief Draw glyphs from a glyph atlas page.
+ *
+ * All of the glyphs share a single texture and descriptor set, so no texture
+ * uploads are needed once the glyphs are in the atlas. Each glyph is still
+ * pushed as its own quad, as the default pipeline has no vertex buffer.
+*/
+void MythPainterVulkan::DrawGlyphs(MythImage *Atlas, const QVector<QRect> &Sources,
+                                   const QVector<QRect> &Destinations,
+                                   const QColor &Color, int Alpha)
+{
+    if (!m_frameStarted)
+        return;
+
+    MythTextureVulkan* texture = GetTextureFromCache(Atlas);
+    if (!texture)
+        return;
+
+    int count = std::min(Sources.size(), Destinations.size());
+    for (int i = 0; i < count; ++i)
+    {
+        texture->PushData(m_transforms.top(), Sources[i], Destinations[i], Alpha, Color);
+        m_queuedTextures.emplace_back(texture);
+    }
+}
+
 MythImage* MythPainterVulkan::GetFormatImagePriv(void)
 {
     return new MythImage(this);
@@ -28,6 +28,7 @@ class MUI_PUBLIC MythPainterVulkan : public MythPainter
     bool    SupportsAnimation (void) override;
     bool    SupportsAlpha     (void) override;
     bool    SupportsClipping  (void) override;
+    bool    SupportsGlyphAtlas(void) override { return true; }
     void    FreeResources     (void) override;
     void    Begin             (QPaintDevice* /*Parent*/) override;
     void    End               (void) override;
@@ -44,6 +45,9 @@ class MUI_PUBLIC MythPainterVulkan : public MythPainter
   protected:
     MythImage* GetFormatImagePriv (void) override;
     void    DeleteFormatImagePriv (MythImage *Image) override;
+    void    DrawGlyphs        (MythImage *Atlas, const QVector<QRect> &Sources,
+                               const QVector<QRect> &Destinations,
+                               const QColor &Color, int Alpha) override;
 
   private:
     Q_DISABLE_COPY(MythPainterVulkan)
@@ -84,6 +88,11 @@ class MUI_PUBLIC MythPainterVulkan : public MythPainter
 
     MythDebugVulkan*   m_debugMarker     { nullptr };
     bool               m_debugAvailable  { true    };
+
+    // Draw statistics (VB_GPU only)
+    int                m_statsFrames     { 0 };
+    int64_t            m_statsDraws      { 0 };
+    int64_t            m_statsBinds      { 0 };
 };
 
 #endif
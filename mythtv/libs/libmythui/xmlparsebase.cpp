@@ -22,6 +22,7 @@
 // Mythui headers
 #include "mythmainwindow.h"
 #include "mythuihelper.h"
+#include "xmlparsecache.h"
 
 /* ui type includes */
 #include "mythscreentype.h"
@@ -696,14 +697,33 @@ bool XMLParseBase::LoadWindowFromXML(const QString &xmlfile,
     bool onlyLoadWindows = true;
     bool showWarnings = true;
 
+    // Try the precompiled window definition first
+    XMLParseCache *cache = XMLParseCache::GetCache();
+    QDomDocument cached;
+    QString cachedfile;
+    QStringList includes;
+    if (cache->Lookup(xmlfile, windowname, cached, cachedfile, includes))
+    {
+        LOG(VB_GUI, LOG_INFO, LOC + QString("Loading window %1 from cache (%2)")
+            .arg(windowname).arg(cachedfile));
+        for (const auto & include : qAsConst(includes))
+            LoadBaseTheme(include);
+        QDomElement window = cached.documentElement();
+        ParseChildren(cachedfile, window, parent, showWarnings);
+        return true;
+    }
+
+    includes.clear();
     const QStringList searchpath = GetMythUI()->GetThemeSearchPath();
     for (const auto & dir : qAsConst(searchpath))
     {
         QString themefile = dir + xmlfile;
         LOG(VB_GUI, LOG_INFO, LOC + QString("Loading window %1 from %2").arg(windowname).arg(themefile));
+        QByteArray window;
         if (doLoad(windowname, parent, themefile,
-                   onlyLoadWindows, showWarnings))
+                   onlyLoadWindows, showWarnings, &includes, &window))
         {
+            cache->Store(xmlfile, windowname, themefile, includes, window);
             return true;
         }
         LOG(VB_FILE, LOG_ERR, LOC + "No theme file " + themefile);
@@ -720,7 +740,9 @@ bool XMLParseBase::doLoad(const QString &windowname,
                           MythUIType *parent,
                           const QString &filename,
                           bool onlyLoadWindows,
-                          bool showWarnings)
+                          bool showWarnings,
+                          QStringList *includes,
+                          QByteArray *windowData)
 {
     QDomDocument doc;
     QFile f(filename);
@@ -757,7 +779,11 @@ bool XMLParseBase::doLoad(const QString &windowname,
                 QString include = getFirstText(e);
 
                 if (!include.isEmpty())
-                     LoadBaseTheme(include);
+                {
+                    LoadBaseTheme(include);
+                    if (includes)
+                        includes->append(include);
+                }
             }
 
             if (onlyLoadWindows && e.tagName() == "window")
@@ -772,10 +798,16 @@ bool XMLParseBase::doLoad(const QString &windowname,
                 }
 
                 if (!include.isEmpty())
+                {
                     LoadBaseTheme(include);
+                    if (includes)
+                        includes->append(include);
+                }
 
                 if (name == windowname)
                 {
+                    if (windowData)
+                        *windowData = XMLParseCache::Serialise(e);
                     ParseChildren(filename, e, parent, showWarnings);
                     return true;
                 }
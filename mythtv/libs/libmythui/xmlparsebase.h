@@ -2,6 +2,7 @@
 #define XMLPARSEBASE_H_
 
 #include <QString>
+#include <QStringList>
 #include <QMap>
 
 #include "mythrect.h"
@@ -64,7 +65,9 @@ class MUI_PUBLIC XMLParseBase
   private:
     static bool doLoad(const QString &windowname, MythUIType *parent,
                        const QString &filename,
-                       bool onlyLoadWindows, bool showWarnings);
+                       bool onlyLoadWindows, bool showWarnings,
+                       QStringList *includes = nullptr,
+                       QByteArray *windowData = nullptr);
     static void ConnectDependants(MythUIType * parent,
                                     QMap<QString, QString> &dependsMap);
 
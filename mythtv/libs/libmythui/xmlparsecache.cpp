@@ -0,0 +1,301 @@
+// Qt
+#include <QDataStream>
+#include <QDateTime>
+#include <QDomDocument>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+// MythTV
+#include "mythlogging.h"
+#include "mythversion.h"
+#include "mythuihelper.h"
+#include "themeinfo.h"
+#include "xmlparsecache.h"
+
+#define LOC QString("XMLParseCache: ")
+
+// Increment when the file format changes
+static const quint32 kCacheMagic   = 0x4d584331; // MXC1
+static const int     kMaxDepth     = 64;
+
+enum NodeTypes : quint8
+{
+    kNodeElement = 1,
+    kNodeText    = 2,
+    kNodeCData   = 3
+};
+
+XMLParseCache* XMLParseCache::GetCache(void)
+{
+    static XMLParseCache s_cache;
+    return &s_cache;
+}
+
+QString XMLParseCache::Header(void) const
+{
+    const QStringList searchpath = GetMythUI()->GetThemeSearchPath();
+    QString version;
+    if (!searchpath.isEmpty())
+    {
+        ThemeInfo theme(searchpath.first());
+        version = QString("%1.%2").arg(theme.GetMajorVersion()).arg(theme.GetMinorVersion());
+    }
+    return QString("%1|%2|%3").arg(MYTH_BINARY_VERSION).arg(version).arg(searchpath.join(":"));
+}
+
+XMLParseCache::Stamp XMLParseCache::GetStamp(const QString &File)
+{
+    Stamp result;
+    result.m_file = File;
+    QFileInfo info(File);
+    if (info.exists())
+    {
+        result.m_modified = info.lastModified().toMSecsSinceEpoch();
+        result.m_size     = info.size();
+    }
+    return result;
+}
+
+/// \brief (Re)load the cache for the current theme, discarding it if it is out of date.
+void XMLParseCache::Load(void)
+{
+    m_entries.clear();
+    m_cacheFile = GetMythUI()->GetThemeCacheDir() + "/themewindows.cache";
+    m_header    = Header();
+
+    QFile file(m_cacheFile);
+    if (!file.open(QIODevice::ReadOnly))
+        return;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic = 0;
+    QString header;
+    stream >> magic >> header;
+    if (magic != kCacheMagic || header != m_header)
+    {
+        LOG(VB_GUI, LOG_INFO, LOC + "Discarding out of date theme cache");
+        return;
+    }
+
+    quint32 count = 0;
+    stream >> count;
+    for (quint32 i = 0; i < count && stream.status() == QDataStream::Ok; ++i)
+    {
+        QString key;
+        Entry entry;
+        quint32 stamps = 0;
+        stream >> key >> entry.m_fileName >> entry.m_includes >> stamps;
+        for (quint32 j = 0; j < stamps && stream.status() == QDataStream::Ok; ++j)
+        {
+            Stamp stamp;
+            stream >> stamp.m_file >> stamp.m_modified >> stamp.m_size;
+            entry.m_stamps.append(stamp);
+        }
+        stream >> entry.m_window;
+        if (stream.status() == QDataStream::Ok)
+            m_entries.insert(key, entry);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to read '%1'").arg(m_cacheFile));
+        m_entries.clear();
+        return;
+    }
+
+    LOG(VB_GUI, LOG_INFO, LOC + QString("Loaded %1 windows from '%2'")
+        .arg(m_entries.size()).arg(m_cacheFile));
+}
+
+void XMLParseCache::Save(void)
+{
+    QSaveFile file(m_cacheFile);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to open '%1' for writing").arg(m_cacheFile));
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << kCacheMagic << m_header << static_cast<quint32>(m_entries.size());
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+    {
+        stream << it.key() << it->m_fileName << it->m_includes
+               << static_cast<quint32>(it->m_stamps.size());
+        for (const auto & stamp : it->m_stamps)
+            stream << stamp.m_file << stamp.m_modified << stamp.m_size;
+        stream << it->m_window;
+    }
+
+    if (!file.commit())
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Failed to write '%1'").arg(m_cacheFile));
+}
+
+/*! \brief Retrieve a cached window definition.
+ *
+ * On success, Document contains the window element as its document element,
+ * FileName is the theme file it was loaded from and Includes lists the base
+ * files that must be loaded first.
+*/
+bool XMLParseCache::Lookup(const QString &XmlFile, const QString &WindowName,
+                           QDomDocument &Document, QString &FileName, QStringList &Includes)
+{
+    QMutexLocker locker(&m_lock);
+    if (m_cacheFile != GetMythUI()->GetThemeCacheDir() + "/themewindows.cache")
+        Load();
+
+    QString key = XmlFile + ":" + WindowName;
+    auto entry = m_entries.constFind(key);
+    if (entry == m_entries.constEnd())
+        return false;
+
+    for (const auto & stamp : entry->m_stamps)
+    {
+        Stamp current = GetStamp(stamp.m_file);
+        if (current.m_modified != stamp.m_modified || current.m_size != stamp.m_size)
+        {
+            LOG(VB_GUI, LOG_INFO, LOC + QString("'%1' has changed").arg(stamp.m_file));
+            m_entries.remove(key);
+            return false;
+        }
+    }
+
+    QDataStream stream(entry->m_window);
+    stream.setVersion(QDataStream::Qt_5_0);
+    Document = QDomDocument();
+    QDomNode root = Document;
+    if (!ReadNode(stream, Document, root, 0) || Document.documentElement().isNull())
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Invalid cache entry for '%1'").arg(key));
+        m_entries.remove(key);
+        return false;
+    }
+
+    FileName = entry->m_fileName;
+    Includes = entry->m_includes;
+    return true;
+}
+
+/// \brief Add a window definition, serialised with Serialise, to the cache.
+void XMLParseCache::Store(const QString &XmlFile, const QString &WindowName,
+                          const QString &FileName, const QStringList &Includes,
+                          const QByteArray &Window)
+{
+    if (Window.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_lock);
+    if (m_cacheFile != GetMythUI()->GetThemeCacheDir() + "/themewindows.cache")
+        Load();
+
+    // The window may be defined in any of the files in the search path, so all
+    // of them (whether they exist or not) determine whether the entry is valid.
+    Entry entry;
+    entry.m_fileName = FileName;
+    entry.m_includes = Includes;
+    entry.m_window   = Window;
+    const QStringList searchpath = GetMythUI()->GetThemeSearchPath();
+    for (const auto & dir : searchpath)
+        entry.m_stamps.append(GetStamp(dir + XmlFile));
+
+    m_entries.insert(XmlFile + ":" + WindowName, entry);
+    Save();
+}
+
+/// \brief Serialise an element and its children (but not comments) to a binary blob.
+QByteArray XMLParseCache::Serialise(const QDomElement &Element)
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_0);
+    WriteNode(stream, Element);
+    return result;
+}
+
+void XMLParseCache::WriteNode(QDataStream &Stream, const QDomNode &Node)
+{
+    if (Node.isCDATASection())
+    {
+        Stream << static_cast<quint8>(kNodeCData) << Node.toCDATASection().data();
+        return;
+    }
+
+    if (Node.isText())
+    {
+        Stream << static_cast<quint8>(kNodeText) << Node.toText().data();
+        return;
+    }
+
+    QDomElement element = Node.toElement();
+    QDomNamedNodeMap attributes = element.attributes();
+    Stream << static_cast<quint8>(kNodeElement) << element.tagName()
+           << static_cast<quint32>(attributes.count());
+    for (int i = 0; i < attributes.count(); ++i)
+    {
+        QDomAttr attribute = attributes.item(i).toAttr();
+        Stream << attribute.name() << attribute.value();
+    }
+
+    quint32 count = 0;
+    for (QDomNode child = Node.firstChild(); !child.isNull(); child = child.nextSibling())
+        if (child.isElement() || child.isText())
+            count++;
+    Stream << count;
+    for (QDomNode child = Node.firstChild(); !child.isNull(); child = child.nextSibling())
+        if (child.isElement() || child.isText())
+            WriteNode(Stream, child);
+}
+
+bool XMLParseCache::ReadNode(QDataStream &Stream, QDomDocument &Document, QDomNode &Parent, int Depth)
+{
+    if (Depth > kMaxDepth)
+        return false;
+
+    quint8 type = 0;
+    QString name;
+    Stream >> type >> name;
+    if (Stream.status() != QDataStream::Ok)
+        return false;
+
+    if (type == kNodeText)
+    {
+        Parent.appendChild(Document.createTextNode(name));
+        return true;
+    }
+
+    if (type == kNodeCData)
+    {
+        Parent.appendChild(Document.createCDATASection(name));
+        return true;
+    }
+
+    if (type != kNodeElement)
+        return false;
+
+    QDomElement element = Document.createElement(name);
+    quint32 attributes = 0;
+    Stream >> attributes;
+    for (quint32 i = 0; i < attributes && Stream.status() == QDataStream::Ok; ++i)
+    {
+        QString attribute;
+        QString value;
+        Stream >> attribute >> value;
+        element.setAttribute(attribute, value);
+    }
+
+    quint32 children = 0;
+    Stream >> children;
+    if (Stream.status() != QDataStream::Ok)
+        return false;
+
+    QDomNode node = element;
+    for (quint32 i = 0; i < children; ++i)
+        if (!ReadNode(Stream, Document, node, Depth + 1))
+            return false;
+
+    Parent.appendChild(element);
+    return true;
+}
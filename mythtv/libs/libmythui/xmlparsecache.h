@@ -0,0 +1,76 @@
+#ifndef XMLPARSECACHE_H
+#define XMLPARSECACHE_H
+
+// Qt
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QDataStream;
+class QDomDocument;
+class QDomElement;
+class QDomNode;
+
+/*! \class XMLParseCache
+ *  \brief A persistent cache of the theme window definitions used by XMLParseBase.
+ *
+ * Loading a window from XML means parsing every theme file in the search path
+ * until the window is found, even though only a small part of a (often large)
+ * file is needed. The first time a window is loaded its element tree is
+ * stored in a compact binary form, along with the file it came from and the
+ * base files it includes. Later loads rebuild just that element tree, which
+ * the widgets then parse as before.
+ *
+ * The cache is saved in the theme cache directory (which is specific to the
+ * theme and resolution) and is discarded if the theme version, search path or
+ * MythTV version change. Each window is also checked against the modification
+ * time and size of every candidate theme file, and is loaded from XML again
+ * if any have changed.
+*/
+class XMLParseCache
+{
+  public:
+    static XMLParseCache* GetCache(void);
+
+    bool Lookup(const QString &XmlFile, const QString &WindowName,
+                QDomDocument &Document, QString &FileName, QStringList &Includes);
+    void Store (const QString &XmlFile, const QString &WindowName,
+                const QString &FileName, const QStringList &Includes,
+                const QByteArray &Window);
+
+    static QByteArray Serialise(const QDomElement &Element);
+
+  private:
+    struct Stamp
+    {
+        QString m_file;
+        qint64  m_modified { -1 };
+        qint64  m_size     { -1 };
+    };
+
+    struct Entry
+    {
+        QString         m_fileName;
+        QStringList     m_includes;
+        QVector<Stamp>  m_stamps;
+        QByteArray      m_window;
+    };
+
+    XMLParseCache() = default;
+    void    Load(void);
+    void    Save(void);
+    QString Header(void) const;
+    static Stamp GetStamp(const QString &File);
+    static void  WriteNode(QDataStream &Stream, const QDomNode &Node);
+    static bool  ReadNode (QDataStream &Stream, QDomDocument &Document, QDomNode &Parent, int Depth);
+
+    QMutex               m_lock;
+    QString              m_cacheFile;
+    QString              m_header;
+    QHash<QString,Entry> m_entries;
+};
+
+#endif
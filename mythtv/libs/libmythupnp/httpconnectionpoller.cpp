@@ -0,0 +1,568 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpconnectionpoller.cpp
+//
+// Purpose     : Event driven (epoll) connection handling for HttpServer
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+// Own headers
+#include "httpconnectionpoller.h"
+
+// C++ headers
+#include <algorithm>
+#include <array>
+#include <cerrno>
+
+// POSIX headers
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Qt headers
+#include <QDateTime>
+#include <QHostAddress>
+
+// MythTV headers
+#include "httpserver.h"
+#include "mythcorecontext.h"
+#include "mythlogging.h"
+#include "mythtimer.h"
+
+#define LOC QString("HttpConnectionPoller: ")
+
+// Time allowed for a new connection to send its first request, and for a
+// request to arrive once it has started.
+static const int kRequestTimeout = 5 * 1000;
+
+// Headers larger than this are refused
+static const int kMaxHeaderSize = 64 * 1024;
+
+// Request bodies up to this size are received before the request is handed
+// to a worker, larger ones are read by the worker itself
+static const int kMaxBufferedBody = 1024 * 1024;
+
+static const int kReadSize = 16 * 1024;
+
+static qint64 Now(void)
+{
+    return QDateTime::currentMSecsSinceEpoch();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// HttpConnectionPoller Class Implementation
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+HttpConnectionPoller::HttpConnectionPoller(HttpServer &httpServer)
+  : MThread("HttpPoller"),
+    m_httpServer(httpServer),
+    m_epoll(epoll_create1(EPOLL_CLOEXEC)),
+    m_wake(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+{
+    if (!IsValid())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to create epoll instance " + ENO);
+        return;
+    }
+
+    epoll_event event {};
+    event.events  = EPOLLIN;
+    event.data.fd = m_wake;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_wake, &event) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to watch wake event " + ENO);
+        close(m_wake);
+        m_wake = -1;
+    }
+}
+
+HttpConnectionPoller::~HttpConnectionPoller()
+{
+    Stop();
+
+    if (m_epoll >= 0)
+        close(m_epoll);
+    if (m_wake >= 0)
+        close(m_wake);
+}
+
+/**
+ * \brief Stop polling and close every connection that is not being served
+ */
+void HttpConnectionPoller::Stop(void)
+{
+    {
+        QMutexLocker locker(&m_lock);
+        m_stopping = true;
+    }
+
+    Wake();
+    wait();
+
+    QMutexLocker locker(&m_lock);
+    for (auto *connection : qAsConst(m_incoming))
+        CloseConnection(connection);
+    m_incoming.clear();
+}
+
+void HttpConnectionPoller::Wake(void) const
+{
+    if (m_wake < 0)
+        return;
+    uint64_t value = 1;
+    if (write(m_wake, &value, sizeof(value)) < 0 && errno != EAGAIN)
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to wake poller " + ENO);
+}
+
+/**
+ * \brief Take ownership of a newly accepted socket
+ */
+void HttpConnectionPoller::AddConnection(int nSocket)
+{
+    auto *connection = new HttpConnection;
+    connection->m_socket   = nSocket;
+    connection->m_deadline = Now() + kRequestTimeout;
+
+    sockaddr_storage address {};
+    socklen_t length = sizeof(address);
+    QHostAddress peer;
+    if (getpeername(nSocket, reinterpret_cast<sockaddr*>(&address), &length) == 0)
+        peer.setAddress(reinterpret_cast<sockaddr*>(&address));
+
+    if (peer.isNull() || !gCoreContext->CheckSubnet(peer))
+    {
+        CloseConnection(connection);
+        return;
+    }
+    connection->m_peerAddress = peer.toString();
+
+    length = sizeof(address);
+    if (getsockname(nSocket, reinterpret_cast<sockaddr*>(&address), &length) == 0)
+    {
+        QHostAddress host(reinterpret_cast<sockaddr*>(&address));
+        connection->m_hostAddress = host.toString();
+        if (address.ss_family == AF_INET6)
+            connection->m_hostPort = ntohs(reinterpret_cast<sockaddr_in6*>(&address)->sin6_port);
+        else
+            connection->m_hostPort = ntohs(reinterpret_cast<sockaddr_in*>(&address)->sin_port);
+    }
+
+    int flags = fcntl(nSocket, F_GETFL);
+    fcntl(nSocket, F_SETFL, flags | O_NONBLOCK);
+    int keepAlive = 1;
+    setsockopt(nSocket, SOL_SOCKET, SO_KEEPALIVE, &keepAlive, sizeof(keepAlive));
+
+    LOG(VB_HTTP, LOG_INFO, LOC + QString("New connection %1 from %2")
+        .arg(nSocket).arg(connection->m_peerAddress));
+
+    ParkConnection(connection, kRequestTimeout);
+}
+
+/**
+ * \brief Return a connection to the poller to wait for its next request
+ *
+ * If the poller is stopping, the connection is closed instead.
+ */
+void HttpConnectionPoller::ParkConnection(HttpConnection *pConnection, int nTimeout)
+{
+    // Ignore any blank lines between pipelined requests
+    int blank = 0;
+    while (blank < pConnection->m_buffer.size() &&
+           (pConnection->m_buffer[blank] == '\r' || pConnection->m_buffer[blank] == '\n'))
+        ++blank;
+    pConnection->m_buffer.remove(0, blank);
+
+    // Part of a pipelined request has already arrived
+    pConnection->m_receiving = !pConnection->m_buffer.isEmpty();
+    pConnection->m_deadline  = Now() + (pConnection->m_receiving ? kRequestTimeout : nTimeout);
+
+    {
+        QMutexLocker locker(&m_lock);
+        if (!m_stopping)
+        {
+            m_incoming.append(pConnection);
+            locker.unlock();
+            Wake();
+            return;
+        }
+    }
+
+    CloseConnection(pConnection);
+}
+
+/**
+ * \brief Whether the buffer holds a complete request header and (unless it
+ *        is very large) body
+ */
+bool HttpConnectionPoller::RequestComplete(const QByteArray &buffer)
+{
+    int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0)
+        return false;
+
+    qint64 contentLength = 0;
+    int lineStart = buffer.indexOf("\r\n") + 2;
+    while (lineStart < headerEnd)
+    {
+        int lineEnd = buffer.indexOf("\r\n", lineStart);
+        QByteArray line = buffer.mid(lineStart, lineEnd - lineStart);
+        if (line.toLower().startsWith("content-length:"))
+            contentLength = line.mid(15).trimmed().toLongLong();
+        lineStart = lineEnd + 2;
+    }
+
+    if (contentLength > kMaxBufferedBody)
+        return true;
+    return buffer.size() >= headerEnd + 4 + contentLength;
+}
+
+/**
+ * \brief Whether the buffer has grown past kMaxHeaderSize without holding
+ *        the end of a request header
+ */
+bool HttpConnectionPoller::HeaderTooLarge(const QByteArray &buffer)
+{
+    return buffer.size() > kMaxHeaderSize &&
+           buffer.indexOf("\r\n\r\n") < 0;
+}
+
+/**
+ * \brief Close a connection's socket and free it
+ */
+void HttpConnectionPoller::CloseConnection(HttpConnection *pConnection)
+{
+    if (!pConnection)
+        return;
+
+    LOG(VB_HTTP, LOG_INFO, LOC + QString("Connection %1 closed. %2 requests were handled")
+        .arg(pConnection->m_socket).arg(pConnection->m_requests));
+
+    if (pConnection->m_socket >= 0)
+        close(pConnection->m_socket);
+    delete pConnection;
+}
+
+void HttpConnectionPoller::Register(HttpConnection *pConnection)
+{
+    if (RequestComplete(pConnection->m_buffer))
+    {
+        Dispatch(pConnection);
+        return;
+    }
+
+    epoll_event event {};
+    event.events  = EPOLLIN | EPOLLRDHUP;
+    event.data.fd = pConnection->m_socket;
+    if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, pConnection->m_socket, &event) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to watch connection %1 ")
+            .arg(pConnection->m_socket) + ENO);
+        CloseConnection(pConnection);
+        return;
+    }
+    m_connections.insert(pConnection->m_socket, pConnection);
+}
+
+/**
+ * \brief Append everything that can be read without blocking to the buffer
+ *
+ * Reading stops early once a complete request has arrived or the header has
+ * grown too large, so the buffer never holds more than one request.
+ * \return false if the connection was closed by the client or failed
+ */
+bool HttpConnectionPoller::Read(HttpConnection *pConnection)
+{
+    while (true)
+    {
+        int size = pConnection->m_buffer.size();
+        pConnection->m_buffer.resize(size + kReadSize);
+        ssize_t count = recv(pConnection->m_socket, pConnection->m_buffer.data() + size,
+                             kReadSize, 0);
+        pConnection->m_buffer.resize(size + static_cast<int>(std::max<ssize_t>(count, 0)));
+
+        if (count > 0)
+        {
+            if (RequestComplete(pConnection->m_buffer) ||
+                HeaderTooLarge(pConnection->m_buffer))
+                return true;
+            continue;
+        }
+        if (count == 0)
+            return false;
+        if (errno == EINTR)
+            continue;
+        return errno == EAGAIN || errno == EWOULDBLOCK;
+    }
+}
+
+void HttpConnectionPoller::Dispatch(HttpConnection *pConnection)
+{
+    m_httpServer.m_threadPool.startReserved(
+        new HttpPolledWorker(m_httpServer, *this, pConnection),
+        QString("HttpServer%1").arg(pConnection->m_socket));
+}
+
+void HttpConnectionPoller::Remove(HttpConnection *pConnection, bool bClose)
+{
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, pConnection->m_socket, nullptr);
+    m_connections.remove(pConnection->m_socket);
+    if (bClose)
+        CloseConnection(pConnection);
+}
+
+void HttpConnectionPoller::run(void)
+{
+    RunProlog();
+
+    LOG(VB_HTTP, LOG_INFO, LOC + "Started");
+    std::array<epoll_event, 64> events {};
+
+    while (true)
+    {
+        QList<HttpConnection*> incoming;
+        {
+            QMutexLocker locker(&m_lock);
+            if (m_stopping)
+                break;
+            incoming.swap(m_incoming);
+        }
+
+        for (auto *connection : qAsConst(incoming))
+            Register(connection);
+
+        // Wake in time to close the first connection to time out
+        qint64 now = Now();
+        qint64 next = now + 1000;
+        for (auto *connection : qAsConst(m_connections))
+            next = std::min(next, connection->m_deadline);
+
+        int count = epoll_wait(m_epoll, events.data(), static_cast<int>(events.size()),
+                               static_cast<int>(std::max(next - now, static_cast<qint64>(0))));
+        if (count < 0 && errno != EINTR)
+        {
+            LOG(VB_GENERAL, LOG_ERR, LOC + "epoll_wait failed " + ENO);
+            break;
+        }
+
+        for (int i = 0; i < count; ++i)
+        {
+            int socket = events[i].data.fd;
+            if (socket == m_wake)
+            {
+                uint64_t value = 0;
+                while (read(m_wake, &value, sizeof(value)) > 0) {}
+                continue;
+            }
+
+            HttpConnection *connection = m_connections.value(socket, nullptr);
+            if (!connection)
+                continue;
+
+            bool open = Read(connection) && !(events[i].events & (EPOLLERR | EPOLLHUP));
+            if (RequestComplete(connection->m_buffer))
+            {
+                // Serve the request even if the client has stopped sending
+                Remove(connection, false);
+                Dispatch(connection);
+            }
+            else if (!open)
+            {
+                Remove(connection, true);
+            }
+            else if (HeaderTooLarge(connection->m_buffer))
+            {
+                LOG(VB_HTTP, LOG_WARNING, LOC + QString("Connection %1 sent an oversized header")
+                    .arg(socket));
+                Remove(connection, true);
+            }
+            else if (!connection->m_receiving && !connection->m_buffer.isEmpty())
+            {
+                // A request has started to arrive, allow a fixed time to
+                // receive it however slowly it trickles in
+                connection->m_receiving = true;
+                connection->m_deadline  = Now() + kRequestTimeout;
+            }
+        }
+
+        now = Now();
+        for (auto *connection : m_connections.values())
+            if (connection->m_deadline <= now)
+                Remove(connection, true);
+    }
+
+    for (auto *connection : m_connections.values())
+        Remove(connection, true);
+
+    LOG(VB_HTTP, LOG_INFO, LOC + "Stopped");
+
+    RunEpilog();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// HttpPolledWorker Class Implementation
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+void HttpPolledWorker::run(void)
+{
+    bool bKeepAlive = false;
+    int  nTimeout   = kRequestTimeout;
+
+    try
+    {
+        // Serve any pipelined requests that have already been received
+        do
+        {
+            PolledSocketRequest request(m_httpServer, m_pConnection);
+            bKeepAlive = m_httpServer.ProcessRequest(&request, nTimeout);
+            m_pConnection->m_requests++;
+        }
+        while (bKeepAlive && m_httpServer.IsRunning() &&
+               HttpConnectionPoller::RequestComplete(m_pConnection->m_buffer));
+    }
+    catch(...)
+    {
+        LOG(VB_GENERAL, LOG_ERR,
+            "HttpPolledWorker::run - Unexpected Exception.");
+        bKeepAlive = false;
+    }
+
+    if (bKeepAlive && m_httpServer.IsRunning())
+        m_poller.ParkConnection(m_pConnection, nTimeout);
+    else
+        HttpConnectionPoller::CloseConnection(m_pConnection);
+    m_pConnection = nullptr;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// PolledSocketRequest Class Implementation
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Wait up to msecs for more data and append it to the buffer
+ * \return false on timeout, end of stream or error
+ */
+bool PolledSocketRequest::Fill( int msecs )
+{
+    pollfd poller { m_pConnection->m_socket, POLLIN, 0 };
+    int ready = poll(&poller, 1, msecs);
+    if (ready <= 0)
+        return false;
+
+    QByteArray &buffer = m_pConnection->m_buffer;
+    int size = buffer.size();
+    buffer.resize(size + kReadSize);
+    ssize_t count = recv(m_pConnection->m_socket, buffer.data() + size, kReadSize, 0);
+    buffer.resize(size + static_cast<int>(std::max<ssize_t>(count, 0)));
+    return count > 0 || (count < 0 && (errno == EAGAIN || errno == EINTR));
+}
+
+QString PolledSocketRequest::ReadLine( int msecs )
+{
+    QByteArray &buffer = m_pConnection->m_buffer;
+    MythTimer timer;
+    timer.start();
+
+    int end = buffer.indexOf('\n');
+    while (end < 0)
+    {
+        int remaining = msecs - timer.elapsed();
+        if (remaining <= 0 || !Fill(remaining))
+        {
+            LOG(VB_HTTP, LOG_INFO, "PolledSocketRequest::ReadLine() - Timed out or connection closed." );
+            return QString();
+        }
+        end = buffer.indexOf('\n');
+    }
+
+    QString sLine = QString::fromUtf8(buffer.constData(), end + 1);
+    buffer.remove(0, end + 1);
+    return sLine;
+}
+
+qint64 PolledSocketRequest::ReadBlock( char *pData, qint64 nMaxLen, int msecs )
+{
+    QByteArray &buffer = m_pConnection->m_buffer;
+    MythTimer timer;
+    timer.start();
+
+    if (msecs == 0)
+    {
+        if (buffer.isEmpty())
+            Fill(0);
+    }
+    else
+    {
+        while (buffer.size() < nMaxLen)
+        {
+            int remaining = msecs - timer.elapsed();
+            if (remaining <= 0 || !Fill(remaining))
+            {
+                LOG(VB_HTTP, LOG_INFO, "PolledSocketRequest::ReadBlock() - Timed out or connection closed." );
+                break;
+            }
+        }
+    }
+
+    // Just return what we have even if timed out.
+    qint64 nBytes = std::min(nMaxLen, static_cast<qint64>(buffer.size()));
+    memcpy(pData, buffer.constData(), static_cast<size_t>(nBytes));
+    buffer.remove(0, static_cast<int>(nBytes));
+    return nBytes;
+}
+
+qint64 PolledSocketRequest::WriteBlock( const char *pData, qint64 nLen )
+{
+    // A client may pause a stream for as long as it likes, so keep waiting
+    // for it to read, checking every so often that the server is still up
+    static const int kWritePoll = 1000;
+
+    qint64 nWritten = 0;
+    while (nWritten < nLen)
+    {
+        ssize_t count = send(m_pConnection->m_socket, pData + nWritten,
+                             static_cast<size_t>(nLen - nWritten), MSG_NOSIGNAL);
+        if (count > 0)
+        {
+            nWritten += count;
+            continue;
+        }
+
+        if (count < 0 && errno == EINTR)
+            continue;
+
+        if (count < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            pollfd poller { m_pConnection->m_socket, POLLOUT, 0 };
+            int ret = 0;
+            do
+                ret = poll(&poller, 1, kWritePoll);
+            while (ret == 0 && m_httpServer.IsRunning());
+            if (ret > 0 || (ret < 0 && errno == EINTR))
+                continue;
+        }
+
+        LOG(VB_HTTP, LOG_WARNING, QString("PolledSocketRequest(%1): Failed to write "
+                                          "%2 bytes to socket")
+            .arg(m_pConnection->m_socket).arg(nLen - nWritten));
+        return -1;
+    }
+
+    return nWritten;
+}
@@ -0,0 +1,163 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpconnectionpoller.h
+//
+// Purpose     : Event driven (epoll) connection handling for HttpServer
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef HTTPCONNECTIONPOLLER_H
+#define HTTPCONNECTIONPOLLER_H
+
+// Qt headers
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QRunnable>
+#include <QString>
+
+// MythTV headers
+#include "mthread.h"
+#include "httprequest.h"
+
+class HttpServer;
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// HttpConnection - A plain TCP connection to HttpServer, which is either
+//                  waiting in the poller or being served by a worker
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+struct HttpConnection
+{
+    int        m_socket      { -1 };
+    QByteArray m_buffer;             // Received but not yet parsed
+    QString    m_hostAddress;
+    quint16    m_hostPort    { 0 };
+    QString    m_peerAddress;
+    qint64     m_deadline    { 0 };  // Closed if still idle at this time (ms)
+    bool       m_receiving   { false }; // A request has started, m_deadline is fixed
+    int        m_requests    { 0 };
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// HttpConnectionPoller Class Definition
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Waits on idle HttpServer connections with epoll.
+ *
+ * Request headers are read without blocking as they arrive, and a connection
+ * is only handed to a worker thread once a complete request has been
+ * received. After the response has been sent, keep-alive connections are
+ * parked back in the poller, so an idle client does not occupy a thread.
+ */
+class HttpConnectionPoller : public MThread
+{
+  public:
+    explicit HttpConnectionPoller(HttpServer &httpServer);
+    ~HttpConnectionPoller() override;
+
+    bool IsValid(void) const { return m_epoll >= 0 && m_wake >= 0; }
+
+    void AddConnection  (int nSocket);
+    void ParkConnection (HttpConnection *pConnection, int nTimeout);
+    void Stop           (void);
+
+    static bool RequestComplete (const QByteArray &buffer);
+    static bool HeaderTooLarge  (const QByteArray &buffer);
+    static void CloseConnection (HttpConnection *pConnection);
+
+  protected:
+    void run(void) override; // MThread
+
+  private:
+    void Wake           (void) const;
+    void Register       (HttpConnection *pConnection);
+    bool Read           (HttpConnection *pConnection);
+    void Dispatch       (HttpConnection *pConnection);
+    void Remove         (HttpConnection *pConnection, bool bClose);
+
+    HttpServer                  &m_httpServer;
+    int                          m_epoll       { -1 };
+    int                          m_wake        { -1 };
+
+    QMutex                       m_lock;
+    QList<HttpConnection*>       m_incoming;   // protected by m_lock
+    bool                         m_stopping    { false }; // protected by m_lock
+
+    // Only used by the poller thread
+    QHash<int, HttpConnection*>  m_connections;
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// HttpPolledWorker - Serves the requests received on a polled connection
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+class HttpPolledWorker : public QRunnable
+{
+  public:
+    HttpPolledWorker(HttpServer &httpServer, HttpConnectionPoller &poller,
+                     HttpConnection *pConnection)
+        : m_httpServer(httpServer), m_poller(poller),
+          m_pConnection(pConnection) {}
+
+    void run(void) override; // QRunnable
+
+  protected:
+    HttpServer           &m_httpServer;
+    HttpConnectionPoller &m_poller;
+    HttpConnection       *m_pConnection { nullptr };
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// PolledSocketRequest - An HTTPRequest read from a polled connection's
+//                       buffer, and from its socket once that is exhausted
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+class PolledSocketRequest : public HTTPRequest
+{
+    public:
+
+        PolledSocketRequest( HttpServer &httpServer, HttpConnection *pConnection )
+            : m_httpServer(httpServer), m_pConnection(pConnection) {}
+        ~PolledSocketRequest() override = default;
+
+        QString  ReadLine        ( int msecs ) override; // HTTPRequest
+        qint64   ReadBlock       ( char *pData, qint64 nMaxLen, int msecs = 0  ) override; // HTTPRequest
+        qint64   WriteBlock      ( const char *pData, qint64 nLen    ) override; // HTTPRequest
+        QString  GetHostAddress  () override // HTTPRequest
+            { return m_pConnection->m_hostAddress; }
+        quint16  GetHostPort     () override // HTTPRequest
+            { return m_pConnection->m_hostPort; }
+        QString  GetPeerAddress  () override // HTTPRequest
+            { return m_pConnection->m_peerAddress; }
+        int      getSocketHandle () override // HTTPRequest
+            { return m_pConnection->m_socket; }
+
+    private:
+
+        bool     Fill            ( int msecs );
+
+        HttpServer     &m_httpServer;
+        HttpConnection *m_pConnection { nullptr };
+};
+
+#endif // HTTPCONNECTIONPOLLER_H
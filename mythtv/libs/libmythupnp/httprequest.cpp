@@ -11,6 +11,7 @@
 //////////////////////////////////////////////////////////////////////////////
 
 #include "httprequest.h"
+#include "httpresponsestream.h"
 
 #include <QFile>
 #include <QFileInfo>
@@ -159,6 +160,15 @@ const char *HTTPRequest::s_szServerHeaders = "Accept-Ranges: bytes\r\n";
 //
 /////////////////////////////////////////////////////////////////////////////
 
+HTTPRequest::~HTTPRequest()
+{
+    delete m_pResponseStream;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 HttpRequestType HTTPRequest::SetRequestType( const QString &sType )
 {
     // HTTP
@@ -229,7 +239,10 @@ QString HTTPRequest::BuildResponseHeader( long long nSize )
             SetResponseHeader("Content-Disposition", QString("inline; filename=\"%2\"").arg(QString(filename.toLatin1())));
         }
 
-        SetResponseHeader("Content-Length", QString::number(nSize));
+        if (nSize < 0)
+            SetResponseHeader("Transfer-Encoding", "chunked");
+        else
+            SetResponseHeader("Content-Length", QString::number(nSize));
 
         // See DLNA  7.4.1.3.11.4.3 Tolerance to unavailable contentFeatures.dlna.org header
         //
@@ -297,6 +310,19 @@ qint64 HTTPRequest::SendResponse( void )
 {
     qint64      nBytes    = 0;
 
+    // ----------------------------------------------------------------------
+    // A large serialized response has already been partly sent as it was
+    // produced, only the last chunk remains.
+    // ----------------------------------------------------------------------
+
+    if (IsResponseStreamed())
+    {
+        LOG(VB_HTTP, LOG_INFO,
+            QString("HTTPRequest::SendResponse( Chunked ) :%1 -> %2:")
+                .arg(GetResponseStatus()) .arg(GetPeerAddress()));
+        return( m_pResponseStream->Finish() );
+    }
+
     switch( m_eResponseType )
     {
         // The following are all eligable for gzip compression
@@ -396,12 +422,13 @@ qint64 HTTPRequest::SendResponse( void )
     LOG(VB_HTTP, LOG_DEBUG, QString("Reponse Content Length: %1").arg(nContentLen));
 
     // ----------------------------------------------------------------------
-    // Should we try to return data gzip'd?
+    // Should we try to return data gzip'd? (unless it already is)
     // ----------------------------------------------------------------------
 
     QBuffer compBuffer;
 
-    if (( nContentLen > 0 ) && m_mapHeaders[ "accept-encoding" ].contains( "gzip" ))
+    if (( nContentLen > 0 ) && !m_mapRespHeaders.contains( "Content-Encoding" ) &&
+        m_mapHeaders[ "accept-encoding" ].contains( "gzip" ))
     {
         QByteArray compressed = gzipCompress( m_response.buffer() );
         compBuffer.setData( compressed );
@@ -1751,6 +1778,26 @@ bool HTTPRequest::ProcessSOAPPayload( const QString &sSOAPAction )
 Serializer *HTTPRequest::GetSerializer()
 {
     Serializer *pSerializer = nullptr;
+    QIODevice  *pDevice     = &m_response;
+
+    // ----------------------------------------------------------------------
+    // Large results are streamed to the client as they are serialized,
+    // see HttpResponseStream. SOAP responses are small, and need the
+    // serializer's headers, so they are always buffered.
+    // ----------------------------------------------------------------------
+
+    if (!m_bSOAPRequest && HttpResponseStream::CanStream( this ))
+    {
+        if (m_pResponseStream == nullptr)
+        {
+            m_pResponseStream = new HttpResponseStream( this,
+                m_nStreamThreshold > 0 ? m_nStreamThreshold
+                                       : HttpResponseStream::kStreamThreshold );
+            m_pResponseStream->open( QIODevice::WriteOnly | QIODevice::Unbuffered );
+        }
+
+        pDevice = m_pResponseStream;
+    }
 
     if (m_bSOAPRequest)
     {
@@ -1764,19 +1811,27 @@ Serializer *HTTPRequest::GetSerializer()
         if (sAccept.contains( "application/json", Qt::CaseInsensitive ) ||
             sAccept.contains( "text/javascript", Qt::CaseInsensitive ))
         {
-            pSerializer = (Serializer *)new JSONSerializer(&m_response,
+            pSerializer = (Serializer *)new JSONSerializer(pDevice,
                                                            m_sMethod);
         }
         else if (sAccept.contains( "text/x-apple-plist+xml", Qt::CaseInsensitive ))
         {
-            pSerializer = (Serializer *)new XmlPListSerializer(&m_response);
+            pSerializer = (Serializer *)new XmlPListSerializer(pDevice);
         }
     }
 
     // Default to XML
 
     if (pSerializer == nullptr)
-        pSerializer = (Serializer *)new XmlSerializer(&m_response, m_sMethod);
+        pSerializer = (Serializer *)new XmlSerializer(pDevice, m_sMethod);
+
+    // The response header may be sent before FormatActionResponse is called
+
+    if (pDevice != &m_response)
+    {
+        m_eResponseType     = ResponseTypeOther;
+        m_sResponseTypeText = pSerializer->GetContentType();
+    }
 
     return pSerializer;
 }
@@ -1785,6 +1840,15 @@ Serializer *HTTPRequest::GetSerializer()
 //
 /////////////////////////////////////////////////////////////////////////////
 
+bool HTTPRequest::IsResponseStreamed() const
+{
+    return m_pResponseStream && m_pResponseStream->IsStreaming();
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
 QString HTTPRequest::Encode(const QString &sIn)
 {
     QString sStr = sIn;
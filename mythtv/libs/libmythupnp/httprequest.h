@@ -104,8 +104,12 @@ class IPostProcess
 //
 /////////////////////////////////////////////////////////////////////////////
 
+class HttpResponseStream;
+
 class UPNP_PUBLIC HTTPRequest
 {
+    friend class HttpResponseStream;
+
     protected:
 
         static const char  *s_szServerHeaders;
@@ -164,6 +168,9 @@ class UPNP_PUBLIC HTTPRequest
         bool                m_bKeepAlive        {true};
         uint                m_nKeepAliveTimeout {0};
 
+        HttpResponseStream *m_pResponseStream   {nullptr};
+        qint64              m_nStreamThreshold  {0}; // 0 for the default
+
     protected:
 
         HttpRequestType SetRequestType      ( const QString &sType  );
@@ -187,7 +194,7 @@ class UPNP_PUBLIC HTTPRequest
 
         void            ParseCookies        ( void );
 
-        QString         BuildResponseHeader ( long long nSize );
+        QString         BuildResponseHeader ( long long nSize ); // nSize < 0 for chunked
 
         qint64          SendData            ( QIODevice *pDevice, qint64 llStart, qint64 llBytes );
         qint64          SendFile            ( QFile &file, qint64 llStart, qint64 llBytes );
@@ -206,7 +213,7 @@ class UPNP_PUBLIC HTTPRequest
     public:
 
                         HTTPRequest     () { m_response.open( QIODevice::ReadWrite ); }
-        virtual        ~HTTPRequest     () = default;
+        virtual        ~HTTPRequest     ();
 
         bool            ParseRequest    ();
 
@@ -235,6 +242,8 @@ class UPNP_PUBLIC HTTPRequest
         bool            GetKeepAlive () const { return m_bKeepAlive; }
 
         Serializer *    GetSerializer   ();
+        void            SetStreamThreshold ( qint64 nBytes ) { m_nStreamThreshold = nBytes; }
+        bool            IsResponseStreamed () const;
 
         QByteArray      GetResponsePage     ( void ); // Static response e.g. 400, 404, 501
 
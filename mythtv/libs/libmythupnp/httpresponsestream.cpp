@@ -0,0 +1,221 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpresponsestream.cpp
+//
+// Purpose     : Chunked (and optionally gzip'd) streaming of large
+//               serialized responses
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "httpresponsestream.h"
+
+// MythTV headers
+#include "httprequest.h"
+#include "mythlogging.h"
+
+#define LOC QString("HttpResponseStream: ")
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+HttpResponseStream::~HttpResponseStream()
+{
+    if (m_bGzip)
+        deflateEnd( &m_zstream );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Chunked transfer encoding needs an HTTP/1.1 client, and a HEAD request
+// must still be answered with the Content-Length of the full response.
+/////////////////////////////////////////////////////////////////////////////
+
+bool HttpResponseStream::CanStream( const HTTPRequest *pRequest )
+{
+    if (( pRequest->m_eType != RequestTypeGet  ) &&
+        ( pRequest->m_eType != RequestTypePost ))
+        return false;
+
+    return ( pRequest->m_nMajor > 1 ) ||
+           ( pRequest->m_nMajor == 1 && pRequest->m_nMinor >= 1 );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 HttpResponseStream::writeData( const char *pData, qint64 nLen )
+{
+    if (m_bFailed || m_bFinished)
+        return -1;
+
+    if (!m_bStreaming)
+    {
+        m_pRequest->m_response.write( pData, nLen );
+
+        if (m_pRequest->m_response.size() >= m_nThreshold && !Begin())
+        {
+            m_bFailed = true;
+            return -1;
+        }
+
+        return nLen;
+    }
+
+    m_pending.append( pData, nLen );
+
+    if (m_pending.size() >= kChunkSize && !Flush( Z_NO_FLUSH ))
+    {
+        m_bFailed = true;
+        return -1;
+    }
+
+    return nLen;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Sends the response header and whatever has been buffered so far.
+/////////////////////////////////////////////////////////////////////////////
+
+bool HttpResponseStream::Begin()
+{
+    if (m_pRequest->m_mapHeaders.value( "accept-encoding" ).contains( "gzip" ))
+    {
+        m_bGzip = (deflateInit2( &m_zstream,
+                                 Z_DEFAULT_COMPRESSION,
+                                 Z_DEFLATED,
+                                 15 + 16,
+                                 8,
+                                 Z_DEFAULT_STRATEGY ) == Z_OK); // gzip encoding
+
+        if (m_bGzip)
+            m_pRequest->SetResponseHeader( "Content-Encoding", "gzip", true );
+    }
+
+    // The serializer's content hash isn't known until the last object has
+    // been serialized, so the only ETag a streamed response can have is one
+    // set up front (see ServiceResponseCache).
+
+    m_pRequest->SetResponseHeader( "Cache-Control", "no-cache", true );
+
+    QByteArray sHeader = m_pRequest->BuildResponseHeader( -1 ).toUtf8();
+
+    LOG(VB_HTTP, LOG_DEBUG, LOC +
+        QString("Streaming response to %1 (gzip: %2)")
+            .arg(m_pRequest->GetPeerAddress()).arg(m_bGzip));
+
+    if (m_pRequest->WriteBlock( sHeader.constData(), sHeader.length() ) <
+        sHeader.length())
+    {
+        LOG(VB_HTTP, LOG_ERR, LOC + "Incomplete write of header");
+        return false;
+    }
+
+    m_bStreaming = true;
+    m_nBytesSent = sHeader.length();
+
+    m_pending.swap( m_pRequest->m_response.buffer() );
+    m_pRequest->m_response.seek( 0 );
+
+    return Flush( Z_NO_FLUSH );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool HttpResponseStream::Flush( int nFlush )
+{
+    if (!m_bGzip)
+    {
+        bool bOk = WriteChunk( m_pending.constData(), m_pending.size() );
+        m_pending.clear();
+        return bOk;
+    }
+
+    char aBuffer[ kChunkSize ];
+
+    m_zstream.next_in  = (Bytef*)(m_pending.data());
+    m_zstream.avail_in = m_pending.size();
+
+    do
+    {
+        m_zstream.next_out  = (Bytef*)(aBuffer);
+        m_zstream.avail_out = sizeof(aBuffer);
+
+        if (deflate( &m_zstream, nFlush ) == Z_STREAM_ERROR)
+        {
+            LOG(VB_HTTP, LOG_ERR, LOC + "deflate() failed");
+            return false;
+        }
+
+        if (!WriteChunk( aBuffer, sizeof(aBuffer) - m_zstream.avail_out ))
+            return false;
+    }
+    while (m_zstream.avail_out == 0);
+
+    m_pending.clear();
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+bool HttpResponseStream::WriteChunk( const char *pData, qint64 nLen )
+{
+    if (nLen <= 0)
+        return true;
+
+    QByteArray chunk = QByteArray::number( nLen, 16 ) + "\r\n";
+    chunk.reserve( chunk.size() + nLen + 2 );
+    chunk.append( pData, nLen );
+    chunk.append( "\r\n" );
+
+    if (m_pRequest->WriteBlock( chunk.constData(), chunk.size() ) != chunk.size())
+    {
+        LOG(VB_HTTP, LOG_ERR, LOC + "Error occurred while writing response body");
+        return false;
+    }
+
+    m_nBytesSent += chunk.size();
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Sends the rest of the response and the terminating zero length chunk.
+// Returns the number of bytes sent, or -1 if the connection failed.
+/////////////////////////////////////////////////////////////////////////////
+
+qint64 HttpResponseStream::Finish()
+{
+    if (m_bFinished || !m_bStreaming)
+        return m_bFailed ? -1 : m_nBytesSent;
+
+    m_bFinished = true;
+
+    if (!m_bFailed)
+        m_bFailed = !Flush( m_bGzip ? Z_FINISH : Z_NO_FLUSH );
+
+    if (m_bGzip)
+    {
+        deflateEnd( &m_zstream );
+        m_bGzip = false;
+    }
+
+    if (!m_bFailed)
+    {
+        static constexpr char kLastChunk[] = "0\r\n\r\n";
+
+        if (m_pRequest->WriteBlock( kLastChunk, sizeof(kLastChunk) - 1 ) !=
+            (qint64)(sizeof(kLastChunk) - 1))
+            m_bFailed = true;
+        else
+            m_nBytesSent += sizeof(kLastChunk) - 1;
+    }
+
+    return m_bFailed ? -1 : m_nBytesSent;
+}
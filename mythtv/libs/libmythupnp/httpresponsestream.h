@@ -0,0 +1,83 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: httpresponsestream.h
+//
+// Purpose     : Chunked (and optionally gzip'd) streaming of large
+//               serialized responses
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef HTTPRESPONSESTREAM_H
+#define HTTPRESPONSESTREAM_H
+
+// Qt headers
+#include <QByteArray>
+#include <QIODevice>
+
+// zlib
+#include <zlib.h>
+
+// MythTV headers
+#include "upnpexp.h"
+
+class HTTPRequest;
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// HttpResponseStream Class Definition
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Device a Serializer writes its output to.
+ *
+ * Small responses are collected in the request's response buffer and sent
+ * as before, with a Content-Length and ETag. Once the serialized output
+ * grows past the threshold (kStreamThreshold by default) the response
+ * header is sent with "Transfer-Encoding: chunked", and from then on the
+ * output is compressed (when the client accepts gzip) and written to the
+ * socket as it is produced, so the whole document is never held in memory.
+ */
+class UPNP_PUBLIC HttpResponseStream : public QIODevice
+{
+  public:
+    explicit HttpResponseStream( HTTPRequest *pRequest,
+                                 qint64 nThreshold = kStreamThreshold )
+        : m_pRequest(pRequest), m_nThreshold(nThreshold) {}
+    ~HttpResponseStream() override;
+
+    bool    isSequential () const override { return true; } // QIODevice
+
+    bool    IsStreaming  () const { return m_bStreaming; }
+    qint64  Finish       ();
+
+    static bool CanStream( const HTTPRequest *pRequest );
+
+    static constexpr int kStreamThreshold { 256 * 1024 };
+    static constexpr int kChunkSize       {  64 * 1024 };
+
+  protected:
+    qint64  readData     ( char */*pData*/, qint64 /*nMaxLen*/ ) override // QIODevice
+        { return -1; }
+    qint64  writeData    ( const char *pData, qint64 nLen ) override; // QIODevice
+
+  private:
+    bool    Begin        ();
+    bool    Flush        ( int nFlush );
+    bool    WriteChunk   ( const char *pData, qint64 nLen );
+
+    HTTPRequest *m_pRequest   {nullptr};
+    qint64       m_nThreshold {kStreamThreshold};
+    QByteArray   m_pending;           // Serialized, but not yet sent
+    z_stream     m_zstream    {};
+    bool         m_bGzip      {false};
+    bool         m_bStreaming {false};
+    bool         m_bFinished  {false};
+    bool         m_bFailed    {false};
+    qint64       m_nBytesSent {0};
+};
+
+#endif // HTTPRESPONSESTREAM_H
@@ -38,6 +38,9 @@
 #include "mythdirs.h"
 #include "mythlogging.h"
 #include "htmlserver.h"
+#ifdef Q_OS_LINUX
+#include "httpconnectionpoller.h"
+#endif
 #include "mythversion.h"
 #include "mythcorecontext.h"
 
@@ -161,6 +164,21 @@ HttpServer::HttpServer() :
     RegisterExtension( new RttiServiceHost( m_sSharePath ));
 
     LoadSSLConfig();
+
+#ifdef Q_OS_LINUX
+    // Plain connections wait for requests in the poller rather than in a
+    // worker thread, so idle keep-alive clients don't use up the pool
+    m_poller = new HttpConnectionPoller(*this);
+    if (m_poller->IsValid())
+    {
+        m_poller->start();
+    }
+    else
+    {
+        delete m_poller;
+        m_poller = nullptr;
+    }
+#endif
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -173,8 +191,20 @@ HttpServer::~HttpServer()
     m_running = false;
     m_rwlock.unlock();
 
+#ifdef Q_OS_LINUX
+    if (m_poller)
+        m_poller->Stop();
+#endif
+
     m_threadPool.Stop();
 
+#ifdef Q_OS_LINUX
+    // Workers return their connections to the poller, so wait for them
+    m_threadPool.waitForDone();
+    delete m_poller;
+    m_poller = nullptr;
+#endif
+
     while (!m_extensions.empty())
     {
         delete m_extensions.takeFirst();
@@ -305,6 +335,14 @@ void HttpServer::newTcpConnection(qt_socket_fd_t socket)
     if (server)
         type = server->GetServerType();
 
+#ifdef Q_OS_LINUX
+    if (m_poller && type == kTCPServer)
+    {
+        m_poller->AddConnection(socket);
+        return;
+    }
+#endif
+
     m_threadPool.startReserved(
         new HttpWorker(*this, socket, type
 #ifndef QT_NO_OPENSSL
@@ -421,6 +459,65 @@ void HttpServer::DelegateRequest(HTTPRequest *pRequest)
     }
 }
 
+/**
+ * \brief Parse a request, pass it to the extensions and send the response
+ * \param pRequest       The request to process
+ * \param nSocketTimeout Set to the idle timeout (ms) for the connection
+ * \return Whether the connection should be kept alive
+ */
+bool HttpServer::ProcessRequest(HTTPRequest *pRequest, int &nSocketTimeout)
+{
+    bool bKeepAlive = true;
+
+    if ( pRequest->ParseRequest() )
+    {
+        bKeepAlive = pRequest->GetKeepAlive();
+        // The timeout is defined by the Server/Server Extension
+        // but must appear in the response headers
+        uint nTimeout = GetSocketTimeout(pRequest); // Seconds
+        pRequest->SetKeepAliveTimeout(nTimeout);
+        nSocketTimeout = nTimeout * 1000; // Milliseconds
+
+        // ------------------------------------------------------
+        // Request Parsed... Pass on to Main HttpServer class to
+        // delegate processing to HttpServerExtensions.
+        // ------------------------------------------------------
+        if ((pRequest->m_nResponseStatus != 400) &&
+            (pRequest->m_nResponseStatus != 401) &&
+            (pRequest->m_nResponseStatus != 403) &&
+            pRequest->m_eType != RequestTypeUnknown)
+            DelegateRequest(pRequest);
+    }
+    else
+    {
+        LOG(VB_HTTP, LOG_ERR, "ParseRequest Failed.");
+
+        pRequest->m_nResponseStatus = 501;
+        pRequest->m_response.write( pRequest->GetResponsePage() );
+        bKeepAlive = false;
+    }
+
+    // -------------------------------------------------------
+    // Always MUST send a response.
+    // -------------------------------------------------------
+    if (pRequest->SendResponse() < 0)
+    {
+        bKeepAlive = false;
+        LOG(VB_HTTP, LOG_ERR,
+            QString("socket(%1) - Error returned from "
+                    "SendResponse... Closing connection")
+                .arg(pRequest->getSocketHandle()));
+    }
+
+    // -------------------------------------------------------
+    // Check to see if a PostProcess was registered
+    // -------------------------------------------------------
+    if ( pRequest->m_pPostProcess != nullptr )
+        pRequest->m_pPostProcess->ExecutePostProcess();
+
+    return bKeepAlive;
+}
+
 uint HttpServer::GetSocketTimeout(HTTPRequest* pRequest) const
 {
     int timeout = -1;
@@ -556,66 +653,12 @@ void HttpWorker::run(void)
                 // ----------------------------------------------------------
 
                 pRequest = new BufferedSocketDeviceRequest( pSocket );
-                if (pRequest != nullptr)
-                {
-                    pRequest->m_bEncrypted = bEncrypted;
-                    if ( pRequest->ParseRequest() )
-                    {
-                        bKeepAlive = pRequest->GetKeepAlive();
-                        // The timeout is defined by the Server/Server Extension
-                        // but must appear in the response headers
-                        uint nTimeout = m_httpServer.GetSocketTimeout(pRequest); // Seconds
-                        pRequest->SetKeepAliveTimeout(nTimeout);
-                        m_socketTimeout = nTimeout * 1000; // Milliseconds
-
-                        // ------------------------------------------------------
-                        // Request Parsed... Pass on to Main HttpServer class to 
-                        // delegate processing to HttpServerExtensions.
-                        // ------------------------------------------------------
-                        if ((pRequest->m_nResponseStatus != 400) &&
-                            (pRequest->m_nResponseStatus != 401) &&
-                            (pRequest->m_nResponseStatus != 403) &&
-                            pRequest->m_eType != RequestTypeUnknown)
-                            m_httpServer.DelegateRequest(pRequest);
-
-                        nRequestsHandled++;
-                    }
-                    else
-                    {
-                        LOG(VB_HTTP, LOG_ERR, "ParseRequest Failed.");
-
-                        pRequest->m_nResponseStatus = 501;
-                        pRequest->m_response.write( pRequest->GetResponsePage() );
-                        bKeepAlive = false;
-                    }
-
-                    // -------------------------------------------------------
-                    // Always MUST send a response.
-                    // -------------------------------------------------------
-                    if (pRequest->SendResponse() < 0)
-                    {
-                        bKeepAlive = false;
-                        LOG(VB_HTTP, LOG_ERR,
-                            QString("socket(%1) - Error returned from "
-                                    "SendResponse... Closing connection")
-                                .arg(pSocket->socketDescriptor()));
-                    }
-
-                    // -------------------------------------------------------
-                    // Check to see if a PostProcess was registered
-                    // -------------------------------------------------------
-                    if ( pRequest->m_pPostProcess != nullptr )
-                        pRequest->m_pPostProcess->ExecutePostProcess();
-
-                    delete pRequest;
-                    pRequest = nullptr;
-                }
-                else
-                {
-                    LOG(VB_GENERAL, LOG_ERR,
-                        "Error Creating BufferedSocketDeviceRequest");
-                    bKeepAlive = false;
-                }
+                pRequest->m_bEncrypted = bEncrypted;
+                bKeepAlive = m_httpServer.ProcessRequest(pRequest, m_socketTimeout);
+                nRequestsHandled++;
+
+                delete pRequest;
+                pRequest = nullptr;
             }
             else
             {
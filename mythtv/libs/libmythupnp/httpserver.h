@@ -45,6 +45,7 @@
 using TaskTime = struct timeval;
 
 class HttpWorkerThread;
+class HttpConnectionPoller;
 class QScriptEngine;
 class HttpServer;
 #ifndef QT_NO_OPENSSL
@@ -113,6 +114,8 @@ class UPNP_PUBLIC HttpServer : public ServerPool
 {
     Q_OBJECT
 
+    friend class HttpConnectionPoller;
+
   public:
     HttpServer();
     ~HttpServer() override;
@@ -120,6 +123,7 @@ class UPNP_PUBLIC HttpServer : public ServerPool
     void RegisterExtension(HttpServerExtension *pExtension);
     void UnregisterExtension(HttpServerExtension *pExtension);
     void DelegateRequest(HTTPRequest *pRequest);
+    bool ProcessRequest(HTTPRequest *pRequest, int &nSocketTimeout);
     /**
      * \brief Get the idle socket timeout value for the relevant extension
      */
@@ -148,6 +152,7 @@ class UPNP_PUBLIC HttpServer : public ServerPool
     QMultiMap< QString, HttpServerExtension* >  m_basePaths;
     QString                 m_sSharePath;
     MThreadPool             m_threadPool;
+    HttpConnectionPoller   *m_poller     { nullptr };
     bool                    m_running    { true }; // protected by m_rwlock
 
     static QMutex           s_platformLock;
@@ -230,21 +230,44 @@ QString JSONSerializer::Encode(const QString &sIn)
     if (sIn.isEmpty())
         return sIn;
 
-    QString sStr = sIn;
+    // Most values need no escaping, so only build a new string once the
+    // first character that does is found.
 
-    // -=>TODO: Would it be better to just loop through string once and build 
-    // new string with encoded chars instead of calling replace multiple times?
-    // It might perform better.
+    int nIdx = 0;
 
-    sStr.replace( '\\', "\\\\" ); // This must be first
-    sStr.replace( '"' , "\\\"" ); 
+    for (; nIdx < sIn.length(); ++nIdx)
+    {
+        ushort ch = sIn.at( nIdx ).unicode();
+
+        if (ch == '\\' || ch == '"'  || ch == '/'  || ch == '\b' ||
+            ch == '\f' || ch == '\n' || ch == '\r' || ch == '\t')
+            break;
+    }
+
+    if (nIdx == sIn.length())
+        return sIn;
 
-    sStr.replace( '\b', "\\b"  );
-    sStr.replace( '\f', "\\f"  );
-    sStr.replace( '\n', "\\n"  );
-    sStr.replace( "\r", "\\r"  );
-    sStr.replace( "\t", "\\t"  );
-    sStr.replace(  "/", "\\/"  );
+    QString sStr;
+    sStr.reserve( sIn.length() + 16 );
+    sStr.append( sIn.constData(), nIdx );
+
+    for (; nIdx < sIn.length(); ++nIdx)
+    {
+        QChar ch = sIn.at( nIdx );
+
+        switch (ch.unicode())
+        {
+            case '\\': sStr += "\\\\"; break;
+            case '"' : sStr += "\\\""; break;
+            case '\b': sStr += "\\b";  break;
+            case '\f': sStr += "\\f";  break;
+            case '\n': sStr += "\\n";  break;
+            case '\r': sStr += "\\r";  break;
+            case '\t': sStr += "\\t";  break;
+            case '/' : sStr += "\\/";  break;
+            default  : sStr += ch;     break;
+        }
+    }
 
     // we don't handle hex values yet...
     /*
@@ -12,8 +12,11 @@
 
 #include "serializer.h"
 
+#include <QHash>
 #include <QMetaObject>
 #include <QMetaProperty>
+#include <QReadWriteLock>
+#include <QStringList>
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -104,43 +107,102 @@ void Serializer::SerializeObjectProperties( const QObject *pObject )
 {
     if (pObject != nullptr)
     {
-        const QMetaObject *pMetaObject = pObject->metaObject();
+        const QMetaObject             *pMetaObject = pObject->metaObject();
+        const SerializerPropertyTable &table       = GetPropertyTable( pMetaObject );
 
-        int nCount = pMetaObject->propertyCount();
-
-        for (int nIdx=0; nIdx < nCount; ++nIdx ) 
+        for (const auto &prop : table)
         {
-            QMetaProperty metaProperty = pMetaObject->property( nIdx );
+            if (!prop.m_bSerialize)
+                continue;
+
+            if (!prop.m_bTransient)
+                m_hash.addData( prop.m_sNameUtf8 );
+
+            QVariant value( prop.m_metaProp.read( pObject ) );
 
-            if (metaProperty.isDesignable( pObject ))
+            if (!prop.m_bTransient && !value.canConvert< QObject* >())
             {
-                const char *pszPropName = metaProperty.name();
-                QString     sPropName( pszPropName );
-
-                if ( sPropName.compare( "objectName" ) == 0)
-                    continue;
-                
-                bool bHash = false;
-
-                if (ReadPropertyMetadata( pObject, 
-                                          sPropName,
-                                          "transient").toLower() != "true" )
-                {
-                    bHash = true;
-                    m_hash.addData( sPropName.toUtf8() );
-                }
-
-                QVariant value( pObject->property( pszPropName ) );
-
-                if (bHash && !value.canConvert< QObject* >()) 
-                {
-                    m_hash.addData( value.toString().toUtf8() );
-                }
-
-                AddProperty( sPropName, value, pMetaObject, &metaProperty );
+                m_hash.addData( value.toString().toUtf8() );
             }
+
+            AddProperty( prop.m_sName, value, pMetaObject, &prop.m_metaProp );
+        }
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Lists of DTC objects serialize thousands of instances of the same class,
+// so the property names and class info options are only looked up the
+// first time a class is seen. The table is indexed by property index.
+//
+// N.B. DESIGNABLE is no longer used at runtime by the data contracts, so
+//      it is read once per class rather than queried on each object.
+//////////////////////////////////////////////////////////////////////////////
+
+const SerializerPropertyTable &Serializer::GetPropertyTable( const QMetaObject *pMetaObject )
+{
+    static QReadWriteLock                                         s_lock;
+    static QHash< const QMetaObject*, SerializerPropertyTable* >  s_tables;
+
+    {
+        QReadLocker locker( &s_lock );
+
+        auto it = s_tables.constFind( pMetaObject );
+
+        if (it != s_tables.constEnd())
+            return **it;
+    }
+
+    auto *pTable = new SerializerPropertyTable( pMetaObject->propertyCount() );
+
+    for (int nIdx = 0; nIdx < pTable->size(); ++nIdx)
+    {
+        SerializerProperty &prop = (*pTable)[ nIdx ];
+
+        prop.m_metaProp   = pMetaObject->property( nIdx );
+        prop.m_sName      = prop.m_metaProp.name();
+        prop.m_sNameUtf8  = prop.m_sName.toUtf8();
+        prop.m_bSerialize = prop.m_metaProp.isDesignable() &&
+                            (prop.m_sName != "objectName");
+
+        int nClassIdx = pMetaObject->indexOfClassInfo( prop.m_metaProp.name() );
+
+        if (nClassIdx < 0)
+            continue;
+
+        QString     sOptionData = pMetaObject->classInfo( nClassIdx ).value();
+        QStringList sOptions    = sOptionData.split( ';' );
+        QString     sType;
+
+        for (const QString &sOption : sOptions)
+        {
+            if (sOption.startsWith( "transient=" ))
+                prop.m_bTransient = (sOption.mid( 10 ).toLower() == "true");
+            else if (sOption.startsWith( "name=" ) && prop.m_sItemHint.isEmpty())
+                prop.m_sItemHint = sOption.mid( 5 );
+            else if (sOption.startsWith( "type=" ) && sType.isEmpty())
+                sType = sOption.mid( 5 );
         }
+
+        if (prop.m_sItemHint.isEmpty())
+            prop.m_sItemHint = sType;
     }
+
+    QWriteLocker locker( &s_lock );
+
+    // Another thread may have built the same table in the meantime
+
+    auto it = s_tables.constFind( pMetaObject );
+
+    if (it != s_tables.constEnd())
+    {
+        delete pTable;
+        return **it;
+    }
+
+    s_tables.insert( pMetaObject, pTable );
+
+    return *pTable;
 }
 
 /////////////////////////////////////////////////////////////////////////////
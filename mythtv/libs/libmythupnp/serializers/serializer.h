@@ -18,8 +18,29 @@
 
 #include <QList>
 #include <QMetaType>
+#include <QMetaProperty>
+#include <QVector>
 #include <QCryptographicHash>
 
+//////////////////////////////////////////////////////////////////////////////
+//
+// SerializerProperty - Reflection data for one property of a serialized
+//                      class. Built once per class, see GetPropertyTable.
+//
+//////////////////////////////////////////////////////////////////////////////
+
+struct SerializerProperty
+{
+    QMetaProperty m_metaProp;
+    QString       m_sName;
+    QByteArray    m_sNameUtf8;
+    QString       m_sItemHint;          // "name=" or "type=" class info option
+    bool          m_bSerialize  {false};
+    bool          m_bTransient  {false};
+};
+
+using SerializerPropertyTable = QVector< SerializerProperty >;
+
 //////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -54,6 +75,8 @@ class UPNP_PUBLIC Serializer
                                                  const QString&  sPropName,
                                                  const QString&  sKey );
 
+        static const SerializerPropertyTable &GetPropertyTable( const QMetaObject *pMetaObject );
+
     public:
 
         virtual void Serialize( const QObject *pObject, const QString &_sName = QString() );
@@ -320,9 +320,26 @@ QString XmlSerializer::GetItemName( const QString &sName )
 
 QString XmlSerializer::GetContentName( const QString        &sName, 
                                        const QMetaObject   *pMetaObject,
-                                       const QMetaProperty */*pMetaProp*/ )
+                                       const QMetaProperty *pMetaProp )
 {
-    // Try to read Name or TypeName from classinfo metadata.
+    // Try to read Name or TypeName from classinfo metadata, which is cached
+    // per class when the property came from the object being serialized.
+
+    if (( pMetaObject != nullptr ) && ( pMetaProp != nullptr ))
+    {
+        const SerializerPropertyTable &table = GetPropertyTable( pMetaObject );
+
+        int nIdx = pMetaProp->propertyIndex();
+
+        if (( nIdx >= 0 ) && ( nIdx < table.size() ) &&
+            ( table[ nIdx ].m_sName == sName ))
+        {
+            if (!table[ nIdx ].m_sItemHint.isEmpty())
+                return GetItemName( table[ nIdx ].m_sItemHint );
+
+            return GetItemName( sName );
+        }
+    }
 
     int nClassIdx = -1;
 
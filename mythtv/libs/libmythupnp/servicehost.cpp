@@ -16,6 +16,7 @@
 #include "servicehost.h"
 #include "wsdl.h"
 #include "xsd.h"
+#include "serviceresponsecache.h"
 //#include "services/rtti.h"
 
 static constexpr int MAX_PARAMS = 256;
@@ -249,6 +250,18 @@ ServiceHost::ServiceHost(const QMetaObject &metaObject,
                                                              RequestTypeHead);
             }
 
+            QString sCacheClassInfo = oInfo.m_sName + "_Cache";
+
+            nClassIdx =
+                m_oMetaObject.indexOfClassInfo(sCacheClassInfo.toLatin1());
+
+            if (nClassIdx >=0)
+            {
+                oInfo.m_cacheGenerations =
+                    QString(m_oMetaObject.classInfo(nClassIdx).value())
+                        .split(',');
+            }
+
             m_Methods.insert( oInfo.m_sName, oInfo );
         }
     }
@@ -393,6 +406,37 @@ bool ServiceHost::ProcessRequest( HTTPRequest *pRequest )
 
                 if (( pRequest->m_eType & oInfo.m_eRequestType ) != 0)
                 {
+                    // ------------------------------------------------------
+                    // Read only methods may be answered from the cache,
+                    // or with a 304, without calling the service at all.
+                    // ------------------------------------------------------
+
+                    QString sCacheKey;
+                    QString sETag;
+
+                    if (!oInfo.m_cacheGenerations.isEmpty() &&
+                        ( pRequest->m_eType != RequestTypePost ) &&
+                        !pRequest->m_bSOAPRequest)
+                    {
+                        sCacheKey = ServiceResponseCache::GetKey( pRequest, oInfo );
+                        sETag     = ServiceResponseCache::GetETag( sCacheKey,
+                                                   oInfo.m_cacheGenerations );
+
+                        if (ServiceResponseCache::FormatResponse( pRequest,
+                                                                  sCacheKey,
+                                                                  sETag ))
+                        {
+                            return true;
+                        }
+
+                        // Known before a streamed header is sent, and only
+                        // streamed if too large to cache
+
+                        pRequest->SetResponseHeader( "ETag", sETag, true );
+                        pRequest->SetStreamThreshold(
+                            ServiceResponseCache::kMaxEntrySize );
+                    }
+
                     // ------------------------------------------------------
                     // Create new Instance of the Service Class so
                     // it's guaranteed to be on the same thread
@@ -406,6 +450,9 @@ bool ServiceHost::ProcessRequest( HTTPRequest *pRequest )
                                                     pRequest->m_mapParams);
 
                     bHandled = FormatResponse( pRequest, vResult );
+
+                    if (bHandled && !sCacheKey.isEmpty())
+                        ServiceResponseCache::AddResponse( pRequest, sCacheKey, sETag );
                 }
             }
 
@@ -443,6 +490,12 @@ bool ServiceHost::ProcessRequest( HTTPRequest *pRequest )
         bHandled = true;
     }
 
+    // An ETag set up front for a cached method only describes a successful
+    // result, not the error that replaced it
+
+    if (pRequest->m_nResponseStatus != 200 && !pRequest->IsResponseStreamed())
+        pRequest->m_mapRespHeaders.remove( "ETag" );
+
     delete pService;
     return bHandled;
 }
@@ -461,6 +514,7 @@ bool ServiceHost::FormatResponse( HTTPRequest *pRequest, QObject *pResults )
 
         pRequest->FormatActionResponse( pSer );
 
+        delete pSer;
         delete pResults;
 
         return true;
@@ -525,5 +579,7 @@ bool ServiceHost::FormatResponse( HTTPRequest *pRequest, const QVariant& vValue
 
     pRequest->FormatActionResponse( pSer );
 
+    delete pSer;
+
     return true;
 }
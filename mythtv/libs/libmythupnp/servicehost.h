@@ -40,6 +40,7 @@ class UPNP_PUBLIC MethodInfo
         HttpRequestType m_eRequestType {(HttpRequestType)(RequestTypeGet |
                                                           RequestTypePost |
                                                           RequestTypeHead)};
+        QStringList     m_cacheGenerations; // See ServiceResponseCache
 
     public:
         MethodInfo() = default;
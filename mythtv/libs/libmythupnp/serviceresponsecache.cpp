@@ -0,0 +1,268 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: serviceresponsecache.cpp
+//
+// Purpose     : Cache of serialized Services API responses, validated by
+//               data generation counters
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "serviceresponsecache.h"
+
+// C++ headers
+#include <algorithm>
+
+// Qt headers
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QUrl>
+
+// MythTV headers
+#include "httprequest.h"
+#include "servicehost.h"
+#include "mythcoreutil.h"
+#include "mythlogging.h"
+
+#define LOC QString("ServiceResponseCache: ")
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+struct CachedServiceResponse
+{
+    QString    m_sETag;
+    QString    m_sContentType;
+    QStringMap m_headers;
+    QByteArray m_body;
+    QByteArray m_gzipBody;      // Compressed when first requested
+};
+
+struct ServiceGeneration
+{
+    quint64 m_nValue   {0};
+    qint64  m_nStarted {0};     // ms since epoch
+};
+
+// Cost is in KB
+static QMutex                                   s_cacheLock;
+static QHash< QString, ServiceGeneration >      s_generations;
+static QCache< QString, CachedServiceResponse > s_responses
+    { ServiceResponseCache::kMaxCacheSize / 1024 };
+
+static int ResponseCost( const CachedServiceResponse &response )
+{
+    return (response.m_body.size() + response.m_gzipBody.size()) / 1024 + 1;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// A generation's value is the time it started, so values from before a
+// backend restart are never reused.
+/////////////////////////////////////////////////////////////////////////////
+
+quint64 ServiceResponseCache::Generation( const QString &sGeneration )
+{
+    QMutexLocker locker( &s_cacheLock );
+
+    qint64             nNow = QDateTime::currentMSecsSinceEpoch();
+    ServiceGeneration &gen  = s_generations[ sGeneration ];
+
+    if (( gen.m_nStarted == 0 ) || ( nNow - gen.m_nStarted >= kMaxAge ))
+    {
+        gen.m_nValue   = std::max( (quint64)nNow, gen.m_nValue + 1 );
+        gen.m_nStarted = nNow;
+    }
+
+    return gen.m_nValue;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+void ServiceResponseCache::Invalidate( const QString &sGeneration )
+{
+    QMutexLocker locker( &s_cacheLock );
+
+    qint64             nNow = QDateTime::currentMSecsSinceEpoch();
+    ServiceGeneration &gen  = s_generations[ sGeneration ];
+
+    gen.m_nValue   = std::max( (quint64)nNow, gen.m_nValue + 1 );
+    gen.m_nStarted = nNow;
+
+    LOG(VB_HTTP, LOG_DEBUG, LOC + QString("%1 generation is now %2")
+        .arg(sGeneration).arg(gen.m_nValue));
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Only the parameters the method takes are part of the key, so cache
+// busting parameters added by browsers don't defeat the cache. The Accept
+// header selects the serializer.
+/////////////////////////////////////////////////////////////////////////////
+
+QString ServiceResponseCache::GetKey( HTTPRequest *pRequest, const MethodInfo &oInfo )
+{
+    QStringMap lowerParams;
+
+    for (auto it = pRequest->m_mapParams.cbegin();
+         it != pRequest->m_mapParams.cend(); ++it)
+    {
+        lowerParams[ it.key().toLower() ] = it.value();
+    }
+
+    QString sKey = pRequest->m_sBaseUrl + "/" + oInfo.m_sName + "?";
+
+    for (const QByteArray &name : oInfo.m_oMethod.parameterNames())
+    {
+        QString sName = QString( name ).toLower();
+
+        auto it = lowerParams.constFind( sName );
+
+        // Values are escaped so a value holding '&' or '=' can't collide
+        // with a different set of parameters
+        if (it != lowerParams.constEnd())
+            sKey += sName + "=" + QString( QUrl::toPercentEncoding( *it ) ) + "&";
+    }
+
+    sKey += "|" + pRequest->GetRequestHeader( "Accept", "*/*" ).toLower();
+
+    return sKey;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+QString ServiceResponseCache::GetETag( const QString     &sKey,
+                                       const QStringList &generations )
+{
+    QCryptographicHash hash( QCryptographicHash::Sha1 );
+
+    hash.addData( sKey.toUtf8() );
+
+    for (const QString &sGeneration : generations)
+    {
+        hash.addData( sGeneration.toUtf8() );
+        hash.addData( QByteArray::number( Generation( sGeneration )));
+    }
+
+    return "\"" + hash.result().toHex() + "\"";
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Answers the request from the cache, returns false if the service method
+// has to be called.
+/////////////////////////////////////////////////////////////////////////////
+
+bool ServiceResponseCache::FormatResponse( HTTPRequest   *pRequest,
+                                           const QString &sKey,
+                                           const QString &sETag )
+{
+    if (pRequest->GetRequestHeader( "If-None-Match", "" ) == sETag)
+    {
+        LOG(VB_HTTP, LOG_INFO, LOC + QString("%1 - Not Modified").arg(sKey));
+
+        pRequest->m_nResponseStatus = 304;
+        pRequest->m_eResponseType   = ResponseTypeHeader; // No entity headers
+        pRequest->SetResponseHeader( "ETag", sETag, true );
+        return true;
+    }
+
+    CachedServiceResponse response;
+
+    {
+        QMutexLocker locker( &s_cacheLock );
+
+        CachedServiceResponse *pCached = s_responses.object( sKey );
+
+        if (pCached == nullptr)
+            return false;
+
+        if (pCached->m_sETag != sETag)
+        {
+            s_responses.remove( sKey );
+            return false;
+        }
+
+        response = *pCached;
+    }
+
+    bool bGzip = pRequest->m_mapHeaders.value( "accept-encoding" ).contains( "gzip" );
+
+    if (bGzip && response.m_gzipBody.isEmpty())
+    {
+        response.m_gzipBody = gzipCompress( response.m_body );
+
+        QMutexLocker locker( &s_cacheLock );
+
+        CachedServiceResponse *pCached = s_responses.object( sKey );
+
+        if (pCached != nullptr && pCached->m_sETag == sETag)
+            s_responses.insert( sKey, new CachedServiceResponse( response ),
+                                ResponseCost( response ));
+    }
+
+    LOG(VB_HTTP, LOG_INFO, LOC + QString("%1 - Cached").arg(sKey));
+
+    pRequest->m_eResponseType     = ResponseTypeOther;
+    pRequest->m_sResponseTypeText = response.m_sContentType;
+    pRequest->m_nResponseStatus   = 200;
+
+    for (auto it = response.m_headers.cbegin(); it != response.m_headers.cend(); ++it)
+        pRequest->SetResponseHeader( it.key(), it.value(), true );
+
+    pRequest->SetResponseHeader( "ETag", sETag, true );
+
+    if (bGzip && !response.m_gzipBody.isEmpty())
+    {
+        pRequest->m_response.buffer() = response.m_gzipBody;
+        pRequest->SetResponseHeader( "Content-Encoding", "gzip", true );
+    }
+    else
+        pRequest->m_response.buffer() = response.m_body;
+
+    return true;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// Called once the service method's result has been serialized.
+/////////////////////////////////////////////////////////////////////////////
+
+void ServiceResponseCache::AddResponse( HTTPRequest   *pRequest,
+                                        const QString &sKey,
+                                        const QString &sETag )
+{
+    // Only a successful response may be revalidated, otherwise a client
+    // would get a 304 for a cached error
+
+    if (pRequest->m_nResponseStatus != 200)
+        return;
+
+    pRequest->SetResponseHeader( "ETag", sETag, true );
+
+    // Streamed responses have already been sent, and aren't kept anywhere
+
+    if (pRequest->IsResponseStreamed()                      ||
+        ( pRequest->m_eResponseType   != ResponseTypeOther ))
+        return;
+
+    const QByteArray &body = pRequest->m_response.buffer();
+
+    if (body.isEmpty() || body.size() > kMaxEntrySize)
+        return;
+
+    auto *pResponse = new CachedServiceResponse;
+
+    pResponse->m_sETag        = sETag;
+    pResponse->m_sContentType = pRequest->m_sResponseTypeText;
+    pResponse->m_headers      = pRequest->m_mapRespHeaders;
+    pResponse->m_body         = body;
+
+    QMutexLocker locker( &s_cacheLock );
+
+    s_responses.insert( sKey, pResponse, ResponseCost( *pResponse ));
+}
@@ -0,0 +1,70 @@
+//////////////////////////////////////////////////////////////////////////////
+// Program Name: serviceresponsecache.h
+//
+// Purpose     : Cache of serialized Services API responses, validated by
+//               data generation counters
+//
+// Licensed under the GPL v2 or later, see COPYING for details
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef SERVICERESPONSECACHE_H
+#define SERVICERESPONSECACHE_H
+
+// Qt headers
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+
+// MythTV headers
+#include "upnpexp.h"
+#include "upnputil.h"
+
+class HTTPRequest;
+class MethodInfo;
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+//
+// ServiceResponseCache Class Definition
+//
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+ * \brief Caches the responses of read only service methods.
+ *
+ * A method opts in with Q_CLASSINFO( "<methodName>_Cache", "<generations>" ),
+ * naming the data generations its result depends on (e.g. "Guide,Schedule").
+ * The backend bumps a generation with Invalidate() when that data changes,
+ * and every generation is bumped after kMaxAge regardless, so anything not
+ * covered by an event is only ever stale for a bounded time.
+ *
+ * The ETag of a response is derived from the request and the current
+ * generations, so a client revalidating with If-None-Match is answered
+ * with a 304 before the service is even created, and a repeated request
+ * is answered from the cached body without touching the database.
+ *
+ * Other caches (e.g. the UPnP ContentDirectory's) use Generation() to
+ * validate their own entries against the same events.
+ */
+class UPNP_PUBLIC ServiceResponseCache
+{
+  public:
+    static void    Invalidate     ( const QString &sGeneration );
+    static quint64 Generation     ( const QString &sGeneration );
+
+    static QString GetKey         ( HTTPRequest *pRequest, const MethodInfo &oInfo );
+    static QString GetETag        ( const QString &sKey, const QStringList &generations );
+
+    static bool    FormatResponse ( HTTPRequest *pRequest,
+                                    const QString &sKey, const QString &sETag );
+    static void    AddResponse    ( HTTPRequest *pRequest,
+                                    const QString &sKey, const QString &sETag );
+
+    static constexpr int    kMaxEntrySize {  16 * 1024 * 1024 };
+    static constexpr int    kMaxCacheSize {  64 * 1024 * 1024 };
+    static constexpr qint64 kMaxAge       {   5 * 60 * 1000   }; // ms
+};
+
+#endif // SERVICERESPONSECACHE_H
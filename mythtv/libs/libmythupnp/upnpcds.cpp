@@ -18,6 +18,7 @@ using namespace std;
 #include "upnp.h"
 #include "upnpcds.h"
 #include "upnputil.h"
+#include "serviceresponsecache.h"
 #include "mythlogging.h"
 #include "mythversion.h"
 
@@ -462,8 +463,9 @@ void UPnpCDS::HandleBrowse( HTTPRequest *pRequest )
                      i++)
                 {
                     UPnpCDSExtension *pExtension = m_extensions[i];
-                    CDSObject* pExtensionRoot = pExtension->GetRoot();
+                    CDSObject* pExtensionRoot = pExtension->AcquireRoot();
                     sResultXML += pExtensionRoot->toXml(filter, true); // Ignore Children
+                    pExtensionRoot->DecrRef();
                     nNumberReturned ++;
                 }
 
@@ -840,6 +842,33 @@ UPnpCDSExtensionResults *UPnpCDSExtension::Browse( UPnpCDSRequest *pRequest )
     LOG(VB_UPNP, LOG_DEBUG, QString("Browse (%1): Current Token '%2'")
                                 .arg(m_sExtensionId).arg(currentToken));
 
+    // ----------------------------------------------------------------------
+    // Clients page through large containers and come back to the same ones
+    // over and over, so answer from the cache where we can
+    // ----------------------------------------------------------------------
+
+    QString sCacheKey;
+
+    if (!m_cacheGenerations.isEmpty())
+    {
+        RefreshCache();
+
+        sCacheKey = QString("%1|%2|%3|%4|%5|%6")
+                        .arg(pRequest->m_sObjectId)
+                        .arg(pRequest->m_eBrowseFlag)
+                        .arg(pRequest->m_nStartingIndex)
+                        .arg(pRequest->m_nRequestedCount)
+                        .arg(pRequest->m_eClient)
+                        .arg(pRequest->m_nClientVersion);
+
+        UPnpCDSExtensionResults *pCached = GetCachedResults(sCacheKey);
+
+        if (pCached != nullptr)
+            return pCached;
+    }
+
+    QReadLocker rootLocker(&m_rootLock);
+
     // ----------------------------------------------------------------------
     // Process based on location in hierarchy
     // ----------------------------------------------------------------------
@@ -863,7 +892,10 @@ UPnpCDSExtensionResults *UPnpCDSExtension::Browse( UPnpCDSRequest *pRequest )
 
                 LOG(VB_UPNP, LOG_DEBUG, QString("UPnpCDS::Browse: BrowseMetadata (%1)").arg(pRequest->m_sObjectId));
                 if (LoadMetadata(pRequest, pResults, tokens, currentToken))
+                {
+                    AddCachedResults(sCacheKey, pResults);
                     return pResults;
+                }
                 pResults->m_eErrorCode = UPnPResult_CDS_NoSuchObject;
                 break;
             }
@@ -873,7 +905,10 @@ UPnpCDSExtensionResults *UPnpCDSExtension::Browse( UPnpCDSRequest *pRequest )
                 pRequest->m_sParentId = pRequest->m_sObjectId;
                 LOG(VB_UPNP, LOG_DEBUG, QString("UPnpCDS::Browse: BrowseDirectChildren (%1)").arg(pRequest->m_sObjectId));
                 if (LoadChildren(pRequest, pResults, tokens, currentToken))
+                {
+                    AddCachedResults(sCacheKey, pResults);
                     return pResults;
+                }
                 pResults->m_eErrorCode = UPnPResult_CDS_NoSuchObject;
                 break;
             }
@@ -890,6 +925,112 @@ UPnpCDSExtensionResults *UPnpCDSExtension::Browse( UPnpCDSRequest *pRequest )
     return( pResults );
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// Drops the cached results, and rebuilds the root (and so the child counts
+// of the top level containers), once any of our generations has moved on.
+/////////////////////////////////////////////////////////////////////////////
+
+void UPnpCDSExtension::RefreshCache()
+{
+    QVector<quint64> stamp;
+
+    for (const QString &sGeneration : qAsConst(m_cacheGenerations))
+        stamp.append(ServiceResponseCache::Generation(sGeneration));
+
+    {
+        QMutexLocker locker(&m_cacheLock);
+
+        if (stamp == m_cacheStamp)
+            return;
+    }
+
+    QWriteLocker rootLocker(&m_rootLock);
+
+    {
+        QMutexLocker locker(&m_cacheLock);
+
+        if (stamp == m_cacheStamp) // Another request got here first
+            return;
+    }
+
+    LOG(VB_UPNP, LOG_INFO, QString("%1: Content has changed, rebuilding")
+                                .arg(m_sExtensionId));
+
+    if (m_pRoot)
+    {
+        m_pRoot->DecrRef();
+        m_pRoot = nullptr;
+    }
+
+    CreateRoot();
+
+    if (m_pRoot)
+    {
+        m_pRoot->m_bCacheXml = true;
+
+        for (auto *pChild : qAsConst(m_pRoot->m_children))
+            pChild->m_bCacheXml = true;
+    }
+
+    QMutexLocker locker(&m_cacheLock);
+
+    m_browseCache.clear();
+    m_cacheStamp = stamp;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+//
+/////////////////////////////////////////////////////////////////////////////
+
+UPnpCDSExtensionResults *UPnpCDSExtension::GetCachedResults( const QString &sKey )
+{
+    QMutexLocker locker(&m_cacheLock);
+
+    CDSBrowseCacheEntry *pEntry = m_browseCache.object(sKey);
+
+    if (pEntry == nullptr)
+        return nullptr;
+
+    LOG(VB_UPNP, LOG_DEBUG, QString("Browse (%1): Cached '%2'")
+                                .arg(m_sExtensionId).arg(sKey));
+
+    auto *pResults = new UPnpCDSExtensionResults();
+
+    pResults->Add(pEntry->m_objects);
+    pResults->m_nTotalMatches = pEntry->m_nTotalMatches;
+    pResults->m_nUpdateID     = pEntry->m_nUpdateID;
+
+    return pResults;
+}
+
+/////////////////////////////////////////////////////////////////////////////
+// The objects are shared with the cache from here on, so they mustn't be
+// changed, and can keep the DIDL they render.
+/////////////////////////////////////////////////////////////////////////////
+
+void UPnpCDSExtension::AddCachedResults( const QString &sKey,
+                                         const UPnpCDSExtensionResults *pResults )
+{
+    if (sKey.isEmpty() || pResults->m_eErrorCode != UPnPResult_Success)
+        return;
+
+    auto *pEntry = new CDSBrowseCacheEntry();
+
+    for (auto *pObject : qAsConst(pResults->m_List))
+    {
+        pObject->IncrRef();
+        pObject->m_bCacheXml = true;
+        pEntry->m_objects.append(pObject);
+    }
+
+    pEntry->m_nTotalMatches = pResults->m_nTotalMatches;
+    pEntry->m_nUpdateID     = pResults->m_nUpdateID;
+
+    QMutexLocker locker(&m_cacheLock);
+
+    m_browseCache.insert(sKey, pEntry, pEntry->m_objects.size() + 1);
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
@@ -1096,6 +1237,24 @@ CDSObject* UPnpCDSExtension::GetRoot()
     return m_pRoot;
 }
 
+/////////////////////////////////////////////////////////////////////////////
+// For use outside of Browse(), where the root may be rebuilt at any time.
+/////////////////////////////////////////////////////////////////////////////
+
+CDSObject* UPnpCDSExtension::AcquireRoot()
+{
+    if (!m_cacheGenerations.isEmpty())
+        RefreshCache();
+
+    QReadLocker rootLocker(&m_rootLock);
+
+    CDSObject *pRoot = GetRoot();
+
+    pRoot->IncrRef();
+
+    return pRoot;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 //
 /////////////////////////////////////////////////////////////////////////////
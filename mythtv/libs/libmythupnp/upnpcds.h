@@ -17,10 +17,15 @@
 #include <utility>
 
 // QT headers
+#include <QCache>
 #include <QList>
 #include <QMap>
+#include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
 #include <QString>
+#include <QStringList>
+#include <QVector>
 
 #include "upnp.h"
 #include "upnpcdsobjects.h"
@@ -199,6 +204,31 @@ using CDSShortCutList = QMap<UPnPShortcutFeature::ShortCutType, QString>;
 using IDTokenMap = QMap<QString, QString>;
 using IDToken = QPair<QString, QString>;
 
+/**
+ * \brief A page of Browse results kept by UPnpCDSExtension.
+ */
+class CDSBrowseCacheEntry
+{
+    public:
+
+        CDSObjects  m_objects;
+        uint16_t    m_nTotalMatches {0};
+        uint16_t    m_nUpdateID     {0};
+
+    public:
+
+        CDSBrowseCacheEntry() = default;
+        ~CDSBrowseCacheEntry()
+        {
+            while (!m_objects.isEmpty())
+            {
+                m_objects.takeLast()->DecrRef();
+            }
+        }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 class UPNP_PUBLIC UPnpCDSExtension
 {
     public:
@@ -247,8 +277,27 @@ class UPNP_PUBLIC UPnpCDSExtension
 
         CDSObject *m_pRoot {nullptr};
 
+        // The data generations (see ServiceResponseCache) the extension's
+        // content depends on. Browse results, and the root's child counts,
+        // are kept until one of them changes. Nothing is cached if empty.
+        QStringList m_cacheGenerations;
+
+    private:
+
+        void                     RefreshCache     ( );
+        UPnpCDSExtensionResults *GetCachedResults ( const QString &sKey );
+        void                     AddCachedResults ( const QString &sKey,
+                                                    const UPnpCDSExtensionResults *pResults );
+
+        QReadWriteLock   m_rootLock;    // Held for writing while m_pRoot is rebuilt
+        QMutex           m_cacheLock;
+        QVector<quint64> m_cacheStamp;  // Generations m_browseCache was built from
+        QCache<QString, CDSBrowseCacheEntry> m_browseCache { kMaxCachedObjects };
+
     public:
 
+        static constexpr int kMaxCachedObjects { 4096 };
+
         UPnpCDSExtension( const QString& sName,
                           QString sExtensionId, 
                           QString sClass )
@@ -259,6 +308,7 @@ class UPNP_PUBLIC UPnpCDSExtension
         }
 
         virtual CDSObject *GetRoot ( );
+        CDSObject         *AcquireRoot ( ); // Caller must DecrRef()
 
         virtual ~UPnpCDSExtension();
 
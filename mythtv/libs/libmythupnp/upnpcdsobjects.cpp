@@ -10,6 +10,7 @@
 //
 //////////////////////////////////////////////////////////////////////////////
 
+#include <QMutex>
 #include <QTextStream>
 #include <QTextCodec>
 #include <QUrl>
@@ -19,6 +20,8 @@
 
 inline QString GetBool( bool bVal ) { return( (bVal) ? "1" : "0" ); }
 
+static QMutex s_xmlFragmentLock;
+
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 //
@@ -264,11 +267,32 @@ void CDSObject::SetChildContainerCount( uint32_t nCount )
 QString CDSObject::toXml( FilterMap &filter,
                           bool ignoreChildren ) const
 {
+    QString sFragmentKey;
+
+    if (m_bCacheXml)
+    {
+        sFragmentKey = filter.join(',') + (ignoreChildren ? "|1" : "|0");
+
+        QMutexLocker locker( &s_xmlFragmentLock );
+
+        auto it = m_xmlFragments.constFind( sFragmentKey );
+
+        if (it != m_xmlFragments.constEnd())
+            return *it;
+    }
+
     QString     sXML;
     QTextStream os( &sXML, QIODevice::WriteOnly );
     os.setCodec(QTextCodec::codecForName("UTF-8"));
     toXml(os, filter, ignoreChildren);
     os << flush;
+
+    if (m_bCacheXml)
+    {
+        QMutexLocker locker( &s_xmlFragmentLock );
+        m_xmlFragments.insert( sFragmentKey, sXML );
+    }
+
     return( sXML );
 }
 
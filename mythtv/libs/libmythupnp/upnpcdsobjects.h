@@ -215,6 +215,10 @@ class UPNP_PUBLIC CDSObject : public ReferenceCounter
 
         Resources       m_resources;
 
+        // Set once the object is held by a browse cache, after which it
+        // must not change. toXml() then keeps the DIDL it renders.
+        bool            m_bCacheXml            {false};
+
 
     public:
 
@@ -280,6 +284,8 @@ class UPNP_PUBLIC CDSObject : public ReferenceCounter
     private:
         static bool FilterContains( const FilterMap &filter, const QString &name ) ;
 
+        mutable QMap<QString, QString> m_xmlFragments; // Keyed by filter
+
 };
 
 #endif // UPNPCDSOBJECTS_H
@@ -63,7 +63,13 @@ libmythservicecontracts-test.target = buildtestmythservicecontracts
 libmythservicecontracts-test.commands = cd libmythservicecontracts/test && $(QMAKE) && $(MAKE)
 unix:QMAKE_EXTRA_TARGETS += libmythservicecontracts-test
 
-unittest.depends = libmyth-test libmythbase-test libmythtv-test libmythmetadata-test libmythservicecontracts-test
+# unit tests libmythui
+libmythui-test.depends = sub-libmythui
+libmythui-test.target = buildtestmythui
+libmythui-test.commands = cd libmythui/test && $(QMAKE) && $(MAKE)
+unix:QMAKE_EXTRA_TARGETS += libmythui-test
+
+unittest.depends = libmyth-test libmythbase-test libmythtv-test libmythmetadata-test libmythservicecontracts-test libmythui-test
 unittest.target = test
 unittest.commands = ../programs/scripts/unittests.sh
 unix:QMAKE_EXTRA_TARGETS += unittest
@@ -54,6 +54,8 @@ using namespace std;
 #include "mthread.h"
 #include "scheduler.h"
 #include "requesthandler/fileserverutil.h"
+#include "services/dvr.h"
+#include "serviceresponsecache.h"
 #include "programinfo.h"
 #include "mythtimezone.h"
 #include "recordinginfo.h"
@@ -325,6 +327,8 @@ MainServer::MainServer(bool master, int port,
         expirer->SetMainServer(this);
 
     m_metadatafactory = new MetadataFactory(this);
+    if (gCoreContext->GetBoolSetting("VideoScanWatch", false))
+        m_metadatafactory->WatchVideoDirs();
 
     m_autoexpireUpdateTimer = new QTimer(this);
     connect(m_autoexpireUpdateTimer, SIGNAL(timeout()),
@@ -1542,6 +1546,25 @@ void MainServer::customEvent(QEvent *e)
             }
         }
 
+        if (me->Message().startsWith("RECORDING_LIST_CHANGE"))
+        {
+            Dvr::RecordedListChanged();
+            ServiceResponseCache::Invalidate("Recordings");
+        }
+
+        if (me->Message() == "SCHEDULE_CHANGE")
+            ServiceResponseCache::Invalidate("Schedule");
+
+        if (me->Message().startsWith("SYSTEM_EVENT MYTHFILLDATABASE_RAN"))
+            ServiceResponseCache::Invalidate("Guide");
+
+        if (me->Message() == "VIDEO_LIST_CHANGE")
+            ServiceResponseCache::Invalidate("Videos");
+
+        if (me->Message().startsWith("MUSIC_SCANNER_FINISHED") ||
+            me->Message().startsWith("MUSIC_METADATA_CHANGED"))
+            ServiceResponseCache::Invalidate("Music");
+
         if (me->Message().startsWith("DOWNLOAD_FILE"))
         {
             QStringList extraDataList = me->ExtraDataList();
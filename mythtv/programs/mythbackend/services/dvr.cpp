@@ -23,8 +23,11 @@
 //
 //////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+
+#include <QHash>
 #include <QMap>
-#include <QRegExp>
+#include <QMutex>
 
 #include "dvr.h"
 
@@ -60,6 +63,51 @@ extern AutoExpire  *expirer;
 //
 /////////////////////////////////////////////////////////////////////////////
 
+// Counts of recordings matching each GetRecordedList filter.  They are
+// cleared whenever the recording list changes, and also expire in case the
+// recorded table is modified without a RECORDING_LIST_CHANGE event.
+static const qint64 kRecordedCountExpiry = 5 * 60 * 1000;
+static QMutex s_recordedCountLock;
+static QHash<QString, QPair<uint, qint64> > s_recordedCounts;
+
+void Dvr::RecordedListChanged(void)
+{
+    QMutexLocker locker(&s_recordedCountLock);
+    s_recordedCounts.clear();
+}
+
+static uint CountRecorded(const QString &sWhere, const MSqlBindings &bindings)
+{
+    QString sKey = sWhere;
+    for (auto it = bindings.cbegin(); it != bindings.cend(); ++it)
+        sKey += QString("|%1=%2").arg(it.key()).arg(it.value().toString());
+
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    {
+        QMutexLocker locker(&s_recordedCountLock);
+        auto cached = s_recordedCounts.constFind(sKey);
+        if (cached != s_recordedCounts.constEnd() && cached->second > now)
+            return cached->first;
+    }
+
+    MSqlQuery query(MSqlQuery::InitCon());
+    query.prepare(QString("SELECT COUNT(*) FROM recorded AS r WHERE %1")
+                  .arg(sWhere));
+    query.bindValues(bindings);
+
+    if (!query.exec() || !query.next())
+    {
+        MythDB::DBError("Dvr::GetRecordedList count", query);
+        return 0;
+    }
+
+    uint nCount = query.value(0).toUInt();
+
+    QMutexLocker locker(&s_recordedCountLock);
+    s_recordedCounts.insert(sKey, qMakePair(nCount, now + kRecordedCountExpiry));
+    return nCount;
+}
+
 DTC::ProgramList* Dvr::GetRecordedList( bool           bDescending,
                                         int            nStartIndex,
                                         int            nCount,
@@ -67,9 +115,77 @@ DTC::ProgramList* Dvr::GetRecordedList( bool           bDescending,
                                         const QString &sRecGroup,
                                         const QString &sStorageGroup,
                                         const QString &sCategory,
-                                        const QString &sSort
+                                        const QString &sSort,
+                                        int            nAfterRecordedId
                                       )
 {
+    // ----------------------------------------------------------------------
+    // Build SQL condition, so that only the requested page is loaded
+    // ----------------------------------------------------------------------
+
+    QStringList  clause;
+    MSqlBindings bindings;
+
+    clause << "r.deletepending = 0";
+
+    if (!sTitleRegEx.isEmpty())
+    {
+        clause << "r.title REGEXP :TitleRegEx";
+        bindings[":TitleRegEx"] = sTitleRegEx;
+    }
+
+    if (!sRecGroup.isEmpty())
+    {
+        clause << "r.recgroup = :RecGroup";
+        bindings[":RecGroup"] = sRecGroup;
+    }
+
+    if (!sStorageGroup.isEmpty())
+    {
+        clause << "r.storagegroup = :StorageGroup";
+        bindings[":StorageGroup"] = sStorageGroup;
+    }
+
+    if (!sCategory.isEmpty())
+    {
+        clause << "r.category = :Category";
+        bindings[":Category"] = sCategory;
+    }
+
+    int nAvailable = (int)CountRecorded(clause.join(" AND "), bindings);
+
+    // A keyset cursor continues after the given recording instead of
+    // skipping StartIndex rows, which the database would have to read.
+    // It is only supported for the default (start time) order.
+    int nOffset = std::max(nStartIndex, 0);
+    if (nAfterRecordedId > 0 && sSort.isEmpty())
+    {
+        MSqlQuery query(MSqlQuery::InitCon());
+        query.prepare("SELECT starttime FROM recorded "
+                      "WHERE recordedid = :RecordedId");
+        query.bindValue(":RecordedId", nAfterRecordedId);
+
+        if (!query.exec())
+            MythDB::DBError("Dvr::GetRecordedList cursor", query);
+        else if (!query.next())
+            throw QString("AfterRecordedId %1 not found").arg(nAfterRecordedId);
+        else
+        {
+            clause << QString("(r.starttime %1 :AfterTime1 OR "
+                              "(r.starttime = :AfterTime2 AND r.recordedid %1 :AfterId))")
+                      .arg(bDescending ? "<" : ">");
+            bindings[":AfterTime1"] = query.value(0);
+            bindings[":AfterTime2"] = query.value(0);
+            bindings[":AfterId"]    = nAfterRecordedId;
+            nOffset = 0;
+        }
+    }
+    else if (nAfterRecordedId > 0)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, "GetRecordedList: AfterRecordedId is only "
+            "supported with the default sort order, using StartIndex");
+    }
+
     QMap< QString, ProgramInfo* > recMap;
 
     if (gCoreContext->GetScheduler())
@@ -84,7 +200,9 @@ DTC::ProgramList* Dvr::GetRecordedList( bool           bDescending,
     if (bDescending)
         desc = -1;
 
-    LoadFromRecorded( progList, false, inUseMap, isJobRunning, recMap, desc, sSort );
+    LoadFromRecorded( progList, clause.join(" AND "), bindings, inUseMap,
+                      isJobRunning, recMap, desc, sSort, (uint)nOffset,
+                      (uint)std::max(nCount, 0) );
 
     QMap< QString, ProgramInfo* >::iterator mit = recMap.begin();
 
@@ -96,32 +214,11 @@ DTC::ProgramList* Dvr::GetRecordedList( bool           bDescending,
     // ----------------------------------------------------------------------
 
     auto *pPrograms = new DTC::ProgramList();
-    int nAvailable = 0;
-
-    int nMax      = (nCount > 0) ? nCount : progList.size();
 
-    nAvailable = 0;
     nCount = 0;
 
-    QRegExp rTitleRegEx        = QRegExp(sTitleRegEx, Qt::CaseInsensitive);
-
     for (auto *pInfo : progList)
     {
-        if (pInfo->IsDeletePending() ||
-            (!sTitleRegEx.isEmpty() && !pInfo->GetTitle().contains(rTitleRegEx)) ||
-            (!sRecGroup.isEmpty() && sRecGroup != pInfo->GetRecordingGroup()) ||
-            (!sStorageGroup.isEmpty() && sStorageGroup != pInfo->GetStorageGroup()) ||
-            (!sCategory.isEmpty() && sCategory != pInfo->GetCategory()))
-            continue;
-
-        if ((nAvailable < nStartIndex) ||
-            (nCount >= nMax))
-        {
-            ++nAvailable;
-            continue;
-        }
-
-        ++nAvailable;
         ++nCount;
 
         DTC::Program *pProgram = pPrograms->AddNewProgram();
@@ -38,6 +38,9 @@ class Dvr : public DvrServices
 
         Q_INVOKABLE explicit Dvr( QObject */*parent*/ = nullptr ) {}
 
+        // Discard cached results that depend on the recorded table
+        static void RecordedListChanged( void );
+
     public:
 
         DTC::ProgramList* GetExpiringList     ( int              StartIndex,
@@ -50,7 +53,8 @@ class Dvr : public DvrServices
                                                 const QString   &RecGroup,
                                                 const QString   &StorageGroup,
                                                 const QString   &Category,
-                                                const QString   &Sort) override; // DvrServices
+                                                const QString   &Sort,
+                                                int              AfterRecordedId) override; // DvrServices
 
         DTC::ProgramList* GetOldRecordedList  ( bool             Descending,
                                                 int              StartIndex,
@@ -341,13 +345,15 @@ class ScriptableDvr : public QObject
                                        const QString   &RecGroup,
                                        const QString   &StorageGroup,
                                        const QString   &Category,
-                                       const QString   &Sort
+                                       const QString   &Sort,
+                                       int              AfterRecordedId
                                      )
         {
             SCRIPT_CATCH_EXCEPTION( nullptr,
                 return m_obj.GetRecordedList( Descending, StartIndex, Count,
                                               TitleRegEx, RecGroup,
-                                              StorageGroup, Category, Sort);
+                                              StorageGroup, Category, Sort,
+                                              AfterRecordedId);
             )
         }
 
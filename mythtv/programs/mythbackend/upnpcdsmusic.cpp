@@ -71,6 +71,9 @@ UPnpCDSMusic::UPnpCDSMusic()
     m_shortcuts.insert(UPnPShortcutFeature::MUSIC_ALBUMS, "Music/Album");
     m_shortcuts.insert(UPnPShortcutFeature::MUSIC_ARTISTS, "Music/Artist");
     m_shortcuts.insert(UPnPShortcutFeature::MUSIC_GENRES, "Music/Genre");
+
+    // Invalidated by the backend (see MainServer::customEvent)
+    m_cacheGenerations << "Music";
 }
 
 /////////////////////////////////////////////////////////////////////////////
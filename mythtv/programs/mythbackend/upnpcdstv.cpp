@@ -142,6 +142,9 @@ UPnpCDSTv::UPnpCDSTv()
 
     // ShortCuts
     m_shortcuts.insert(UPnPShortcutFeature::VIDEOS_RECORDINGS, "Recordings");
+
+    // Invalidated by the backend (see MainServer::customEvent)
+    m_cacheGenerations << "Recordings";
 }
 
 void UPnpCDSTv::CreateRoot()
@@ -38,6 +38,9 @@ UPnpCDSVideo::UPnpCDSVideo()
     m_shortcuts.insert(UPnPShortcutFeature::VIDEOS, "Videos");
     m_shortcuts.insert(UPnPShortcutFeature::VIDEOS_ALL, "Videos/Video");
     m_shortcuts.insert(UPnPShortcutFeature::VIDEOS_GENRES, "Videos/Genre");
+
+    // Invalidated by the backend (see MainServer::customEvent)
+    m_cacheGenerations << "Videos";
 }
 
 void UPnpCDSVideo::CreateRoot()
@@ -35,6 +35,9 @@ void MythFrontendCommandLineParser::LoadArguments(void)
         "Start the frontend within specified plugin.", "")
             ->SetGroup("Startup Behavior")
             ->SetBlocks("jumppoint");
+    add("--startup-profile", "startupprofile", "",
+        "Write a timeline of the startup phases to the specified file.", "")
+            ->SetGroup("Startup Behavior");
 
     add(QStringList{"-G", "--get-setting"},
         "getsetting", "", "", "")
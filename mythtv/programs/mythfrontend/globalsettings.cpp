@@ -70,6 +70,22 @@ static HostSpinBoxSetting *AudioReadAhead()
     return gc;
 }
 
+static HostSpinBoxSetting *ReadAheadBufferCap()
+{
+    auto *gc = new HostSpinBoxSetting("ReadAheadBufferCap", 8, 512, 8, 8);
+
+    gc->setLabel(PlaybackSettings::tr("Maximum read ahead buffer (MB)"));
+
+    gc->setValue(64);
+
+    gc->setHelpText(PlaybackSettings::tr(
+        "The read ahead buffer grows to hold a few seconds of video at the "
+        "rate it is actually being played. This is the largest it may grow to. "
+        "Increase this value if high bitrate recordings stutter after seeking "
+        "when played from another backend. Default is 64."));
+    return gc;
+}
+
 static HostComboBoxSetting *ColourPrimaries()
 {
     auto *gc = new HostComboBoxSetting("ColourPrimariesMode");
@@ -4286,6 +4302,7 @@ void PlaybackSettings::Load(void)
     advanced->setLabel(tr("Advanced Playback Settings"));
     advanced->addChild(RealtimePriority());
     advanced->addChild(AudioReadAhead());
+    advanced->addChild(ReadAheadBufferCap());
     advanced->addChild(ColourPrimaries());
     advanced->addChild(ChromaUpsampling());
 #ifdef USING_VAAPI
@@ -0,0 +1,219 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+
+// Qt headers
+#include <QSet>
+#include <QStringList>
+
+// MythTV headers
+#include "mythdate.h"
+#include "mythdbcon.h"
+#include "mythlogging.h"
+#include "guidecache.h"
+
+#define LOC QString("GuideCache: ")
+
+// Listings are reloaded from the database after this many seconds
+static const int kCacheLifetime = 10 * 60;
+
+GuideCache::~GuideCache()
+{
+    Clear();
+}
+
+bool GuideCache::Covers(const Entry *Item, const QDateTime &Start,
+                        const QDateTime &End) const
+{
+    if (!Item || Item->m_start > Start || Item->m_end < End)
+        return false;
+    return Item->m_loaded.secsTo(MythDate::current()) < kCacheLifetime;
+}
+
+bool GuideCache::Contains(uint ChanId, const QDateTime &Start,
+                          const QDateTime &End) const
+{
+    QMutexLocker locker(&m_lock);
+    return Covers(m_entries.value(ChanId, nullptr), Start, End);
+}
+
+/** \brief Ensure listings between Start and End are cached for the given channels.
+ *
+ * Channels that are not already covered are loaded with a single query, with
+ * Slack seconds of listings added either side of the requested window.
+ */
+void GuideCache::Load(const QVector<uint> &ChanIds, const QDateTime &Start,
+                      const QDateTime &End, int Slack, const ProgramList &SchedList)
+{
+    QStringList missing;
+    {
+        QMutexLocker locker(&m_lock);
+        for (uint chanid : ChanIds)
+        {
+            QString id = QString::number(chanid);
+            if (!Covers(m_entries.value(chanid, nullptr), Start, End) &&
+                !missing.contains(id))
+            {
+                missing.append(id);
+            }
+        }
+    }
+
+    if (missing.isEmpty())
+        return;
+
+    QDateTime start = Start.addSecs(-Slack);
+    QDateTime end   = End.addSecs(Slack);
+
+    // N.B. The default grouping used by LoadFromProgram would merge programs
+    // on different channels with the same channel number and callsign.
+    QString querystr = QString(
+        "WHERE program.chanid IN (%1) "
+        "  AND program.endtime >= :STARTTS "
+        "  AND program.starttime <= :ENDTS "
+        "  AND program.starttime >= :STARTLIMITTS "
+        "  AND program.manualid = 0 "
+        "GROUP BY program.chanid, program.starttime, channel.channum, "
+        "         channel.callsign, program.title ").arg(missing.join(","));
+    MSqlBindings bindings;
+    bindings[":STARTTS"]      = start;
+    bindings[":STARTLIMITTS"] = start.addDays(-1);
+    bindings[":ENDTS"]        = end;
+
+    ProgramList programs(false);
+    LoadFromProgram(programs, querystr, bindings, SchedList);
+
+    LOG(VB_GUI, LOG_DEBUG, LOC + QString("Loaded %1 programs for %2 channels")
+        .arg(programs.size()).arg(missing.size()));
+
+    QDateTime now = MythDate::current();
+    QHash<uint,Entry*> loaded;
+    for (const QString &id : qAsConst(missing))
+    {
+        auto *entry = new Entry;
+        entry->m_start  = start;
+        entry->m_end    = end;
+        entry->m_loaded = now;
+        loaded.insert(id.toUInt(), entry);
+    }
+
+    // Programs are returned in start time order, which is preserved per channel
+    for (auto *program : programs)
+    {
+        Entry *entry = loaded.value(program->GetChanID(), nullptr);
+        if (entry)
+            entry->m_programs.push_back(program);
+        else
+            delete program;
+    }
+
+    QMutexLocker locker(&m_lock);
+    for (auto it = loaded.cbegin(); it != loaded.cend(); ++it)
+    {
+        delete m_entries.value(it.key(), nullptr);
+        m_entries.insert(it.key(), it.value());
+    }
+}
+
+/** \brief Append copies of the listings for a channel between Start and End.
+ *
+ * The selection matches the query used by GuideGrid for a single channel. The
+ * channel is loaded if it is not already cached.
+ */
+void GuideCache::GetPrograms(ProgramList &Programs, uint ChanId,
+                             const QDateTime &Start, const QDateTime &End,
+                             const ProgramList &SchedList)
+{
+    if (!Contains(ChanId, Start, End))
+        Load({ ChanId }, Start, End, static_cast<int>(Start.secsTo(End)), SchedList);
+
+    QDateTime limit = Start.addDays(-1);
+
+    QMutexLocker locker(&m_lock);
+    Entry *entry = m_entries.value(ChanId, nullptr);
+    if (!entry)
+        return;
+
+    for (auto *program : entry->m_programs)
+    {
+        QDateTime starttime = program->GetScheduledStartTime();
+        if (starttime > End)
+            break;
+        if (starttime >= limit && program->GetScheduledEndTime() >= Start)
+            Programs.push_back(new ProgramInfo(*program));
+    }
+}
+
+/** \brief Drop the channels whose cached scheduler state is no longer valid.
+ *
+ * Scheduler state is only applied to a program with the same start time as a
+ * scheduled recording, so only the channels with a program starting at the
+ * time of an added, removed or changed recording need to be reloaded.
+ */
+void GuideCache::Invalidate(const Schedule &Before, const Schedule &After)
+{
+    QSet<QDateTime> changed;
+    for (auto it = Before.cbegin(); it != Before.cend(); ++it)
+        if (After.value(it.key()) != it.value())
+            changed.insert(it.key().second);
+    for (auto it = After.cbegin(); it != After.cend(); ++it)
+        if (!Before.contains(it.key()))
+            changed.insert(it.key().second);
+
+    if (changed.isEmpty())
+        return;
+
+    QMutexLocker locker(&m_lock);
+    int dropped = 0;
+    for (auto it = m_entries.begin(); it != m_entries.end(); )
+    {
+        bool stale = false;
+        for (auto *program : (*it)->m_programs)
+        {
+            if (changed.contains(program->GetScheduledStartTime()))
+            {
+                stale = true;
+                break;
+            }
+        }
+
+        if (stale)
+        {
+            delete *it;
+            it = m_entries.erase(it);
+            dropped++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    LOG(VB_GUI, LOG_DEBUG, LOC + QString("%1 schedule changes, dropped %2 channels")
+        .arg(changed.size()).arg(dropped));
+}
+
+void GuideCache::Clear(void)
+{
+    QMutexLocker locker(&m_lock);
+    qDeleteAll(m_entries);
+    m_entries.clear();
+}
+
+GuideCache::Schedule GuideCache::ScheduleState(const ProgramList &SchedList)
+{
+    Schedule result;
+    for (auto *program : SchedList)
+    {
+        result.insert(qMakePair(program->GetChanID(), program->GetScheduledStartTime()),
+                      QString("%1:%2:%3:%4:%5:%6:%7:%8")
+                      .arg(static_cast<int>(program->GetRecordingStatus()))
+                      .arg(static_cast<int>(program->GetRecordingRuleType()))
+                      .arg(program->GetRecordingRuleID())
+                      .arg(program->GetFindID())
+                      .arg(program->GetInputID())
+                      .arg(program->GetRecordingPriority())
+                      .arg(program->GetRecordingStartTime().toSecsSinceEpoch())
+                      .arg(program->GetRecordingEndTime().toSecsSinceEpoch()));
+    }
+    return result;
+}
@@ -0,0 +1,69 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+#ifndef GUIDE_CACHE_H
+#define GUIDE_CACHE_H
+
+// Qt headers
+#include <QDateTime>
+#include <QMutex>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QPair>
+
+// MythTV headers
+#include "programinfo.h"
+
+/** \class GuideCache
+ *  \brief Frontend side cache of program guide listings.
+ *
+ * Listings are held per channel for a window of time. Channels are loaded
+ * with some slack either side of the requested window, so that scrolling
+ * and paging through time is served from memory, and all missing channels
+ * are loaded with a single query rather than one query per channel. Entries
+ * are reloaded after a few minutes so that guide data updates are picked up.
+ *
+ * The cached ProgramInfos have the scheduler state applied when they are
+ * loaded. When the schedule changes only the channels with a program in an
+ * affected time slot are dropped.
+ *
+ * \note All methods are thread safe.
+ */
+class GuideCache
+{
+  public:
+    /// Scheduler state keyed by chanid and start time, see ScheduleState()
+    using Schedule = QMap<QPair<uint,QDateTime>,QString>;
+
+    GuideCache() = default;
+    ~GuideCache();
+
+    bool Contains(uint ChanId, const QDateTime &Start, const QDateTime &End) const;
+    void Load(const QVector<uint> &ChanIds, const QDateTime &Start,
+              const QDateTime &End, int Slack, const ProgramList &SchedList);
+    void GetPrograms(ProgramList &Programs, uint ChanId, const QDateTime &Start,
+                     const QDateTime &End, const ProgramList &SchedList);
+    void Invalidate(const Schedule &Before, const Schedule &After);
+    void Clear(void);
+
+    static Schedule ScheduleState(const ProgramList &SchedList);
+
+  private:
+    Q_DISABLE_COPY(GuideCache)
+
+    struct Entry
+    {
+        QDateTime    m_start;
+        QDateTime    m_end;
+        QDateTime    m_loaded;
+        ProgramList  m_programs;
+    };
+
+    bool Covers(const Entry *Item, const QDateTime &Start,
+                const QDateTime &End) const;
+
+    mutable QMutex          m_lock;
+    QHash<uint,Entry*>      m_entries;
+};
+
+#endif // GUIDE_CACHE_H
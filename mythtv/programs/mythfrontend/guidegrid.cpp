@@ -64,6 +64,7 @@ QWaitCondition epgIsVisibleCond;
 const QString kUnknownTitle = "";
 //const QString kUnknownCategory = QObject::tr("Unknown");
 const unsigned long kUpdateMS = 60 * 1000UL; // Grid update interval (mS)
+const int kPrefetchMS = 750; // Idle time before loading adjacent pages (mS)
 static bool SelectionIsTunable(const ChannelInfoList &selection);
 
 JumpToChannel::JumpToChannel(
@@ -277,6 +278,13 @@ public:
             return false;
         }
 
+        // Load any rows that are not already cached with a single query
+        QVector<int> missing;
+        for (unsigned int i = 0; i < m_numRows; ++i)
+            if (!m_proglists[i])
+                missing.push_back(m_chanNums[i]);
+        m_guide->loadProgramLists(missing);
+
         for (unsigned int i = 0; i < m_numRows; ++i)
         {
             unsigned int row = i + m_firstRow;
@@ -344,6 +352,28 @@ public:
     QVector<bool> m_unavailables;
 };
 
+// Loads the listings either side of the current page into the guide
+// cache while the user is idle. There is no UI part.
+class GuidePrefetch : public GuideUpdaterBase
+{
+public:
+    GuidePrefetch(GuideGrid *guide, uint startChan, QDateTime startTime)
+        : GuideUpdaterBase(guide), m_currentStartChannel(startChan),
+          m_currentStartTime(std::move(startTime)) {}
+    bool ExecuteNonUI(void) override // GuideUpdaterBase
+    {
+        if (m_currentStartChannel == m_guide->GetCurrentStartChannel() &&
+            m_currentStartTime == m_guide->GetCurrentStartTime())
+        {
+            m_guide->prefetchProgramLists();
+        }
+        return false;
+    }
+    void ExecuteUI(void) override {} // GuideUpdaterBase
+    uint m_currentStartChannel;
+    QDateTime m_currentStartTime;
+};
+
 class UpdateGuideEvent : public QEvent
 {
 public:
@@ -498,6 +528,7 @@ GuideGrid::GuideGrid(MythScreenStack *parent,
            m_previewVideoRefreshTimer(new QTimer(this)),
            m_channelOrdering(gCoreContext->GetSetting("ChannelOrdering", "channum")),
            m_updateTimer(new QTimer(this)),
+           m_prefetchTimer(new QTimer(this)),
            m_threadPool("GuideGridHelperPool"),
            m_changrpid(changrpid),
            m_changrplist(ChannelGroup::GetChannelGroups(false))
@@ -505,6 +536,8 @@ GuideGrid::GuideGrid(MythScreenStack *parent,
     connect(m_previewVideoRefreshTimer, SIGNAL(timeout()),
             this,                     SLOT(refreshVideo()));
     connect(m_updateTimer, SIGNAL(timeout()), SLOT(updateTimeout()) );
+    connect(m_prefetchTimer, SIGNAL(timeout()), SLOT(prefetchTimeout()) );
+    m_prefetchTimer->setSingleShot(true);
 
     for (uint i = 0; i < MAX_DISPLAY_CHANS; i++)
         m_programs.push_back(nullptr);
@@ -574,6 +607,17 @@ void GuideGrid::Load(void)
     setStartChannel((int)(m_currentStartChannel) - (m_channelCount / 2));
     m_channelCount = min(m_channelCount, maxchannel + 1);
 
+    QVector<int> chanNums;
+    for (int y = 0; y < m_channelCount; ++y)
+    {
+        int chanNum = y + m_currentStartChannel;
+        if (chanNum >= (int) m_channelInfos.size())
+            chanNum -= (int) m_channelInfos.size();
+        if (chanNum >= 0 && chanNum < (int) m_channelInfos.size())
+            chanNums.push_back(chanNum);
+    }
+    loadProgramLists(chanNums);
+
     for (int y = 0; y < m_channelCount; ++y)
     {
         int chanNum = y + m_currentStartChannel;
@@ -617,6 +661,8 @@ GuideGrid::~GuideGrid()
 {
     m_updateTimer->disconnect(this);
     m_updateTimer = nullptr;
+    m_prefetchTimer->disconnect(this);
+    m_prefetchTimer = nullptr;
 
     GuideHelper::Wait(this);
 
@@ -1170,25 +1216,21 @@ int GuideGrid::GetStartChannelOffset(int row) const
 ProgramList GuideGrid::GetProgramList(uint chanid) const
 {
     ProgramList proglist;
-    MSqlBindings bindings;
-    QString querystr =
-        "WHERE program.chanid     = :CHANID       AND "
-        "      program.endtime   >= :STARTTS      AND "
-        "      program.starttime <= :ENDTS        AND "
-        "      program.starttime >= :STARTLIMITTS AND "
-        "      program.manualid   = 0 ";
-    QDateTime starttime = m_currentStartTime.addSecs(0 - m_currentStartTime.time().second());
-    bindings[":STARTTS"] = starttime;
-    bindings[":STARTLIMITTS"] = starttime.addDays(-1);
-    bindings[":ENDTS"] = m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
-    bindings[":CHANID"]  = chanid;
-
-    ProgramList dummy;
-    LoadFromProgram(proglist, querystr, bindings, dummy);
-
+    m_guideCache.GetPrograms(proglist, chanid, GetQueryStartTime(),
+                             GetQueryEndTime(), m_recList);
     return proglist;
 }
 
+QDateTime GuideGrid::GetQueryStartTime(void) const
+{
+    return m_currentStartTime.addSecs(0 - m_currentStartTime.time().second());
+}
+
+QDateTime GuideGrid::GetQueryEndTime(void) const
+{
+    return m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
+}
+
 static ProgramList *CopyProglist(ProgramList *proglist)
 {
     if (!proglist)
@@ -1525,26 +1567,80 @@ ProgramList *GuideGrid::getProgramListFromProgram(int chanNum)
 {
     auto *proglist = new ProgramList();
 
-    if (proglist)
+    const ChannelInfo *chinfo = GetChannelInfo(chanNum);
+    if (chinfo)
     {
-        MSqlBindings bindings;
-        QString querystr = "WHERE program.chanid = :CHANID "
-                           "  AND program.endtime >= :STARTTS "
-                           "  AND program.starttime <= :ENDTS "
-                           "  AND program.starttime >= :STARTLIMITTS "
-                           "  AND program.manualid = 0 ";
-        QDateTime starttime = m_currentStartTime.addSecs(0 - m_currentStartTime.time().second());
-        bindings[":CHANID"]  = GetChannelInfo(chanNum)->m_chanId;
-        bindings[":STARTTS"] = starttime;
-        bindings[":STARTLIMITTS"] = starttime.addDays(-1);
-        bindings[":ENDTS"] = m_currentEndTime.addSecs(0 - m_currentEndTime.time().second());
-
-        LoadFromProgram(*proglist, querystr, bindings, m_recList);
+        m_guideCache.GetPrograms(*proglist, chinfo->m_chanId,
+                                 GetQueryStartTime(), GetQueryEndTime(),
+                                 m_recList);
     }
 
     return proglist;
 }
 
+// Make sure the listings for the given channel indexes are in the guide
+// cache, loading any that are missing with a single query. The cached
+// window extends one page either side of the current page.
+void GuideGrid::loadProgramLists(const QVector<int> &chanNums)
+{
+    QVector<uint> chanids;
+    for (int chanNum : chanNums)
+    {
+        const ChannelInfo *chinfo = GetChannelInfo(chanNum);
+        if (chinfo)
+            chanids.push_back(chinfo->m_chanId);
+    }
+
+    if (chanids.empty())
+        return;
+
+    QDateTime start = GetQueryStartTime();
+    QDateTime end   = GetQueryEndTime();
+    m_guideCache.Load(chanids, start, end, static_cast<int>(start.secsTo(end)),
+                      m_recList);
+}
+
+// Load the previous and next pages of channels, and the previous and
+// next pages of time for the current channels, into the guide cache.
+void GuideGrid::prefetchProgramLists(void)
+{
+    int count = static_cast<int>(GetChannelCount());
+    if (count < 1)
+        return;
+
+    QVector<uint> chanids;
+    int rows = min(m_channelCount * 3, count);
+    for (int i = 0; i < rows; ++i)
+    {
+        int chanNum = (static_cast<int>(m_currentStartChannel) - m_channelCount + i) % count;
+        if (chanNum < 0)
+            chanNum += count;
+        const ChannelInfo *chinfo = GetChannelInfo(chanNum);
+        if (chinfo)
+            chanids.push_back(chinfo->m_chanId);
+    }
+
+    QDateTime start = GetQueryStartTime();
+    QDateTime end   = GetQueryEndTime();
+    int page = static_cast<int>(start.secsTo(end));
+    m_guideCache.Load(chanids, start.addSecs(-page), end.addSecs(page), page,
+                      m_recList);
+}
+
+void GuideGrid::prefetchTimeout(void)
+{
+    // Only prefetch while nothing else is being loaded
+    if (GuideHelper::IsLoading(this))
+    {
+        m_prefetchTimer->start(kPrefetchMS);
+        return;
+    }
+
+    auto *updater = new GuidePrefetch(this, m_currentStartChannel,
+                                      m_currentStartTime);
+    m_threadPool.start(new GuideHelper(this, updater), "GuideHelper");
+}
+
 void GuideGrid::fillProgramRowInfos(int firstRow, bool useExistingData)
 {
     bool allRows = false;
@@ -1857,7 +1953,9 @@ void GuideGrid::customEvent(QEvent *event)
         if (message == "SCHEDULE_CHANGE")
         {
             GuideHelper::Wait(this);
+            GuideCache::Schedule before = GuideCache::ScheduleState(m_recList);
             LoadFromScheduler(m_recList);
+            m_guideCache.Invalidate(before, GuideCache::ScheduleState(m_recList));
             fillProgramInfos();
         }
         else if (message == "STOP_VIDEO_REFRESH_TIMER")
@@ -2059,6 +2157,9 @@ void GuideGrid::updateProgramsUI(unsigned int firstRow, unsigned int numRows,
             updateInfo();
     }
     m_guideGrid->SetRedraw();
+
+    if (m_prefetchTimer)
+        m_prefetchTimer->start(kPrefetchMS);
 }
 
 void GuideGrid::updateChannels(void)
@@ -2243,7 +2344,7 @@ void GuideGrid::generateListings()
     maxchannel = max((int)GetChannelCount() - 1, 0);
     m_channelCount = min(m_guideGrid->getChannelCount(), maxchannel + 1);
 
-    LoadFromScheduler(m_recList);
+    // m_recList is kept up to date by SCHEDULE_CHANGE events
     fillProgramInfos();
 }
 
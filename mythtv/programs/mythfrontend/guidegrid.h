@@ -24,6 +24,7 @@ using namespace std;
 
 // mythfrontend
 #include "schedulecommon.h"
+#include "guidecache.h"
 
 using namespace std;
 
@@ -175,6 +176,7 @@ class GuideGrid : public ScheduleCommon, public JumpToChannelListener
     void updateInfo(void);
     void updateChannels(void);
     void updateJumpToChannel(void);
+    void prefetchTimeout(void);
 
   private:
 
@@ -212,6 +214,8 @@ class GuideGrid : public ScheduleCommon, public JumpToChannelListener
 public:
     // These need to be public so that the helper classes can operate.
     ProgramList *getProgramListFromProgram(int chanNum);
+    void loadProgramLists(const QVector<int> &chanNums);
+    void prefetchProgramLists(void);
     void updateProgramsUI(unsigned int firstRow, unsigned int numRows,
                           int progPast,
                           const QVector<ProgramList*> &proglists,
@@ -231,6 +235,8 @@ private:
     int                  GetStartChannelOffset(int row = -1) const;
 
     ProgramList GetProgramList(uint chanid) const;
+    QDateTime GetQueryStartTime(void) const;
+    QDateTime GetQueryEndTime(void) const;
     uint GetAlternateChannelIndex(uint chan_idx, bool with_same_channum) const;
     void updateDateText(void);
 
@@ -242,6 +248,7 @@ private:
     QMap<uint,uint>      m_channelInfoIdx;
 
     vector<ProgramList*> m_programs;
+    mutable GuideCache   m_guideCache;
     ProgInfoGuideArray m_programInfos {};
     ProgramList  m_recList;
 
@@ -275,6 +282,7 @@ private:
     QString m_channelOrdering;
 
     QTimer *m_updateTimer                 {nullptr}; // audited ref #5318
+    QTimer *m_prefetchTimer               {nullptr}; // audited ref #5318
 
     MThreadPool       m_threadPool;
 
@@ -12,6 +12,8 @@ using namespace std;
 #include <QKeyEvent>
 #include <QEvent>
 #include <QDir>
+#include <QDirIterator>
+#include <QLibrary>
 #include <QTextCodec>
 #include <QApplication>
 #include <QTimer>
@@ -89,6 +91,7 @@ using namespace std;
 #include "cleanupguard.h"
 #include "standardsettings.h"
 #include "settingshelper.h"
+#include "startupprofile.h"
 
 // Video
 #include "cleanup.h"
@@ -1834,8 +1837,47 @@ static int revokeRoot (void)
 }
 
 
+/// Load the plugin libraries so that MythPluginManager finds them already
+/// mapped and relocated. QLibrary leaves them loaded when it is destroyed.
+static void preloadPlugins(void)
+{
+    QDir dir(GetPluginsDir());
+    dir.setFilter(QDir::Files | QDir::Readable);
+    dir.setNameFilters(QStringList(GetPluginsNameFilter()));
+    for (const auto & library : dir.entryList())
+    {
+        QLibrary plugin(GetPluginsDir() + library);
+        if (!plugin.load())
+        {
+            LOG(VB_GENERAL, LOG_WARNING, QString("Failed to preload '%1': %2")
+                .arg(library).arg(plugin.errorString()));
+        }
+    }
+}
+
+/// Read the font files that MythFontManager will register, so that
+/// registration (which must happen on the UI thread) is not waiting on disk.
+static void prefetchFonts(const QStringList &Dirs)
+{
+    const QStringList filters { "*.ttf", "*.otf", "*.ttc" };
+    for (const auto & dir : Dirs)
+    {
+        QDirIterator it(dir, filters, QDir::Files | QDir::Readable,
+                        QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            QFile file(it.next());
+            if (file.open(QIODevice::ReadOnly))
+                file.readAll();
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
+    StartupProfile startup;
+    startup.Phase("Command line");
+
     bool bPromptForBackend    = false;
     bool bBypassAutoDiscovery = false;
 
@@ -1858,6 +1900,9 @@ int main(int argc, char **argv)
         return GENERIC_EXIT_OK;
     }
 
+    startup.SetOutput(cmdline.toString("startupprofile"));
+
+    startup.Phase("Application");
     MythDisplay::ConfigureQtGUI(1, cmdline.toString("display"));
     QApplication::setSetuidAllowed(true);
     QApplication a(argc, argv);
@@ -1887,6 +1932,7 @@ int main(int argc, char **argv)
     SignalHandler::SetHandler(SIGHUP, logSigHup);
 #endif
 
+    startup.Phase("Logging");
     int retval = cmdline.ConfigureLogging();
     if (retval != GENERIC_EXIT_OK)
         return retval;
@@ -1904,6 +1950,7 @@ int main(int argc, char **argv)
     if (!cmdline.toString("geometry").isEmpty())
         MythUIHelper::ParseGeometryOverride(cmdline.toString("geometry"));
 
+    startup.Phase("Context");
     fe_sd_notify("STATUS=Connecting to database.");
     gContext = new MythContext(MYTH_BINARY_VERSION, true);
     gCoreContext->SetAsFrontend(true);
@@ -1918,6 +1965,10 @@ int main(int argc, char **argv)
 
     cmdline.ApplySettingsOverride();
 
+    // Plugins are not needed until after the main window is up
+    startup.StartTask("Plugin preload", preloadPlugins);
+
+    startup.Phase("Schema");
     if (!GetMythDB()->HaveSchema())
     {
         if (!InitializeMythSchema())
@@ -1929,6 +1980,7 @@ int main(int argc, char **argv)
 
     if (!cmdline.toBool("noupnp"))
     {
+        startup.Phase("UPnP");
         fe_sd_notify("STATUS=Creating UPnP media renderer");
         g_pUPnp  = new MediaRenderer();
         if (!g_pUPnp->isInitialized())
@@ -1986,14 +2038,17 @@ int main(int argc, char **argv)
     }
 #endif
 
+    startup.Phase("LCD");
     fe_sd_notify("STATUS=Initializing LCD");
     LCD::SetupLCD();
     if (LCD *lcd = LCD::Get())
         lcd->setupLEDs(RemoteGetRecordingMask);
 
+    startup.Phase("Translation");
     fe_sd_notify("STATUS=Loading translation");
     MythTranslation::load("mythfrontend");
 
+    startup.Phase("Theme");
     fe_sd_notify("STATUS=Loading themes");
     QString themename = gCoreContext->GetSetting("Theme", DEFAULT_UI_THEME);
 
@@ -2016,6 +2071,9 @@ int main(int argc, char **argv)
         return GENERIC_EXIT_NO_THEME;
     }
 
+    startup.StartTask("Font prefetch", [themedir]() { prefetchFonts({ GetFontsDir(), themedir }); });
+
+    startup.Phase("Main window");
     MythMainWindow *mainWindow = GetMythMainWindow();
     mainWindow->Init(false);
     mainWindow->setWindowTitle(QCoreApplication::translate("(MythFrontendMain)",
@@ -2025,6 +2083,7 @@ int main(int argc, char **argv)
 #ifdef USING_AIRPLAY
     if (gCoreContext->GetBoolSetting("AirPlayEnabled", true))
     {
+        startup.Phase("AirPlay");
         fe_sd_notify("STATUS=Initializing AirPlay");
         MythRAOPDevice::Create();
         if (!gCoreContext->GetBoolSetting("AirPlayAudioOnly", false))
@@ -2034,6 +2093,7 @@ int main(int argc, char **argv)
     }
 #endif
 
+    startup.Phase("Language");
     // We must reload the translation after a language change and this
     // also means clearing the cached/loaded theme strings, so reload the
     // theme which also triggers a translation reload
@@ -2043,6 +2103,7 @@ int main(int argc, char **argv)
             return GENERIC_EXIT_NO_THEME;
     }
 
+    startup.Phase("Database upgrade");
     if (!UpgradeTVDatabaseSchema(false, false, true))
     {
         LOG(VB_GENERAL, LOG_ERR,
@@ -2056,6 +2117,7 @@ int main(int argc, char **argv)
     // when they were written originally
     mainWindow->ReloadKeys();
 
+    startup.Phase("Jump points");
     fe_sd_notify("STATUS=Initializing jump points");
     InitJumpPoints();
     InitKeys();
@@ -2064,14 +2126,18 @@ int main(int argc, char **argv)
 
     internal_media_init();
 
+    startup.Phase("In use programs");
     CleanupMyOldInUsePrograms();
 
     setHttpProxy();
 
+    startup.WaitForTask("Plugin preload");
+    startup.Phase("Plugins");
     fe_sd_notify("STATUS=Initializing plugins");
     g_pmanager = new MythPluginManager();
     gCoreContext->SetPluginManager(g_pmanager);
 
+    startup.Phase("Media monitor");
     fe_sd_notify("STATUS=Initializing media monitor");
     MediaMonitor *mon = MediaMonitor::GetMediaMonitor();
     if (mon)
@@ -2080,6 +2146,7 @@ int main(int argc, char **argv)
         mainWindow->installEventFilter(mon);
     }
 
+    startup.Phase("Network control");
     fe_sd_notify("STATUS=Initializing network control");
     NetworkControl *networkControl = nullptr;
     if (gCoreContext->GetBoolSetting("NetworkControlEnabled", false))
@@ -2094,6 +2161,7 @@ int main(int argc, char **argv)
         }
     }
 
+    startup.Phase("Menu");
 #if CONFIG_DARWIN
     GetMythMainWindow()->SetEffectsEnabled(false);
     GetMythMainWindow()->Init();
@@ -2105,6 +2173,7 @@ int main(int argc, char **argv)
     {
         return GENERIC_EXIT_NO_THEME;
     }
+    startup.Phase("Theme updates");
     fe_sd_notify("STATUS=Loading theme updates");
     std::unique_ptr<ThemeUpdateChecker> themeUpdateChecker;
     if (gCoreContext->GetBoolSetting("ThemeUpdateNofications", true))
@@ -2117,6 +2186,7 @@ int main(int argc, char **argv)
     PreviewGeneratorQueue::CreatePreviewGeneratorQueue(
         PreviewGenerator::kRemote, 50, 60);
 
+    startup.Phase("Housekeeper");
     fe_sd_notify("STATUS=Creating housekeeper");
     auto *housekeeping = new HouseKeeper();
 #ifdef __linux__
@@ -2127,6 +2197,7 @@ int main(int argc, char **argv)
     housekeeping->Start();
 
 
+    startup.Phase("Start screen");
     if (cmdline.toBool("runplugin"))
     {
         QStringList plugins = g_pmanager->EnumeratePlugins();
@@ -2172,6 +2243,8 @@ int main(int argc, char **argv)
         standbyScreen();
     }
 
+    startup.Finish();
+
     // Provide systemd ready notification (for type=notify units)
     fe_sd_notify("STATUS=");
     fe_sd_notify("READY=1");
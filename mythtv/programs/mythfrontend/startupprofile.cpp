@@ -0,0 +1,155 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+
+// Std
+#include <algorithm>
+
+// Qt headers
+#include <QFile>
+#include <QTextStream>
+
+// MythTV headers
+#include "mthread.h"
+#include "mythlogging.h"
+#include "startupprofile.h"
+
+#define LOC QString("Startup: ")
+
+/// \brief Runs a single startup task on its own thread and records its duration.
+class StartupTask : public MThread
+{
+  public:
+    StartupTask(StartupProfile *Profile, const QString &Name, std::function<void()> Task)
+      : MThread("Startup" + Name),
+        m_profile(Profile),
+        m_name(Name),
+        m_task(std::move(Task))
+    {
+    }
+
+    void run(void) override
+    {
+        RunProlog();
+        qint64 start = m_profile->Elapsed();
+        m_task();
+        m_profile->Record(m_name, objectName(), start, m_profile->Elapsed());
+        RunEpilog();
+    }
+
+  private:
+    StartupProfile       *m_profile { nullptr };
+    QString               m_name;
+    std::function<void()> m_task;
+};
+
+StartupProfile::StartupProfile()
+{
+    m_timer.start();
+}
+
+StartupProfile::~StartupProfile()
+{
+    for (auto *task : qAsConst(m_tasks))
+    {
+        task->wait();
+        delete task;
+    }
+}
+
+/// \brief End the current main thread phase (if any) and start a new one.
+void StartupProfile::Phase(const QString &Name)
+{
+    qint64 now = m_timer.elapsed();
+    if (!m_phase.isEmpty())
+        Record(m_phase, "main", m_phaseStart, now);
+    m_phase      = Name;
+    m_phaseStart = now;
+}
+
+/// \brief Run Task on a new thread, overlapping the main thread phases.
+void StartupProfile::StartTask(const QString &Name, std::function<void()> Task)
+{
+    if (m_tasks.contains(Name))
+        return;
+    auto *task = new StartupTask(this, Name, std::move(Task));
+    m_tasks.insert(Name, task);
+    task->start();
+}
+
+/// \brief Block until the named task has completed.
+void StartupProfile::WaitForTask(const QString &Name)
+{
+    StartupTask *task = m_tasks.value(Name, nullptr);
+    if (!task)
+        return;
+
+    qint64 start = m_timer.elapsed();
+    task->wait();
+    qint64 waited = m_timer.elapsed() - start;
+    if (waited > 0)
+    {
+        LOG(VB_GENERAL, LOG_DEBUG, LOC + QString("Waited %1ms for '%2'")
+            .arg(waited).arg(Name));
+    }
+}
+
+void StartupProfile::Record(const QString &Name, const QString &Thread,
+                            qint64 Start, qint64 End)
+{
+    QMutexLocker locker(&m_lock);
+    m_entries.append({ Name, Thread, Start, End });
+}
+
+/*! \brief End the last phase, log the timeline and write it to the output file.
+ *
+ * Tasks that are still running are waited for, so that the timeline is complete.
+*/
+void StartupProfile::Finish(void)
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+
+    Phase(QString());
+    qint64 total = m_timer.elapsed();
+    for (const auto & name : m_tasks.keys())
+        WaitForTask(name);
+
+    QVector<Entry> entries;
+    {
+        QMutexLocker locker(&m_lock);
+        entries = m_entries;
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const Entry &First, const Entry &Second)
+                     { return First.m_start < Second.m_start; });
+
+    for (const auto & entry : qAsConst(entries))
+    {
+        LOG(VB_GENERAL, LOG_DEBUG, LOC + QString("%1: %2ms (%3)")
+            .arg(entry.m_name).arg(entry.m_end - entry.m_start).arg(entry.m_thread));
+    }
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Frontend ready after %1ms").arg(total));
+
+    if (m_output.isEmpty())
+        return;
+
+    QFile file(m_output);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to open '%1' for writing")
+            .arg(m_output));
+        return;
+    }
+
+    QTextStream stream(&file);
+    stream << "# start(ms)\tduration(ms)\tthread\tphase\n";
+    for (const auto & entry : qAsConst(entries))
+    {
+        stream << entry.m_start << '\t' << (entry.m_end - entry.m_start) << '\t'
+               << entry.m_thread << '\t' << entry.m_name << '\n';
+    }
+    stream << total << "\t0\tmain\tReady\n";
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Wrote startup profile to '%1'")
+        .arg(m_output));
+}
@@ -0,0 +1,65 @@
+// -*- Mode: c++ -*-
+// vim:set sw=4 ts=4 expandtab:
+#ifndef STARTUP_PROFILE_H
+#define STARTUP_PROFILE_H
+
+// Std
+#include <functional>
+
+// Qt headers
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVector>
+
+class StartupTask;
+
+/** \class StartupProfile
+ *  \brief A timeline of the phases of frontend startup.
+ *
+ * Phases on the main thread are sequential - starting a phase ends the
+ * previous one. Independent work can be run as a named task on its own
+ * thread, overlapping the main thread phases, and is recorded in the same
+ * timeline. Finish() logs the duration of each phase and, if an output file
+ * was given, writes the timeline to it.
+ *
+ * \note Tasks must not create QObjects that are used by the main thread.
+ */
+class StartupProfile
+{
+  public:
+    StartupProfile();
+   ~StartupProfile();
+
+    void SetOutput   (const QString &File) { m_output = File; }
+    void Phase       (const QString &Name);
+    void StartTask   (const QString &Name, std::function<void()> Task);
+    void WaitForTask (const QString &Name);
+    void Finish      (void);
+    void Record      (const QString &Name, const QString &Thread,
+                      qint64 Start, qint64 End);
+    qint64 Elapsed   (void) const { return m_timer.elapsed(); }
+
+  private:
+    Q_DISABLE_COPY(StartupProfile)
+
+    struct Entry
+    {
+        QString m_name;
+        QString m_thread;
+        qint64  m_start { 0 };
+        qint64  m_end   { 0 };
+    };
+
+    QElapsedTimer               m_timer;
+    QString                     m_output;
+    QString                     m_phase;
+    qint64                      m_phaseStart { 0 };
+    QMutex                      m_lock;
+    QVector<Entry>              m_entries;
+    QMap<QString,StartupTask*>  m_tasks;
+    bool                        m_finished   { false };
+};
+
+#endif // STARTUP_PROFILE_H
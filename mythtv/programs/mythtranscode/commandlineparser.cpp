@@ -70,6 +70,17 @@ void MythTranscodeCommandLineParser::LoadArguments(void)
             "Inverses the cutlist, leaving only the marked off sections.", "")
         ->SetGroup("Cutlist")
         ->SetRequires("usecutlist");
+    add("--smartcut", "smartcut", false,
+            "Apply the cutlist by copying the video and only re-encoding "
+            "the partial GOPs at each cut point.",
+            "Applies the cutlist without transcoding the whole recording. "
+            "Whole GOPs are copied unchanged and the frames between each cut "
+            "point and the nearest keyframe are re-encoded, in parallel. "
+            "Falls back to a full transcode if the video cannot be re-encoded "
+            "in its original format.")
+        ->SetGroup("Cutlist")
+        ->SetRequires("usecutlist")
+        ->SetBlocks("mpeg2");
 
     add("--showprogress", "showprogress", false,
             "Display status info in stdout", "")
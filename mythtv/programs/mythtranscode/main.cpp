@@ -21,6 +21,7 @@ using namespace std;
 #include "mythdate.h"
 #include "transcode.h"
 #include "mpeg2fix.h"
+#include "smartcut.h"
 #include "remotefile.h"
 #include "mythtranslation.h"
 #include "loggingserver.h"
@@ -464,6 +465,11 @@ int main(int argc, char *argv[])
         cerr << "--cleancut is pointless without --honorcutlist" << endl;
         return GENERIC_EXIT_INVALID_CMDLINE;
     }
+    if (cmdline.toBool("smartcut") && !useCutlist)
+    {
+        cerr << "--smartcut requires --honorcutlist" << endl;
+        return GENERIC_EXIT_INVALID_CMDLINE;
+    }
 
     if (fifo_info)
     {
@@ -614,7 +620,63 @@ int main(int argc, char *argv[])
     if (!recorderOptions.isEmpty())
         transcode->SetRecorderOptions(recorderOptions);
     int result = 0;
-    if ((!mpeg2 && !build_index) || cmdline.toBool("hls"))
+    bool smartcut = false;
+    if (cmdline.toBool("smartcut") &&
+        (build_index || !fifodir.isEmpty() ||
+         cmdline.toBool("avf") || cmdline.toBool("hls")))
+    {
+        LOG(VB_GENERAL, LOG_WARNING, "--smartcut can't be used with "
+            "--reindex, --fifodir, --avf or --hls, ignoring it");
+    }
+    else if (cmdline.toBool("smartcut"))
+    {
+        // --honorcutlist without an explicit list cuts the recording's cutlist
+        if (deleteMap.isEmpty())
+            pginfo->QueryCutList(deleteMap);
+        frm_pos_map_t keyframes;
+        pginfo->QueryPositionMap(keyframes, MARK_GOP_BYFRAME);
+
+        if (jobID >= 0)
+            glbl_jobID = jobID;
+        SmartCut cutter(infile, outfile, deleteMap, keyframes, showprogress,
+                        (jobID >= 0) ? &UpdateJobQueue : nullptr,
+                        (jobID >= 0) ? &CheckJobQueue : nullptr);
+        if (cutter.Init())
+        {
+            smartcut = true;
+            result = cutter.Start();
+            if (result == REENCODE_OK)
+            {
+                // The cut file needs a new seek table, as the mpeg2 path
+                // builds for its output
+                MPEG2fixup m2f(infile, outfile, nullptr, nullptr, false, false,
+                               20, showprogress, otype,
+                               (jobID >= 0) ? &UpdateJobQueue : nullptr,
+                               (jobID >= 0) ? &CheckJobQueue : nullptr);
+                result = BuildKeyframeIndex(&m2f, outfile, posMap, durMap, jobID);
+                if (result == REENCODE_OK)
+                {
+                    if (update_index)
+                    {
+                        UpdatePositionMap(posMap, durMap, nullptr, pginfo);
+                        pginfo->SaveFilesize(QFileInfo(outfile).size());
+                    }
+                    else
+                    {
+                        UpdatePositionMap(posMap, durMap, outfile + QString(".map"),
+                                          pginfo);
+                    }
+                }
+            }
+        }
+        else
+        {
+            LOG(VB_GENERAL, LOG_NOTICE, QString("Cannot smart cut %1, "
+                "falling back to a full transcode").arg(infile));
+        }
+    }
+
+    if (!smartcut && ((!mpeg2 && !build_index) || cmdline.toBool("hls")))
     {
         result = transcode->TranscodeFile(infile, outfile,
                                           profilename, useCutlist,
@@ -0,0 +1,818 @@
+// Std
+#include <algorithm>
+#include <utility>
+
+// Qt
+#include <QThread>
+
+// MythTV
+#include "mthread.h"
+#include "mythlogging.h"
+#include "transcodedefs.h"
+#include "smartcut.h"
+
+#define LOC QString("SmartCut: ")
+
+// How far to look for the next keyframe before giving up
+#define MAX_GOP_SEARCH 600
+
+/*! \class SmartCutEncoder
+ *  \brief Re-encodes queued boundary segments until there are none left.
+*/
+class SmartCutEncoder : public MThread
+{
+  public:
+    explicit SmartCutEncoder(SmartCut *Parent)
+      : MThread("SmartCutEncoder"),
+        m_parent(Parent)
+    {
+    }
+
+  protected:
+    void run(void) override
+    {
+        RunProlog();
+        while (!m_parent->m_abort.load())
+        {
+            int index = m_parent->m_nextSegment.fetchAndAddOrdered(1);
+            if (index >= m_parent->m_segments.size())
+                break;
+            SmartCut::Segment *segment = m_parent->m_segments[index];
+            segment->m_result = m_parent->EncodeSegment(segment);
+        }
+        RunEpilog();
+    }
+
+  private:
+    SmartCut *m_parent { nullptr };
+};
+
+SmartCut::SmartCut(QString InFile, QString OutFile, frm_dir_map_t DeleteMap,
+                   frm_pos_map_t Keyframes, bool ShowProgress,
+                   void (*UpdateFunc)(float), int (*CheckFunc)())
+  : m_infile(std::move(InFile)),
+    m_outfile(std::move(OutFile)),
+    m_deleteMap(std::move(DeleteMap)),
+    m_keyframes(std::move(Keyframes)),
+    m_showProgress(ShowProgress),
+    m_updateStatus(UpdateFunc),
+    m_checkAbort(CheckFunc)
+{
+}
+
+SmartCut::~SmartCut()
+{
+    for (auto *segment : qAsConst(m_segments))
+    {
+        for (auto *packet : qAsConst(segment->m_packets))
+            av_packet_free(&packet);
+        delete segment;
+    }
+
+    if (m_output)
+    {
+        if (!(m_output->oformat->flags & AVFMT_NOFILE))
+            avio_closep(&m_output->pb);
+        avformat_free_context(m_output);
+    }
+
+    if (m_input)
+        avformat_close_input(&m_input);
+}
+
+bool SmartCut::OpenInput(AVFormatContext **Context) const
+{
+    QByteArray name = m_infile.toLocal8Bit();
+    if (avformat_open_input(Context, name.constData(), nullptr, nullptr) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to open '%1'").arg(m_infile));
+        return false;
+    }
+
+    if (avformat_find_stream_info(*Context, nullptr) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to find streams in '%1'").arg(m_infile));
+        avformat_close_input(Context);
+        return false;
+    }
+    return true;
+}
+
+/*! \brief Create an encoder that produces packets that can be spliced into
+ *         the original video stream.
+ *
+ * B frames are disabled so that re-encoded packets never need reordering.
+*/
+AVCodecContext *SmartCut::CreateEncoder(void) const
+{
+    AVCodecParameters *params = m_input->streams[m_videoIndex]->codecpar;
+    AVCodec *codec = avcodec_find_encoder(params->codec_id);
+    if (!codec)
+        return nullptr;
+
+    AVCodecContext *encoder = avcodec_alloc_context3(codec);
+    if (!encoder)
+        return nullptr;
+
+    int64_t bitrate = params->bit_rate ? params->bit_rate : m_input->bit_rate;
+    encoder->width                  = params->width;
+    encoder->height                 = params->height;
+    encoder->pix_fmt                = static_cast<AVPixelFormat>(params->format);
+    encoder->sample_aspect_ratio    = params->sample_aspect_ratio;
+    encoder->framerate              = m_frameRate;
+    encoder->time_base              = av_inv_q(m_frameRate);
+    encoder->color_range            = params->color_range;
+    encoder->color_primaries        = params->color_primaries;
+    encoder->color_trc              = params->color_trc;
+    encoder->colorspace             = params->color_space;
+    encoder->chroma_sample_location = params->chroma_location;
+    encoder->field_order            = params->field_order;
+    encoder->bit_rate               = bitrate > 0 ? bitrate : 8000000;
+    encoder->max_b_frames           = 0;
+    encoder->gop_size               = MAX_GOP_SEARCH;
+    // Segments are encoded in parallel instead
+    encoder->thread_count           = 1;
+    if (params->field_order != AV_FIELD_PROGRESSIVE && params->field_order != AV_FIELD_UNKNOWN)
+        encoder->flags |= AV_CODEC_FLAG_INTERLACED_DCT | AV_CODEC_FLAG_INTERLACED_ME;
+
+    if (avcodec_open2(encoder, codec, nullptr) < 0)
+        avcodec_free_context(&encoder);
+    return encoder;
+}
+
+/*! \brief Check that the input can be smart cut and prepare the output.
+ *
+ * Fails if the video codec cannot be encoded with the same parameters or the
+ * input container cannot be written, in which case a full transcode is needed.
+*/
+bool SmartCut::Init(void)
+{
+    if (!OpenInput(&m_input))
+        return false;
+
+    m_videoIndex = av_find_best_stream(m_input, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    if (m_videoIndex < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "No video stream");
+        return false;
+    }
+
+    AVStream *stream = m_input->streams[m_videoIndex];
+    m_timeBase  = stream->time_base;
+    m_frameRate = av_guess_frame_rate(m_input, stream, nullptr);
+    if (m_frameRate.num <= 0 || m_frameRate.den <= 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Unknown frame rate");
+        return false;
+    }
+    m_frameDuration = std::max(av_rescale_q(1, av_inv_q(m_frameRate), m_timeBase), static_cast<int64_t>(1));
+    m_startPts = (stream->start_time != AV_NOPTS_VALUE) ? stream->start_time : 0;
+
+    AVCodecContext *encoder = CreateEncoder();
+    if (!encoder)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Cannot encode %1 video")
+            .arg(avcodec_get_name(stream->codecpar->codec_id)));
+        return false;
+    }
+    avcodec_free_context(&encoder);
+
+    if (!OpenOutput())
+        return false;
+
+    // The largest pts/dts difference is the decoder delay that copied
+    // packets carry and that re-encoded packets must match
+    AVPacket *packet = av_packet_alloc();
+    int count = 0;
+    while ((count < MAX_GOP_SEARCH) && (av_read_frame(m_input, packet) >= 0))
+    {
+        if ((packet->stream_index == m_videoIndex) && (packet->pts != AV_NOPTS_VALUE) &&
+            (packet->dts != AV_NOPTS_VALUE))
+        {
+            m_reorderDelay = std::max(m_reorderDelay, packet->pts - packet->dts);
+            count++;
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("%1 video at %2fps, %3 keyframes in position map")
+        .arg(avcodec_get_name(stream->codecpar->codec_id))
+        .arg(av_q2d(m_frameRate), 0, 'f', 2).arg(m_keyframes.size()));
+    return true;
+}
+
+/// \brief Create the output in the same container as the input, copying all
+///        audio and subtitle streams alongside the selected video stream.
+bool SmartCut::OpenOutput(void)
+{
+    QString format = QString(m_input->iformat->name).section(',', 0, 0);
+    QByteArray name = m_outfile.toLocal8Bit();
+    avformat_alloc_output_context2(&m_output, nullptr, format.toLatin1().constData(), name.constData());
+    if (!m_output)
+    {
+        LOG(VB_GENERAL, LOG_WARNING, LOC + QString("Cannot write '%1' files").arg(format));
+        return false;
+    }
+
+    for (uint i = 0; i < m_input->nb_streams; ++i)
+    {
+        AVStream *in = m_input->streams[i];
+        AVMediaType type = in->codecpar->codec_type;
+        bool keep = (static_cast<int>(i) == m_videoIndex) ||
+                    (type == AVMEDIA_TYPE_AUDIO) || (type == AVMEDIA_TYPE_SUBTITLE);
+        if (!keep)
+        {
+            m_streamMap.append(-1);
+            continue;
+        }
+
+        AVStream *out = avformat_new_stream(m_output, nullptr);
+        if (!out || avcodec_parameters_copy(out->codecpar, in->codecpar) < 0)
+            return false;
+        out->codecpar->codec_tag = 0;
+        out->time_base   = in->time_base;
+        out->disposition = in->disposition;
+        av_dict_copy(&out->metadata, in->metadata, 0);
+        m_streamMap.append(out->index);
+        m_lastDts.append(AV_NOPTS_VALUE);
+    }
+    return true;
+}
+
+int64_t SmartCut::FrameToPts(uint64_t Frame) const
+{
+    return m_startPts + av_rescale_q(static_cast<int64_t>(Frame), av_inv_q(m_frameRate), m_timeBase);
+}
+
+/// \brief Read the whole video stream to find the keyframes when there is no position map.
+void SmartCut::ScanKeyframes(void)
+{
+    LOG(VB_GENERAL, LOG_INFO, LOC + "No position map - scanning for keyframes");
+    avformat_seek_file(m_input, m_videoIndex, INT64_MIN, m_startPts, m_startPts, 0);
+    AVPacket *packet = av_packet_alloc();
+    while (av_read_frame(m_input, packet) >= 0)
+    {
+        if ((packet->stream_index == m_videoIndex) && (packet->flags & AV_PKT_FLAG_KEY) &&
+            (packet->pts != AV_NOPTS_VALUE))
+        {
+            m_keyPts.append(packet->pts);
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    std::sort(m_keyPts.begin(), m_keyPts.end());
+}
+
+/*! \brief Find the first keyframe at or after Pts.
+ *
+ * If LeadingPts is set, it returns the earliest presentation time of the
+ * frames that follow the keyframe in decode order but are displayed before
+ * it (the leading B frames of an open GOP). These cannot be copied without
+ * the keyframe.
+*/
+int64_t SmartCut::FindKeyframe(int64_t Pts, int64_t *LeadingPts)
+{
+    if (av_seek_frame(m_input, m_videoIndex, Pts, AVSEEK_FLAG_BACKWARD) < 0)
+        avformat_seek_file(m_input, m_videoIndex, INT64_MIN, m_startPts, m_startPts, 0);
+
+    int64_t result  = AV_NOPTS_VALUE;
+    int64_t leading = AV_NOPTS_VALUE;
+    int count = 0;
+    AVPacket *packet = av_packet_alloc();
+    while (av_read_frame(m_input, packet) >= 0)
+    {
+        bool done = false;
+        if ((packet->stream_index == m_videoIndex) && (packet->pts != AV_NOPTS_VALUE))
+        {
+            if (result == AV_NOPTS_VALUE)
+            {
+                if ((packet->flags & AV_PKT_FLAG_KEY) && (packet->pts >= Pts - m_frameDuration / 2))
+                {
+                    result = leading = packet->pts;
+                    done = !LeadingPts;
+                }
+                else
+                {
+                    done = ++count > MAX_GOP_SEARCH;
+                }
+            }
+            else if (packet->pts < result)
+            {
+                leading = std::min(leading, packet->pts);
+            }
+            else
+            {
+                done = true;
+            }
+        }
+        av_packet_unref(packet);
+        if (done)
+            break;
+    }
+    av_packet_free(&packet);
+
+    if (LeadingPts)
+        *LeadingPts = leading;
+    return result;
+}
+
+/// \brief Return the first keyframe at or after Pts and before Limit.
+int64_t SmartCut::KeyframeAtOrAfter(int64_t Pts, int64_t Limit)
+{
+    int64_t result = AV_NOPTS_VALUE;
+    if (!m_keyPts.isEmpty())
+    {
+        auto it = std::lower_bound(m_keyPts.cbegin(), m_keyPts.cend(), Pts - m_frameDuration / 2);
+        if (it != m_keyPts.cend())
+            result = *it;
+    }
+    else
+    {
+        // Use the position map to skip straight to the keyframe
+        auto it = std::find_if(m_keyframes.keyBegin(), m_keyframes.keyEnd(),
+            [&](uint64_t Frame) { return FrameToPts(Frame) >= Pts - m_frameDuration / 2; });
+        result = FindKeyframe((it == m_keyframes.keyEnd()) ? Pts : FrameToPts(*it));
+    }
+    return (result != AV_NOPTS_VALUE && result < Limit) ? result : AV_NOPTS_VALUE;
+}
+
+/// \brief Return the last keyframe at or before Pts and after Floor.
+int64_t SmartCut::KeyframeBefore(int64_t Pts, int64_t Floor, int64_t *LeadingPts)
+{
+    QList<int64_t> candidates;
+    if (!m_keyPts.isEmpty())
+    {
+        auto it = std::upper_bound(m_keyPts.cbegin(), m_keyPts.cend(), Pts + m_frameDuration / 2);
+        if (it != m_keyPts.cbegin())
+            candidates.append(*(--it));
+    }
+    else
+    {
+        // Position map frame numbers may drift slightly from the timestamps,
+        // so try a few candidates
+        for (auto it = m_keyframes.keyEnd(); it != m_keyframes.keyBegin() && candidates.size() < 3; )
+        {
+            int64_t pts = FrameToPts(*(--it));
+            if (pts <= Pts + m_frameDuration / 2)
+                candidates.append(pts);
+        }
+    }
+
+    for (int64_t candidate : qAsConst(candidates))
+    {
+        if (candidate <= Floor)
+            break;
+        int64_t result = FindKeyframe(candidate, LeadingPts);
+        if (result != AV_NOPTS_VALUE && result > Floor && result <= Pts + m_frameDuration / 2)
+            return result;
+    }
+    return AV_NOPTS_VALUE;
+}
+
+/*! \brief Convert the cutlist into kept regions and plan how each is written.
+ *
+ * Cut marks are inclusive, so a region starts on the frame after a
+ * MARK_CUT_END and finishes on the frame before a MARK_CUT_START.
+*/
+void SmartCut::BuildRegions(void)
+{
+    QList<QPair<uint64_t,uint64_t> > kept;
+    uint64_t start = 0;
+    bool incut = false;
+    for (auto it = m_deleteMap.cbegin(); it != m_deleteMap.cend(); ++it)
+    {
+        if (it.value() == MARK_CUT_START && !incut)
+        {
+            if (it.key() > start)
+                kept.append(qMakePair(start, it.key()));
+            incut = true;
+        }
+        else if (it.value() == MARK_CUT_END)
+        {
+            start = it.key() + 1;
+            incut = false;
+        }
+    }
+    if (!incut)
+        kept.append(qMakePair(start, UINT64_MAX));
+
+    int64_t duration = (m_input->duration != AV_NOPTS_VALUE) ?
+        av_rescale_q(m_input->duration, AV_TIME_BASE_Q, m_timeBase) : INT64_MAX - m_startPts;
+
+    for (const auto & range : qAsConst(kept))
+    {
+        Region region;
+        region.m_start = FrameToPts(range.first);
+        region.m_end   = (range.second == UINT64_MAX) ? INT64_MAX : FrameToPts(range.second);
+        if (region.m_start - m_startPts >= duration)
+            break;
+
+        int64_t first = KeyframeAtOrAfter(region.m_start, region.m_end);
+        int64_t leading = AV_NOPTS_VALUE;
+        int64_t last = AV_NOPTS_VALUE;
+        if (first != AV_NOPTS_VALUE && region.m_end != INT64_MAX)
+            last = KeyframeBefore(region.m_end, first, &leading);
+
+        if (first == AV_NOPTS_VALUE || (region.m_end != INT64_MAX && last == AV_NOPTS_VALUE))
+        {
+            // No complete GOP in this region - re-encode all of it
+            region.m_head = new Segment;
+            region.m_head->m_start = region.m_start;
+            region.m_head->m_end   = region.m_end;
+        }
+        else
+        {
+            region.m_copyStart = first;
+            if (first > region.m_start)
+            {
+                region.m_head = new Segment;
+                region.m_head->m_start = region.m_start;
+                region.m_head->m_end   = first;
+            }
+            if (region.m_end != INT64_MAX)
+            {
+                region.m_copyEnd = leading;
+                if (leading < region.m_end)
+                {
+                    region.m_tail = new Segment;
+                    region.m_tail->m_start = leading;
+                    region.m_tail->m_end   = region.m_end;
+                }
+            }
+        }
+
+        if (region.m_head)
+            m_segments.append(region.m_head);
+        if (region.m_tail)
+            m_segments.append(region.m_tail);
+        m_regions.append(region);
+
+        QString plan = "re-encode";
+        if (region.m_copyStart != AV_NOPTS_VALUE)
+        {
+            plan = QString("%1copy%2").arg(region.m_head ? "re-encode head, " : "")
+                                      .arg(region.m_tail ? ", re-encode tail" : "");
+        }
+        LOG(VB_GENERAL, LOG_INFO, LOC + QString("Keeping frames %1-%2: %3").arg(range.first)
+            .arg(range.second == UINT64_MAX ? QString("end") : QString::number(range.second - 1))
+            .arg(plan));
+    }
+}
+
+/// \brief Decode and re-encode a single boundary segment into memory.
+int SmartCut::EncodeSegment(Segment *Seg)
+{
+    AVFormatContext *input = nullptr;
+    if (!OpenInput(&input))
+        return REENCODE_ERROR;
+
+    for (uint i = 0; i < input->nb_streams; ++i)
+        if (static_cast<int>(i) != m_videoIndex)
+            input->streams[i]->discard = AVDISCARD_ALL;
+
+    AVStream *stream = input->streams[m_videoIndex];
+    AVCodec *codec = avcodec_find_decoder(stream->codecpar->codec_id);
+    AVCodecContext *decoder = avcodec_alloc_context3(codec);
+    AVCodecContext *encoder = CreateEncoder();
+    AVPacket *packet = av_packet_alloc();
+    AVFrame *frame = av_frame_alloc();
+    QList<int64_t> timestamps;
+    int result = REENCODE_ERROR;
+
+    auto encode = [&](AVFrame *Frame)
+    {
+        if (avcodec_send_frame(encoder, Frame) < 0)
+            return false;
+        while (true)
+        {
+            AVPacket *out = av_packet_alloc();
+            int ret = avcodec_receive_packet(encoder, out);
+            if (ret < 0)
+            {
+                av_packet_free(&out);
+                return (ret == AVERROR(EAGAIN)) || (ret == AVERROR_EOF);
+            }
+            // No B frames, so packets come out in the order frames went in
+            out->pts = timestamps.isEmpty() ? AV_NOPTS_VALUE : timestamps.takeFirst();
+            out->dts = out->pts;
+            out->duration = m_frameDuration;
+            out->stream_index = m_videoIndex;
+            Seg->m_packets.append(out);
+        }
+    };
+
+    if (decoder && encoder && packet && frame &&
+        (avcodec_parameters_to_context(decoder, stream->codecpar) >= 0))
+    {
+        decoder->pkt_timebase = stream->time_base;
+        decoder->thread_count = 1;
+        if ((avcodec_open2(decoder, codec, nullptr) >= 0) &&
+            (av_seek_frame(input, m_videoIndex, Seg->m_start, AVSEEK_FLAG_BACKWARD) >= 0))
+        {
+            result = REENCODE_OK;
+            int64_t count = 0;
+            bool done = false;
+            while (!done && !m_abort.load() && (result == REENCODE_OK))
+            {
+                int ret = av_read_frame(input, packet);
+                if (ret < 0)
+                {
+                    avcodec_send_packet(decoder, nullptr);
+                }
+                else if (packet->stream_index != m_videoIndex)
+                {
+                    av_packet_unref(packet);
+                    continue;
+                }
+                else
+                {
+                    avcodec_send_packet(decoder, packet);
+                    av_packet_unref(packet);
+                }
+
+                while (!done && (avcodec_receive_frame(decoder, frame) >= 0))
+                {
+                    int64_t pts = frame->best_effort_timestamp;
+                    if (pts != AV_NOPTS_VALUE && pts >= Seg->m_start)
+                    {
+                        if (pts >= Seg->m_end)
+                        {
+                            done = true;
+                        }
+                        else
+                        {
+                            // Every segment starts with an I frame
+                            frame->pict_type = count ? AV_PICTURE_TYPE_NONE : AV_PICTURE_TYPE_I;
+                            frame->pts = count++;
+                            timestamps.append(pts);
+                            if (!encode(frame))
+                                result = REENCODE_ERROR;
+                        }
+                    }
+                    av_frame_unref(frame);
+                }
+                done |= ret < 0;
+            }
+
+            if (result == REENCODE_OK && !encode(nullptr))
+                result = REENCODE_ERROR;
+            if (m_abort.load())
+                result = REENCODE_STOPPED;
+        }
+    }
+
+    LOG(VB_GENERAL, (result == REENCODE_OK) ? LOG_DEBUG : LOG_ERR, LOC +
+        QString("Re-encoded %1 frames (%2-%3): %4").arg(Seg->m_packets.size())
+        .arg(Seg->m_start).arg(Seg->m_end).arg(result == REENCODE_OK ? "ok" : "failed"));
+
+    av_frame_free(&frame);
+    av_packet_free(&packet);
+    avcodec_free_context(&encoder);
+    avcodec_free_context(&decoder);
+    avformat_close_input(&input);
+    return result;
+}
+
+/// \brief Re-encode all of the boundary segments in parallel.
+int SmartCut::EncodeSegments(void)
+{
+    if (m_segments.isEmpty())
+        return REENCODE_OK;
+
+    int count = std::min(std::max(QThread::idealThreadCount(), 1), m_segments.size());
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Re-encoding %1 boundary segments with %2 threads")
+        .arg(m_segments.size()).arg(count));
+
+    QList<SmartCutEncoder*> encoders;
+    for (int i = 0; i < count; ++i)
+    {
+        encoders.append(new SmartCutEncoder(this));
+        encoders.last()->start();
+    }
+
+    for (auto *encoder : qAsConst(encoders))
+    {
+        while (!encoder->wait(1000))
+        {
+            if (m_checkAbort && m_checkAbort())
+                m_abort.store(1);
+            if (m_updateStatus)
+            {
+                int done = std::min(m_nextSegment.load(), m_segments.size());
+                m_updateStatus(50.0F * done / m_segments.size());
+            }
+        }
+        delete encoder;
+    }
+
+    if (m_abort.load())
+        return REENCODE_STOPPED;
+    for (auto *segment : qAsConst(m_segments))
+        if (segment->m_result != REENCODE_OK)
+            return segment->m_result;
+    return REENCODE_OK;
+}
+
+/*! \brief Write a packet into the output timeline.
+ *
+ * \param Offset    Amount to shift the packet by, in video stream units.
+ * \param Reencoded Packet came from our encoder and has no decoder delay of its own.
+*/
+int SmartCut::WritePacket(AVPacket *Packet, int64_t Offset, bool Reencoded)
+{
+    int index = Packet->stream_index;
+    int out = m_streamMap[index];
+    AVRational timebase = m_input->streams[index]->time_base;
+
+    AVPacket *packet = av_packet_clone(Packet);
+    if (!packet)
+        return REENCODE_ERROR;
+
+    // The output timeline starts at the decoder delay so that dts is never negative
+    int64_t shift = av_rescale_q(Offset + m_reorderDelay, m_timeBase, timebase);
+    packet->pts += shift;
+    if (Reencoded)
+        packet->dts = packet->pts - av_rescale_q(m_reorderDelay, m_timeBase, timebase);
+    else if (packet->dts != AV_NOPTS_VALUE)
+        packet->dts += shift;
+    else
+        packet->dts = packet->pts;
+
+    // Keep dts increasing across the joins
+    int64_t &last = m_lastDts[out];
+    if (last != AV_NOPTS_VALUE && packet->dts <= last)
+        packet->dts = last + 1;
+    if (packet->dts > packet->pts && (Reencoded || index != m_videoIndex))
+        packet->pts = packet->dts;
+    last = packet->dts;
+
+    packet->stream_index = out;
+    packet->pos = -1;
+    av_packet_rescale_ts(packet, timebase, m_output->streams[out]->time_base);
+    int ret = av_interleaved_write_frame(m_output, packet);
+    av_packet_free(&packet);
+    if (ret < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to write packet for stream %1").arg(out));
+        return REENCODE_ERROR;
+    }
+    return REENCODE_OK;
+}
+
+/*! \brief Write the re-encoded head, copied GOPs and re-encoded tail of a region.
+ *
+ * \param Cursor The output time (in video stream units) at which the region
+ *               starts. Updated to the end of the region.
+*/
+int SmartCut::WriteRegion(const Region &Reg, int64_t &Cursor)
+{
+    int64_t offset = Cursor - Reg.m_start;
+    int64_t last = Reg.m_start;
+    int result = REENCODE_OK;
+
+    if (Reg.m_head)
+    {
+        for (auto *packet : qAsConst(Reg.m_head->m_packets))
+        {
+            result = WritePacket(packet, offset, true);
+            if (result != REENCODE_OK)
+                return result;
+            last = std::max(last, packet->pts + m_frameDuration);
+        }
+    }
+
+    // Copy the GOPs, plus audio and subtitles for the whole region. Keep reading
+    // a little past the end as streams are not perfectly interleaved.
+    int64_t slack = av_rescale_q(2, AVRational { 1, 1 }, m_timeBase);
+    int64_t stop  = (Reg.m_end == INT64_MAX) ? INT64_MAX : Reg.m_end + slack;
+    if (av_seek_frame(m_input, m_videoIndex, Reg.m_start, AVSEEK_FLAG_BACKWARD) < 0)
+        avformat_seek_file(m_input, m_videoIndex, INT64_MIN, m_startPts, m_startPts, 0);
+
+    bool copying = false;
+    bool copied  = Reg.m_copyStart == AV_NOPTS_VALUE;
+    AVPacket *packet = av_packet_alloc();
+    while ((result == REENCODE_OK) && (av_read_frame(m_input, packet) >= 0))
+    {
+        int index = packet->stream_index;
+        if ((m_streamMap.value(index, -1) < 0) || (packet->pts == AV_NOPTS_VALUE))
+        {
+            av_packet_unref(packet);
+            continue;
+        }
+
+        int64_t pts = av_rescale_q(packet->pts, m_input->streams[index]->time_base, m_timeBase);
+        if (pts >= stop)
+        {
+            av_packet_unref(packet);
+            break;
+        }
+
+        if (index == m_videoIndex)
+        {
+            bool key = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+            if (!copied && !copying && key && (packet->pts == Reg.m_copyStart))
+            {
+                copying = true;
+            }
+            else if (copying && key && (packet->pts >= Reg.m_copyEnd))
+            {
+                copying = false;
+                copied  = true;
+            }
+
+            // Leading B frames either side are covered by the re-encoded segments
+            if (copying && (packet->pts >= Reg.m_copyStart) && (packet->pts < Reg.m_copyEnd))
+            {
+                result = WritePacket(packet, offset, false);
+                last = std::max(last, packet->pts + m_frameDuration);
+            }
+        }
+        else if (pts >= Reg.m_start && pts < Reg.m_end)
+        {
+            result = WritePacket(packet, offset, false);
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+
+    if (!copied && !copying)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Lost keyframe %1").arg(Reg.m_copyStart));
+        return REENCODE_ERROR;
+    }
+
+    if (Reg.m_tail && (result == REENCODE_OK))
+    {
+        for (auto *tail : qAsConst(Reg.m_tail->m_packets))
+        {
+            result = WritePacket(tail, offset, true);
+            if (result != REENCODE_OK)
+                break;
+            last = std::max(last, tail->pts + m_frameDuration);
+        }
+    }
+
+    Cursor += ((Reg.m_end == INT64_MAX) ? last : Reg.m_end) - Reg.m_start;
+    return result;
+}
+
+/// \brief Apply the cutlist. Returns one of the REENCODE_ result codes.
+int SmartCut::Start(void)
+{
+    if (!m_input || !m_output)
+        return REENCODE_ERROR;
+
+    if (m_keyframes.isEmpty())
+        ScanKeyframes();
+    BuildRegions();
+    if (m_regions.isEmpty())
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Cutlist removes everything");
+        return REENCODE_ERROR;
+    }
+
+    int result = EncodeSegments();
+    if (result != REENCODE_OK)
+        return result;
+
+    QByteArray name = m_outfile.toLocal8Bit();
+    if (!(m_output->oformat->flags & AVFMT_NOFILE) &&
+        (avio_open(&m_output->pb, name.constData(), AVIO_FLAG_WRITE) < 0))
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + QString("Failed to open '%1'").arg(m_outfile));
+        return REENCODE_ERROR;
+    }
+
+    if (avformat_write_header(m_output, nullptr) < 0)
+    {
+        LOG(VB_GENERAL, LOG_ERR, LOC + "Failed to write header");
+        return REENCODE_ERROR;
+    }
+
+    int64_t cursor = 0;
+    for (int i = 0; i < m_regions.size(); ++i)
+    {
+        if (m_checkAbort && m_checkAbort())
+            return REENCODE_STOPPED;
+
+        result = WriteRegion(m_regions[i], cursor);
+        if (result != REENCODE_OK)
+            return result;
+
+        float percent = 50.0F + (50.0F * (i + 1) / m_regions.size());
+        if (m_updateStatus)
+            m_updateStatus(percent);
+        if (m_showProgress)
+            LOG(VB_GENERAL, LOG_INFO, LOC + QString("%1% done").arg(percent, 0, 'f', 1));
+    }
+
+    if (av_write_trailer(m_output) < 0)
+        return REENCODE_ERROR;
+
+    LOG(VB_GENERAL, LOG_INFO, LOC + QString("Wrote %1 seconds in %2 regions")
+        .arg(av_q2d(m_timeBase) * cursor, 0, 'f', 1).arg(m_regions.size()));
+    return REENCODE_OK;
+}
+
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
@@ -0,0 +1,102 @@
+#ifndef SMARTCUT_H
+#define SMARTCUT_H
+
+// Qt
+#include <QAtomicInt>
+#include <QString>
+#include <QList>
+
+// MythTV
+#include "programtypes.h"
+
+extern "C" {
+#include "libavcodec/avcodec.h"
+#include "libavformat/avformat.h"
+}
+
+/*! \class SmartCut
+ *  \brief Applies a cutlist by stream copying whole GOPs and re-encoding only
+ *         the partial GOPs at each cut point.
+ *
+ * Each kept region is split into an optional re-encoded head (from the cut to
+ * the first keyframe), the stream copied GOPs and an optional re-encoded tail
+ * (from the last keyframe to the next cut). The re-encoded segments are
+ * independent of each other and are encoded in parallel before the output is
+ * assembled. Audio and subtitle packets are always stream copied.
+ *
+ * Keyframes are taken from the recording's position map when available, which
+ * avoids reading the deleted parts of the recording at all.
+*/
+class SmartCut
+{
+    friend class SmartCutEncoder;
+
+  public:
+    SmartCut(QString InFile, QString OutFile, frm_dir_map_t DeleteMap,
+             frm_pos_map_t Keyframes, bool ShowProgress,
+             void (*UpdateFunc)(float) = nullptr, int (*CheckFunc)() = nullptr);
+    ~SmartCut();
+
+    bool Init(void);
+    int  Start(void);
+
+  private:
+    struct Segment
+    {
+        int64_t           m_start  { AV_NOPTS_VALUE };
+        int64_t           m_end    { AV_NOPTS_VALUE };
+        QList<AVPacket*>  m_packets;
+        int               m_result { 0 };
+    };
+
+    struct Region
+    {
+        int64_t  m_start     { 0 };               // first kept pts
+        int64_t  m_end       { INT64_MAX };       // first pts after the region
+        int64_t  m_copyStart { AV_NOPTS_VALUE };  // keyframe that starts copying
+        int64_t  m_copyEnd   { INT64_MAX };       // first pts not copied
+        Segment *m_head      { nullptr };
+        Segment *m_tail      { nullptr };
+    };
+
+    bool     OpenInput        (AVFormatContext **Context) const;
+    AVCodecContext* CreateEncoder(void) const;
+    bool     OpenOutput       (void);
+    void     BuildRegions     (void);
+    void     ScanKeyframes    (void);
+    int64_t  FrameToPts       (uint64_t Frame) const;
+    int64_t  FindKeyframe     (int64_t Pts, int64_t *LeadingPts = nullptr);
+    int64_t  KeyframeAtOrAfter(int64_t Pts, int64_t Limit);
+    int64_t  KeyframeBefore   (int64_t Pts, int64_t Floor, int64_t *LeadingPts);
+    int      EncodeSegment    (Segment *Seg);
+    int      EncodeSegments   (void);
+    int      WriteRegion      (const Region &Reg, int64_t &Cursor);
+    int      WritePacket      (AVPacket *Packet, int64_t Offset, bool Reencoded);
+
+    QString           m_infile;
+    QString           m_outfile;
+    frm_dir_map_t     m_deleteMap;
+    frm_pos_map_t     m_keyframes;
+    QList<int64_t>    m_keyPts;
+    bool              m_showProgress   { false };
+    void            (*m_updateStatus)(float) { nullptr };
+    int             (*m_checkAbort)()  { nullptr };
+
+    AVFormatContext  *m_input          { nullptr };
+    AVFormatContext  *m_output         { nullptr };
+    int               m_videoIndex     { -1 };
+    AVRational        m_timeBase       { 1, 90000 };
+    AVRational        m_frameRate      { 0, 1 };
+    int64_t           m_startPts       { 0 };
+    int64_t           m_frameDuration  { 0 };
+    int64_t           m_reorderDelay   { 0 };
+    QList<int>        m_streamMap;     // input stream index -> output index (or -1)
+    QList<int64_t>    m_lastDts;       // per output stream
+    QList<Region>     m_regions;
+    QList<Segment*>   m_segments;
+    QAtomicInt        m_nextSegment    { 0 };
+    QAtomicInt        m_abort          { 0 };
+};
+
+#endif
+/* vim: set expandtab tabstop=4 shiftwidth=4: */
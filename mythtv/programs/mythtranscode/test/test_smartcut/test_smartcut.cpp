@@ -0,0 +1,363 @@
+/*
+ *  Class TestSmartCut
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+#include "test_smartcut.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "mythcorecontext.h"
+#include "smartcut.h"
+#include "transcodedefs.h"
+
+// The recording is ten seconds of 25fps MPEG-2 with a keyframe every second
+static constexpr int kFrames { 250 };
+static constexpr int kGOP    { 25 };
+static constexpr int kWidth  { 352 };
+static constexpr int kHeight { 288 };
+
+bool TestSmartCut::WriteRecording(const QString &Filename)
+{
+    AVCodec *codec = avcodec_find_encoder(AV_CODEC_ID_MPEG2VIDEO);
+    if (!codec)
+        return false;
+
+    QByteArray name = Filename.toLocal8Bit();
+    AVFormatContext *output = nullptr;
+    avformat_alloc_output_context2(&output, nullptr, "mpegts", name.constData());
+    if (!output)
+        return false;
+
+    AVStream *stream = avformat_new_stream(output, nullptr);
+    AVCodecContext *encoder = avcodec_alloc_context3(codec);
+    encoder->width        = kWidth;
+    encoder->height       = kHeight;
+    encoder->pix_fmt      = AV_PIX_FMT_YUV420P;
+    encoder->time_base    = { 1, 25 };
+    encoder->framerate    = { 25, 1 };
+    encoder->gop_size     = kGOP;
+    encoder->max_b_frames = 2;
+    encoder->bit_rate     = 1000000;
+    stream->time_base     = encoder->time_base;
+
+    AVFrame  *frame  = av_frame_alloc();
+    AVPacket *packet = av_packet_alloc();
+    frame->format = encoder->pix_fmt;
+    frame->width  = kWidth;
+    frame->height = kHeight;
+
+    bool ok = (avcodec_open2(encoder, codec, nullptr) >= 0) &&
+              (avcodec_parameters_from_context(stream->codecpar, encoder) >= 0) &&
+              (av_frame_get_buffer(frame, 0) >= 0) &&
+              (avio_open(&output->pb, name.constData(), AVIO_FLAG_WRITE) >= 0) &&
+              (avformat_write_header(output, nullptr) >= 0);
+
+    // Send every frame, then a null frame to drain the encoder
+    for (int i = 0; ok && i <= kFrames; ++i)
+    {
+        AVFrame *input = nullptr;
+        if (i < kFrames)
+        {
+            ok = av_frame_make_writable(frame) >= 0;
+            for (int y = 0; ok && y < kHeight; ++y)
+                for (int x = 0; x < kWidth; ++x)
+                    frame->data[0][y * frame->linesize[0] + x] = static_cast<uint8_t>(x + y + i * 3);
+            for (int y = 0; ok && y < kHeight / 2; ++y)
+            {
+                memset(frame->data[1] + y * frame->linesize[1], 128, kWidth / 2);
+                memset(frame->data[2] + y * frame->linesize[2], 128, kWidth / 2);
+            }
+            frame->pts = i;
+            input = frame;
+        }
+
+        ok = ok && (avcodec_send_frame(encoder, input) >= 0);
+        while (ok && avcodec_receive_packet(encoder, packet) >= 0)
+        {
+            av_packet_rescale_ts(packet, encoder->time_base, stream->time_base);
+            packet->stream_index = stream->index;
+            ok = av_interleaved_write_frame(output, packet) >= 0;
+        }
+    }
+
+    if (ok)
+        ok = av_write_trailer(output) >= 0;
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&encoder);
+    if (output->pb)
+        avio_closep(&output->pb);
+    avformat_free_context(output);
+    return ok;
+}
+
+// Returns the number of video frames in a file, or -1 if it can't be read
+int TestSmartCut::CountFrames(const QString &Filename, bool &StartsOnKeyframe)
+{
+    QByteArray name = Filename.toLocal8Bit();
+    AVFormatContext *input = nullptr;
+    if (avformat_open_input(&input, name.constData(), nullptr, nullptr) < 0)
+        return -1;
+    if (avformat_find_stream_info(input, nullptr) < 0)
+    {
+        avformat_close_input(&input);
+        return -1;
+    }
+
+    int video = av_find_best_stream(input, AVMEDIA_TYPE_VIDEO, -1, -1, nullptr, 0);
+    int frames = 0;
+    StartsOnKeyframe = false;
+    AVPacket *packet = av_packet_alloc();
+    while (video >= 0 && av_read_frame(input, packet) >= 0)
+    {
+        if (packet->stream_index == video)
+        {
+            if (frames++ == 0)
+                StartsOnKeyframe = (packet->flags & AV_PKT_FLAG_KEY) != 0;
+        }
+        av_packet_unref(packet);
+    }
+    av_packet_free(&packet);
+    avformat_close_input(&input);
+    return (video >= 0) ? frames : -1;
+}
+
+// Mean distance of a decoded picture from source frame Index, allowing for
+// the pattern wrapping around
+static double PictureError(const AVFrame *Frame, int Index)
+{
+    qint64 total = 0;
+    for (int y = 0; y < kHeight; ++y)
+    {
+        for (int x = 0; x < kWidth; ++x)
+        {
+            int want = static_cast<uint8_t>(x + y + Index * 3);
+            int diff = std::abs(Frame->data[0][y * Frame->linesize[0] + x] - want);
+            total += std::min(diff, 256 - diff);
+        }
+    }
+    return static_cast<double>(total) / (kWidth * kHeight);
+}
+
+bool TestSmartCut::CheckDecode(const QString &Filename, const QVector<int> &Expected)
+{
+    QByteArray name = Filename.toLocal8Bit();
+    AVFormatContext *input = nullptr;
+    if (avformat_open_input(&input, name.constData(), nullptr, nullptr) < 0)
+        return false;
+
+    AVCodecContext *decoder = nullptr;
+    AVFrame  *frame  = av_frame_alloc();
+    AVPacket *packet = av_packet_alloc();
+    int video = -1;
+    bool ok = avformat_find_stream_info(input, nullptr) >= 0;
+    if (ok)
+    {
+        AVCodec *codec = nullptr;
+        video = av_find_best_stream(input, AVMEDIA_TYPE_VIDEO, -1, -1, &codec, 0);
+        decoder = codec ? avcodec_alloc_context3(codec) : nullptr;
+        ok = decoder && (video >= 0) &&
+             (avcodec_parameters_to_context(decoder, input->streams[video]->codecpar) >= 0) &&
+             (avcodec_open2(decoder, codec, nullptr) >= 0);
+    }
+
+    int     decoded  = 0;
+    int64_t lastdts  = AV_NOPTS_VALUE;
+    int64_t lastpts  = AV_NOPTS_VALUE;
+    bool    draining = false;
+    while (ok)
+    {
+        if (!draining)
+        {
+            if (av_read_frame(input, packet) < 0)
+            {
+                draining = true;
+                ok = avcodec_send_packet(decoder, nullptr) >= 0;
+            }
+            else if (packet->stream_index != video)
+            {
+                av_packet_unref(packet);
+                continue;
+            }
+            else
+            {
+                if (packet->dts != AV_NOPTS_VALUE)
+                {
+                    if (lastdts != AV_NOPTS_VALUE && packet->dts <= lastdts)
+                    {
+                        qWarning() << "Packet dts" << packet->dts << "after" << lastdts;
+                        ok = false;
+                    }
+                    if (packet->pts != AV_NOPTS_VALUE && packet->pts < packet->dts)
+                    {
+                        qWarning() << "Packet pts" << packet->pts << "before dts" << packet->dts;
+                        ok = false;
+                    }
+                    lastdts = packet->dts;
+                }
+                ok = ok && (avcodec_send_packet(decoder, packet) >= 0);
+                av_packet_unref(packet);
+            }
+        }
+
+        int ret = 0;
+        while (ok && (ret = avcodec_receive_frame(decoder, frame)) >= 0)
+        {
+            if (frame->decode_error_flags || (frame->flags & AV_FRAME_FLAG_CORRUPT))
+            {
+                qWarning() << "Frame" << decoded << "is corrupt";
+                ok = false;
+            }
+            int64_t pts = frame->best_effort_timestamp;
+            if (pts == AV_NOPTS_VALUE || (lastpts != AV_NOPTS_VALUE && pts <= lastpts))
+            {
+                qWarning() << "Frame" << decoded << "pts" << pts << "after" << lastpts;
+                ok = false;
+            }
+            lastpts = pts;
+
+            if (decoded >= Expected.size())
+            {
+                qWarning() << "More frames than expected";
+                ok = false;
+            }
+            else
+            {
+                // Normal coding error is a level or two, a broken reference
+                // is far more
+                double error = PictureError(frame, Expected[decoded]);
+                if (error > 8.0)
+                {
+                    qWarning() << "Frame" << decoded << "doesn't match source frame"
+                               << Expected[decoded] << "error" << error;
+                    ok = false;
+                }
+            }
+            ++decoded;
+            av_frame_unref(frame);
+        }
+        if (ret == AVERROR_EOF)
+            break;
+        if (ret != AVERROR(EAGAIN))
+            ok = false;
+    }
+
+    if (ok && decoded != Expected.size())
+    {
+        qWarning() << "Decoded" << decoded << "frames, expected" << Expected.size();
+        ok = false;
+    }
+
+    av_packet_free(&packet);
+    av_frame_free(&frame);
+    avcodec_free_context(&decoder);
+    avformat_close_input(&input);
+    return ok;
+}
+
+void TestSmartCut::initTestCase(void)
+{
+    gCoreContext = new MythCoreContext("bin_version", nullptr);
+
+    s_dir = new QTemporaryDir();
+    QVERIFY(s_dir->isValid());
+    s_recording = s_dir->filePath("recording.ts");
+    QVERIFY2(WriteRecording(s_recording), "Can't write an MPEG-2 test recording");
+}
+
+void TestSmartCut::cleanupTestCase(void)
+{
+    delete s_dir;
+    s_dir = nullptr;
+}
+
+void TestSmartCut::cut_data(void)
+{
+    // The frames from CUTSTART to CUTEND, inclusive, are removed. A CUTEND
+    // of -1 cuts to the end of the recording.
+    QTest::addColumn<int>("CUTSTART");
+    QTest::addColumn<int>("CUTEND");
+
+    QTest::newRow("Within GOPs")      << 40  << 90;
+    QTest::newRow("On GOP boundaries") << 50 << 99;
+    QTest::newRow("From the start")   << 0   << 30;
+    QTest::newRow("To the end")       << 200 << -1;
+    QTest::newRow("Within one GOP")   << 105 << 115;
+}
+
+// Cuts the frames from CutStart to CutEnd, returning the output file
+QString TestSmartCut::Cut(int CutStart, int CutEnd)
+{
+    frm_dir_map_t deleteMap;
+    deleteMap[CutStart] = MARK_CUT_START;
+    if (CutEnd >= 0)
+        deleteMap[CutEnd] = MARK_CUT_END;
+
+    // No position map, so the keyframes are found by reading the recording
+    QString outfile = s_dir->filePath(QString("%1-%2.ts")
+                                      .arg(QTest::currentTestFunction())
+                                      .arg(QTest::currentDataTag()));
+    SmartCut cutter(s_recording, outfile, deleteMap, frm_pos_map_t(), false);
+    if (!cutter.Init() || cutter.Start() != REENCODE_OK)
+        return QString();
+    return outfile;
+}
+
+void TestSmartCut::cut(void)
+{
+    QFETCH(int, CUTSTART);
+    QFETCH(int, CUTEND);
+
+    int removed = ((CUTEND >= 0) ? CUTEND + 1 : kFrames) - CUTSTART;
+    QString outfile = Cut(CUTSTART, CUTEND);
+    QVERIFY(!outfile.isEmpty());
+
+    bool keyframe = false;
+    QCOMPARE(CountFrames(outfile, keyframe), kFrames - removed);
+    QVERIFY(keyframe);
+}
+
+void TestSmartCut::decode_data(void)
+{
+    cut_data();
+}
+
+/*!
+ * \brief Decode a cut file and check every picture around the splice points.
+ *
+ * The re-encoded segments carry their own sequence headers and timestamps,
+ * so this checks that packet and frame timestamps keep increasing, that no
+ * frame is flagged as corrupt and that each picture is the source frame
+ * expected at that position rather than a concealed or misreferenced one.
+ */
+void TestSmartCut::decode(void)
+{
+    QFETCH(int, CUTSTART);
+    QFETCH(int, CUTEND);
+
+    QVector<int> expected;
+    for (int i = 0; i < kFrames; ++i)
+        if (i < CUTSTART || (CUTEND >= 0 && i > CUTEND))
+            expected.append(i);
+
+    QString outfile = Cut(CUTSTART, CUTEND);
+    QVERIFY(!outfile.isEmpty());
+    QVERIFY(CheckDecode(outfile, expected));
+}
+
+QTEST_GUILESS_MAIN(TestSmartCut)
@@ -0,0 +1,44 @@
+/*
+ *  Class TestSmartCut
+ *
+ *   This program is free software; you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation; either version 2 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program; if not, write to the Free Software
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301 USA
+ */
+
+#include <QtTest/QtTest>
+#include <QTemporaryDir>
+
+#include "programtypes.h"
+
+class TestSmartCut: public QObject
+{
+    Q_OBJECT
+
+  private:
+    static bool WriteRecording(const QString &Filename);
+    static int  CountFrames(const QString &Filename, bool &StartsOnKeyframe);
+    static QString Cut(int CutStart, int CutEnd);
+    static bool CheckDecode(const QString &Filename, const QVector<int> &Expected);
+
+    static inline QTemporaryDir *s_dir { nullptr };
+    static inline QString        s_recording;
+
+  private slots:
+    static void initTestCase(void);
+    static void cleanupTestCase(void);
+    static void cut_data(void);
+    static void cut(void);
+    static void decode_data(void);
+    static void decode(void);
+};
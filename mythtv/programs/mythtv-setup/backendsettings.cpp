@@ -274,6 +274,19 @@ static HostCheckBoxSetting *TruncateDeletes()
     return hc;
 };
 
+static HostCheckBoxSetting *VideoScanWatch()
+{
+    auto *hc = new HostCheckBoxSetting("VideoScanWatch");
+    hc->setLabel(QObject::tr("Watch video directories for changes"));
+    hc->setValue(false);
+    hc->setHelpText(QObject::tr("If enabled, this backend scans new, moved "
+                    "and deleted videos in its video storage directories as "
+                    "soon as they change, instead of waiting for a full scan. "
+                    "Changes made to network shares by other machines are "
+                    "not seen. Only available on Linux."));
+    return hc;
+};
+
 static GlobalCheckBoxSetting *DeletesFollowLinks()
 {
     auto *gc = new GlobalCheckBoxSetting("DeletesFollowLinks");
@@ -927,6 +940,7 @@ BackendSettings::BackendSettings()
     fm->addChild(MasterBackendOverride());
     fm->addChild(DeletesFollowLinks());
     fm->addChild(TruncateDeletes());
+    fm->addChild(VideoScanWatch());
     fm->addChild(HDRingbufferSize());
     fm->addChild(StorageScheduler());
     group2->addChild(fm);
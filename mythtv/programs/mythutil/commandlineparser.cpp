@@ -234,6 +234,9 @@ void MythUtilCommandLineParser::LoadArguments(void)
     // musicmetautils.cpp
     add("--force", "musicforce", false, "Ignore file timestamps", "")
         ->SetChildOf("scanmusic");
+    add("--watch", "musicwatch", false, "After scanning, keep watching the "
+        "storage group for changes until stopped (Linux, local changes only)", "")
+        ->SetChildOf("scanmusic");
     add("--songid", "songid", "", "ID of track to update", "")
         ->SetChildOf("updatemeta");
     add("--title", "title", "", "(optional) Title of track", "")
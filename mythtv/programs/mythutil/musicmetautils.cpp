@@ -191,6 +191,8 @@ static int ScanMusic(const MythUtilCommandLineParser &cmdline)
     }
 
     fscan->SearchDirs(dirList);
+    if (cmdline.toBool("musicwatch"))
+        fscan->WatchDirs(dirList);
     delete fscan;
 
     return GENERIC_EXIT_OK;